@@ -27,6 +27,7 @@
 
 // STL
 #include <sstream>
+#include <string>
 
 // BusyBee
 #include <busybee_constants.h>
@@ -37,6 +38,7 @@
 #include "common/macros.h"
 #include "admin/admin.h"
 #include "admin/coord_rpc_add_space.h"
+#include "admin/coord_rpc_index.h"
 #include "admin/coord_rpc_rm_space.h"
 #include "admin/hyperspace_builder_internal.h"
 #include "admin/pending_perf_counters.h"
@@ -141,8 +143,9 @@ admin :: add_space(const char* description,
         return -1;
     }
 
-    std::auto_ptr<e::buffer> msg(e::buffer::create(pack_size(space)));
-    msg->pack_at(0) << space;
+    std::auto_ptr<e::buffer> msg(e::buffer::create(pack_size(space) +
+                                                   pack_size_index_extensions(space)));
+    pack_index_extensions(msg->pack_at(0) << space, space);
 
     int64_t id = m_next_admin_id;
     ++m_next_admin_id;
@@ -189,6 +192,20 @@ admin :: rm_space(const char* name,
     }
 }
 
+int64_t
+admin :: add_index(const char* space, const char* attr,
+                   hyperdex_admin_returncode* status)
+{
+    return index_rpc("index_add", space, attr, status);
+}
+
+int64_t
+admin :: rm_index(const char* space, const char* attr,
+                  hyperdex_admin_returncode* status)
+{
+    return index_rpc("index_rm", space, attr, status);
+}
+
 int64_t
 admin :: enable_perf_counters(hyperdex_admin_returncode* status,
                               hyperdex_admin_perf_counter* pc)
@@ -714,6 +731,36 @@ admin :: handle_disruption(const server_id& si)
     m_busybee.drop(si.get());
 }
 
+int64_t
+admin :: index_rpc(const char* func,
+                   const char* space, const char* attr,
+                   hyperdex_admin_returncode* status)
+{
+    if (!maintain_coord_connection(status))
+    {
+        return -1;
+    }
+
+    std::string msg(space, strlen(space) + 1);
+    msg.append(attr, strlen(attr) + 1);
+    int64_t id = m_next_admin_id;
+    ++m_next_admin_id;
+    e::intrusive_ptr<coord_rpc> op = new coord_rpc_index(id, status);
+    int64_t cid = m_coord.rpc(func, msg.data(), msg.size(),
+                              &op->repl_status, &op->repl_output, &op->repl_output_sz);
+
+    if (cid >= 0)
+    {
+        m_coord_ops[cid] = op;
+        return op->admin_visible_id();
+    }
+    else
+    {
+        interpret_rpc_request_failure(op->repl_status, status);
+        return -1;
+    }
+}
+
 HYPERDEX_API std::ostream&
 operator << (std::ostream& lhs, hyperdex_admin_returncode rhs)
 {
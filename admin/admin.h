@@ -63,6 +63,11 @@ class admin
                           enum hyperdex_admin_returncode* status);
         int64_t rm_space(const char* name,
                          enum hyperdex_admin_returncode* status);
+        // manage indices on existing spaces
+        int64_t add_index(const char* space, const char* attr,
+                          enum hyperdex_admin_returncode* status);
+        int64_t rm_index(const char* space, const char* attr,
+                         enum hyperdex_admin_returncode* status);
         // read performance counters
         int64_t enable_perf_counters(hyperdex_admin_returncode* status,
                                      hyperdex_admin_perf_counter* pc);
@@ -108,6 +113,10 @@ class admin
                   e::intrusive_ptr<pending> op,
                   hyperdex_admin_returncode* status);
         void handle_disruption(const server_id& si);
+        // send "space\0attr\0" to the coordinator's index transition
+        int64_t index_rpc(const char* func,
+                          const char* space, const char* attr,
+                          hyperdex_admin_returncode* status);
 
     private:
         coordinator_link m_coord;
@@ -132,6 +132,30 @@ hyperdex_admin_rm_space(struct hyperdex_admin* _adm,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_admin_add_index(struct hyperdex_admin* _adm,
+                         const char* space,
+                         const char* attribute,
+                         hyperdex_admin_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    hyperdex::admin* adm = reinterpret_cast<hyperdex::admin*>(_adm);
+    return adm->add_index(space, attribute, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_admin_rm_index(struct hyperdex_admin* _adm,
+                        const char* space,
+                        const char* attribute,
+                        hyperdex_admin_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    hyperdex::admin* adm = reinterpret_cast<hyperdex::admin*>(_adm);
+    return adm->rm_index(space, attribute, status);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_admin_enable_perf_counters(struct hyperdex_admin* _adm,
                                     enum hyperdex_admin_returncode* status,
@@ -70,11 +70,15 @@ class hypersubspace
     public:
         std::vector<const char*> attrs;
         std::vector<const char*> sindices;
+        std::vector<const char*> covering;
+        std::vector<std::vector<const char*> > composites;
 };
 
 hypersubspace :: hypersubspace()
     : attrs()
     , sindices()
+    , covering()
+    , composites()
 {
 }
 
@@ -107,6 +111,10 @@ class hyperspace
         attribute key;
         std::vector<attribute> attributes;
         std::vector<const char*> pindices;
+        std::vector<const char*> pcovering;
+        std::vector<std::vector<const char*> > pcomposites;
+        // is the most recently started composite index a primary one?
+        bool composite_primary;
         std::vector<hypersubspace> subspaces;
         uint64_t fault_tolerance;
         uint64_t partitions;
@@ -124,6 +132,9 @@ hyperspace :: hyperspace()
     , key()
     , attributes()
     , pindices()
+    , pcovering()
+    , pcomposites()
+    , composite_primary(false)
     , subspaces()
     , fault_tolerance(2)
     , partitions(256)
@@ -201,6 +212,42 @@ is_concrete_datatype(hyperdatatype type)
     return datatype_info::lookup(type) != NULL;
 }
 
+static hyperspace_returncode
+hyperspace_covering(hyperspace* space,
+                    std::vector<const char*>* covering,
+                    const char* attr)
+{
+    if (strcmp(space->key.name, attr) == 0)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot cover \"%s\" because it is the key", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_IS_KEY;
+    }
+
+    if (!space->has_attr(attr))
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot cover \"%s\" because there is no attribute by that name", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_UNKNOWN_ATTR;
+    }
+
+    for (size_t i = 0; i < covering->size(); ++i)
+    {
+        if (strcmp((*covering)[i], attr) == 0)
+        {
+            snprintf(space->buffer, BUFFER_SIZE, "cannot cover \"%s\" because it is already covered", attr);
+            space->buffer[BUFFER_SIZE - 1] = '\0';
+            space->error = space->buffer;
+            return HYPERSPACE_DUPLICATE;
+        }
+    }
+
+    covering->push_back(space->internalize(attr));
+    return HYPERSPACE_SUCCESS;
+}
+
 extern "C"
 {
 
@@ -418,6 +465,20 @@ hyperspace_primary_index(hyperspace* space, const char* attr)
     return HYPERSPACE_SUCCESS;
 }
 
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_primary_covering(hyperspace* space, const char* attr)
+{
+    return hyperspace_covering(space, &space->pcovering, attr);
+}
+
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_primary_composite_index(hyperspace* space)
+{
+    space->pcomposites.push_back(std::vector<const char*>());
+    space->composite_primary = true;
+    return HYPERSPACE_SUCCESS;
+}
+
 HYPERDEX_API enum hyperspace_returncode
 hyperspace_add_subspace(hyperspace* space)
 {
@@ -509,6 +570,102 @@ hyperspace_add_secondary_index(hyperspace* space, const char* attr)
     return HYPERSPACE_SUCCESS;
 }
 
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_add_secondary_covering(hyperspace* space, const char* attr)
+{
+    if (space->subspaces.empty())
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot cover attribute in subspace, because there is no subspace");
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_NO_SUBSPACE;
+    }
+
+    return hyperspace_covering(space, &space->subspaces.back().covering, attr);
+}
+
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_add_secondary_composite_index(hyperspace* space)
+{
+    if (space->subspaces.empty())
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot create composite index, because there is no subspace");
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_NO_SUBSPACE;
+    }
+
+    space->subspaces.back().composites.push_back(std::vector<const char*>());
+    space->composite_primary = false;
+    return HYPERSPACE_SUCCESS;
+}
+
+HYPERDEX_API enum hyperspace_returncode
+hyperspace_add_composite_index_attribute(hyperspace* space, const char* attr)
+{
+    std::vector<const char*>* composite = NULL;
+
+    if (space->composite_primary && !space->pcomposites.empty())
+    {
+        composite = &space->pcomposites.back();
+    }
+    else if (!space->composite_primary && !space->subspaces.empty() &&
+             !space->subspaces.back().composites.empty())
+    {
+        composite = &space->subspaces.back().composites.back();
+    }
+
+    if (!composite)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot add \"%s\" to composite index, because there is no composite index", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_NO_SUBSPACE;
+    }
+
+    if (strcmp(space->key.name, attr) == 0)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot add \"%s\" to composite index because it is the key", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_IS_KEY;
+    }
+
+    if (!space->has_attr(attr))
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot add \"%s\" to composite index because there is no attribute by that name", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_UNKNOWN_ATTR;
+    }
+
+    hyperdatatype type = space->attr_type(attr);
+
+    if (type != HYPERDATATYPE_STRING &&
+        type != HYPERDATATYPE_INT64 &&
+        type != HYPERDATATYPE_FLOAT)
+    {
+        snprintf(space->buffer, BUFFER_SIZE, "cannot add \"%s\" to composite index because only strings, integers and floats may be combined", attr);
+        space->buffer[BUFFER_SIZE - 1] = '\0';
+        space->error = space->buffer;
+        return HYPERSPACE_UNINDEXABLE;
+    }
+
+    for (size_t i = 0; i < composite->size(); ++i)
+    {
+        if (strcmp((*composite)[i], attr) == 0)
+        {
+            snprintf(space->buffer, BUFFER_SIZE, "cannot add \"%s\" to composite index because it is already part of it", attr);
+            space->buffer[BUFFER_SIZE - 1] = '\0';
+            space->error = space->buffer;
+            return HYPERSPACE_DUPLICATE;
+        }
+    }
+
+    composite->push_back(space->internalize(attr));
+    return HYPERSPACE_SUCCESS;
+}
+
 HYPERDEX_API enum hyperspace_returncode
 hyperspace_set_fault_tolerance(hyperspace* space, uint64_t num)
 {
@@ -577,6 +734,25 @@ hyperdex :: space_to_space(hyperspace* in, hyperdex::space* out)
         sp.subspaces.back().indices.push_back(attr);
     }
 
+    for (size_t i = 0; i < in->pcovering.size(); ++i)
+    {
+        uint16_t attr = sc.lookup_attr(in->pcovering[i]);
+        assert(attr < sc.attrs_sz);
+        sp.subspaces.back().covering.push_back(attr);
+    }
+
+    for (size_t i = 0; i < in->pcomposites.size(); ++i)
+    {
+        sp.subspaces.back().composites.push_back(std::vector<uint16_t>());
+
+        for (size_t j = 0; j < in->pcomposites[i].size(); ++j)
+        {
+            uint16_t attr = sc.lookup_attr(in->pcomposites[i][j]);
+            assert(attr < sc.attrs_sz);
+            sp.subspaces.back().composites.back().push_back(attr);
+        }
+    }
+
     for (size_t i = 0; i < in->subspaces.size(); ++i)
     {
         if (in->subspaces[i].attrs.empty())
@@ -599,6 +775,25 @@ hyperdex :: space_to_space(hyperspace* in, hyperdex::space* out)
             assert(attr < sc.attrs_sz);
             sp.subspaces.back().indices.push_back(attr);
         }
+
+        for (size_t j = 0; j < in->subspaces[i].covering.size(); ++j)
+        {
+            uint16_t attr = sc.lookup_attr(in->subspaces[i].covering[j]);
+            assert(attr < sc.attrs_sz);
+            sp.subspaces.back().covering.push_back(attr);
+        }
+
+        for (size_t j = 0; j < in->subspaces[i].composites.size(); ++j)
+        {
+            sp.subspaces.back().composites.push_back(std::vector<uint16_t>());
+
+            for (size_t k = 0; k < in->subspaces[i].composites[j].size(); ++k)
+            {
+                uint16_t attr = sc.lookup_attr(in->subspaces[i].composites[j][k]);
+                assert(attr < sc.attrs_sz);
+                sp.subspaces.back().composites.back().push_back(attr);
+            }
+        }
     }
 
     sp.fault_tolerance = in->fault_tolerance;
@@ -74,6 +74,7 @@ yyerror(YYLTYPE* yylloc, struct hyperspace* space, void* scanner, const char* ms
 %token SUBSPACE
 %token PINDEX
 %token SINDEX
+%token COVERING
 
 %token <str> IDENTIFIER
 %token <num> NUMBER
@@ -89,6 +90,8 @@ yyerror(YYLTYPE* yylloc, struct hyperspace* space, void* scanner, const char* ms
 %type <ret> attribute_list
 %type <str> pindex
 %type <str> sindex
+%type <str> pcover
+%type <str> scover
 
 %union
 {
@@ -105,7 +108,7 @@ yyerror(YYLTYPE* yylloc, struct hyperspace* space, void* scanner, const char* ms
 
 %%
 
-space : SPACE name key ATTRIBUTES attribute_list pindices subspaces options
+space : SPACE name key ATTRIBUTES attribute_list pindices pcovering subspaces options
 
 name : IDENTIFIER { hyperspace_set_name(space, $1); free($1); }
 
@@ -121,12 +124,22 @@ pindices :
          | PINDEX pindex
 
 pindex : IDENTIFIER            { hyperspace_primary_index(space, $1); free($1); }
+       | pcomposite            { $$ = NULL; }
        | pindex ',' IDENTIFIER { hyperspace_primary_index(space, $3); free($3); }
+       | pindex ',' pcomposite
+
+pcomposite : '(' { hyperspace_primary_composite_index(space); } composite_attrs ')'
+
+pcovering :
+          | COVERING pcover
+
+pcover : IDENTIFIER            { hyperspace_primary_covering(space, $1); free($1); }
+       | pcover ',' IDENTIFIER { hyperspace_primary_covering(space, $3); free($3); }
 
 subspaces :
           | subspaces subspace
 
-subspace : SUBSPACE sattrs sindices
+subspace : SUBSPACE sattrs sindices scovering
 
 sattrs : IDENTIFIER            { hyperspace_add_subspace(space); hyperspace_add_subspace_attribute(space, $1); free($1); }
        | sattrs ',' IDENTIFIER { hyperspace_add_subspace_attribute(space, $3); free($3); }
@@ -135,7 +148,20 @@ sindices :
          | SINDEX sindex
 
 sindex : IDENTIFIER            { hyperspace_add_secondary_index(space, $1); free($1); }
+       | scomposite            { $$ = NULL; }
        | sindex ',' IDENTIFIER { hyperspace_add_secondary_index(space, $3); free($3); }
+       | sindex ',' scomposite
+
+scomposite : '(' { hyperspace_add_secondary_composite_index(space); } composite_attrs ')'
+
+composite_attrs : IDENTIFIER                     { hyperspace_add_composite_index_attribute(space, $1); free($1); }
+                | composite_attrs ',' IDENTIFIER { hyperspace_add_composite_index_attribute(space, $3); free($3); }
+
+scovering :
+          | COVERING scover
+
+scover : IDENTIFIER            { hyperspace_add_secondary_covering(space, $1); free($1); }
+       | scover ',' IDENTIFIER { hyperspace_add_secondary_covering(space, $3); free($3); }
 
 options :                { }
         | options option { }
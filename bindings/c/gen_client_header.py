@@ -80,6 +80,21 @@ struct hyperdex_client_attribute_check
     enum hyperpredicate predicate;
 };
 
+#define HYPERDEX_CLIENT_AGGREGATE_BUCKETS 16
+
+struct hyperdex_client_aggregate_result
+{
+    uint64_t count; /* number of objects aggregated */
+    double sum;
+    double min;
+    double max;
+    double avg;
+    /* the histogram evenly divides [histogram_lower, histogram_upper) */
+    uint64_t below;
+    uint64_t above;
+    uint64_t buckets[HYPERDEX_CLIENT_AGGREGATE_BUCKETS];
+};
+
 /* HyperClient returncode occupies [8448, 8576) */
 enum hyperdex_client_returncode
 {
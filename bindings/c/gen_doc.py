@@ -35,6 +35,13 @@ ARGS_IN = {(generator.AsyncCall, generator.SpaceName): 'The name of the space as
           ,(generator.AsyncCall, generator.Predicates): 'A set of predicates '
            'to check against.  \\texttt{checks} points to an array of length '
            '\\texttt{checks\_sz}.'
+          ,(generator.AsyncCall, generator.AttributeNames): 'The names of the '
+           'attributes to retrieve.  \\texttt{attrnames} points to an array of '
+           '\\texttt{attrnames\_sz} c-strings.'
+          ,(generator.AsyncCall, generator.AggregateAttribute): 'The name of '
+           'the int64 or float attribute to aggregate.'
+          ,(generator.AsyncCall, generator.HistogramRange): 'The range '
+           'divided evenly among the buckets of the histogram.'
           ,(generator.Iterator, generator.SpaceName): 'The name of the space as a c-string.'
           ,(generator.Iterator, generator.SortBy): 'The attribute to sort by.'
           ,(generator.Iterator, generator.Limit): 'The number of results to return.'
@@ -42,6 +49,9 @@ ARGS_IN = {(generator.AsyncCall, generator.SpaceName): 'The name of the space as
           ,(generator.Iterator, generator.Predicates): 'A set of predicates '
            'to check against.  \\texttt{checks} points to an array of length '
            '\\texttt{checks\_sz}.'
+          ,(generator.Iterator, generator.AttributeNames): 'The names of the '
+           'attributes to retrieve.  \\texttt{attrnames} points to an array of '
+           '\\texttt{attrnames\_sz} c-strings.'
           }
 ARGS_OUT = {(generator.AsyncCall, generator.Status): 'The status of the '
             'operation.  The client library will fill in this variable before '
@@ -55,6 +65,9 @@ ARGS_OUT = {(generator.AsyncCall, generator.Status): 'The status of the '
             'pointers must remain valid until the operation completes.'
            ,(generator.AsyncCall, generator.Count): 'The number of objects which '
             'match the predicates.'
+           ,(generator.AsyncCall, generator.Aggregate): 'The sum, minimum, '
+            'maximum, average and histogram of the attribute over the objects '
+            'which match the predicates.'
            ,(generator.AsyncCall, generator.Description): 'The description of '
             'the search.  This is a c-string that the client must free.'
            ,(generator.Iterator, generator.Status): 'The status of the '
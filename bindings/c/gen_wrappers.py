@@ -225,16 +225,42 @@ def generate_func(x):
     func += '    C_WRAP_EXCEPT(\n'
     if x.name == 'get':
         func += '    return cl->get(space, key, key_sz, status, attrs, attrs_sz);\n'
+    elif x.name == 'get_partial':
+        func += '    return cl->get_partial(space, key, key_sz, attrnames, attrnames_sz, status, attrs, attrs_sz);\n'
     elif x.name == 'search':
         func += '    return cl->search(space, checks, checks_sz, status, attrs, attrs_sz);\n'
+    elif x.name == 'search_partial':
+        func += '    return cl->search_partial(space, checks, checks_sz, attrnames, attrnames_sz, status, attrs, attrs_sz);\n'
+    elif x.name == 'search_limit':
+        func += '    return cl->search_limit(space, checks, checks_sz, limit, status, attrs, attrs_sz);\n'
     elif x.name == 'search_describe':
         func += '    return cl->search_describe(space, checks, checks_sz, status, description);\n'
     elif x.name == 'sorted_search':
         func += '    return cl->sorted_search(space, checks, checks_sz, sort_by, limit, maxmin, status, attrs, attrs_sz);\n'
+    elif x.name == 'sorted_search_partial':
+        func += '    return cl->sorted_search_partial(space, checks, checks_sz, sort_by, limit, maxmin, attrnames, attrnames_sz, status, attrs, attrs_sz);\n'
     elif x.name == 'group_del':
         func += '    return cl->group_del(space, checks, checks_sz, status);\n'
     elif x.name == 'count':
         func += '    return cl->count(space, checks, checks_sz, status, count);\n'
+    elif x.name == 'aggregate':
+        func += '    return cl->aggregate(space, checks, checks_sz, attr, histogram_lower, histogram_upper, status, aggregate);\n'
+    elif x.name.startswith('group_'):
+        args = ('opinfo', 'space', 'checks', 'checks_sz')
+        if generator.Attributes in x.args_in:
+            args += ('attrs', 'attrs_sz')
+        else:
+            args += ('NULL', '0')
+        if generator.MapAttributes in x.args_in:
+            args += ('mapattrs', 'mapattrs_sz')
+        else:
+            args += ('NULL', '0')
+        args += ('status',)
+        func += '    const hyperdex_client_keyop_info* opinfo;\n'
+        func += '    opinfo = hyperdex_client_keyop_info_lookup(XSTR({0}), strlen(XSTR({0})));\n'.format(x.name)
+        func += '    return cl->perform_group_funcall('
+        func += ', '.join([rename(a) for a in args])
+        func += ');\n'
     else:
         args = ('opinfo', 'space', 'key', 'key_sz')
         if generator.Predicates in x.args_in:
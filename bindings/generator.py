@@ -52,6 +52,14 @@ class Count(object):
     args = (('uint64_t', 'count'),)
 class MaxMin(object):
     args = (('int', 'maxmin'),)
+class AttributeNames(object):
+    args = (('const char**', 'attrnames'), ('size_t', 'attrnames_sz'))
+class AggregateAttribute(object):
+    args = (('const char*', 'attr'),)
+class HistogramRange(object):
+    args = (('double', 'histogram_lower'), ('double', 'histogram_upper'))
+class Aggregate(object):
+    args = (('struct hyperdex_client_aggregate_result', 'aggregate'),)
 
 class Method(object):
 
@@ -63,6 +71,7 @@ class Method(object):
 
 Client = [
     Method('get', AsyncCall, (SpaceName, Key), (Status, Attributes)),
+    Method('get_partial', AsyncCall, (SpaceName, Key, AttributeNames), (Status, Attributes)),
     Method('put', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
     Method('cond_put', AsyncCall, (SpaceName, Key, Predicates, Attributes), (Status,)),
     Method('put_if_not_exist', AsyncCall, (SpaceName, Key, Attributes), (Status,)),
@@ -125,8 +134,41 @@ Client = [
     Method('map_string_append', AsyncCall, (SpaceName, Key, MapAttributes), (Status,)),
     Method('cond_map_string_append', AsyncCall, (SpaceName, Key, Predicates, MapAttributes), (Status,)),
     Method('search', Iterator, (SpaceName, Predicates), (Status, Attributes)),
+    Method('search_partial', Iterator, (SpaceName, Predicates, AttributeNames), (Status, Attributes)),
+    Method('search_limit', Iterator, (SpaceName, Predicates, Limit), (Status, Attributes)),
     Method('search_describe', AsyncCall, (SpaceName, Predicates), (Status, Description)),
     Method('sorted_search', Iterator, (SpaceName, Predicates, SortBy, Limit, MaxMin), (Status, Attributes)),
+    Method('sorted_search_partial', Iterator, (SpaceName, Predicates, SortBy, Limit, MaxMin, AttributeNames), (Status, Attributes)),
     Method('group_del', AsyncCall, (SpaceName, Predicates), (Status,)),
+    Method('group_put', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_add', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_sub', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_mul', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_div', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_mod', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_and', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_or', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_atomic_xor', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_string_prepend', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_string_append', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_list_lpush', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_list_rpush', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_set_add', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_set_remove', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_set_intersect', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_set_union', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_map_add', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_remove', AsyncCall, (SpaceName, Predicates, Attributes), (Status,)),
+    Method('group_map_atomic_add', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_sub', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_mul', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_div', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_mod', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_and', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_or', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_atomic_xor', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_string_prepend', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
+    Method('group_map_string_append', AsyncCall, (SpaceName, Predicates, MapAttributes), (Status,)),
     Method('count', AsyncCall, (SpaceName, Predicates), (Status, Count)),
+    Method('aggregate', AsyncCall, (SpaceName, Predicates, AggregateAttribute, HistogramRange), (Status, Aggregate)),
     None][:-1]
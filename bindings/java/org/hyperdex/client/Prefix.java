@@ -0,0 +1,22 @@
+package org.hyperdex.client;
+
+import java.util.*;
+
+public class Prefix extends Predicate
+{
+    public Prefix(Object prefix) throws AttributeError
+    {
+        if ( ! Client.isBytes(prefix) )
+        {
+            throw new AttributeError("Prefix must be a byte[], ByteArray, or String");
+        }
+
+        List<Map.Entry<hyperpredicate,Object>> raw
+            = new Vector<Map.Entry<hyperpredicate,Object>>(1);
+
+        raw.add(new AbstractMap.SimpleEntry<hyperpredicate,Object>(
+                hyperpredicate.HYPERPREDICATE_PREFIX,prefix));
+
+        this.raw = raw;
+    }
+}
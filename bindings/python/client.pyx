@@ -42,6 +42,10 @@ cdef extern from "stdlib.h":
     void* malloc(size_t size)
     void free(void* ptr)
 
+cdef extern from "string.h":
+
+    void* memset(void* s, int c, size_t n)
+
 cdef extern from "sys/socket.h":
 
     ctypedef uint16_t in_port_t
@@ -85,6 +89,8 @@ cdef extern from "hyperdex.h":
         HYPERPREDICATE_REGEX         = 9733
         HYPERPREDICATE_LENGTH_LESS_EQUAL    = 9735
         HYPERPREDICATE_CONTAINS      = 9737
+        HYPERPREDICATE_PREFIX        = 9738
+        HYPERPREDICATE_IN            = 9739
 
 cdef extern from "hyperdex/client.h":
 
@@ -112,6 +118,16 @@ cdef extern from "hyperdex/client.h":
         hyperdatatype datatype
         hyperpredicate predicate
 
+    cdef struct hyperdex_client_aggregate_result:
+        uint64_t count
+        double sum
+        double min
+        double max
+        double avg
+        uint64_t below
+        uint64_t above
+        uint64_t buckets[16]
+
     cdef enum hyperdex_client_returncode:
         HYPERDEX_CLIENT_SUCCESS      = 8448
         HYPERDEX_CLIENT_NOTFOUND     = 8449
@@ -143,6 +159,7 @@ cdef extern from "hyperdex/client.h":
     hyperdex_client* hyperdex_client_create(char* coordinator, uint16_t port)
     void hyperdex_client_destroy(hyperdex_client* client)
     int64_t hyperdex_client_get(hyperdex_client* client, char* space, char* key, size_t key_sz, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
+    int64_t hyperdex_client_get_partial(hyperdex_client* client, char* space, char* key, size_t key_sz, char** attrnames, size_t attrnames_sz, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
     int64_t hyperdex_client_put(hyperdex_client* client, char* space, char* key, size_t key_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_cond_put(hyperdex_client* client, char* space, char* key, size_t key_sz, hyperdex_client_attribute_check* condattrs, size_t condattrs_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_put_if_not_exist(hyperdex_client* client, char* space, char* key, size_t key_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
@@ -205,10 +222,43 @@ cdef extern from "hyperdex/client.h":
     int64_t hyperdex_client_map_string_append(hyperdex_client* client, char* space, char* key, size_t key_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_cond_map_string_append(hyperdex_client* client, char* space, char* key, size_t key_sz, hyperdex_client_attribute_check* condattrs, size_t condattrs_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_search(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
+    int64_t hyperdex_client_search_partial(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, char** attrnames, size_t attrnames_sz, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
+    int64_t hyperdex_client_search_limit(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, uint64_t limit, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
     int64_t hyperdex_client_search_describe(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_returncode* status, char** text)
     int64_t hyperdex_client_sorted_search(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, char* sort_by, uint64_t limit, int maximize, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
+    int64_t hyperdex_client_sorted_search_partial(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, char* sort_by, uint64_t limit, int maximize, char** attrnames, size_t attrnames_sz, hyperdex_client_returncode* status, hyperdex_client_attribute** attrs, size_t* attrs_sz)
     int64_t hyperdex_client_group_del(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_put(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_add(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_sub(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_mul(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_div(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_mod(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_and(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_or(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_atomic_xor(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_string_prepend(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_string_append(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_list_lpush(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_list_rpush(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_set_add(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_set_remove(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_set_intersect(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_set_union(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_add(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_remove(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_add(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_sub(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_mul(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_div(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_mod(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_and(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_or(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_atomic_xor(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_string_prepend(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
+    int64_t hyperdex_client_group_map_string_append(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute* attrs, size_t attrs_sz, hyperdex_client_returncode* status)
     int64_t hyperdex_client_count(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_returncode* status, uint64_t* result)
+    int64_t hyperdex_client_aggregate(hyperdex_client* client, char* space, hyperdex_client_attribute_check* chks, size_t chks_sz, char* attr, double histogram_lower, double histogram_upper, hyperdex_client_returncode* status, hyperdex_client_aggregate_result* aggregate)
     int64_t hyperdex_client_loop(hyperdex_client* client, int timeout, hyperdex_client_returncode* status)
     void hyperdex_client_destroy_attrs(hyperdex_client_attribute* attrs, size_t attrs_sz)
 
@@ -216,6 +266,8 @@ ctypedef int64_t (*hyperdex_client_simple_op)(hyperdex_client*, char*, char*, si
 ctypedef int64_t (*hyperdex_client_map_op)(hyperdex_client*, char*, char*, size_t, hyperdex_client_map_attribute*, size_t, hyperdex_client_returncode*)
 ctypedef int64_t (*hyperdex_client_cond_op)(hyperdex_client*, char*, char*, size_t, hyperdex_client_attribute_check* condattrs, size_t condattrs_sz, hyperdex_client_attribute*, size_t, hyperdex_client_returncode*)
 ctypedef int64_t (*hyperdex_client_cond_map_op)(hyperdex_client*, char*, char*, size_t, hyperdex_client_attribute_check* condattrs, size_t condattrs_sz, hyperdex_client_map_attribute*, size_t, hyperdex_client_returncode*)
+ctypedef int64_t (*hyperdex_client_group_op)(hyperdex_client*, char*, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_attribute*, size_t, hyperdex_client_returncode*)
+ctypedef int64_t (*hyperdex_client_group_map_op)(hyperdex_client*, char*, hyperdex_client_attribute_check* chks, size_t chks_sz, hyperdex_client_map_attribute*, size_t, hyperdex_client_returncode*)
 
 import collections
 import struct
@@ -820,6 +872,36 @@ cdef _check_reqid_search(int64_t reqid, hyperdex_client_returncode status,
         raise HyperClientException(status, attr)
 
 
+cdef _check_reqid_search_attrs(int64_t reqid, hyperdex_client_returncode status,
+                               hyperdex_client_attribute_check* chks, size_t chks_sz,
+                               hyperdex_client_attribute* attrs, size_t attrs_sz):
+    cdef bytes attr
+    if reqid < 0:
+        idx = -1 - reqid
+        attr = None
+        if idx >= 0 and idx < chks_sz and chks and chks[idx].attr:
+            attr = chks[idx].attr
+        idx -= chks_sz
+        if idx >= 0 and idx < attrs_sz and attrs and attrs[idx].attr:
+            attr = attrs[idx].attr
+        raise HyperClientException(status, attr)
+
+
+cdef _check_reqid_search_map_attrs(int64_t reqid, hyperdex_client_returncode status,
+                                   hyperdex_client_attribute_check* chks, size_t chks_sz,
+                                   hyperdex_client_map_attribute* attrs, size_t attrs_sz):
+    cdef bytes attr
+    if reqid < 0:
+        idx = -1 - reqid
+        attr = None
+        if idx >= 0 and idx < chks_sz and chks and chks[idx].attr:
+            attr = chks[idx].attr
+        idx -= chks_sz
+        if idx >= 0 and idx < attrs_sz and attrs and attrs[idx].attr:
+            attr = attrs[idx].attr
+        raise HyperClientException(status, attr)
+
+
 cdef class Deferred:
 
     cdef Client _client
@@ -849,7 +931,7 @@ cdef class DeferredGet(Deferred):
     cdef size_t _attrs_sz
     cdef bytes _space
 
-    def __cinit__(self, Client client, bytes space, key):
+    def __cinit__(self, Client client, bytes space, key, list attrnames=None):
         self._attrs = <hyperdex_client_attribute*> NULL
         self._attrs_sz = 0
         self._space = space
@@ -857,10 +939,23 @@ cdef class DeferredGet(Deferred):
         datatype, key_backing = _obj_to_backing(key)
         cdef char* space_cstr = space
         cdef char* key_cstr = key_backing
-        self._reqid = hyperdex_client_get(client._client, space_cstr,
-                                      key_cstr, len(key_backing),
-                                      &self._status,
-                                      &self._attrs, &self._attrs_sz)
+        cdef char** names = NULL
+        cdef size_t names_sz = 0
+        if attrnames is None:
+            self._reqid = hyperdex_client_get(client._client, space_cstr,
+                                          key_cstr, len(key_backing),
+                                          &self._status,
+                                          &self._attrs, &self._attrs_sz)
+        else:
+            try:
+                backings = _attrnames_to_c(attrnames, &names, &names_sz)
+                self._reqid = hyperdex_client_get_partial(client._client, space_cstr,
+                                                      key_cstr, len(key_backing),
+                                                      names, names_sz,
+                                                      &self._status,
+                                                      &self._attrs, &self._attrs_sz)
+            finally:
+                if names: free(names)
         _check_reqid(self._reqid, self._status)
         client._ops[self._reqid] = self
 
@@ -1119,6 +1214,19 @@ cdef _predicate_to_c(dict predicate,
     return backings
 
 
+cdef _attrnames_to_c(list attrnames, char*** names, size_t* names_sz):
+    names_sz[0] = len(attrnames)
+    names[0] = <char**> malloc(sizeof(char*) * (names_sz[0] + 1))
+    if names[0] == NULL:
+        raise MemoryError()
+    backings = []
+    for i, name in enumerate(attrnames):
+        name = bytes(name)
+        backings.append(name)
+        names[0][i] = name
+    return backings
+
+
 cdef class DeferredGroupDel(Deferred):
 
     def __cinit__(self, Client client, bytes space, dict predicate):
@@ -1145,6 +1253,77 @@ cdef class DeferredGroupDel(Deferred):
             raise HyperClientException(self._status)
 
 
+cdef class DeferredGroupOp(Deferred):
+
+    def __cinit__(self, Client client):
+        pass
+
+    cdef call(self, hyperdex_client_group_op op, bytes space, dict predicate, dict value):
+        cdef char* space_cstr = space
+        cdef hyperdex_client_attribute_check* chks = NULL
+        cdef size_t chks_sz = 0
+        cdef hyperdex_client_attribute* attrs = NULL
+        try:
+            backingsc = _predicate_to_c(predicate, &chks, &chks_sz)
+            backingsa = _dict_to_attrs(value.items(), &attrs)
+            self._reqid = op(self._client._client, space_cstr,
+                             chks, chks_sz,
+                             attrs, len(value),
+                             &self._status)
+            _check_reqid_search_attrs(self._reqid, self._status,
+                                      chks, chks_sz,
+                                      attrs, len(value))
+            self._client._ops[self._reqid] = self
+        finally:
+            if chks:
+                free(chks)
+            if attrs:
+                free(attrs)
+
+    def wait(self):
+        Deferred.wait(self)
+        if self._status == HYPERDEX_CLIENT_SUCCESS:
+            return True
+        else:
+            raise HyperClientException(self._status)
+
+
+cdef class DeferredGroupMapOp(Deferred):
+
+    def __cinit__(self, Client client):
+        pass
+
+    cdef call(self, hyperdex_client_group_map_op op, bytes space, dict predicate, dict value):
+        cdef char* space_cstr = space
+        cdef hyperdex_client_attribute_check* chks = NULL
+        cdef size_t chks_sz = 0
+        cdef hyperdex_client_map_attribute* attrs = NULL
+        cdef size_t attrs_sz = 0
+        try:
+            backingsc = _predicate_to_c(predicate, &chks, &chks_sz)
+            backingsa = _dict_to_map_attrs(value.items(), &attrs, &attrs_sz)
+            self._reqid = op(self._client._client, space_cstr,
+                             chks, chks_sz,
+                             attrs, attrs_sz,
+                             &self._status)
+            _check_reqid_search_map_attrs(self._reqid, self._status,
+                                          chks, chks_sz,
+                                          attrs, attrs_sz)
+            self._client._ops[self._reqid] = self
+        finally:
+            if chks:
+                free(chks)
+            if attrs:
+                free(attrs)
+
+    def wait(self):
+        Deferred.wait(self)
+        if self._status == HYPERDEX_CLIENT_SUCCESS:
+            return True
+        else:
+            raise HyperClientException(self._status)
+
+
 cdef class DeferredSearchDescribe(Deferred):
 
     cdef char* _text
@@ -1207,6 +1386,44 @@ cdef class DeferredCount(Deferred):
             raise HyperClientException(self._status)
 
 
+cdef class DeferredAggregate(Deferred):
+
+    cdef hyperdex_client_aggregate_result _result
+
+    def __cinit__(self, Client client, bytes space, dict predicate, bytes attr,
+                  double histogram_lower, double histogram_upper):
+        self._client = client
+        self._reqid = 0
+        self._status = HYPERDEX_CLIENT_GARBAGE
+        memset(&self._result, 0, sizeof(hyperdex_client_aggregate_result))
+        cdef hyperdex_client_attribute_check* chks = NULL
+        cdef size_t chks_sz = 0
+        try:
+            backings = _predicate_to_c(predicate, &chks, &chks_sz)
+            self._reqid = hyperdex_client_aggregate(client._client, space,
+                                            chks, chks_sz, attr,
+                                            histogram_lower, histogram_upper,
+                                            &self._status, &self._result)
+            _check_reqid_search(self._reqid, self._status, chks, chks_sz)
+            client._ops[self._reqid] = self
+        finally:
+            if chks: free(chks)
+
+    def wait(self):
+        Deferred.wait(self)
+        if self._status == HYPERDEX_CLIENT_SUCCESS:
+            return {'count': self._result.count,
+                    'sum': self._result.sum,
+                    'min': self._result.min,
+                    'max': self._result.max,
+                    'avg': self._result.avg,
+                    'below': self._result.below,
+                    'above': self._result.above,
+                    'buckets': [self._result.buckets[i] for i in range(16)]}
+        else:
+            raise HyperClientException(self._status)
+
+
 cdef class SearchBase:
 
     cdef Client _client
@@ -1253,48 +1470,85 @@ cdef class SearchBase:
 
 cdef class Search(SearchBase):
 
-    def __cinit__(self, Client client, bytes space, dict predicate):
+    def __cinit__(self, Client client, bytes space, dict predicate, list attrnames=None, limit=None):
         cdef hyperdex_client_attribute_check* chks = NULL
         cdef size_t chks_sz = 0
+        cdef char** names = NULL
+        cdef size_t names_sz = 0
+        cdef uint64_t lim = 0
+        if attrnames is not None and limit is not None:
+            raise ValueError("a search cannot take both attrnames and limit")
         try:
             backings = _predicate_to_c(predicate, &chks, &chks_sz)
-            self._reqid = hyperdex_client_search(client._client, space,
-                                             chks, chks_sz,
-                                             &self._status,
-                                             &self._attrs,
-                                             &self._attrs_sz)
+            if limit is not None:
+                lim = limit
+                self._reqid = hyperdex_client_search_limit(client._client, space,
+                                                       chks, chks_sz, lim,
+                                                       &self._status,
+                                                       &self._attrs,
+                                                       &self._attrs_sz)
+            elif attrnames is None:
+                self._reqid = hyperdex_client_search(client._client, space,
+                                                 chks, chks_sz,
+                                                 &self._status,
+                                                 &self._attrs,
+                                                 &self._attrs_sz)
+            else:
+                backings += _attrnames_to_c(attrnames, &names, &names_sz)
+                self._reqid = hyperdex_client_search_partial(client._client, space,
+                                                         chks, chks_sz,
+                                                         names, names_sz,
+                                                         &self._status,
+                                                         &self._attrs,
+                                                         &self._attrs_sz)
             _check_reqid_search(self._reqid, self._status, chks, chks_sz)
             client._ops[self._reqid] = self
         finally:
             if chks: free(chks)
+            if names: free(names)
 
 
 cdef class SortedSearch(SearchBase):
 
     def __cinit__(self, Client client, bytes space, dict predicate,
-                  bytes sort_by, long limit, bytes compare):
+                  bytes sort_by, long limit, bytes compare, list attrnames=None):
         cdef uint64_t lim = limit
         cdef int maxi = 0
         cdef hyperdex_client_attribute_check* chks = NULL
         cdef size_t chks_sz = 0
+        cdef char** names = NULL
+        cdef size_t names_sz = 0
         if compare not in ('maximize', 'max', 'minimize', 'min'):
             raise ValueError("'compare' must be either 'max' or 'min'")
         if compare in ('max', 'maximize'):
             maxi = 1
         try:
             backings = _predicate_to_c(predicate, &chks, &chks_sz)
-            self._reqid = hyperdex_client_sorted_search(client._client, space,
-                                                    chks, chks_sz,
-                                                    sort_by,
-                                                    lim,
-                                                    maxi,
-                                                    &self._status,
-                                                    &self._attrs,
-                                                    &self._attrs_sz)
+            if attrnames is None:
+                self._reqid = hyperdex_client_sorted_search(client._client, space,
+                                                        chks, chks_sz,
+                                                        sort_by,
+                                                        lim,
+                                                        maxi,
+                                                        &self._status,
+                                                        &self._attrs,
+                                                        &self._attrs_sz)
+            else:
+                backings += _attrnames_to_c(attrnames, &names, &names_sz)
+                self._reqid = hyperdex_client_sorted_search_partial(client._client, space,
+                                                                chks, chks_sz,
+                                                                sort_by,
+                                                                lim,
+                                                                maxi,
+                                                                names, names_sz,
+                                                                &self._status,
+                                                                &self._attrs,
+                                                                &self._attrs_sz)
             _check_reqid_search(self._reqid, self._status, chks, chks_sz)
             client._ops[self._reqid] = self
         finally:
             if chks: free(chks)
+            if names: free(names)
 
 
 cdef class Predicate:
@@ -1349,6 +1603,22 @@ cdef class Regex(Predicate):
         Predicate.__init__(self, [(HYPERPREDICATE_REGEX, regex)])
 
 
+cdef class Prefix(Predicate):
+
+    def __init__(self, prefix):
+        if type(prefix) != bytes:
+            raise AttributeError("Prefix must be a byte")
+        Predicate.__init__(self, [(HYPERPREDICATE_PREFIX, prefix)])
+
+
+cdef class In(Predicate):
+
+    def __init__(self, candidates):
+        if type(candidates) not in (list, tuple, set, frozenset):
+            raise AttributeError("In must be a list, tuple, or set")
+        Predicate.__init__(self, [(HYPERPREDICATE_IN, list(candidates))])
+
+
 cdef class LengthLessEqual(Predicate):
 
     def __init__(self, upper):
@@ -1373,6 +1643,10 @@ cdef class Client:
         async = self.async_get(space, key)
         return async.wait()
 
+    def get_partial(self, bytes space, key, list attrnames):
+        async = self.async_get_partial(space, key, attrnames)
+        return async.wait()
+
     def put(self, bytes space, key, dict value):
         async = self.async_put(space, key, value)
         return async.wait()
@@ -1625,19 +1899,153 @@ cdef class Client:
         async = self.async_group_del(space, predicate)
         return async.wait()
 
+    def group_put(self, bytes space, dict predicate, dict value):
+        async = self.async_group_put(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_add(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_add(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_sub(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_sub(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_mul(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_mul(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_div(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_div(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_mod(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_mod(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_and(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_and(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_or(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_or(space, predicate, value)
+        return async.wait()
+
+    def group_atomic_xor(self, bytes space, dict predicate, dict value):
+        async = self.async_group_atomic_xor(space, predicate, value)
+        return async.wait()
+
+    def group_string_prepend(self, bytes space, dict predicate, dict value):
+        async = self.async_group_string_prepend(space, predicate, value)
+        return async.wait()
+
+    def group_string_append(self, bytes space, dict predicate, dict value):
+        async = self.async_group_string_append(space, predicate, value)
+        return async.wait()
+
+    def group_list_lpush(self, bytes space, dict predicate, dict value):
+        async = self.async_group_list_lpush(space, predicate, value)
+        return async.wait()
+
+    def group_list_rpush(self, bytes space, dict predicate, dict value):
+        async = self.async_group_list_rpush(space, predicate, value)
+        return async.wait()
+
+    def group_set_add(self, bytes space, dict predicate, dict value):
+        async = self.async_group_set_add(space, predicate, value)
+        return async.wait()
+
+    def group_set_remove(self, bytes space, dict predicate, dict value):
+        async = self.async_group_set_remove(space, predicate, value)
+        return async.wait()
+
+    def group_set_intersect(self, bytes space, dict predicate, dict value):
+        async = self.async_group_set_intersect(space, predicate, value)
+        return async.wait()
+
+    def group_set_union(self, bytes space, dict predicate, dict value):
+        async = self.async_group_set_union(space, predicate, value)
+        return async.wait()
+
+    def group_map_add(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_add(space, predicate, value)
+        return async.wait()
+
+    def group_map_remove(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_remove(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_add(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_add(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_sub(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_sub(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_mul(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_mul(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_div(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_div(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_mod(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_mod(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_and(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_and(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_or(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_or(space, predicate, value)
+        return async.wait()
+
+    def group_map_atomic_xor(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_atomic_xor(space, predicate, value)
+        return async.wait()
+
+    def group_map_string_prepend(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_string_prepend(space, predicate, value)
+        return async.wait()
+
+    def group_map_string_append(self, bytes space, dict predicate, dict value):
+        async = self.async_group_map_string_append(space, predicate, value)
+        return async.wait()
+
     def count(self, bytes space, dict predicate, bool unsafe=False):
         async = self.async_count(space, predicate, unsafe)
         return async.wait()
 
+    def aggregate(self, bytes space, dict predicate, bytes attr,
+                  double histogram_lower=0., double histogram_upper=0.):
+        async = self.async_aggregate(space, predicate, attr,
+                                     histogram_lower, histogram_upper)
+        return async.wait()
+
     def search(self, bytes space, dict predicate):
         return Search(self, space, predicate)
 
+    def search_partial(self, bytes space, dict predicate, list attrnames):
+        return Search(self, space, predicate, attrnames)
+
+    def search_limit(self, bytes space, dict predicate, long limit):
+        return Search(self, space, predicate, None, limit)
+
     def sorted_search(self, bytes space, dict predicate, bytes sort_by, long limit, bytes compare):
         return SortedSearch(self, space, predicate, sort_by, limit, compare)
 
+    def sorted_search_partial(self, bytes space, dict predicate, bytes sort_by, long limit, bytes compare, list attrnames):
+        return SortedSearch(self, space, predicate, sort_by, limit, compare, attrnames)
+
     def async_get(self, bytes space, key):
         return DeferredGet(self, space, key)
 
+    def async_get_partial(self, bytes space, key, list attrnames):
+        return DeferredGet(self, space, key, attrnames)
+
     def async_put(self, bytes space, key, dict value):
         d = DeferredFromAttrs(self)
         d.call(<hyperdex_client_simple_op> hyperdex_client_put, space, key, value)
@@ -1946,9 +2354,159 @@ cdef class Client:
     def async_group_del(self, bytes space, dict predicate):
         return DeferredGroupDel(self, space, predicate)
 
+    def async_group_put(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_put, space, predicate, value)
+        return d
+
+    def async_group_atomic_add(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_add, space, predicate, value)
+        return d
+
+    def async_group_atomic_sub(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_sub, space, predicate, value)
+        return d
+
+    def async_group_atomic_mul(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_mul, space, predicate, value)
+        return d
+
+    def async_group_atomic_div(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_div, space, predicate, value)
+        return d
+
+    def async_group_atomic_mod(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_mod, space, predicate, value)
+        return d
+
+    def async_group_atomic_and(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_and, space, predicate, value)
+        return d
+
+    def async_group_atomic_or(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_or, space, predicate, value)
+        return d
+
+    def async_group_atomic_xor(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_atomic_xor, space, predicate, value)
+        return d
+
+    def async_group_string_prepend(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_string_prepend, space, predicate, value)
+        return d
+
+    def async_group_string_append(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_string_append, space, predicate, value)
+        return d
+
+    def async_group_list_lpush(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_list_lpush, space, predicate, value)
+        return d
+
+    def async_group_list_rpush(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_list_rpush, space, predicate, value)
+        return d
+
+    def async_group_set_add(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_set_add, space, predicate, value)
+        return d
+
+    def async_group_set_remove(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_set_remove, space, predicate, value)
+        return d
+
+    def async_group_set_intersect(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_set_intersect, space, predicate, value)
+        return d
+
+    def async_group_set_union(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_set_union, space, predicate, value)
+        return d
+
+    def async_group_map_add(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_add, space, predicate, value)
+        return d
+
+    def async_group_map_remove(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupOp(self)
+        d.call(<hyperdex_client_group_op> hyperdex_client_group_map_remove, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_add(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_add, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_sub(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_sub, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_mul(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_mul, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_div(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_div, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_mod(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_mod, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_and(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_and, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_or(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_or, space, predicate, value)
+        return d
+
+    def async_group_map_atomic_xor(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_atomic_xor, space, predicate, value)
+        return d
+
+    def async_group_map_string_prepend(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_string_prepend, space, predicate, value)
+        return d
+
+    def async_group_map_string_append(self, bytes space, dict predicate, dict value):
+        d = DeferredGroupMapOp(self)
+        d.call(<hyperdex_client_group_map_op> hyperdex_client_group_map_string_append, space, predicate, value)
+        return d
+
     def async_count(self, bytes space, dict predicate, bool unsafe=False):
         return DeferredCount(self, space, predicate, unsafe)
 
+    def async_aggregate(self, bytes space, dict predicate, bytes attr,
+                        double histogram_lower=0., double histogram_upper=0.):
+        return DeferredAggregate(self, space, predicate, attr,
+                                 histogram_lower, histogram_upper)
+
     def loop(self):
         cdef hyperdex_client_returncode rc
         ret = hyperdex_client_loop(self._client, -1, &rc)
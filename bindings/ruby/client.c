@@ -49,6 +49,8 @@ static VALUE class_lessequal;
 static VALUE class_greaterequal;
 static VALUE class_range;
 static VALUE class_regex;
+static VALUE class_prefix;
+static VALUE class_in;
 static VALUE class_lengthequals;
 static VALUE class_lengthlessequal;
 static VALUE class_lengthgreaterequal;
@@ -361,6 +363,14 @@ hyperdex_ruby_client_convert_type(struct hyperdex_ds_arena* arena,
     }
 }
 
+static void
+hyperdex_ruby_client_convert_aggregateattribute(struct hyperdex_ds_arena* arena,
+                                                VALUE x,
+                                                const char** attr)
+{
+    *attr = hyperdex_ruby_client_convert_cstring(x, "Aggregate attribute must be a string or symbol");
+}
+
 static void
 hyperdex_ruby_client_convert_attributes(struct hyperdex_ds_arena* arena,
                                         VALUE x,
@@ -404,6 +414,62 @@ hyperdex_ruby_client_convert_attributes(struct hyperdex_ds_arena* arena,
     }
 }
 
+static void
+hyperdex_ruby_client_convert_attributenames(struct hyperdex_ds_arena* arena,
+                                            VALUE x,
+                                            const char*** _attrnames,
+                                            size_t* _attrnames_sz)
+{
+    const char** attrnames = NULL;
+    size_t attrnames_sz = 0;
+    ssize_t i = 0;
+
+    if (TYPE(x) != T_ARRAY)
+    {
+        rb_exc_raise(rb_exc_new2(rb_eTypeError, "Attribute names must be specified as an array"));
+        abort(); // unreachable?
+    }
+
+    attrnames_sz = RARRAY_LEN(x);
+    attrnames = hyperdex_ds_allocate_attribute_names(arena, attrnames_sz);
+
+    if (!attrnames)
+    {
+        rb_exc_raise(rb_exc_new2(rb_eNoMemError, "failed to allocate memory"));
+        abort(); // unreachable?
+    }
+
+    *_attrnames = attrnames;
+    *_attrnames_sz = attrnames_sz;
+
+    for (i = 0; i < RARRAY_LEN(x); ++i)
+    {
+        attrnames[i] = hyperdex_ruby_client_convert_cstring(rb_ary_entry(x, i), "Attribute name must be a string or symbol");
+    }
+}
+
+static void
+hyperdex_ruby_client_convert_histogramrange(struct hyperdex_ds_arena* arena,
+                                            VALUE x,
+                                            double* histogram_lower,
+                                            double* histogram_upper)
+{
+    if (rb_obj_is_kind_of(x, rb_cRange) == Qtrue)
+    {
+        *histogram_lower = NUM2DBL(rb_funcall(x, rb_intern("first"), 0));
+        *histogram_upper = NUM2DBL(rb_funcall(x, rb_intern("last"), 0));
+    }
+    else if (TYPE(x) == T_ARRAY && RARRAY_LEN(x) == 2)
+    {
+        *histogram_lower = NUM2DBL(rb_ary_entry(x, 0));
+        *histogram_upper = NUM2DBL(rb_ary_entry(x, 1));
+    }
+    else
+    {
+        rb_exc_raise(rb_exc_new2(rb_eTypeError, "Histogram range must be a Range or an array of two numbers"));
+    }
+}
+
 static void
 hyperdex_ruby_client_convert_key(struct hyperdex_ds_arena* arena,
                                  VALUE x,
@@ -1000,6 +1066,7 @@ struct hyperdex_ruby_client_deferred
     size_t attrs_sz;
     const char* description;
     uint64_t count;
+    struct hyperdex_client_aggregate_result aggregate;
     int finished;
     VALUE (*encode_return)(struct hyperdex_ruby_client_deferred* d);
 };
@@ -1058,6 +1125,7 @@ hyperdex_ruby_client_deferred_alloc(VALUE class)
     dfrd->attrs_sz = 0;
     dfrd->description = NULL;
     dfrd->count = 0;
+    memset(&dfrd->aggregate, 0, sizeof(dfrd->aggregate));
     dfrd->finished = 0;
     dfrd->encode_return = NULL;
     return Data_Wrap_Struct(class, hyperdex_ruby_client_deferred_mark, hyperdex_ruby_client_deferred_free, dfrd);
@@ -1148,6 +1216,49 @@ hyperdex_ruby_client_deferred_encode_status_attributes(struct hyperdex_ruby_clie
     }
 }
 
+static VALUE
+hyperdex_ruby_client_deferred_encode_status_aggregate(struct hyperdex_ruby_client_deferred* d)
+{
+    struct hyperdex_client* client = NULL;
+    VALUE ret;
+    VALUE buckets;
+    size_t i;
+
+    if (d->status == HYPERDEX_CLIENT_SUCCESS)
+    {
+        ret = rb_hash_new();
+        buckets = rb_ary_new();
+
+        for (i = 0; i < HYPERDEX_CLIENT_AGGREGATE_BUCKETS; ++i)
+        {
+            rb_ary_push(buckets, ULL2NUM(d->aggregate.buckets[i]));
+        }
+
+        rb_hash_aset(ret, ID2SYM(rb_intern("count")), ULL2NUM(d->aggregate.count));
+        rb_hash_aset(ret, ID2SYM(rb_intern("sum")), rb_float_new(d->aggregate.sum));
+        rb_hash_aset(ret, ID2SYM(rb_intern("min")), rb_float_new(d->aggregate.min));
+        rb_hash_aset(ret, ID2SYM(rb_intern("max")), rb_float_new(d->aggregate.max));
+        rb_hash_aset(ret, ID2SYM(rb_intern("avg")), rb_float_new(d->aggregate.avg));
+        rb_hash_aset(ret, ID2SYM(rb_intern("below")), ULL2NUM(d->aggregate.below));
+        rb_hash_aset(ret, ID2SYM(rb_intern("above")), ULL2NUM(d->aggregate.above));
+        rb_hash_aset(ret, ID2SYM(rb_intern("buckets")), buckets);
+        return ret;
+    }
+    else if (d->status == HYPERDEX_CLIENT_NOTFOUND)
+    {
+        return Qnil;
+    }
+    else if (d->status == HYPERDEX_CLIENT_CMPFAIL)
+    {
+        return Qfalse;
+    }
+    else
+    {
+        Data_Get_Struct(d->client, struct hyperdex_client, client);
+        hyperdex_ruby_client_throw_exception(d->status, hyperdex_client_error_message(client));
+    }
+}
+
 static VALUE
 hyperdex_ruby_client_deferred_encode_status_count(struct hyperdex_ruby_client_deferred* d)
 {
@@ -1527,6 +1638,26 @@ hyperdex_ruby_client_predicate_regex_init(VALUE self, VALUE v)
     return self;
 }
 
+static VALUE
+hyperdex_ruby_client_predicate_prefix_init(VALUE self, VALUE v)
+{
+    struct hyperdex_ruby_client_predicate* pred = NULL;
+    Data_Get_Struct(self, struct hyperdex_ruby_client_predicate, pred);
+    pred->checks[0].v = v;
+    pred->checks[0].predicate = HYPERPREDICATE_PREFIX;
+    return self;
+}
+
+static VALUE
+hyperdex_ruby_client_predicate_in_init(VALUE self, VALUE v)
+{
+    struct hyperdex_ruby_client_predicate* pred = NULL;
+    Data_Get_Struct(self, struct hyperdex_ruby_client_predicate, pred);
+    pred->checks[0].v = v;
+    pred->checks[0].predicate = HYPERPREDICATE_IN;
+    return self;
+}
+
 static VALUE
 hyperdex_ruby_client_predicate_lengthequals_init(VALUE self, VALUE v)
 {
@@ -1637,6 +1768,16 @@ Init_hyperdex_client()
     rb_define_alloc_func(class_regex , hyperdex_ruby_client_predicate_alloc1);
     rb_define_method(class_regex , "initialize", hyperdex_ruby_client_predicate_regex_init, 1);
 
+    /* create the Prefix class */
+    class_prefix = rb_define_class_under(mod_hyperdex_client, "Prefix", class_predicate);
+    rb_define_alloc_func(class_prefix , hyperdex_ruby_client_predicate_alloc1);
+    rb_define_method(class_prefix , "initialize", hyperdex_ruby_client_predicate_prefix_init, 1);
+
+    /* create the In class */
+    class_in = rb_define_class_under(mod_hyperdex_client, "In", class_predicate);
+    rb_define_alloc_func(class_in , hyperdex_ruby_client_predicate_alloc1);
+    rb_define_method(class_in , "initialize", hyperdex_ruby_client_predicate_in_init, 1);
+
     /* create the LengthEquals class */
     class_lengthequals = rb_define_class_under(mod_hyperdex_client, "LengthEquals", class_predicate);
     rb_define_alloc_func(class_lengthequals , hyperdex_ruby_client_predicate_alloc1);
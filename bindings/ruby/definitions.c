@@ -56,6 +56,37 @@ _hyperdex_ruby_client_asynccall__spacename_key__status_attributes(int64_t (*f)(s
     return dfrd;
 }
 
+static VALUE
+_hyperdex_ruby_client_asynccall__spacename_key_attributenames__status_attributes(int64_t (*f)(struct hyperdex_client* client, const char* space, const char* key, size_t key_sz, const char** attrnames, size_t attrnames_sz, enum hyperdex_client_returncode* status, const struct hyperdex_client_attribute** attrs, size_t* attrs_sz), VALUE self, VALUE spacename, VALUE key, VALUE attributenames)
+{
+    VALUE dfrd;
+    const char* in_space;
+    const char* in_key;
+    size_t in_key_sz;
+    const char** in_attrnames;
+    size_t in_attrnames_sz;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_deferred* d;
+    dfrd = rb_class_new_instance(1, &self, class_deferred);
+    rb_iv_set(self, "tmp", dfrd);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(dfrd, struct hyperdex_ruby_client_deferred, d);
+    hyperdex_ruby_client_convert_spacename(d->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_key(d->arena, key, &in_key, &in_key_sz);
+    hyperdex_ruby_client_convert_attributenames(d->arena, attributenames, &in_attrnames, &in_attrnames_sz);
+    d->reqid = f(client, in_space, in_key, in_key_sz, in_attrnames, in_attrnames_sz, &d->status, &d->attrs, &d->attrs_sz);
+
+    if (d->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(d->status, hyperdex_client_error_message(client));
+    }
+
+    d->encode_return = hyperdex_ruby_client_deferred_encode_status_attributes;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(d->reqid), dfrd);
+    rb_iv_set(self, "tmp", Qnil);
+    return dfrd;
+}
+
 static VALUE
 _hyperdex_ruby_client_asynccall__spacename_key_attributes__status(int64_t (*f)(struct hyperdex_client* client, const char* space, const char* key, size_t key_sz, const struct hyperdex_client_attribute* attrs, size_t attrs_sz, enum hyperdex_client_returncode* status), VALUE self, VALUE spacename, VALUE key, VALUE attributes)
 {
@@ -273,6 +304,67 @@ _hyperdex_ruby_client_iterator__spacename_predicates__status_attributes(int64_t
     return iter;
 }
 
+static VALUE
+_hyperdex_ruby_client_iterator__spacename_predicates_attributenames__status_attributes(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, const char** attrnames, size_t attrnames_sz, enum hyperdex_client_returncode* status, const struct hyperdex_client_attribute** attrs, size_t* attrs_sz), VALUE self, VALUE spacename, VALUE predicates, VALUE attributenames)
+{
+    VALUE iter;
+    const char* in_space;
+    const struct hyperdex_client_attribute_check* in_checks;
+    size_t in_checks_sz;
+    const char** in_attrnames;
+    size_t in_attrnames_sz;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_iterator* it;
+    iter = rb_class_new_instance(1, &self, class_iterator);
+    rb_iv_set(self, "tmp", iter);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(iter, struct hyperdex_ruby_client_iterator, it);
+    hyperdex_ruby_client_convert_spacename(it->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_predicates(it->arena, predicates, &in_checks, &in_checks_sz);
+    hyperdex_ruby_client_convert_attributenames(it->arena, attributenames, &in_attrnames, &in_attrnames_sz);
+    it->reqid = f(client, in_space, in_checks, in_checks_sz, in_attrnames, in_attrnames_sz, &it->status, &it->attrs, &it->attrs_sz);
+
+    if (it->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(it->status, hyperdex_client_error_message(client));
+    }
+
+    it->encode_return = hyperdex_ruby_client_iterator_encode_status_attributes;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(it->reqid), iter);
+    rb_iv_set(self, "tmp", Qnil);
+    return iter;
+}
+
+static VALUE
+_hyperdex_ruby_client_iterator__spacename_predicates_limit__status_attributes(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, uint64_t limit, enum hyperdex_client_returncode* status, const struct hyperdex_client_attribute** attrs, size_t* attrs_sz), VALUE self, VALUE spacename, VALUE predicates, VALUE limit)
+{
+    VALUE iter;
+    const char* in_space;
+    const struct hyperdex_client_attribute_check* in_checks;
+    size_t in_checks_sz;
+    uint64_t in_limit;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_iterator* it;
+    iter = rb_class_new_instance(1, &self, class_iterator);
+    rb_iv_set(self, "tmp", iter);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(iter, struct hyperdex_ruby_client_iterator, it);
+    hyperdex_ruby_client_convert_spacename(it->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_predicates(it->arena, predicates, &in_checks, &in_checks_sz);
+    hyperdex_ruby_client_convert_limit(it->arena, limit, &in_limit);
+    it->reqid = f(client, in_space, in_checks, in_checks_sz, in_limit, &it->status, &it->attrs, &it->attrs_sz);
+
+    if (it->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(it->status, hyperdex_client_error_message(client));
+    }
+
+    it->encode_return = hyperdex_ruby_client_iterator_encode_status_attributes;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(it->reqid), iter);
+    rb_iv_set(self, "tmp", Qnil);
+    return iter;
+}
+
 static VALUE
 _hyperdex_ruby_client_asynccall__spacename_predicates__status_description(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, enum hyperdex_client_returncode* status, const char** description), VALUE self, VALUE spacename, VALUE predicates)
 {
@@ -335,6 +427,43 @@ _hyperdex_ruby_client_iterator__spacename_predicates_sortby_limit_maxmin__status
     return iter;
 }
 
+static VALUE
+_hyperdex_ruby_client_iterator__spacename_predicates_sortby_limit_maxmin_attributenames__status_attributes(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, const char* sort_by, uint64_t limit, int maxmin, const char** attrnames, size_t attrnames_sz, enum hyperdex_client_returncode* status, const struct hyperdex_client_attribute** attrs, size_t* attrs_sz), VALUE self, VALUE spacename, VALUE predicates, VALUE sortby, VALUE limit, VALUE maxmin, VALUE attributenames)
+{
+    VALUE iter;
+    const char* in_space;
+    const struct hyperdex_client_attribute_check* in_checks;
+    size_t in_checks_sz;
+    const char* in_sort_by;
+    uint64_t in_limit;
+    int in_maxmin;
+    const char** in_attrnames;
+    size_t in_attrnames_sz;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_iterator* it;
+    iter = rb_class_new_instance(1, &self, class_iterator);
+    rb_iv_set(self, "tmp", iter);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(iter, struct hyperdex_ruby_client_iterator, it);
+    hyperdex_ruby_client_convert_spacename(it->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_predicates(it->arena, predicates, &in_checks, &in_checks_sz);
+    hyperdex_ruby_client_convert_sortby(it->arena, sortby, &in_sort_by);
+    hyperdex_ruby_client_convert_limit(it->arena, limit, &in_limit);
+    hyperdex_ruby_client_convert_maxmin(it->arena, maxmin, &in_maxmin);
+    hyperdex_ruby_client_convert_attributenames(it->arena, attributenames, &in_attrnames, &in_attrnames_sz);
+    it->reqid = f(client, in_space, in_checks, in_checks_sz, in_sort_by, in_limit, in_maxmin, in_attrnames, in_attrnames_sz, &it->status, &it->attrs, &it->attrs_sz);
+
+    if (it->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(it->status, hyperdex_client_error_message(client));
+    }
+
+    it->encode_return = hyperdex_ruby_client_iterator_encode_status_attributes;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(it->reqid), iter);
+    rb_iv_set(self, "tmp", Qnil);
+    return iter;
+}
+
 static VALUE
 _hyperdex_ruby_client_asynccall__spacename_predicates__status(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, enum hyperdex_client_returncode* status), VALUE self, VALUE spacename, VALUE predicates)
 {
@@ -363,6 +492,68 @@ _hyperdex_ruby_client_asynccall__spacename_predicates__status(int64_t (*f)(struc
     return dfrd;
 }
 
+static VALUE
+_hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, const struct hyperdex_client_attribute* attrs, size_t attrs_sz, enum hyperdex_client_returncode* status), VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE dfrd;
+    const char* in_space;
+    const struct hyperdex_client_attribute_check* in_checks;
+    size_t in_checks_sz;
+    const struct hyperdex_client_attribute* in_attrs;
+    size_t in_attrs_sz;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_deferred* d;
+    dfrd = rb_class_new_instance(1, &self, class_deferred);
+    rb_iv_set(self, "tmp", dfrd);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(dfrd, struct hyperdex_ruby_client_deferred, d);
+    hyperdex_ruby_client_convert_spacename(d->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_predicates(d->arena, predicates, &in_checks, &in_checks_sz);
+    hyperdex_ruby_client_convert_attributes(d->arena, attributes, &in_attrs, &in_attrs_sz);
+    d->reqid = f(client, in_space, in_checks, in_checks_sz, in_attrs, in_attrs_sz, &d->status);
+
+    if (d->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(d->status, hyperdex_client_error_message(client));
+    }
+
+    d->encode_return = hyperdex_ruby_client_deferred_encode_status;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(d->reqid), dfrd);
+    rb_iv_set(self, "tmp", Qnil);
+    return dfrd;
+}
+
+static VALUE
+_hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz, enum hyperdex_client_returncode* status), VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE dfrd;
+    const char* in_space;
+    const struct hyperdex_client_attribute_check* in_checks;
+    size_t in_checks_sz;
+    const struct hyperdex_client_map_attribute* in_mapattrs;
+    size_t in_mapattrs_sz;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_deferred* d;
+    dfrd = rb_class_new_instance(1, &self, class_deferred);
+    rb_iv_set(self, "tmp", dfrd);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(dfrd, struct hyperdex_ruby_client_deferred, d);
+    hyperdex_ruby_client_convert_spacename(d->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_predicates(d->arena, predicates, &in_checks, &in_checks_sz);
+    hyperdex_ruby_client_convert_mapattributes(d->arena, mapattributes, &in_mapattrs, &in_mapattrs_sz);
+    d->reqid = f(client, in_space, in_checks, in_checks_sz, in_mapattrs, in_mapattrs_sz, &d->status);
+
+    if (d->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(d->status, hyperdex_client_error_message(client));
+    }
+
+    d->encode_return = hyperdex_ruby_client_deferred_encode_status;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(d->reqid), dfrd);
+    rb_iv_set(self, "tmp", Qnil);
+    return dfrd;
+}
+
 static VALUE
 _hyperdex_ruby_client_asynccall__spacename_predicates__status_count(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, enum hyperdex_client_returncode* status, uint64_t* count), VALUE self, VALUE spacename, VALUE predicates)
 {
@@ -391,6 +582,39 @@ _hyperdex_ruby_client_asynccall__spacename_predicates__status_count(int64_t (*f)
     return dfrd;
 }
 
+static VALUE
+_hyperdex_ruby_client_asynccall__spacename_predicates_aggregateattribute_histogramrange__status_aggregate(int64_t (*f)(struct hyperdex_client* client, const char* space, const struct hyperdex_client_attribute_check* checks, size_t checks_sz, const char* attr, double histogram_lower, double histogram_upper, enum hyperdex_client_returncode* status, struct hyperdex_client_aggregate_result* aggregate), VALUE self, VALUE spacename, VALUE predicates, VALUE aggregateattribute, VALUE histogramrange)
+{
+    VALUE dfrd;
+    const char* in_space;
+    const struct hyperdex_client_attribute_check* in_checks;
+    size_t in_checks_sz;
+    const char* in_attr;
+    double in_histogram_lower;
+    double in_histogram_upper;
+    struct hyperdex_client* client;
+    struct hyperdex_ruby_client_deferred* d;
+    dfrd = rb_class_new_instance(1, &self, class_deferred);
+    rb_iv_set(self, "tmp", dfrd);
+    Data_Get_Struct(self, struct hyperdex_client, client);
+    Data_Get_Struct(dfrd, struct hyperdex_ruby_client_deferred, d);
+    hyperdex_ruby_client_convert_spacename(d->arena, spacename, &in_space);
+    hyperdex_ruby_client_convert_predicates(d->arena, predicates, &in_checks, &in_checks_sz);
+    hyperdex_ruby_client_convert_aggregateattribute(d->arena, aggregateattribute, &in_attr);
+    hyperdex_ruby_client_convert_histogramrange(d->arena, histogramrange, &in_histogram_lower, &in_histogram_upper);
+    d->reqid = f(client, in_space, in_checks, in_checks_sz, in_attr, in_histogram_lower, in_histogram_upper, &d->status, &d->aggregate);
+
+    if (d->reqid < 0)
+    {
+        hyperdex_ruby_client_throw_exception(d->status, hyperdex_client_error_message(client));
+    }
+
+    d->encode_return = hyperdex_ruby_client_deferred_encode_status_aggregate;
+    rb_hash_aset(rb_iv_get(self, "ops"), LONG2NUM(d->reqid), dfrd);
+    rb_iv_set(self, "tmp", Qnil);
+    return dfrd;
+}
+
 
 static VALUE
 hyperdex_ruby_client_get(VALUE self, VALUE spacename, VALUE key)
@@ -404,6 +628,18 @@ hyperdex_ruby_client_wait_get(VALUE self, VALUE spacename, VALUE key)
     return rb_funcall(deferred, rb_intern("wait"), 0);
 }
 
+static VALUE
+hyperdex_ruby_client_get_partial(VALUE self, VALUE spacename, VALUE key, VALUE attributenames)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_key_attributenames__status_attributes(hyperdex_client_get_partial, self, spacename, key, attributenames);
+}
+VALUE
+hyperdex_ruby_client_wait_get_partial(VALUE self, VALUE spacename, VALUE key, VALUE attributenames)
+{
+    VALUE deferred = hyperdex_ruby_client_get_partial(self, spacename, key, attributenames);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
 static VALUE
 hyperdex_ruby_client_put(VALUE self, VALUE spacename, VALUE key, VALUE attributes)
 {
@@ -1142,6 +1378,18 @@ hyperdex_ruby_client_search(VALUE self, VALUE spacename, VALUE predicates)
     return _hyperdex_ruby_client_iterator__spacename_predicates__status_attributes(hyperdex_client_search, self, spacename, predicates);
 }
 
+static VALUE
+hyperdex_ruby_client_search_partial(VALUE self, VALUE spacename, VALUE predicates, VALUE attributenames)
+{
+    return _hyperdex_ruby_client_iterator__spacename_predicates_attributenames__status_attributes(hyperdex_client_search_partial, self, spacename, predicates, attributenames);
+}
+
+static VALUE
+hyperdex_ruby_client_search_limit(VALUE self, VALUE spacename, VALUE predicates, VALUE limit)
+{
+    return _hyperdex_ruby_client_iterator__spacename_predicates_limit__status_attributes(hyperdex_client_search_limit, self, spacename, predicates, limit);
+}
+
 static VALUE
 hyperdex_ruby_client_search_describe(VALUE self, VALUE spacename, VALUE predicates)
 {
@@ -1160,6 +1408,12 @@ hyperdex_ruby_client_sorted_search(VALUE self, VALUE spacename, VALUE predicates
     return _hyperdex_ruby_client_iterator__spacename_predicates_sortby_limit_maxmin__status_attributes(hyperdex_client_sorted_search, self, spacename, predicates, sortby, limit, maxmin);
 }
 
+static VALUE
+hyperdex_ruby_client_sorted_search_partial(VALUE self, VALUE spacename, VALUE predicates, VALUE sortby, VALUE limit, VALUE maxmin, VALUE attributenames)
+{
+    return _hyperdex_ruby_client_iterator__spacename_predicates_sortby_limit_maxmin_attributenames__status_attributes(hyperdex_client_sorted_search_partial, self, spacename, predicates, sortby, limit, maxmin, attributenames);
+}
+
 static VALUE
 hyperdex_ruby_client_group_del(VALUE self, VALUE spacename, VALUE predicates)
 {
@@ -1172,6 +1426,354 @@ hyperdex_ruby_client_wait_group_del(VALUE self, VALUE spacename, VALUE predicate
     return rb_funcall(deferred, rb_intern("wait"), 0);
 }
 
+static VALUE
+hyperdex_ruby_client_group_put(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_put, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_put(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_put(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_add(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_add, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_add(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_add(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_sub(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_sub, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_sub(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_sub(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_mul(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_mul, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_mul(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_mul(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_div(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_div, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_div(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_div(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_mod(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_mod, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_mod(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_mod(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_and(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_and, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_and(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_and(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_or(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_or, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_or(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_or(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_atomic_xor(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_atomic_xor, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_atomic_xor(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_atomic_xor(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_string_prepend(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_string_prepend, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_string_prepend(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_string_prepend(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_string_append(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_string_append, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_string_append(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_string_append(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_list_lpush(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_list_lpush, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_list_lpush(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_list_lpush(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_list_rpush(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_list_rpush, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_list_rpush(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_list_rpush(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_set_add(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_set_add, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_set_add(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_set_add(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_set_remove(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_set_remove, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_set_remove(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_set_remove(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_set_intersect(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_set_intersect, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_set_intersect(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_set_intersect(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_set_union(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_set_union, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_set_union(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_set_union(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_add(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_add, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_add(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_add(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_remove(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_attributes__status(hyperdex_client_group_map_remove, self, spacename, predicates, attributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_remove(VALUE self, VALUE spacename, VALUE predicates, VALUE attributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_remove(self, spacename, predicates, attributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_add(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_add, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_add(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_add(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_sub(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_sub, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_sub(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_sub(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_mul(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_mul, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_mul(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_mul(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_div(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_div, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_div(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_div(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_mod(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_mod, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_mod(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_mod(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_and(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_and, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_and(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_and(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_or(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_or, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_or(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_or(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_atomic_xor(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_atomic_xor, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_atomic_xor(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_atomic_xor(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_string_prepend(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_string_prepend, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_string_prepend(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_string_prepend(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
+static VALUE
+hyperdex_ruby_client_group_map_string_append(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_mapattributes__status(hyperdex_client_group_map_string_append, self, spacename, predicates, mapattributes);
+}
+VALUE
+hyperdex_ruby_client_wait_group_map_string_append(VALUE self, VALUE spacename, VALUE predicates, VALUE mapattributes)
+{
+    VALUE deferred = hyperdex_ruby_client_group_map_string_append(self, spacename, predicates, mapattributes);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
+
 static VALUE
 hyperdex_ruby_client_count(VALUE self, VALUE spacename, VALUE predicates)
 {
@@ -1183,3 +1785,15 @@ hyperdex_ruby_client_wait_count(VALUE self, VALUE spacename, VALUE predicates)
     VALUE deferred = hyperdex_ruby_client_count(self, spacename, predicates);
     return rb_funcall(deferred, rb_intern("wait"), 0);
 }
+
+static VALUE
+hyperdex_ruby_client_aggregate(VALUE self, VALUE spacename, VALUE predicates, VALUE aggregateattribute, VALUE histogramrange)
+{
+    return _hyperdex_ruby_client_asynccall__spacename_predicates_aggregateattribute_histogramrange__status_aggregate(hyperdex_client_aggregate, self, spacename, predicates, aggregateattribute, histogramrange);
+}
+VALUE
+hyperdex_ruby_client_wait_aggregate(VALUE self, VALUE spacename, VALUE predicates, VALUE aggregateattribute, VALUE histogramrange)
+{
+    VALUE deferred = hyperdex_ruby_client_aggregate(self, spacename, predicates, aggregateattribute, histogramrange);
+    return rb_funcall(deferred, rb_intern("wait"), 0);
+}
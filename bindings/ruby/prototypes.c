@@ -30,6 +30,8 @@
 
 rb_define_method(class_client, "async_get", hyperdex_ruby_client_get, 2);
 rb_define_method(class_client, "get", hyperdex_ruby_client_wait_get, 2);
+rb_define_method(class_client, "async_get_partial", hyperdex_ruby_client_get_partial, 3);
+rb_define_method(class_client, "get_partial", hyperdex_ruby_client_wait_get_partial, 3);
 rb_define_method(class_client, "async_put", hyperdex_ruby_client_put, 3);
 rb_define_method(class_client, "put", hyperdex_ruby_client_wait_put, 3);
 rb_define_method(class_client, "async_cond_put", hyperdex_ruby_client_cond_put, 4);
@@ -153,10 +155,73 @@ rb_define_method(class_client, "map_string_append", hyperdex_ruby_client_wait_ma
 rb_define_method(class_client, "async_cond_map_string_append", hyperdex_ruby_client_cond_map_string_append, 4);
 rb_define_method(class_client, "cond_map_string_append", hyperdex_ruby_client_wait_cond_map_string_append, 4);
 rb_define_method(class_client, "search", hyperdex_ruby_client_search, 2);
+rb_define_method(class_client, "search_partial", hyperdex_ruby_client_search_partial, 3);
+rb_define_method(class_client, "search_limit", hyperdex_ruby_client_search_limit, 3);
 rb_define_method(class_client, "async_search_describe", hyperdex_ruby_client_search_describe, 2);
 rb_define_method(class_client, "search_describe", hyperdex_ruby_client_wait_search_describe, 2);
 rb_define_method(class_client, "sorted_search", hyperdex_ruby_client_sorted_search, 5);
+rb_define_method(class_client, "sorted_search_partial", hyperdex_ruby_client_sorted_search_partial, 6);
 rb_define_method(class_client, "async_group_del", hyperdex_ruby_client_group_del, 2);
 rb_define_method(class_client, "group_del", hyperdex_ruby_client_wait_group_del, 2);
+rb_define_method(class_client, "async_group_put", hyperdex_ruby_client_group_put, 3);
+rb_define_method(class_client, "group_put", hyperdex_ruby_client_wait_group_put, 3);
+rb_define_method(class_client, "async_group_atomic_add", hyperdex_ruby_client_group_atomic_add, 3);
+rb_define_method(class_client, "group_atomic_add", hyperdex_ruby_client_wait_group_atomic_add, 3);
+rb_define_method(class_client, "async_group_atomic_sub", hyperdex_ruby_client_group_atomic_sub, 3);
+rb_define_method(class_client, "group_atomic_sub", hyperdex_ruby_client_wait_group_atomic_sub, 3);
+rb_define_method(class_client, "async_group_atomic_mul", hyperdex_ruby_client_group_atomic_mul, 3);
+rb_define_method(class_client, "group_atomic_mul", hyperdex_ruby_client_wait_group_atomic_mul, 3);
+rb_define_method(class_client, "async_group_atomic_div", hyperdex_ruby_client_group_atomic_div, 3);
+rb_define_method(class_client, "group_atomic_div", hyperdex_ruby_client_wait_group_atomic_div, 3);
+rb_define_method(class_client, "async_group_atomic_mod", hyperdex_ruby_client_group_atomic_mod, 3);
+rb_define_method(class_client, "group_atomic_mod", hyperdex_ruby_client_wait_group_atomic_mod, 3);
+rb_define_method(class_client, "async_group_atomic_and", hyperdex_ruby_client_group_atomic_and, 3);
+rb_define_method(class_client, "group_atomic_and", hyperdex_ruby_client_wait_group_atomic_and, 3);
+rb_define_method(class_client, "async_group_atomic_or", hyperdex_ruby_client_group_atomic_or, 3);
+rb_define_method(class_client, "group_atomic_or", hyperdex_ruby_client_wait_group_atomic_or, 3);
+rb_define_method(class_client, "async_group_atomic_xor", hyperdex_ruby_client_group_atomic_xor, 3);
+rb_define_method(class_client, "group_atomic_xor", hyperdex_ruby_client_wait_group_atomic_xor, 3);
+rb_define_method(class_client, "async_group_string_prepend", hyperdex_ruby_client_group_string_prepend, 3);
+rb_define_method(class_client, "group_string_prepend", hyperdex_ruby_client_wait_group_string_prepend, 3);
+rb_define_method(class_client, "async_group_string_append", hyperdex_ruby_client_group_string_append, 3);
+rb_define_method(class_client, "group_string_append", hyperdex_ruby_client_wait_group_string_append, 3);
+rb_define_method(class_client, "async_group_list_lpush", hyperdex_ruby_client_group_list_lpush, 3);
+rb_define_method(class_client, "group_list_lpush", hyperdex_ruby_client_wait_group_list_lpush, 3);
+rb_define_method(class_client, "async_group_list_rpush", hyperdex_ruby_client_group_list_rpush, 3);
+rb_define_method(class_client, "group_list_rpush", hyperdex_ruby_client_wait_group_list_rpush, 3);
+rb_define_method(class_client, "async_group_set_add", hyperdex_ruby_client_group_set_add, 3);
+rb_define_method(class_client, "group_set_add", hyperdex_ruby_client_wait_group_set_add, 3);
+rb_define_method(class_client, "async_group_set_remove", hyperdex_ruby_client_group_set_remove, 3);
+rb_define_method(class_client, "group_set_remove", hyperdex_ruby_client_wait_group_set_remove, 3);
+rb_define_method(class_client, "async_group_set_intersect", hyperdex_ruby_client_group_set_intersect, 3);
+rb_define_method(class_client, "group_set_intersect", hyperdex_ruby_client_wait_group_set_intersect, 3);
+rb_define_method(class_client, "async_group_set_union", hyperdex_ruby_client_group_set_union, 3);
+rb_define_method(class_client, "group_set_union", hyperdex_ruby_client_wait_group_set_union, 3);
+rb_define_method(class_client, "async_group_map_add", hyperdex_ruby_client_group_map_add, 3);
+rb_define_method(class_client, "group_map_add", hyperdex_ruby_client_wait_group_map_add, 3);
+rb_define_method(class_client, "async_group_map_remove", hyperdex_ruby_client_group_map_remove, 3);
+rb_define_method(class_client, "group_map_remove", hyperdex_ruby_client_wait_group_map_remove, 3);
+rb_define_method(class_client, "async_group_map_atomic_add", hyperdex_ruby_client_group_map_atomic_add, 3);
+rb_define_method(class_client, "group_map_atomic_add", hyperdex_ruby_client_wait_group_map_atomic_add, 3);
+rb_define_method(class_client, "async_group_map_atomic_sub", hyperdex_ruby_client_group_map_atomic_sub, 3);
+rb_define_method(class_client, "group_map_atomic_sub", hyperdex_ruby_client_wait_group_map_atomic_sub, 3);
+rb_define_method(class_client, "async_group_map_atomic_mul", hyperdex_ruby_client_group_map_atomic_mul, 3);
+rb_define_method(class_client, "group_map_atomic_mul", hyperdex_ruby_client_wait_group_map_atomic_mul, 3);
+rb_define_method(class_client, "async_group_map_atomic_div", hyperdex_ruby_client_group_map_atomic_div, 3);
+rb_define_method(class_client, "group_map_atomic_div", hyperdex_ruby_client_wait_group_map_atomic_div, 3);
+rb_define_method(class_client, "async_group_map_atomic_mod", hyperdex_ruby_client_group_map_atomic_mod, 3);
+rb_define_method(class_client, "group_map_atomic_mod", hyperdex_ruby_client_wait_group_map_atomic_mod, 3);
+rb_define_method(class_client, "async_group_map_atomic_and", hyperdex_ruby_client_group_map_atomic_and, 3);
+rb_define_method(class_client, "group_map_atomic_and", hyperdex_ruby_client_wait_group_map_atomic_and, 3);
+rb_define_method(class_client, "async_group_map_atomic_or", hyperdex_ruby_client_group_map_atomic_or, 3);
+rb_define_method(class_client, "group_map_atomic_or", hyperdex_ruby_client_wait_group_map_atomic_or, 3);
+rb_define_method(class_client, "async_group_map_atomic_xor", hyperdex_ruby_client_group_map_atomic_xor, 3);
+rb_define_method(class_client, "group_map_atomic_xor", hyperdex_ruby_client_wait_group_map_atomic_xor, 3);
+rb_define_method(class_client, "async_group_map_string_prepend", hyperdex_ruby_client_group_map_string_prepend, 3);
+rb_define_method(class_client, "group_map_string_prepend", hyperdex_ruby_client_wait_group_map_string_prepend, 3);
+rb_define_method(class_client, "async_group_map_string_append", hyperdex_ruby_client_group_map_string_append, 3);
+rb_define_method(class_client, "group_map_string_append", hyperdex_ruby_client_wait_group_map_string_append, 3);
 rb_define_method(class_client, "async_count", hyperdex_ruby_client_count, 2);
 rb_define_method(class_client, "count", hyperdex_ruby_client_wait_count, 2);
+rb_define_method(class_client, "async_aggregate", hyperdex_ruby_client_aggregate, 4);
+rb_define_method(class_client, "aggregate", hyperdex_ruby_client_wait_aggregate, 4);
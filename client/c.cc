@@ -194,6 +194,19 @@ hyperdex_client_get(hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_get_partial(hyperdex_client* _cl,
+                            const char* space,
+                            const char* key, size_t key_sz,
+                            const char** attrnames, size_t attrnames_sz,
+                            hyperdex_client_returncode* status,
+                            const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->get_partial(space, key, key_sz, attrnames, attrnames_sz, status, attrs, attrs_sz);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_put(hyperdex_client* _cl,
                     const char* space,
@@ -1088,6 +1101,32 @@ hyperdex_client_search(hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_search_partial(hyperdex_client* _cl,
+                               const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char** attrnames, size_t attrnames_sz,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->search_partial(space, checks, checks_sz, attrnames, attrnames_sz, status, attrs, attrs_sz);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_search_limit(hyperdex_client* _cl,
+                             const char* space,
+                             const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                             uint64_t limit,
+                             hyperdex_client_returncode* status,
+                             const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->search_limit(space, checks, checks_sz, limit, status, attrs, attrs_sz);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_search_describe(hyperdex_client* _cl,
                                 const char* space,
@@ -1115,6 +1154,22 @@ hyperdex_client_sorted_search(hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_sorted_search_partial(hyperdex_client* _cl,
+                                      const char* space,
+                                      const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                      const char* sort_by,
+                                      uint64_t limit,
+                                      int maxmin,
+                                      const char** attrnames, size_t attrnames_sz,
+                                      hyperdex_client_returncode* status,
+                                      const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    C_WRAP_EXCEPT(
+    return cl->sorted_search_partial(space, checks, checks_sz, sort_by, limit, maxmin, attrnames, attrnames_sz, status, attrs, attrs_sz);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_group_del(hyperdex_client* _cl,
                           const char* space,
@@ -1126,6 +1181,412 @@ hyperdex_client_group_del(hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_group_put(hyperdex_client* _cl,
+                          const char* space,
+                          const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                          hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_put), strlen(XSTR(group_put)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_add(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_add), strlen(XSTR(group_atomic_add)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_sub(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_sub), strlen(XSTR(group_atomic_sub)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_mul(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_mul), strlen(XSTR(group_atomic_mul)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_div(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_div), strlen(XSTR(group_atomic_div)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_mod(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_mod), strlen(XSTR(group_atomic_mod)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_and(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_and), strlen(XSTR(group_atomic_and)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_or(hyperdex_client* _cl,
+                                const char* space,
+                                const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_or), strlen(XSTR(group_atomic_or)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_atomic_xor(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_atomic_xor), strlen(XSTR(group_atomic_xor)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_string_prepend(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_string_prepend), strlen(XSTR(group_string_prepend)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_string_append(hyperdex_client* _cl,
+                                    const char* space,
+                                    const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_string_append), strlen(XSTR(group_string_append)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_list_lpush(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_list_lpush), strlen(XSTR(group_list_lpush)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_list_rpush(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_list_rpush), strlen(XSTR(group_list_rpush)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_set_add(hyperdex_client* _cl,
+                              const char* space,
+                              const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                              const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                              hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_set_add), strlen(XSTR(group_set_add)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_set_remove(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_set_remove), strlen(XSTR(group_set_remove)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_set_intersect(hyperdex_client* _cl,
+                                    const char* space,
+                                    const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_set_intersect), strlen(XSTR(group_set_intersect)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_set_union(hyperdex_client* _cl,
+                                const char* space,
+                                const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_set_union), strlen(XSTR(group_set_union)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_add(hyperdex_client* _cl,
+                              const char* space,
+                              const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                              const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                              hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_add), strlen(XSTR(group_map_add)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_remove(hyperdex_client* _cl,
+                                 const char* space,
+                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_remove), strlen(XSTR(group_map_remove)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, attrs, attrs_sz, NULL, 0, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_add(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_add), strlen(XSTR(group_map_atomic_add)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_sub(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_sub), strlen(XSTR(group_map_atomic_sub)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_mul(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_mul), strlen(XSTR(group_map_atomic_mul)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_div(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_div), strlen(XSTR(group_map_atomic_div)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_mod(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_mod), strlen(XSTR(group_map_atomic_mod)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_and(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_and), strlen(XSTR(group_map_atomic_and)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_or(hyperdex_client* _cl,
+                                    const char* space,
+                                    const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                    hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_or), strlen(XSTR(group_map_atomic_or)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_atomic_xor(hyperdex_client* _cl,
+                                     const char* space,
+                                     const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_atomic_xor), strlen(XSTR(group_map_atomic_xor)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_string_prepend(hyperdex_client* _cl,
+                                         const char* space,
+                                         const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                         const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                         hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_string_prepend), strlen(XSTR(group_map_string_prepend)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
+HYPERDEX_API int64_t
+hyperdex_client_group_map_string_append(hyperdex_client* _cl,
+                                        const char* space,
+                                        const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                        const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                        hyperdex_client_returncode* status)
+{
+    C_WRAP_EXCEPT(
+    const hyperdex_client_keyop_info* opinfo;
+    opinfo = hyperdex_client_keyop_info_lookup(XSTR(group_map_string_append), strlen(XSTR(group_map_string_append)));
+    return cl->perform_group_funcall(opinfo, space, checks, checks_sz, NULL, 0, mapattrs, mapattrs_sz, status);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_count(hyperdex_client* _cl,
                       const char* space,
@@ -1138,6 +1599,20 @@ hyperdex_client_count(hyperdex_client* _cl,
     );
 }
 
+HYPERDEX_API int64_t
+hyperdex_client_aggregate(hyperdex_client* _cl,
+                          const char* space,
+                          const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const char* attr,
+                          double histogram_lower, double histogram_upper,
+                          hyperdex_client_returncode* status,
+                          hyperdex_client_aggregate_result* aggregate)
+{
+    C_WRAP_EXCEPT(
+    return cl->aggregate(space, checks, checks_sz, attr, histogram_lower, histogram_upper, status, aggregate);
+    );
+}
+
 HYPERDEX_API int64_t
 hyperdex_client_loop(hyperdex_client* _cl, int timeout,
                      hyperdex_client_returncode* status)
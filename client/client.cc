@@ -25,6 +25,8 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+#define __STDC_LIMIT_MACROS
+
 // STL
 #include <algorithm>
 
@@ -37,15 +39,18 @@
 
 // HyperDex
 #include "visibility.h"
+#include "common/aggregate.h"
 #include "common/attribute_check.h"
 #include "common/datatypes.h"
 #include "common/funcall.h"
 #include "common/macros.h"
 #include "common/network_msgtype.h"
+#include "common/projection.h"
 #include "common/serialization.h"
 #include "client/client.h"
 #include "client/constants.h"
 #include "client/pending_atomic.h"
+#include "client/pending_aggregate.h"
 #include "client/pending_count.h"
 #include "client/pending_get.h"
 #include "client/pending_group_del.h"
@@ -94,6 +99,15 @@ int64_t
 client :: get(const char* space, const char* _key, size_t _key_sz,
               hyperdex_client_returncode* status,
               const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    return get_partial(space, _key, _key_sz, NULL, 0, status, attrs, attrs_sz);
+}
+
+int64_t
+client :: get_partial(const char* space, const char* _key, size_t _key_sz,
+                      const char** attrnames, size_t attrnames_sz,
+                      hyperdex_client_returncode* status,
+                      const hyperdex_client_attribute** attrs, size_t* attrs_sz)
 {
     if (!maintain_coord_connection(status))
     {
@@ -118,11 +132,21 @@ client :: get(const char* space, const char* _key, size_t _key_sz,
         return -1;
     }
 
+    std::vector<uint16_t> projection;
+    size_t num_names = prepare_projection(space, *sc, attrnames, attrnames_sz, status, &projection);
+
+    if (num_names != attrnames_sz)
+    {
+        return -2 - num_names;
+    }
+
     e::intrusive_ptr<pending> op;
-    op = new pending_get(m_next_client_id++, status, attrs, attrs_sz);
-    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ + sizeof(uint32_t) + key.size();
+    op = new pending_get(m_next_client_id++, projection, status, attrs, attrs_sz);
+    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
+              + sizeof(uint32_t) + key.size()
+              + pack_size(projection);
     std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << key;
+    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << key << projection;
     return send_keyop(space, key, REQ_GET, msg, op, status);
 }
 
@@ -151,16 +175,27 @@ client :: search(const char* space,
                  hyperdex_client_returncode* status,
                  const hyperdex_client_attribute** attrs, size_t* attrs_sz)
 {
-    SEARCH_BOILERPLATE
-    int64_t client_id = m_next_client_id++;
-    e::intrusive_ptr<pending_aggregation> op;
-    op = new pending_search(client_id, status, attrs, attrs_sz);
-    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
-              + sizeof(uint64_t)
-              + pack_size(checks);
-    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << client_id << checks;
-    return perform_aggregation(servers, op, REQ_SEARCH_START, msg, status);
+    return search_partial(space, chks, chks_sz, NULL, 0, status, attrs, attrs_sz);
+}
+
+int64_t
+client :: search_partial(const char* space,
+                         const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                         const char** attrnames, size_t attrnames_sz,
+                         hyperdex_client_returncode* status,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    return perform_search(space, chks, chks_sz, attrnames, attrnames_sz, UINT64_MAX, status, attrs, attrs_sz);
+}
+
+int64_t
+client :: search_limit(const char* space,
+                       const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                       uint64_t limit,
+                       hyperdex_client_returncode* status,
+                       const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    return perform_search(space, chks, chks_sz, NULL, 0, limit, status, attrs, attrs_sz);
 }
 
 int64_t
@@ -187,6 +222,20 @@ client :: sorted_search(const char* space,
                         bool maximize,
                         hyperdex_client_returncode* status,
                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    return sorted_search_partial(space, chks, chks_sz, sort_by, limit, maximize,
+                                 NULL, 0, status, attrs, attrs_sz);
+}
+
+int64_t
+client :: sorted_search_partial(const char* space,
+                                const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                                const char* sort_by,
+                                uint64_t limit,
+                                bool maximize,
+                                const char** attrnames, size_t attrnames_sz,
+                                hyperdex_client_returncode* status,
+                                const hyperdex_client_attribute** attrs, size_t* attrs_sz)
 {
     SEARCH_BOILERPLATE
     uint16_t sort_by_num = sc->lookup_attr(sort_by);
@@ -209,17 +258,60 @@ client :: sorted_search(const char* space,
         return -1 - chks_sz;
     }
 
+    std::vector<uint16_t> projection;
+    size_t num_names = prepare_projection(space, *sc, attrnames, attrnames_sz, status, &projection);
+
+    if (num_names != attrnames_sz)
+    {
+        return -2 - chks_sz - num_names;
+    }
+
+    // the sort attribute must come back so results from different servers
+    // can be merged; find where it lands within the projected value, and
+    // strip it again before yielding if the caller did not ask for it
+    uint16_t sort_by_idx = sort_by_num;
+    uint16_t strip_idx = 0;
+    std::vector<uint16_t> returned(projection);
+
+    if (!projection.empty())
+    {
+        bool requested = std::find(projection.begin(), projection.end(), sort_by_num) != projection.end();
+        projection.push_back(sort_by_num);
+        std::sort(projection.begin(), projection.end());
+        projection.erase(std::unique(projection.begin(), projection.end()), projection.end());
+        std::vector<uint16_t> attrnums;
+        projected_attrs(*sc, projection, &attrnums);
+
+        if (sort_by_num > 0)
+        {
+            sort_by_idx = std::find(attrnums.begin(), attrnums.end(), sort_by_num)
+                        - attrnums.begin() + 1;
+        }
+
+        if (sort_by_num > 0 && !requested)
+        {
+            strip_idx = sort_by_idx;
+            returned = projection;
+            returned.erase(std::find(returned.begin(), returned.end(), sort_by_num));
+        }
+        else
+        {
+            returned = projection;
+        }
+    }
+
     int64_t client_id = m_next_client_id++;
     e::intrusive_ptr<pending_aggregation> op;
-    op = new pending_sorted_search(this, client_id, maximize, limit, sort_by_num, di, status, attrs, attrs_sz);
+    op = new pending_sorted_search(this, client_id, maximize, limit, sort_by_idx, strip_idx, di, returned, status, attrs, attrs_sz);
     int8_t max = maximize ? 1 : 0;
     size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
               + pack_size(checks)
               + sizeof(limit)
               + sizeof(sort_by_num)
-              + sizeof(max);
+              + sizeof(max)
+              + pack_size(projection);
     std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << checks << limit << sort_by_num << max;
+    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << checks << limit << sort_by_num << max << projection;
     return perform_aggregation(servers, op, REQ_SORTED_SEARCH, msg, status);
 }
 
@@ -231,7 +323,7 @@ client :: group_del(const char* space,
     SEARCH_BOILERPLATE
     int64_t client_id = m_next_client_id++;
     e::intrusive_ptr<pending_aggregation> op;
-    op = new pending_group_del(client_id, status);
+    op = new pending_group_del(client_id, RESP_GROUP_DEL, status);
     size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
               + pack_size(checks);
     std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
@@ -256,6 +348,46 @@ client :: count(const char* space,
     return perform_aggregation(servers, op, REQ_COUNT, msg, status);
 }
 
+int64_t
+client :: aggregate(const char* space,
+                    const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                    const char* attr,
+                    double histogram_lower, double histogram_upper,
+                    hyperdex_client_returncode* status,
+                    hyperdex_client_aggregate_result* result)
+{
+    SEARCH_BOILERPLATE
+    uint16_t attrnum = sc->lookup_attr(attr);
+
+    if (attrnum == sc->attrs_sz)
+    {
+        ERROR(UNKNOWNATTR) << "\"" << e::strescape(attr)
+                           << "\" is not an attribute of space \""
+                           << e::strescape(space) << "\"";
+        return -1 - chks_sz;
+    }
+
+    if (!aggregatable(sc->attrs[attrnum].type))
+    {
+        ERROR(WRONGTYPE) << "cannot aggregate attribute \""
+                         << e::strescape(attr)
+                         << "\": it is not an int64 or float";
+        return -1 - chks_sz;
+    }
+
+    aggregate_stats stats(histogram_lower, histogram_upper, HYPERDEX_CLIENT_AGGREGATE_BUCKETS);
+    int64_t client_id = m_next_client_id++;
+    e::intrusive_ptr<pending_aggregation> op;
+    op = new pending_aggregate(client_id, stats, status, result);
+    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
+              + pack_size(checks)
+              + sizeof(attrnum)
+              + pack_size(stats);
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << checks << attrnum << stats;
+    return perform_aggregation(servers, op, REQ_AGGREGATE, msg, status);
+}
+
 int64_t
 client :: perform_funcall(const hyperdex_client_keyop_info* opinfo,
                           const char* space, const char* _key, size_t _key_sz,
@@ -333,6 +465,56 @@ client :: perform_funcall(const hyperdex_client_keyop_info* opinfo,
     return send_keyop(space, key, REQ_ATOMIC, msg, op, status);
 }
 
+int64_t
+client :: perform_group_funcall(const hyperdex_client_keyop_info* opinfo,
+                                const char* space,
+                                const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                                const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                hyperdex_client_returncode* status)
+{
+    SEARCH_BOILERPLATE
+    std::vector<funcall> funcs;
+    size_t idx = 0;
+
+    // Prepare the attrs
+    idx = prepare_funcs(space, *sc, opinfo, attrs, attrs_sz, status, &funcs);
+
+    if (idx < attrs_sz)
+    {
+        return -1 - chks_sz - idx;
+    }
+
+    // Prepare the mapattrs
+    idx = prepare_funcs(space, *sc, opinfo, mapattrs, mapattrs_sz, status, &funcs);
+
+    if (idx < mapattrs_sz)
+    {
+        return -1 - chks_sz - attrs_sz - idx;
+    }
+
+    std::stable_sort(funcs.begin(), funcs.end());
+    int64_t client_id = m_next_client_id++;
+    e::intrusive_ptr<pending_aggregation> op;
+    op = new pending_group_del(client_id, RESP_GROUP_ATOMIC, status);
+    // Everything after the search checks is the tail of a REQ_ATOMIC that the
+    // servers apply to each matching key.  The search checks are repeated as
+    // the per-key checks so that an object that stopped matching between the
+    // search and the update is left alone.
+    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
+              + pack_size(checks)
+              + sizeof(uint8_t)
+              + pack_size(checks)
+              + pack_size(funcs);
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    uint8_t flags = (opinfo->fail_if_not_found ? 1 : 0)
+                  | (opinfo->fail_if_found ? 2 : 0)
+                  | (opinfo->erase ? 0 : 128);
+    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ)
+        << checks << flags << checks << funcs;
+    return perform_aggregation(servers, op, REQ_GROUP_ATOMIC, msg, status);
+}
+
 int64_t
 client :: loop(int timeout, hyperdex_client_returncode* status)
 {
@@ -554,6 +736,15 @@ client :: prepare_checks(const char* space, const schema& sc,
             datatype = sc.attrs[attrnum].type;
         }
 
+        // an empty IN-list carries no element type of its own
+        if (chks[i].predicate == HYPERPREDICATE_IN &&
+            datatype == CONTAINER_TYPE(datatype) &&
+            IS_PRIMITIVE(sc.attrs[attrnum].type) &&
+            chks[i].value_sz == 0)
+        {
+            datatype = CREATE_CONTAINER(datatype, sc.attrs[attrnum].type);
+        }
+
         attribute_check c;
         c.attr = attrnum;
         c.value = e::slice(chks[i].value, chks[i].value_sz);
@@ -702,6 +893,34 @@ client :: prepare_funcs(const char* space, const schema& sc,
     return mapattrs_sz;
 }
 
+size_t
+client :: prepare_projection(const char* space, const schema& sc,
+                             const char** attrnames, size_t attrnames_sz,
+                             hyperdex_client_returncode* status,
+                             std::vector<uint16_t>* projection)
+{
+    projection->reserve(projection->size() + attrnames_sz);
+
+    for (size_t i = 0; i < attrnames_sz; ++i)
+    {
+        uint16_t attrnum = sc.lookup_attr(attrnames[i]);
+
+        if (attrnum >= sc.attrs_sz)
+        {
+            ERROR(UNKNOWNATTR) << "\"" << e::strescape(attrnames[i])
+                               << "\" is not an attribute of space \""
+                               << e::strescape(space) << "\"";
+            return i;
+        }
+
+        projection->push_back(attrnum);
+    }
+
+    std::sort(projection->begin(), projection->end());
+    projection->erase(std::unique(projection->begin(), projection->end()), projection->end());
+    return attrnames_sz;
+}
+
 size_t
 client :: prepare_searchop(const schema& sc,
                            const char* space,
@@ -731,6 +950,42 @@ client :: prepare_searchop(const schema& sc,
     return 0;
 }
 
+int64_t
+client :: perform_search(const char* space,
+                         const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                         const char** attrnames, size_t attrnames_sz,
+                         uint64_t limit,
+                         hyperdex_client_returncode* status,
+                         const hyperdex_client_attribute** attrs, size_t* attrs_sz)
+{
+    SEARCH_BOILERPLATE
+    std::vector<uint16_t> projection;
+    size_t num_names = prepare_projection(space, *sc, attrnames, attrnames_sz, status, &projection);
+
+    if (num_names != attrnames_sz)
+    {
+        return -1 - chks_sz - num_names;
+    }
+
+    int64_t client_id = m_next_client_id++;
+    e::intrusive_ptr<pending_aggregation> op;
+    op = new pending_search(client_id, projection, limit, status, attrs, attrs_sz);
+    // no one region may return more than the limit for the whole search
+    uint64_t max_objects = std::min(limit, static_cast<uint64_t>(HYPERDEX_CLIENT_SEARCH_BATCH_OBJECTS));
+    size_t sz = HYPERDEX_CLIENT_HEADER_SIZE_REQ
+              + sizeof(uint64_t)
+              + pack_size(checks)
+              + pack_size(projection)
+              + 3 * sizeof(uint64_t);
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    msg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ)
+        << client_id << checks << projection
+        << max_objects
+        << static_cast<uint64_t>(HYPERDEX_CLIENT_SEARCH_BATCH_BYTES)
+        << limit;
+    return perform_aggregation(servers, op, REQ_SEARCH_START, msg, status);
+}
+
 int64_t
 client :: perform_aggregation(const std::vector<virtual_server_id>& servers,
                               e::intrusive_ptr<pending_aggregation> _op,
@@ -832,8 +1087,12 @@ client :: send(network_msgtype mt,
     switch (rc)
     {
         case BUSYBEE_SUCCESS:
-            op->handle_sent_to(id, to);
-            m_pending_ops.insert(std::make_pair(nonce, pending_server_pair(id, to, op)));
+            if (op)
+            {
+                op->handle_sent_to(id, to);
+                m_pending_ops.insert(std::make_pair(nonce, pending_server_pair(id, to, op)));
+            }
+
             return true;
         case BUSYBEE_DISRUPTED:
             handle_disruption(id);
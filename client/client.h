@@ -62,10 +62,24 @@ class client
         int64_t get(const char* space, const char* key, size_t key_sz,
                     hyperdex_client_returncode* status,
                     const hyperdex_client_attribute** attrs, size_t* attrs_sz);
+        int64_t get_partial(const char* space, const char* key, size_t key_sz,
+                            const char** attrnames, size_t attrnames_sz,
+                            hyperdex_client_returncode* status,
+                            const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         int64_t search(const char* space,
                        const hyperdex_client_attribute_check* checks, size_t checks_sz,
                        hyperdex_client_returncode* status,
                        const hyperdex_client_attribute** attrs, size_t* attrs_sz);
+        int64_t search_partial(const char* space,
+                               const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char** attrnames, size_t attrnames_sz,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz);
+        int64_t search_limit(const char* space,
+                             const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                             uint64_t limit,
+                             hyperdex_client_returncode* status,
+                             const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         int64_t search_describe(const char* space,
                                 const hyperdex_client_attribute_check* checks, size_t checks_sz,
                                 hyperdex_client_returncode* status, const char** description);
@@ -76,12 +90,26 @@ class client
                               bool maximize,
                               hyperdex_client_returncode* status,
                               const hyperdex_client_attribute** attrs, size_t* attrs_sz);
+        int64_t sorted_search_partial(const char* space,
+                                      const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                      const char* sort_by,
+                                      uint64_t limit,
+                                      bool maximize,
+                                      const char** attrnames, size_t attrnames_sz,
+                                      hyperdex_client_returncode* status,
+                                      const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         int64_t group_del(const char* space,
                           const hyperdex_client_attribute_check* checks, size_t checks_sz,
                           hyperdex_client_returncode* status);
         int64_t count(const char* space,
                       const hyperdex_client_attribute_check* checks, size_t checks_sz,
                       hyperdex_client_returncode* status, uint64_t* result);
+        int64_t aggregate(const char* space,
+                          const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const char* attr,
+                          double histogram_lower, double histogram_upper,
+                          hyperdex_client_returncode* status,
+                          hyperdex_client_aggregate_result* aggregate);
         // general keyop call
         int64_t perform_funcall(const hyperdex_client_keyop_info* opinfo,
                                 const char* space, const char* key, size_t key_sz,
@@ -89,6 +117,13 @@ class client
                                 const hyperdex_client_attribute* attrs, size_t attrs_sz,
                                 const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
                                 hyperdex_client_returncode* status);
+        // general group keyop call
+        int64_t perform_group_funcall(const hyperdex_client_keyop_info* opinfo,
+                                      const char* space,
+                                      const hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                      const hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                      const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                      hyperdex_client_returncode* status);
         // looping/polling
         int64_t loop(int timeout, hyperdex_client_returncode* status);
         // error handling
@@ -134,18 +169,29 @@ class client
                              const hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
                              hyperdex_client_returncode* status,
                              std::vector<funcall>* funcs);
+        size_t prepare_projection(const char* space, const schema& sc,
+                                  const char** attrnames, size_t attrnames_sz,
+                                  hyperdex_client_returncode* status,
+                                  std::vector<uint16_t>* projection);
         size_t prepare_searchop(const schema& sc,
                                 const char* space,
                                 const hyperdex_client_attribute_check* chks, size_t chks_sz,
                                 hyperdex_client_returncode* status,
                                 std::vector<attribute_check>* checks,
                                 std::vector<virtual_server_id>* servers);
+        int64_t perform_search(const char* space,
+                               const hyperdex_client_attribute_check* chks, size_t chks_sz,
+                               const char** attrnames, size_t attrnames_sz,
+                               uint64_t limit,
+                               hyperdex_client_returncode* status,
+                               const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         int64_t perform_aggregation(const std::vector<virtual_server_id>& servers,
                                     e::intrusive_ptr<pending_aggregation> op,
                                     network_msgtype mt,
                                     std::auto_ptr<e::buffer> msg,
                                     hyperdex_client_returncode* status);
         bool maintain_coord_connection(hyperdex_client_returncode* status);
+        // op may be NULL for messages the server does not answer
         bool send(network_msgtype mt,
                   const virtual_server_id& to,
                   uint64_t nonce,
@@ -42,4 +42,8 @@
                                       + sizeof(uint64_t) /*vidt*/ \
                                       + sizeof(uint64_t) /*nonce*/)
 
+// The most objects/bytes a server may pack into a single RESP_SEARCH_ITEM
+#define HYPERDEX_CLIENT_SEARCH_BATCH_OBJECTS 1024
+#define HYPERDEX_CLIENT_SEARCH_BATCH_BYTES (1024 * 1024)
+
 #endif // hyperdex_client_constants_h_
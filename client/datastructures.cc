@@ -315,6 +315,13 @@ hyperdex_ds_allocate_map_attribute(struct hyperdex_ds_arena* arena, size_t sz)
     return reinterpret_cast<struct hyperdex_client_map_attribute*>(arena->allocate(bytes));
 }
 
+HYPERDEX_API const char**
+hyperdex_ds_allocate_attribute_names(struct hyperdex_ds_arena* arena, size_t sz)
+{
+    size_t bytes = sizeof(const char*) * sz;
+    return reinterpret_cast<const char**>(arena->allocate(bytes));
+}
+
 //////////////////////////// pack/unpack ints/floats ///////////////////////////
 
 HYPERDEX_API void
@@ -34,11 +34,13 @@
 using hyperdex::pending_get;
 
 pending_get :: pending_get(uint64_t id,
+                           const std::vector<uint16_t>& projection,
                            hyperdex_client_returncode* status,
                            const hyperdex_client_attribute** attrs,
                            size_t* attrs_sz)
     : pending(id, status)
     , m_state(INITIALIZED)
+    , m_projection(projection)
     , m_attrs(attrs)
     , m_attrs_sz(attrs_sz)
 {
@@ -175,8 +177,8 @@ pending_get :: handle_message(client* cl,
 
     if (!value_to_attributes(*cl->m_coord.config(),
                              cl->m_coord.config()->get_region_id(vsi),
-                             NULL, 0, value, &op_status, &op_error,
-                             m_attrs, m_attrs_sz))
+                             NULL, 0, value, m_projection,
+                             &op_status, &op_error, m_attrs, m_attrs_sz))
     {
         set_status(op_status);
         set_error(op_error);
@@ -28,6 +28,9 @@
 #ifndef hyperdex_client_pending_get_h_
 #define hyperdex_client_pending_get_h_
 
+// STL
+#include <vector>
+
 // HyperDex
 #include "namespace.h"
 #include "client/pending.h"
@@ -38,6 +41,7 @@ class pending_get : public pending
 {
     public:
         pending_get(uint64_t client_visible_id,
+                    const std::vector<uint16_t>& projection,
                     hyperdex_client_returncode* status,
                     const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         virtual ~pending_get() throw ();
@@ -69,6 +73,7 @@ class pending_get : public pending
 
     private:
         enum { INITIALIZED, SENT, RECV, YIELDED } m_state;
+        const std::vector<uint16_t> m_projection;
         const hyperdex_client_attribute** m_attrs;
         size_t* m_attrs_sz;
 };
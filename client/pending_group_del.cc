@@ -31,8 +31,10 @@
 using hyperdex::pending_group_del;
 
 pending_group_del :: pending_group_del(uint64_t id,
+                                       network_msgtype expected,
                                        hyperdex_client_returncode* status)
     : pending_aggregation(id, status)
+    , m_expected(expected)
     , m_done(false)
 {
     set_status(HYPERDEX_CLIENT_SUCCESS);
@@ -84,9 +86,9 @@ pending_group_del :: handle_message(client* cl,
     *status = HYPERDEX_CLIENT_SUCCESS;
     *err = e::error();
 
-    if (mt != RESP_GROUP_DEL)
+    if (mt != m_expected)
     {
-        PENDING_ERROR(SERVERERROR) << "server vsi responded to GROUP DEL with " << mt;
+        PENDING_ERROR(SERVERERROR) << "server vsi responded to " << m_expected << " with " << mt;
         return true;
     }
 
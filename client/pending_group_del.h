@@ -34,10 +34,13 @@
 
 BEGIN_HYPERDEX_NAMESPACE
 
+// A group operation applied region by region; every region answers with a
+// reply of type expected once it is done.
 class pending_group_del : public pending_aggregation
 {
     public:
         pending_group_del(uint64_t client_visible_id,
+                          network_msgtype expected,
                           hyperdex_client_returncode* status);
         virtual ~pending_group_del() throw ();
 
@@ -65,6 +68,7 @@ class pending_group_del : public pending_aggregation
         pending_group_del& operator = (const pending_group_del& rhs);
 
     private:
+        network_msgtype m_expected;
         bool m_done;
 };
 
@@ -25,6 +25,9 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// STL
+#include <algorithm>
+
 // HyperDex
 #include "client/client.h"
 #include "client/constants.h"
@@ -34,13 +37,23 @@
 using hyperdex::pending_search;
 
 pending_search :: pending_search(uint64_t id,
+                                 const std::vector<uint16_t>& projection,
+                                 uint64_t limit,
                                  hyperdex_client_returncode* status,
                                  const hyperdex_client_attribute** attrs, size_t* attrs_sz)
     : pending_aggregation(id, status)
+    , m_projection(projection)
+    , m_limit(limit)
+    , m_received(0)
     , m_attrs(attrs)
     , m_attrs_sz(attrs_sz)
     , m_yield(false)
     , m_done(false)
+    , m_batch()
+    , m_batch_up()
+    , m_batch_remain(0)
+    , m_batch_cl(NULL)
+    , m_batch_vsi()
 {
     *m_attrs = NULL;
     *m_attrs_sz = 0;
@@ -63,6 +76,19 @@ pending_search :: yield(hyperdex_client_returncode* status, e::error* err)
     *err = e::error();
     m_yield = false;
 
+    if (m_batch_remain > 0)
+    {
+        yield_batch_item();
+
+        if (m_batch_remain == 0 && limit_reached())
+        {
+            m_done = true;
+        }
+
+        m_yield = m_batch_remain > 0 || m_done;
+        return true;
+    }
+
     if (this->aggregation_done() && !m_done)
     {
         m_yield = true;
@@ -112,6 +138,12 @@ pending_search :: handle_message(client* cl,
 
         return true;
     }
+    else if (mt == RESP_SEARCH_ERROR)
+    {
+        PENDING_ERROR(SERVERERROR) << "server " << vsi << " could not perform the SEARCH";
+        m_yield = true;
+        return true;
+    }
     else if (mt != RESP_SEARCH_ITEM)
     {
         PENDING_ERROR(SERVERERROR) << "server vsi responded to SEARCH with " << mt;
@@ -119,9 +151,8 @@ pending_search :: handle_message(client* cl,
         return true;
     }
 
-    e::slice key;
-    std::vector<e::slice> value;
-    up = up >> key >> value;
+    uint64_t count;
+    up = up >> count;
 
     if (up.error())
     {
@@ -133,32 +164,103 @@ pending_search :: handle_message(client* cl,
         return true;
     }
 
+    // Objects past the limit are never unpacked; once the limit is reached
+    // the region is told to drop its search instead of sending more.
+    count = std::min(count, m_limit - m_received);
+    m_received += count;
+
+    if (m_received >= m_limit)
+    {
+        std::auto_ptr<e::buffer> smsg(e::buffer::create(HYPERDEX_CLIENT_HEADER_SIZE_REQ + sizeof(uint64_t)));
+        smsg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ)
+            << static_cast<uint64_t>(client_visible_id());
+        // a lost stop only leaves the region's search idle on the server
+        hyperdex_client_returncode stop_status;
+        cl->send(REQ_SEARCH_STOP, vsi, cl->m_next_server_nonce++, smsg,
+                 e::intrusive_ptr<pending>(), &stop_status);
+    }
+    else
+    {
+        // Ask for the next batch before handing out this one so the server
+        // works on it while the application consumes these objects.
+        uint64_t max_objects = std::min(m_limit - m_received,
+                                        static_cast<uint64_t>(HYPERDEX_CLIENT_SEARCH_BATCH_OBJECTS));
+        std::auto_ptr<e::buffer> smsg(e::buffer::create(HYPERDEX_CLIENT_HEADER_SIZE_REQ + 3 * sizeof(uint64_t)));
+        smsg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ)
+            << static_cast<uint64_t>(client_visible_id())
+            << max_objects
+            << static_cast<uint64_t>(HYPERDEX_CLIENT_SEARCH_BATCH_BYTES);
+
+        if (!cl->send(REQ_SEARCH_NEXT, vsi, cl->m_next_server_nonce++, smsg, this, status))
+        {
+            PENDING_ERROR(RECONFIGURE) << "could not send SEARCH_NEXT to " << vsi;
+            m_yield = true;
+            return true;
+        }
+    }
+
+    m_batch = msg;
+    m_batch_up = up;
+    m_batch_remain = count;
+    m_batch_cl = cl;
+    m_batch_vsi = vsi;
+
+    if (m_batch_remain == 0 && limit_reached())
+    {
+        m_done = true;
+    }
+
+    m_yield = m_batch_remain > 0 || m_done;
+    return true;
+}
+
+bool
+pending_search :: limit_reached()
+{
+    // Regions stopped at the limit never send RESP_SEARCH_DONE, so the search
+    // is complete once every region has answered its last request.
+    return m_received >= m_limit && this->aggregation_done();
+}
+
+void
+pending_search :: yield_batch_item()
+{
+    assert(m_batch_remain > 0);
+    --m_batch_remain;
+    e::slice key;
+    std::vector<e::slice> value;
+    m_batch_up = m_batch_up >> key >> value;
+
+    if (m_batch_up.error())
+    {
+        PENDING_ERROR(SERVERERROR) << "communication error: server "
+                                   << m_batch_vsi << " sent corrupt message="
+                                   << m_batch->as_slice().hex()
+                                   << " in response to a SEARCH";
+        m_batch_remain = 0;
+        m_batch.reset();
+        return;
+    }
+
     hyperdex_client_returncode op_status;
     e::error op_error;
 
-    if (!value_to_attributes(*cl->m_coord.config(),
-                             cl->m_coord.config()->get_region_id(vsi),
-                             key.data(), key.size(), value,
+    if (!value_to_attributes(*m_batch_cl->m_coord.config(),
+                             m_batch_cl->m_coord.config()->get_region_id(m_batch_vsi),
+                             key.data(), key.size(), value, m_projection,
                              &op_status, &op_error, m_attrs, m_attrs_sz))
     {
         set_status(op_status);
         set_error(op_error);
-        m_yield = true;
-        return true;
     }
-
-    std::auto_ptr<e::buffer> smsg(e::buffer::create(HYPERDEX_CLIENT_HEADER_SIZE_REQ + sizeof(uint64_t)));
-    smsg->pack_at(HYPERDEX_CLIENT_HEADER_SIZE_REQ) << static_cast<uint64_t>(client_visible_id());
-
-    if (!cl->send(REQ_SEARCH_NEXT, vsi, cl->m_next_server_nonce++, smsg, this, status))
+    else
     {
-        PENDING_ERROR(RECONFIGURE) << "could not send SEARCH_NEXT to " << vsi;
-        m_yield = true;
-        return true;
+        set_status(HYPERDEX_CLIENT_SUCCESS);
+        set_error(e::error());
     }
 
-    set_status(HYPERDEX_CLIENT_SUCCESS);
-    set_error(e::error());
-    m_yield = true;
-    return true;
+    if (m_batch_remain == 0)
+    {
+        m_batch.reset();
+    }
 }
@@ -38,6 +38,8 @@ class pending_search : public pending_aggregation
 {
     public:
         pending_search(uint64_t client_visible_id,
+                       const std::vector<uint16_t>& projection,
+                       uint64_t limit,
                        hyperdex_client_returncode* status,
                        const hyperdex_client_attribute** attrs, size_t* attrs_sz);
         virtual ~pending_search() throw ();
@@ -66,10 +68,24 @@ class pending_search : public pending_aggregation
         pending_search& operator = (const pending_search& rhs);
 
     private:
+        void yield_batch_item();
+        bool limit_reached();
+
+    private:
+        const std::vector<uint16_t> m_projection;
+        // objects accepted from all regions so far, and the most to accept
+        const uint64_t m_limit;
+        uint64_t m_received;
         const hyperdex_client_attribute** m_attrs;
         size_t* m_attrs_sz;
         bool m_yield;
         bool m_done;
+        // the most recent RESP_SEARCH_ITEM and the objects left to yield from it
+        std::auto_ptr<e::buffer> m_batch;
+        e::unpacker m_batch_up;
+        uint64_t m_batch_remain;
+        client* m_batch_cl;
+        virtual_server_id m_batch_vsi;
 };
 
 END_HYPERDEX_NAMESPACE
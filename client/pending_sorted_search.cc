@@ -36,12 +36,36 @@
 using hyperdex::datatype_info;
 using hyperdex::pending_sorted_search;
 
+namespace
+{
+
+class sorted_search_comparator
+{
+    public:
+        sorted_search_comparator(bool maximize,
+                                 uint16_t sort_by_idx,
+                                 datatype_info* sort_by_di);
+
+    public:
+        bool operator () (const pending_sorted_search::item& lhs,
+                          const pending_sorted_search::item& rhs);
+
+    private:
+        bool m_maximize;
+        uint16_t m_sort_by_idx;
+        datatype_info* m_sort_by_di;
+};
+
+} // namespace
+
 pending_sorted_search :: pending_sorted_search(client* cl,
                                                uint64_t id,
                                                bool maximize,
                                                uint64_t limit,
                                                uint16_t sort_by_idx,
+                                               uint16_t strip_idx,
                                                datatype_info* sort_by_di,
+                                               const std::vector<uint16_t>& projection,
                                                hyperdex_client_returncode* status,
                                                const hyperdex_client_attribute** attrs,
                                                size_t* attrs_sz)
@@ -52,11 +76,15 @@ pending_sorted_search :: pending_sorted_search(client* cl,
     , m_maximize(maximize)
     , m_limit(limit)
     , m_sort_by_idx(sort_by_idx)
+    , m_strip_idx(strip_idx)
     , m_sort_by_di(sort_by_di)
+    , m_projection(projection)
     , m_attrs(attrs)
     , m_attrs_sz(attrs_sz)
     , m_results()
     , m_results_idx()
+    , m_sorted(false)
+    , m_errored(false)
 {
 }
 
@@ -77,6 +105,22 @@ pending_sorted_search :: yield(hyperdex_client_returncode* status, e::error* err
     *err = e::error();
     m_yield = false;
 
+    if (m_errored)
+    {
+        // the error was recorded when it arrived; any results follow once
+        // every region has answered
+        m_errored = false;
+        m_yield = this->aggregation_done();
+        return true;
+    }
+
+    if (!m_sorted)
+    {
+        sorted_search_comparator ssc(m_maximize, m_sort_by_idx, m_sort_by_di);
+        std::sort(m_results.begin(), m_results.end(), ssc);
+        m_sorted = true;
+    }
+
     if (this->aggregation_done() && m_results_idx >= m_results.size())
     {
         set_status(HYPERDEX_CLIENT_SEARCHDONE);
@@ -89,11 +133,17 @@ pending_sorted_search :: yield(hyperdex_client_returncode* status, e::error* err
     hyperdex_client_returncode op_status;
     e::error op_error;
     const e::slice& key(m_results[m_results_idx].key);
-    const std::vector<e::slice>& value(m_results[m_results_idx].value);
+    std::vector<e::slice> value(m_results[m_results_idx].value);
     ++m_results_idx;
 
+    if (m_strip_idx > 0 && m_strip_idx <= value.size())
+    {
+        value.erase(value.begin() + m_strip_idx - 1);
+    }
+
     if (!value_to_attributes(*m_cl->m_coord.config(), m_ri, key.data(), key.size(),
-                             value, &op_status, &op_error, m_attrs, m_attrs_sz))
+                             value, m_projection, &op_status, &op_error,
+                             m_attrs, m_attrs_sz))
     {
         set_status(op_status);
         set_error(op_error);
@@ -122,33 +172,12 @@ pending_sorted_search :: handle_failure(const server_id& si,
                                         const virtual_server_id& vsi)
 {
     m_yield = true;
+    m_errored = true;
     PENDING_ERROR(RECONFIGURE) << "reconfiguration affecting "
                                << vsi << "/" << si;
     return pending_aggregation::handle_failure(si, vsi);
 }
 
-namespace
-{
-
-class sorted_search_comparator
-{
-    public:
-        sorted_search_comparator(bool maximize,
-                                 uint16_t sort_by_idx,
-                                 datatype_info* sort_by_di);
-
-    public:
-        bool operator () (const pending_sorted_search::item& lhs,
-                          const pending_sorted_search::item& rhs);
-
-    private:
-        bool m_maximize;
-        uint16_t m_sort_by_idx;
-        datatype_info* m_sort_by_di;
-};
-
-} // namespace
-
 sorted_search_comparator :: sorted_search_comparator(bool maximize,
                                                      uint16_t sort_by_idx,
                                                      datatype_info* sort_by_di)
@@ -207,6 +236,7 @@ pending_sorted_search :: handle_message(client* cl,
     {
         PENDING_ERROR(SERVERERROR) << "server vsi responded to SORTED_SEARCH with " << mt;
         m_yield = true;
+        m_errored = true;
         return true;
     }
 
@@ -220,6 +250,7 @@ pending_sorted_search :: handle_message(client* cl,
                                    << msg->as_slice().hex()
                                    << " in response to a SORTED_SEARCH";
         m_yield = true;
+        m_errored = true;
         return true;
     }
 
@@ -239,6 +270,7 @@ pending_sorted_search :: handle_message(client* cl,
                                        << msg->as_slice().hex()
                                        << " in response to a SORTED_SEARCH";
             m_yield = true;
+            m_errored = true;
             return true;
         }
 
@@ -255,12 +287,6 @@ pending_sorted_search :: handle_message(client* cl,
     m_yield = this->aggregation_done();
     set_status(HYPERDEX_CLIENT_SUCCESS);
     set_error(e::error());
-
-    if (m_yield)
-    {
-        std::sort(m_results.begin(), m_results.end(), ssc);
-    }
-
     return true;
 }
 
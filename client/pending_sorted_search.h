@@ -43,7 +43,9 @@ class pending_sorted_search : public pending_aggregation
                               bool maximize,
                               uint64_t limit,
                               uint16_t sort_by_idx,
+                              uint16_t strip_idx,
                               datatype_info* sort_by_di,
+                              const std::vector<uint16_t>& projection,
                               hyperdex_client_returncode* status,
                               const hyperdex_client_attribute** attrs,
                               size_t* attrs_sz);
@@ -84,11 +86,18 @@ class pending_sorted_search : public pending_aggregation
         bool m_maximize;
         const uint64_t m_limit;
         const uint16_t m_sort_by_idx;
+        // the 1-based position of a value attribute fetched only for sorting
+        // and removed before yielding, or 0
+        const uint16_t m_strip_idx;
         datatype_info* m_sort_by_di;
+        const std::vector<uint16_t> m_projection;
         const hyperdex_client_attribute** m_attrs;
         size_t* m_attrs_sz;
         std::vector<item> m_results;
         size_t m_results_idx;
+        bool m_sorted;
+        // an error has been set and not yet returned to the application
+        bool m_errored;
 };
 
 class pending_sorted_search :: item
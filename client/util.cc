@@ -30,6 +30,7 @@
 #include <e/guard.h>
 
 // HyperDex
+#include "common/projection.h"
 #include "common/schema.h"
 #include "client/util.h"
 
@@ -44,31 +45,34 @@ hyperdex :: value_to_attributes(const configuration& config,
                                 const uint8_t* key,
                                 size_t key_sz,
                                 const std::vector<e::slice>& value,
+                                const std::vector<uint16_t>& projection,
                                 hyperdex_client_returncode* op_status,
                                 e::error* op_error,
                                 const hyperdex_client_attribute** attrs,
                                 size_t* attrs_sz)
 {
     const schema* sc = config.get_schema(rid);
+    std::vector<uint16_t> attrnums;
+    projected_attrs(*sc, projection, &attrnums);
 
-    if (value.size() + 1 != sc->attrs_sz)
+    if (value.size() != attrnums.size())
     {
         UTIL_ERROR(SERVERERROR) << "received object with " << value.size()
                                 << " attributes instead of "
-                                << sc->attrs_sz - 1 << " attributes";
+                                << attrnums.size() << " attributes";
         return false;
     }
 
-    size_t sz = sizeof(hyperdex_client_attribute) * sc->attrs_sz + key_sz
+    size_t sz = sizeof(hyperdex_client_attribute) * (value.size() + 1) + key_sz
               + strlen(sc->attrs[0].name) + 1;
 
     for (size_t i = 0; i < value.size(); ++i)
     {
-        sz += strlen(sc->attrs[i + 1].name) + 1 + value[i].size();
+        sz += strlen(sc->attrs[attrnums[i]].name) + 1 + value[i].size();
     }
 
     std::vector<hyperdex_client_attribute> ha;
-    ha.reserve(sc->attrs_sz);
+    ha.reserve(value.size() + 1);
     char* ret = static_cast<char*>(malloc(sz));
 
     if (!ret)
@@ -98,18 +102,22 @@ hyperdex :: value_to_attributes(const configuration& config,
     for (size_t i = 0; i < value.size(); ++i)
     {
         ha.push_back(hyperdex_client_attribute());
-        size_t attr_sz = strlen(sc->attrs[i + 1].name) + 1;
+        size_t attr_sz = strlen(sc->attrs[attrnums[i]].name) + 1;
         ha.back().attr = data;
-        memmove(data, sc->attrs[i + 1].name, attr_sz);
+        memmove(data, sc->attrs[attrnums[i]].name, attr_sz);
         data += attr_sz;
         ha.back().value = data;
         memmove(data, value[i].data(), value[i].size());
         data += value[i].size();
         ha.back().value_sz = value[i].size();
-        ha.back().datatype = sc->attrs[i + 1].type;
+        ha.back().datatype = sc->attrs[attrnums[i]].type;
+    }
+
+    if (!ha.empty())
+    {
+        memmove(ret, &ha.front(), sizeof(hyperdex_client_attribute) * ha.size());
     }
 
-    memmove(ret, &ha.front(), sizeof(hyperdex_client_attribute) * ha.size());
     *op_status = HYPERDEX_CLIENT_SUCCESS;
     *op_error = e::error();
     *attrs = reinterpret_cast<hyperdex_client_attribute*>(ret);
@@ -40,13 +40,15 @@
 BEGIN_HYPERDEX_NAMESPACE
 
 // Convert the key and value vector returned by entity to an array of
-// hyperdex_attribute using the given configuration.
+// hyperdex_attribute using the given configuration.  The value holds the
+// attributes selected by projection (see common/projection.h).
 bool
 value_to_attributes(const configuration& config,
                     const region_id& rid,
                     const uint8_t* key,
                     size_t key_sz,
                     const std::vector<e::slice>& value,
+                    const std::vector<uint16_t>& projection,
                     hyperdex_client_returncode* op_status,
                     e::error* op_error,
                     const hyperdex_client_attribute** attrs,
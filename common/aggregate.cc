@@ -0,0 +1,195 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/aggregate.h"
+
+using hyperdex::aggregate_stats;
+
+aggregate_stats :: aggregate_stats()
+    : lower(0)
+    , upper(0)
+    , count(0)
+    , int_sum(0)
+    , sum(0)
+    , min(0)
+    , max(0)
+    , below(0)
+    , above(0)
+    , buckets()
+{
+}
+
+aggregate_stats :: aggregate_stats(double l, double u, size_t num_buckets)
+    : lower(l)
+    , upper(u)
+    , count(0)
+    , int_sum(0)
+    , sum(0)
+    , min(0)
+    , max(0)
+    , below(0)
+    , above(0)
+    , buckets(num_buckets, 0)
+{
+}
+
+aggregate_stats :: ~aggregate_stats() throw ()
+{
+}
+
+void
+aggregate_stats :: add_int(int64_t x)
+{
+    // wrap on overflow rather than invoke undefined behavior
+    int_sum = static_cast<int64_t>(static_cast<uint64_t>(int_sum) +
+                                   static_cast<uint64_t>(x));
+    observe(x);
+}
+
+void
+aggregate_stats :: add_float(double x)
+{
+    sum += x;
+    observe(x);
+}
+
+double
+aggregate_stats :: total() const
+{
+    return sum + int_sum;
+}
+
+void
+aggregate_stats :: observe(double x)
+{
+    if (count == 0 || x < min)
+    {
+        min = x;
+    }
+
+    if (count == 0 || x > max)
+    {
+        max = x;
+    }
+
+    ++count;
+
+    if (!(x >= lower))
+    {
+        ++below;
+    }
+    else if (!(x < upper) || buckets.empty())
+    {
+        ++above;
+    }
+    else
+    {
+        size_t idx = (x - lower) / (upper - lower) * buckets.size();
+        idx = idx < buckets.size() ? idx : buckets.size() - 1;
+        ++buckets[idx];
+    }
+}
+
+void
+aggregate_stats :: merge(const aggregate_stats& other)
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    if (count == 0 || other.min < min)
+    {
+        min = other.min;
+    }
+
+    if (count == 0 || other.max > max)
+    {
+        max = other.max;
+    }
+
+    count += other.count;
+    int_sum = static_cast<int64_t>(static_cast<uint64_t>(int_sum) +
+                                   static_cast<uint64_t>(other.int_sum));
+    sum += other.sum;
+    below += other.below;
+    above += other.above;
+
+    for (size_t i = 0; i < buckets.size() && i < other.buckets.size(); ++i)
+    {
+        buckets[i] += other.buckets[i];
+    }
+}
+
+bool
+hyperdex :: aggregatable(hyperdatatype type)
+{
+    return type == HYPERDATATYPE_INT64 ||
+           type == HYPERDATATYPE_FLOAT;
+}
+
+bool
+hyperdex :: aggregate_value(hyperdatatype type, const e::slice& value, aggregate_stats* stats)
+{
+    if (!value.empty() && value.size() != sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    // an empty value is the type's default of zero
+    if (type == HYPERDATATYPE_INT64)
+    {
+        int64_t number = 0;
+
+        if (!value.empty())
+        {
+            e::unpack64le(value.data(), &number);
+        }
+
+        stats->add_int(number);
+        return true;
+    }
+    else if (type == HYPERDATATYPE_FLOAT)
+    {
+        double number = 0;
+
+        if (!value.empty())
+        {
+            e::unpackdoublele(value.data(), &number);
+        }
+
+        stats->add_float(number);
+        return true;
+    }
+
+    return false;
+}
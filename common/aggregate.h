@@ -0,0 +1,93 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+#ifndef hyperdex_common_aggregate_h_
+#define hyperdex_common_aggregate_h_
+
+// STL
+#include <vector>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "hyperdex.h"
+
+// servers refuse histograms with more buckets than this
+#define HYPERDEX_MAX_AGGREGATE_BUCKETS 1024
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// The running summary of a numeric attribute over the objects of a search.
+// The client sends an empty one describing the histogram, each server fills it
+// in for its region, and the client merges the results.
+class aggregate_stats
+{
+    public:
+        aggregate_stats();
+        aggregate_stats(double lower, double upper, size_t num_buckets);
+        ~aggregate_stats() throw ();
+
+    public:
+        void add_int(int64_t x);
+        void add_float(double x);
+        void merge(const aggregate_stats& other);
+        // the sum of every value added, of both kinds
+        double total() const;
+
+    private:
+        void observe(double x);
+
+    public:
+        // histogram buckets evenly divide [lower, upper)
+        double lower;
+        double upper;
+        uint64_t count;
+        // int64 values are summed exactly; float values in double precision
+        int64_t int_sum;
+        double sum;
+        double min;
+        double max;
+        uint64_t below;
+        uint64_t above;
+        std::vector<uint64_t> buckets;
+};
+
+// int64 and float attributes are the only ones that can be aggregated
+bool
+aggregatable(hyperdatatype type);
+
+// decode an int64 or float value and add it to stats; false if it does not
+// decode
+bool
+aggregate_value(hyperdatatype type, const e::slice& value, aggregate_stats* stats);
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_aggregate_h_
@@ -40,6 +40,7 @@ attribute_check :: attribute_check()
     , value()
     , datatype(HYPERDATATYPE_GARBAGE)
     , predicate(HYPERPREDICATE_FAIL)
+    , regex()
 {
 }
 
@@ -73,6 +74,14 @@ hyperdex :: validate_attribute_check(const schema& sc,
         case HYPERPREDICATE_REGEX:
             return di_check->datatype() == HYPERDATATYPE_STRING &&
                    di_attr->has_regex();
+        case HYPERPREDICATE_PREFIX:
+            return di_check->datatype() == HYPERDATATYPE_STRING &&
+                   di_attr->datatype() == HYPERDATATYPE_STRING;
+        case HYPERPREDICATE_IN:
+            return IS_PRIMITIVE(di_attr->datatype()) &&
+                   (CONTAINER_TYPE(di_check->datatype()) == HYPERDATATYPE_LIST_GENERIC ||
+                    CONTAINER_TYPE(di_check->datatype()) == HYPERDATATYPE_SET_GENERIC) &&
+                   di_check->contains_datatype() == di_attr->datatype();
         case HYPERPREDICATE_CONTAINS_LESS_THAN:
         case HYPERPREDICATE_LENGTH_EQUALS:
         case HYPERPREDICATE_LENGTH_LESS_EQUAL:
@@ -142,8 +151,33 @@ hyperdex :: passes_attribute_check(const schema& sc,
                    di_attr->comparable() &&
                    di_attr->compare(check.value, value) >= 0;
         case HYPERPREDICATE_REGEX:
+            if (di_check->datatype() != HYPERDATATYPE_STRING ||
+                !di_attr->has_regex())
+            {
+                return false;
+            }
+
+            if (check.regex.get())
+            {
+                return di_attr->regex(*check.regex, value);
+            }
+            else
+            {
+                regex_program re;
+                re.compile(check.value.data(), check.value.size());
+                return di_attr->regex(re, value);
+            }
+        case HYPERPREDICATE_PREFIX:
             return di_check->datatype() == HYPERDATATYPE_STRING &&
-                   di_attr->has_regex();
+                   di_attr->datatype() == HYPERDATATYPE_STRING &&
+                   check.value.size() <= value.size() &&
+                   memcmp(check.value.data(), value.data(), check.value.size()) == 0;
+        case HYPERPREDICATE_IN:
+            return IS_PRIMITIVE(di_attr->datatype()) &&
+                   (CONTAINER_TYPE(di_check->datatype()) == HYPERDATATYPE_LIST_GENERIC ||
+                    CONTAINER_TYPE(di_check->datatype()) == HYPERDATATYPE_SET_GENERIC) &&
+                   di_check->contains_datatype() == di_attr->datatype() &&
+                   di_check->contains(check.value, value);
         case HYPERPREDICATE_LENGTH_EQUALS:
             memset(buf_i, 0, sizeof(int64_t));
             memmove(buf_i, check.value.data(), std::min(check.value.size(), sizeof(int64_t)));
@@ -175,6 +209,72 @@ hyperdex :: passes_attribute_check(const schema& sc,
     }
 }
 
+void
+hyperdex :: compile_attribute_checks(std::vector<hyperdex::attribute_check>* checks)
+{
+    for (size_t i = 0; i < checks->size(); ++i)
+    {
+        attribute_check& check((*checks)[i]);
+
+        if (check.datatype != HYPERDATATYPE_STRING)
+        {
+            continue;
+        }
+
+        if (check.predicate == HYPERPREDICATE_REGEX)
+        {
+            check.regex.reset(new regex_program());
+            check.regex->compile(check.value.data(), check.value.size());
+        }
+        else if (check.predicate == HYPERPREDICATE_PREFIX)
+        {
+            // "^" followed by every byte of the prefix escaped
+            std::vector<uint8_t> regex(1 + 2 * check.value.size(), '\\');
+            regex[0] = '^';
+
+            for (size_t j = 0; j < check.value.size(); ++j)
+            {
+                regex[2 + 2 * j] = check.value.data()[j];
+            }
+
+            check.regex.reset(new regex_program());
+            check.regex->compile(&regex.front(), regex.size());
+        }
+    }
+}
+
+bool
+hyperdex :: unpack_in_check(const schema& sc,
+                            const attribute_check& check,
+                            std::vector<e::slice>* elems)
+{
+    elems->clear();
+
+    if (check.predicate != HYPERPREDICATE_IN ||
+        check.attr >= sc.attrs_sz ||
+        !validate_attribute_check(sc, check))
+    {
+        return false;
+    }
+
+    datatype_info* di_attr = datatype_info::lookup(sc.attrs[check.attr].type);
+    const uint8_t* ptr = check.value.data();
+    const uint8_t* end = ptr + check.value.size();
+    e::slice elem;
+
+    while (ptr < end)
+    {
+        if (!di_attr->step(&ptr, end, &elem))
+        {
+            return false;
+        }
+
+        elems->push_back(elem);
+    }
+
+    return true;
+}
+
 size_t
 hyperdex :: passes_attribute_checks(const schema& sc,
                                     const std::vector<hyperdex::attribute_check>& checks,
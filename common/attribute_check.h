@@ -28,12 +28,17 @@
 #ifndef hyperdex_common_attribute_check_h_
 #define hyperdex_common_attribute_check_h_
 
+// STL
+#include <tr1/memory>
+#include <vector>
+
 // e
 #include <e/slice.h>
 
 // HyperDex
 #include "namespace.h"
 #include "hyperdex.h"
+#include "common/regex_match.h"
 #include "common/schema.h"
 
 BEGIN_HYPERDEX_NAMESPACE
@@ -49,6 +54,10 @@ class attribute_check
         e::slice value;
         hyperdatatype datatype;
         hyperpredicate predicate;
+        // the compiled form of a HYPERPREDICATE_REGEX value, or of the
+        // anchored literal a HYPERPREDICATE_PREFIX value stands for; copies of
+        // the check share it
+        std::tr1::shared_ptr<regex_program> regex;
 };
 
 bool
@@ -59,11 +68,24 @@ size_t
 validate_attribute_checks(const schema& sc,
                           const std::vector<hyperdex::attribute_check>& checks);
 
+// compile every regex and prefix check once so that evaluating it against many
+// objects does not reparse the pattern, and so that range_searches may turn
+// its literal prefix into a range
+void
+compile_attribute_checks(std::vector<hyperdex::attribute_check>* checks);
+
 bool
 passes_attribute_check(const schema& sc,
                        const attribute_check& chk,
                        const e::slice& value);
 
+// the candidates of a HYPERPREDICATE_IN check, each encoded as a value of the
+// attribute; false if the check is not a valid IN-list
+bool
+unpack_in_check(const schema& sc,
+                const attribute_check& chk,
+                std::vector<e::slice>* elems);
+
 size_t
 passes_attribute_checks(const schema& sc,
                         const std::vector<hyperdex::attribute_check>& checks,
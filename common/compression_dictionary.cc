@@ -0,0 +1,359 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <cstring>
+
+// STL
+#include <algorithm>
+#include <tr1/unordered_map>
+#include <tr1/unordered_set>
+
+// HyperDex
+#include "common/compression_dictionary.h"
+
+// Matches shorter than this are emitted as literals
+#define MIN_MATCH 4
+// Hash tables index this many bits of each four-byte sequence's hash
+#define DICT_HASH_BITS 14
+#define INPUT_HASH_BITS 10
+// Training scores segments of this many bytes by their substrings of
+// TRAIN_KMER bytes
+#define TRAIN_SEGMENT 64
+#define TRAIN_KMER 8
+
+using hyperdex::compression_dictionary;
+
+static inline uint32_t
+read32(const uint8_t* ptr)
+{
+    uint32_t x;
+    memmove(&x, ptr, sizeof(x));
+    return x;
+}
+
+static inline uint64_t
+read64(const uint8_t* ptr)
+{
+    uint64_t x;
+    memmove(&x, ptr, sizeof(x));
+    return x;
+}
+
+static inline uint32_t
+hash4(const uint8_t* ptr, unsigned bits)
+{
+    return (read32(ptr) * 2654435761U) >> (32 - bits);
+}
+
+static void
+append_varint(uint64_t x, std::string* out)
+{
+    while (x >= 0x80)
+    {
+        out->push_back(static_cast<char>((x & 0x7f) | 0x80));
+        x >>= 7;
+    }
+
+    out->push_back(static_cast<char>(x));
+}
+
+static bool
+read_varint(const uint8_t** ptr, const uint8_t* end, uint64_t* x)
+{
+    *x = 0;
+
+    for (unsigned shift = 0; *ptr < end && shift < 64; shift += 7)
+    {
+        uint8_t b = **ptr;
+        ++*ptr;
+        *x |= static_cast<uint64_t>(b & 0x7f) << shift;
+
+        if (!(b & 0x80))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static size_t
+match_length(const uint8_t* a, const uint8_t* a_end,
+             const uint8_t* b, const uint8_t* b_end)
+{
+    size_t n = 0;
+
+    while (a + n < a_end && b + n < b_end && a[n] == b[n])
+    {
+        ++n;
+    }
+
+    return n;
+}
+
+compression_dictionary :: compression_dictionary()
+    : m_dict()
+    , m_table()
+{
+    index();
+}
+
+compression_dictionary :: ~compression_dictionary() throw ()
+{
+}
+
+void
+compression_dictionary :: train(const std::vector<std::string>& samples, size_t dict_sz)
+{
+    // the number of samples in which each k-mer occurs
+    std::tr1::unordered_map<uint64_t, uint32_t> freq;
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        const uint8_t* s = reinterpret_cast<const uint8_t*>(samples[i].data());
+        std::tr1::unordered_set<uint64_t> seen;
+
+        for (size_t j = 0; j + TRAIN_KMER <= samples[i].size(); ++j)
+        {
+            seen.insert(read64(s + j));
+        }
+
+        for (std::tr1::unordered_set<uint64_t>::iterator it = seen.begin(); it != seen.end(); ++it)
+        {
+            ++freq[*it];
+        }
+    }
+
+    // candidate segments start every half segment of every sample
+    std::vector<std::pair<size_t, size_t> > candidates;
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        for (size_t j = 0; j + TRAIN_KMER <= samples[i].size(); j += TRAIN_SEGMENT / 2)
+        {
+            candidates.push_back(std::make_pair(i, j));
+        }
+    }
+
+    // greedily take the segment whose k-mers are shared by the most samples,
+    // then forget those k-mers so that the next pick covers new ones
+    std::vector<std::string> picked;
+    size_t picked_sz = 0;
+
+    while (picked_sz < dict_sz)
+    {
+        uint64_t best_score = 0;
+        size_t best = 0;
+
+        for (size_t c = 0; c < candidates.size(); ++c)
+        {
+            const std::string& s(samples[candidates[c].first]);
+            const uint8_t* ptr = reinterpret_cast<const uint8_t*>(s.data());
+            size_t end = std::min(s.size(), candidates[c].second + TRAIN_SEGMENT);
+            uint64_t score = 0;
+
+            for (size_t j = candidates[c].second; j + TRAIN_KMER <= end; ++j)
+            {
+                std::tr1::unordered_map<uint64_t, uint32_t>::iterator it = freq.find(read64(ptr + j));
+
+                if (it != freq.end() && it->second > 1)
+                {
+                    score += it->second;
+                }
+            }
+
+            if (score > best_score)
+            {
+                best_score = score;
+                best = c;
+            }
+        }
+
+        if (best_score == 0)
+        {
+            break;
+        }
+
+        const std::string& s(samples[candidates[best].first]);
+        size_t start = candidates[best].second;
+        size_t end = std::min(s.size(), start + TRAIN_SEGMENT);
+        end = std::min(end, start + dict_sz - picked_sz);
+        const uint8_t* ptr = reinterpret_cast<const uint8_t*>(s.data());
+
+        for (size_t j = start; j + TRAIN_KMER <= end; ++j)
+        {
+            freq.erase(read64(ptr + j));
+        }
+
+        picked.push_back(s.substr(start, end - start));
+        picked_sz += end - start;
+    }
+
+    // the most useful segments go last, nearest the data, for short offsets
+    m_dict.clear();
+
+    for (size_t i = picked.size(); i > 0; --i)
+    {
+        m_dict += picked[i - 1];
+    }
+
+    index();
+}
+
+void
+compression_dictionary :: load(const std::string& contents)
+{
+    m_dict = contents;
+    index();
+}
+
+void
+compression_dictionary :: compress(const uint8_t* data, size_t data_sz, std::string* out) const
+{
+    const uint8_t* dict = reinterpret_cast<const uint8_t*>(m_dict.data());
+    const uint8_t* dict_end = dict + m_dict.size();
+    const uint8_t* end = data + data_sz;
+    std::vector<uint32_t> table(1U << INPUT_HASH_BITS, 0);
+    size_t lit = 0;
+    size_t i = 0;
+    out->clear();
+
+    while (i + MIN_MATCH <= data_sz)
+    {
+        const uint8_t* p = data + i;
+        size_t best_len = 0;
+        size_t best_dist = 0;
+        uint32_t d = m_table[hash4(p, DICT_HASH_BITS)];
+
+        if (d > 0)
+        {
+            size_t len = match_length(dict + d - 1, dict_end, p, end);
+
+            if (len >= MIN_MATCH)
+            {
+                best_len = len;
+                best_dist = m_dict.size() - (d - 1) + i;
+            }
+        }
+
+        uint32_t* slot = &table[hash4(p, INPUT_HASH_BITS)];
+
+        if (*slot > 0)
+        {
+            size_t len = match_length(data + *slot - 1, end, p, end);
+
+            if (len >= MIN_MATCH && len > best_len)
+            {
+                best_len = len;
+                best_dist = i - (*slot - 1);
+            }
+        }
+
+        *slot = i + 1;
+
+        if (best_len == 0)
+        {
+            ++i;
+            ++lit;
+            continue;
+        }
+
+        append_varint(lit, out);
+        out->append(reinterpret_cast<const char*>(p - lit), lit);
+        append_varint(best_dist, out);
+        append_varint(best_len - MIN_MATCH, out);
+        i += best_len;
+        lit = 0;
+    }
+
+    lit += data_sz - i;
+    append_varint(lit, out);
+    out->append(reinterpret_cast<const char*>(end - lit), lit);
+}
+
+bool
+compression_dictionary :: decompress(const uint8_t* data, size_t data_sz,
+                                     size_t raw_sz, std::string* out) const
+{
+    const uint8_t* ptr = data;
+    const uint8_t* end = data + data_sz;
+    out->clear();
+    out->reserve(raw_sz);
+
+    while (true)
+    {
+        uint64_t lit;
+
+        if (!read_varint(&ptr, end, &lit) ||
+            lit > static_cast<uint64_t>(end - ptr) ||
+            lit > raw_sz - out->size())
+        {
+            return false;
+        }
+
+        out->append(reinterpret_cast<const char*>(ptr), lit);
+        ptr += lit;
+
+        if (out->size() == raw_sz)
+        {
+            return ptr == end;
+        }
+
+        uint64_t dist;
+        uint64_t len;
+
+        if (!read_varint(&ptr, end, &dist) ||
+            !read_varint(&ptr, end, &len) ||
+            dist == 0 || dist > m_dict.size() + out->size() ||
+            len > raw_sz || len + MIN_MATCH > raw_sz - out->size())
+        {
+            return false;
+        }
+
+        len += MIN_MATCH;
+        // a position in the dictionary followed by the output so far
+        size_t pos = m_dict.size() + out->size() - dist;
+
+        for (size_t j = 0; j < len; ++j, ++pos)
+        {
+            out->push_back(pos < m_dict.size() ? m_dict[pos] : (*out)[pos - m_dict.size()]);
+        }
+    }
+}
+
+void
+compression_dictionary :: index()
+{
+    m_table.assign(1U << DICT_HASH_BITS, 0);
+    const uint8_t* dict = reinterpret_cast<const uint8_t*>(m_dict.data());
+
+    for (size_t i = 0; i + MIN_MATCH <= m_dict.size(); ++i)
+    {
+        m_table[hash4(dict + i, DICT_HASH_BITS)] = i + 1;
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_common_compression_dictionary_h_
+#define hyperdex_common_compression_dictionary_h_
+
+// C
+#include <cstdlib>
+#include <stdint.h>
+
+// STL
+#include <string>
+#include <vector>
+
+// HyperDex
+#include "namespace.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// An LZ77 compressor whose history starts out holding a dictionary of byte
+// strings common to the inputs, so that even inputs of a few dozen bytes can
+// be encoded as references to it.  Dictionaries are trained from samples by
+// keeping the segments whose 8-byte substrings recur across the most samples.
+class compression_dictionary
+{
+    public:
+        compression_dictionary();
+        ~compression_dictionary() throw ();
+
+    public:
+        // replace the dictionary with one of at most dict_sz bytes trained
+        // from samples
+        void train(const std::vector<std::string>& samples, size_t dict_sz);
+        // replace the dictionary with a previously trained one
+        void load(const std::string& contents);
+        const std::string& contents() const { return m_dict; }
+        void compress(const uint8_t* data, size_t data_sz, std::string* out) const;
+        // false if data is not the compression of exactly raw_sz bytes
+        bool decompress(const uint8_t* data, size_t data_sz,
+                        size_t raw_sz, std::string* out) const;
+
+    private:
+        void index();
+
+    private:
+        std::string m_dict;
+        // the last position + 1 of the dictionary at which each hash of four
+        // bytes occurs, or 0
+        std::vector<uint32_t> m_table;
+
+    private:
+        compression_dictionary(const compression_dictionary&);
+        compression_dictionary& operator = (const compression_dictionary&);
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_compression_dictionary_h_
@@ -43,6 +43,7 @@ using hyperdex::region_id;
 using hyperdex::schema;
 using hyperdex::server;
 using hyperdex::server_id;
+using hyperdex::space_id;
 using hyperdex::subspace;
 using hyperdex::subspace_id;
 using hyperdex::virtual_server_id;
@@ -55,6 +56,7 @@ configuration :: configuration()
     , m_server_ids_by_virtual()
     , m_schemas_by_region()
     , m_subspaces_by_region()
+    , m_space_ids_by_region()
     , m_subspace_ids_by_region()
     , m_subspace_ids_for_prev()
     , m_subspace_ids_for_next()
@@ -62,6 +64,8 @@ configuration :: configuration()
     , m_tails_by_region()
     , m_next_by_virtual()
     , m_point_leaders_by_virtual()
+    , m_key_subspace_ids_by_region()
+    , m_point_leaders_by_hash()
     , m_spaces()
     , m_transfers()
 {
@@ -76,6 +80,7 @@ configuration :: configuration(const configuration& other)
     , m_server_ids_by_virtual(other.m_server_ids_by_virtual)
     , m_schemas_by_region(other.m_schemas_by_region)
     , m_subspaces_by_region(other.m_subspaces_by_region)
+    , m_space_ids_by_region(other.m_space_ids_by_region)
     , m_subspace_ids_by_region(other.m_subspace_ids_by_region)
     , m_subspace_ids_for_prev(other.m_subspace_ids_for_prev)
     , m_subspace_ids_for_next(other.m_subspace_ids_for_next)
@@ -83,6 +88,8 @@ configuration :: configuration(const configuration& other)
     , m_tails_by_region(other.m_tails_by_region)
     , m_next_by_virtual(other.m_next_by_virtual)
     , m_point_leaders_by_virtual(other.m_point_leaders_by_virtual)
+    , m_key_subspace_ids_by_region(other.m_key_subspace_ids_by_region)
+    , m_point_leaders_by_hash(other.m_point_leaders_by_hash)
     , m_spaces(other.m_spaces)
     , m_transfers(other.m_transfers)
 {
@@ -273,6 +280,22 @@ configuration :: get_virtual(const region_id& ri, const server_id& si) const
     return virtual_server_id();
 }
 
+space_id
+configuration :: space_of(const region_id& ri) const
+{
+    std::vector<pair_uint64_t>::const_iterator it;
+    it = std::lower_bound(m_space_ids_by_region.begin(),
+                          m_space_ids_by_region.end(),
+                          pair_uint64_t(ri.get(), 0));
+
+    if (it != m_space_ids_by_region.end() && it->first == ri.get())
+    {
+        return space_id(it->second);
+    }
+
+    return space_id();
+}
+
 subspace_id
 configuration :: subspace_of(const region_id& ri) const
 {
@@ -448,40 +471,35 @@ configuration :: point_leader(const char* sname, const e::slice& key) const
 virtual_server_id
 configuration :: point_leader(const region_id& rid, const e::slice& key) const
 {
-    for (size_t s = 0; s < m_spaces.size(); ++s)
-    {
-        for (size_t ss = 0; ss < m_spaces[s].subspaces.size(); ++ss)
-        {
-            for (size_t r = 0; r < m_spaces[s].subspaces[ss].regions.size(); ++r)
-            {
-                if (m_spaces[s].subspaces[ss].regions[r].id != rid)
-                {
-                    continue;
-                }
+    std::vector<pair_uint64_t>::const_iterator ks;
+    ks = std::lower_bound(m_key_subspace_ids_by_region.begin(),
+                          m_key_subspace_ids_by_region.end(),
+                          pair_uint64_t(rid.get(), 0));
 
-                uint64_t h;
-                hash(m_spaces[s].sc, key, &h);
+    if (ks == m_key_subspace_ids_by_region.end() || ks->first != rid.get())
+    {
+        return virtual_server_id();
+    }
 
-                for (size_t pl = 0; pl < m_spaces[s].subspaces[0].regions.size(); ++pl)
-                {
-                    if (m_spaces[s].subspaces[0].regions[pl].lower_coord[0] <= h &&
-                        h <= m_spaces[s].subspaces[0].regions[pl].upper_coord[0])
-                    {
-                        if (m_spaces[s].subspaces[0].regions[pl].replicas.empty())
-                        {
-                            return virtual_server_id();
-                        }
+    const schema* sc = get_schema(rid);
+    assert(sc);
+    uint64_t h;
+    hash(*sc, key, &h);
 
-                        return m_spaces[s].subspaces[0].regions[pl].replicas[0].vsi;
-                    }
-                }
+    // the regions of the key subspace partition the hash space, so the point
+    // leader is the last region whose lower bound does not exceed h
+    std::vector<point_leader_t>::const_iterator pl;
+    pl = std::upper_bound(m_point_leaders_by_hash.begin(),
+                          m_point_leaders_by_hash.end(),
+                          point_leader_t(pair_uint64_t(ks->second, h), UINT64_MAX));
 
-                abort();
-            }
-        }
+    if (pl == m_point_leaders_by_hash.begin() ||
+        (pl - 1)->first.first != ks->second)
+    {
+        abort();
     }
 
-    return virtual_server_id();
+    return virtual_server_id((pl - 1)->second);
 }
 
 bool
@@ -678,6 +696,34 @@ configuration :: lookup_search(const char* space_name,
         }
     }
 
+    // the hashes of the candidates of each IN-list; a region must hold at
+    // least one of them
+    std::vector<std::pair<uint16_t, std::vector<uint64_t> > > in_lists;
+
+    for (size_t i = 0; i < chks.size(); ++i)
+    {
+        std::vector<e::slice> elems;
+
+        if (!unpack_in_check(s->sc, chks[i], &elems))
+        {
+            continue;
+        }
+
+        // an empty IN-list admits no object
+        if (elems.empty())
+        {
+            servers->clear();
+            return;
+        }
+
+        in_lists.push_back(std::make_pair(chks[i].attr, std::vector<uint64_t>()));
+
+        for (size_t j = 0; j < elems.size(); ++j)
+        {
+            in_lists.back().second.push_back(hash(s->sc.attrs[chks[i].attr].type, elems[j]));
+        }
+    }
+
     bool initialized = false;
     std::vector<virtual_server_id> smallest_server_set;
 
@@ -760,6 +806,25 @@ configuration :: lookup_search(const char* space_name,
                 }
             }
 
+            for (size_t k = 0; !exclude && k < in_lists.size(); ++k)
+            {
+                const std::vector<uint16_t>& attrs(s->subspaces[i].attrs);
+                size_t attr = std::find(attrs.begin(), attrs.end(), in_lists[k].first) - attrs.begin();
+
+                if (attr >= attrs.size() || attr >= reg.lower_coord.size())
+                {
+                    continue;
+                }
+
+                exclude = true;
+
+                for (size_t l = 0; exclude && l < in_lists[k].second.size(); ++l)
+                {
+                    uint64_t h = in_lists[k].second[l];
+                    exclude = h < reg.lower_coord[attr] || h > reg.upper_coord[attr];
+                }
+            }
+
             if (!exclude)
             {
                 this_server_set.push_back(reg.replicas.back().vsi);
@@ -884,6 +949,7 @@ configuration :: operator = (const configuration& rhs)
     m_server_ids_by_virtual = rhs.m_server_ids_by_virtual;
     m_schemas_by_region = rhs.m_schemas_by_region;
     m_subspaces_by_region = rhs.m_subspaces_by_region;
+    m_space_ids_by_region = rhs.m_space_ids_by_region;
     m_subspace_ids_by_region = rhs.m_subspace_ids_by_region;
     m_subspace_ids_for_prev = rhs.m_subspace_ids_for_prev;
     m_subspace_ids_for_next = rhs.m_subspace_ids_for_next;
@@ -891,6 +957,8 @@ configuration :: operator = (const configuration& rhs)
     m_tails_by_region = rhs.m_tails_by_region;
     m_next_by_virtual = rhs.m_next_by_virtual;
     m_point_leaders_by_virtual = rhs.m_point_leaders_by_virtual;
+    m_key_subspace_ids_by_region = rhs.m_key_subspace_ids_by_region;
+    m_point_leaders_by_hash = rhs.m_point_leaders_by_hash;
     m_spaces = rhs.m_spaces;
     m_transfers = rhs.m_transfers;
     refill_cache();
@@ -904,6 +972,7 @@ configuration :: refill_cache()
     m_server_ids_by_virtual.clear();
     m_schemas_by_region.clear();
     m_subspaces_by_region.clear();
+    m_space_ids_by_region.clear();
     m_subspace_ids_by_region.clear();
     m_subspace_ids_for_prev.clear();
     m_subspace_ids_for_next.clear();
@@ -911,6 +980,8 @@ configuration :: refill_cache()
     m_tails_by_region.clear();
     m_next_by_virtual.clear();
     m_point_leaders_by_virtual.clear();
+    m_key_subspace_ids_by_region.clear();
+    m_point_leaders_by_hash.clear();
 
     for (size_t w = 0; w < m_spaces.size(); ++w)
     {
@@ -937,7 +1008,15 @@ configuration :: refill_cache()
                 region& r(ss.regions[y]);
                 m_schemas_by_region.push_back(std::make_pair(r.id.get(), &s.sc));
                 m_subspaces_by_region.push_back(std::make_pair(r.id.get(), &ss));
+                m_space_ids_by_region.push_back(std::make_pair(r.id.get(), s.id.get()));
                 m_subspace_ids_by_region.push_back(std::make_pair(r.id.get(), ss.id.get()));
+                m_key_subspace_ids_by_region.push_back(std::make_pair(r.id.get(), s.subspaces[0].id.get()));
+
+                if (x == 0)
+                {
+                    uint64_t vsi = r.replicas.empty() ? 0 : r.replicas[0].vsi.get();
+                    m_point_leaders_by_hash.push_back(std::make_pair(std::make_pair(ss.id.get(), r.lower_coord[0]), vsi));
+                }
 
                 if (r.replicas.empty())
                 {
@@ -983,6 +1062,7 @@ configuration :: refill_cache()
     std::sort(m_server_ids_by_virtual.begin(), m_server_ids_by_virtual.end());
     std::sort(m_schemas_by_region.begin(), m_schemas_by_region.end());
     std::sort(m_subspaces_by_region.begin(), m_subspaces_by_region.end());
+    std::sort(m_space_ids_by_region.begin(), m_space_ids_by_region.end());
     std::sort(m_subspace_ids_by_region.begin(), m_subspace_ids_by_region.end());
     std::sort(m_subspace_ids_for_prev.begin(), m_subspace_ids_for_prev.end());
     std::sort(m_subspace_ids_for_next.begin(), m_subspace_ids_for_next.end());
@@ -990,6 +1070,8 @@ configuration :: refill_cache()
     std::sort(m_tails_by_region.begin(), m_tails_by_region.end());
     std::sort(m_next_by_virtual.begin(), m_next_by_virtual.end());
     std::sort(m_point_leaders_by_virtual.begin(), m_point_leaders_by_virtual.end());
+    std::sort(m_key_subspace_ids_by_region.begin(), m_key_subspace_ids_by_region.end());
+    std::sort(m_point_leaders_by_hash.begin(), m_point_leaders_by_hash.end());
 }
 
 e::unpacker
@@ -1031,6 +1113,12 @@ hyperdex :: operator >> (e::unpacker up, configuration& c)
         c.m_transfers.push_back(xfer);
     }
 
+    // one block per space, absent when the coordinator predates them
+    for (size_t i = 0; !up.error() && up.remain() && i < c.m_spaces.size(); ++i)
+    {
+        up = unpack_index_extensions(up, &c.m_spaces[i]);
+    }
+
     c.refill_cache();
     return up;
 }
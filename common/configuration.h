@@ -77,6 +77,7 @@ class configuration
         const schema* get_schema(const region_id& ri) const;
         const subspace* get_subspace(const region_id& ri) const;
         virtual_server_id get_virtual(const region_id& ri, const server_id& si) const;
+        space_id space_of(const region_id& ri) const;
         subspace_id subspace_of(const region_id& ri) const;
         subspace_id subspace_prev(const subspace_id& ss) const;
         subspace_id subspace_next(const subspace_id& ss) const;
@@ -134,6 +135,8 @@ class configuration
         typedef std::pair<uint64_t, schema*> uint64_schema_t;
         typedef std::pair<uint64_t, subspace*> uint64_subspace_t;
         typedef std::pair<uint64_t, po6::net::location> uint64_location_t;
+        // ((key subspace, lower hash bound), point leader)
+        typedef std::pair<pair_uint64_t, uint64_t> point_leader_t;
 
     private:
         uint64_t m_cluster;
@@ -143,6 +146,7 @@ class configuration
         std::vector<pair_uint64_t> m_server_ids_by_virtual;
         std::vector<uint64_schema_t> m_schemas_by_region;
         std::vector<uint64_subspace_t> m_subspaces_by_region;
+        std::vector<pair_uint64_t> m_space_ids_by_region;
         std::vector<pair_uint64_t> m_subspace_ids_by_region;
         std::vector<pair_uint64_t> m_subspace_ids_for_prev;
         std::vector<pair_uint64_t> m_subspace_ids_for_next;
@@ -150,6 +154,8 @@ class configuration
         std::vector<pair_uint64_t> m_tails_by_region;
         std::vector<pair_uint64_t> m_next_by_virtual;
         std::vector<uint64_t> m_point_leaders_by_virtual;
+        std::vector<pair_uint64_t> m_key_subspace_ids_by_region;
+        std::vector<point_leader_t> m_point_leaders_by_hash;
         std::vector<space> m_spaces;
         std::vector<transfer> m_transfers;
 };
@@ -165,10 +165,10 @@ datatype_string :: has_regex()
 }
 
 bool
-datatype_string :: regex(const e::slice& r,
+datatype_string :: regex(const regex_program& r,
                          const e::slice& v)
 {
-    return regex_match(r.data(), r.size(), v.data(), v.size());
+    return r.match(v.data(), v.size());
 }
 
 bool
@@ -57,7 +57,7 @@ class datatype_string : public datatype_info
         virtual bool has_length();
         virtual uint64_t length(const e::slice& value);
         virtual bool has_regex();
-        virtual bool regex(const e::slice& regex,
+        virtual bool regex(const regex_program& regex,
                            const e::slice& value);
         virtual bool containable();
         virtual bool step(const uint8_t** ptr,
@@ -159,7 +159,7 @@ datatype_info :: has_regex()
 }
 
 bool
-datatype_info :: regex(const e::slice&,
+datatype_info :: regex(const regex_program&,
                        const e::slice&)
 {
     // if you see an abort here, you overrode "has_regex", but not this method
@@ -38,6 +38,7 @@
 #include "common/ids.h"
 
 BEGIN_HYPERDEX_NAMESPACE
+class regex_program;
 
 class datatype_info
 {
@@ -74,7 +75,7 @@ class datatype_info
     // override these if the type can be matched with regexes
     public:
         virtual bool has_regex();
-        virtual bool regex(const e::slice& regex,
+        virtual bool regex(const regex_program& regex,
                            const e::slice& value);
 
     // override thes if the type can be matched with "contains"
@@ -84,6 +84,8 @@ operator << (std::ostream& lhs, hyperpredicate rhs)
         STRINGIFY(HYPERPREDICATE_LENGTH_LESS_EQUAL);
         STRINGIFY(HYPERPREDICATE_LENGTH_GREATER_EQUAL);
         STRINGIFY(HYPERPREDICATE_CONTAINS);
+        STRINGIFY(HYPERPREDICATE_PREFIX);
+        STRINGIFY(HYPERPREDICATE_IN);
         default:
             lhs << "unknown hyperpredicate";
             break;
@@ -117,6 +117,43 @@ space :: validate() const
                 }
             }
         }
+
+        for (size_t j = 0; j < subspaces[i].covering.size(); ++j)
+        {
+            if (subspaces[i].covering[j] == 0 ||
+                subspaces[i].covering[j] >= sc.attrs_sz)
+            {
+                return false;
+            }
+        }
+
+        // composite entries are tagged with numbers following the attributes
+        if (sc.attrs_sz + subspaces[i].composites.size() > 65536)
+        {
+            return false;
+        }
+
+        for (size_t j = 0; j < subspaces[i].composites.size(); ++j)
+        {
+            const std::vector<uint16_t>& composite(subspaces[i].composites[j]);
+
+            if (composite.size() < 2)
+            {
+                return false;
+            }
+
+            for (size_t k = 0; k < composite.size(); ++k)
+            {
+                if (composite[k] == 0 ||
+                    composite[k] >= sc.attrs_sz ||
+                    (sc.attrs[composite[k]].type != HYPERDATATYPE_STRING &&
+                     sc.attrs[composite[k]].type != HYPERDATATYPE_INT64 &&
+                     sc.attrs[composite[k]].type != HYPERDATATYPE_FLOAT))
+                {
+                    return false;
+                }
+            }
+        }
     }
 
     return true;
@@ -268,6 +305,8 @@ subspace :: subspace()
     : id()
     , attrs()
     , indices()
+    , covering()
+    , composites()
     , regions()
 {
 }
@@ -276,6 +315,8 @@ subspace :: subspace(const subspace& other)
     : id(other.id)
     , attrs(other.attrs)
     , indices(other.indices)
+    , covering(other.covering)
+    , composites(other.composites)
     , regions(other.regions)
 {
 }
@@ -306,12 +347,33 @@ subspace :: indexed(uint16_t attr) const
     return false;
 }
 
+bool
+subspace :: covers(uint16_t attr) const
+{
+    if (attr == 0)
+    {
+        return true;
+    }
+
+    for (size_t i = 0; i < covering.size(); ++i)
+    {
+        if (covering[i] == attr)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 subspace&
 subspace :: operator = (const subspace& rhs)
 {
     id = rhs.id;
     attrs = rhs.attrs;
     indices = rhs.indices;
+    covering = rhs.covering;
+    composites = rhs.composites;
     regions = rhs.regions;
     return *this;
 }
@@ -353,6 +415,8 @@ hyperdex :: operator >> (e::unpacker up, subspace& s)
     s.id = subspace_id(id);
     s.attrs.clear();
     s.indices.clear();
+    s.covering.clear();
+    s.composites.clear();
     s.regions.resize(num_regions);
 
     for (size_t i = 0; !up.error() && i < num_attrs; ++i)
@@ -395,6 +459,138 @@ hyperdex :: pack_size(const subspace& s)
     return sz;
 }
 
+// The block is a length, a version, and then per subspace the covering
+// attributes and composite indices.  Later versions only append, so a reader
+// takes the fields it knows and skips the rest of the block.
+#define INDEX_EXTENSIONS_VERSION 1
+
+static size_t
+index_extensions_block_size(const space& s)
+{
+    size_t sz = sizeof(uint8_t) /* version */
+              + sizeof(uint16_t); /* num_subspaces */
+
+    for (size_t i = 0; i < s.subspaces.size(); ++i)
+    {
+        const subspace& ss(s.subspaces[i]);
+        sz += sizeof(uint16_t) /* covering.size() */
+            + sizeof(uint16_t) * ss.covering.size() /* covering */
+            + sizeof(uint16_t); /* composites.size() */
+
+        for (size_t j = 0; j < ss.composites.size(); ++j)
+        {
+            sz += sizeof(uint16_t) + sizeof(uint16_t) * ss.composites[j].size();
+        }
+    }
+
+    return sz;
+}
+
+e::buffer::packer
+hyperdex :: pack_index_extensions(e::buffer::packer pa, const space& s)
+{
+    uint32_t block_sz = index_extensions_block_size(s);
+    uint8_t version = INDEX_EXTENSIONS_VERSION;
+    uint16_t num_subspaces = s.subspaces.size();
+    pa = pa << block_sz << version << num_subspaces;
+
+    for (size_t i = 0; i < num_subspaces; ++i)
+    {
+        const subspace& ss(s.subspaces[i]);
+        uint16_t num_covering = ss.covering.size();
+        uint16_t num_composites = ss.composites.size();
+        pa = pa << num_covering;
+
+        for (size_t j = 0; j < num_covering; ++j)
+        {
+            pa = pa << ss.covering[j];
+        }
+
+        pa = pa << num_composites;
+
+        for (size_t j = 0; j < num_composites; ++j)
+        {
+            uint16_t num_composite_attrs = ss.composites[j].size();
+            pa = pa << num_composite_attrs;
+
+            for (size_t k = 0; k < num_composite_attrs; ++k)
+            {
+                pa = pa << ss.composites[j][k];
+            }
+        }
+    }
+
+    return pa;
+}
+
+e::unpacker
+hyperdex :: unpack_index_extensions(e::unpacker up, space* s)
+{
+    e::slice block;
+    up = up >> block;
+
+    if (up.error())
+    {
+        return up;
+    }
+
+    e::unpacker bup(block);
+    uint8_t version;
+    uint16_t num_subspaces;
+    bup = bup >> version >> num_subspaces;
+
+    if (bup.error() || version < INDEX_EXTENSIONS_VERSION)
+    {
+        return up.as_error();
+    }
+
+    for (size_t i = 0; !bup.error() && i < num_subspaces; ++i)
+    {
+        std::vector<uint16_t> covering;
+        std::vector<std::vector<uint16_t> > composites;
+        uint16_t num_covering;
+        uint16_t num_composites;
+        bup = bup >> num_covering;
+
+        for (size_t j = 0; !bup.error() && j < num_covering; ++j)
+        {
+            uint16_t attr;
+            bup = bup >> attr;
+            covering.push_back(attr);
+        }
+
+        bup = bup >> num_composites;
+
+        for (size_t j = 0; !bup.error() && j < num_composites; ++j)
+        {
+            uint16_t num_composite_attrs;
+            bup = bup >> num_composite_attrs;
+            composites.push_back(std::vector<uint16_t>());
+
+            for (size_t k = 0; !bup.error() && k < num_composite_attrs; ++k)
+            {
+                uint16_t attr;
+                bup = bup >> attr;
+                composites.back().push_back(attr);
+            }
+        }
+
+        if (!bup.error() && i < s->subspaces.size())
+        {
+            s->subspaces[i].covering.swap(covering);
+            s->subspaces[i].composites.swap(composites);
+        }
+    }
+
+    return bup.error() ? up.as_error() : up;
+}
+
+size_t
+hyperdex :: pack_size_index_extensions(const space& s)
+{
+    return sizeof(uint32_t) + index_extensions_block_size(s);
+}
+
 region :: region()
     : id()
     , lower_coord()
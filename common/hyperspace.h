@@ -89,6 +89,16 @@ operator >> (e::unpacker, space& s);
 size_t
 pack_size(const space& s);
 
+// Covering attributes and composite indices postdate the space format.  They
+// travel in a separate, versioned block after everything that a reader which
+// predates them understands, and a reader treats a missing block as none.
+e::buffer::packer
+pack_index_extensions(e::buffer::packer, const space& s);
+e::unpacker
+unpack_index_extensions(e::unpacker, space* s);
+size_t
+pack_size_index_extensions(const space& s);
+
 class subspace
 {
     public:
@@ -98,6 +108,7 @@ class subspace
 
     public:
         bool indexed(uint16_t attr) const;
+        bool covers(uint16_t attr) const;
 
     public:
         subspace& operator = (const subspace&);
@@ -106,6 +117,12 @@ class subspace
         subspace_id id;
         std::vector<uint16_t> attrs;
         std::vector<uint16_t> indices;
+        // attributes whose values are stored in every primitive index entry
+        // so that searches touching only these attributes skip the object
+        std::vector<uint16_t> covering;
+        // indices over several attributes, ordered by the first attribute,
+        // then the second, and so on
+        std::vector<std::vector<uint16_t> > composites;
         std::vector<region> regions;
 };
 
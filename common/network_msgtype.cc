@@ -38,11 +38,13 @@ hyperdex :: operator << (std::ostream& lhs, const network_msgtype& rhs)
         STRINGIFY(RESP_GET);
         STRINGIFY(REQ_ATOMIC);
         STRINGIFY(RESP_ATOMIC);
+        STRINGIFY(REQ_ATOMIC_BATCH);
         STRINGIFY(REQ_SEARCH_START);
         STRINGIFY(REQ_SEARCH_NEXT);
         STRINGIFY(REQ_SEARCH_STOP);
         STRINGIFY(RESP_SEARCH_ITEM);
         STRINGIFY(RESP_SEARCH_DONE);
+        STRINGIFY(RESP_SEARCH_ERROR);
         STRINGIFY(REQ_SORTED_SEARCH);
         STRINGIFY(RESP_SORTED_SEARCH);
         STRINGIFY(REQ_GROUP_DEL);
@@ -51,6 +53,10 @@ hyperdex :: operator << (std::ostream& lhs, const network_msgtype& rhs)
         STRINGIFY(RESP_COUNT);
         STRINGIFY(REQ_SEARCH_DESCRIBE);
         STRINGIFY(RESP_SEARCH_DESCRIBE);
+        STRINGIFY(REQ_AGGREGATE);
+        STRINGIFY(RESP_AGGREGATE);
+        STRINGIFY(REQ_GROUP_ATOMIC);
+        STRINGIFY(RESP_GROUP_ATOMIC);
         STRINGIFY(CHAIN_OP);
         STRINGIFY(CHAIN_SUBSPACE);
         STRINGIFY(CHAIN_ACK);
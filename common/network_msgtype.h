@@ -43,12 +43,16 @@ enum network_msgtype
 
     REQ_ATOMIC      = 16,
     RESP_ATOMIC     = 17,
+    // sent between servers; one REQ_ATOMIC applied to many keys
+    REQ_ATOMIC_BATCH    = 18,
 
     REQ_SEARCH_START    = 32,
     REQ_SEARCH_NEXT     = 33,
     REQ_SEARCH_STOP     = 34,
     RESP_SEARCH_ITEM    = 35,
     RESP_SEARCH_DONE    = 36,
+    // the region refused the search or no longer holds it
+    RESP_SEARCH_ERROR   = 37,
 
     REQ_SORTED_SEARCH   = 40,
     RESP_SORTED_SEARCH  = 41,
@@ -62,6 +66,12 @@ enum network_msgtype
     REQ_SEARCH_DESCRIBE  = 52,
     RESP_SEARCH_DESCRIBE = 53,
 
+    REQ_AGGREGATE   = 54,
+    RESP_AGGREGATE  = 55,
+
+    REQ_GROUP_ATOMIC    = 56,
+    RESP_GROUP_ATOMIC   = 57,
+
     CHAIN_OP        = 64,
     CHAIN_SUBSPACE  = 65,
     CHAIN_ACK       = 66,
@@ -178,3 +178,74 @@ hyperdex :: ordered_encode_double(double x)
 #ifndef _MSC_VER
 #pragma GCC diagnostic pop
 #endif
+
+void
+hyperdex :: ordered_encode_escaped(const char* data, size_t sz, std::vector<char>* out)
+{
+    out->reserve(out->size() + sz + 2);
+
+    for (size_t i = 0; i < sz; ++i)
+    {
+        out->push_back(data[i]);
+
+        if (data[i] == '\x00')
+        {
+            out->push_back('\xff');
+        }
+    }
+
+    out->push_back('\x00');
+    out->push_back('\x01');
+}
+
+bool
+hyperdex :: ordered_escaped_size(const char* ptr, size_t sz, size_t* esc_sz)
+{
+    for (size_t i = 0; i + 1 < sz; ++i)
+    {
+        if (ptr[i] != '\x00')
+        {
+            continue;
+        }
+
+        if (ptr[i + 1] == '\x01')
+        {
+            *esc_sz = i + 2;
+            return true;
+        }
+
+        if (ptr[i + 1] != '\xff')
+        {
+            return false;
+        }
+
+        ++i;
+    }
+
+    return false;
+}
+
+bool
+hyperdex :: ordered_decode_escaped(const char* ptr, size_t sz, std::vector<char>* out)
+{
+    size_t esc_sz;
+
+    if (!ordered_escaped_size(ptr, sz, &esc_sz) || esc_sz != sz)
+    {
+        return false;
+    }
+
+    out->clear();
+
+    for (size_t i = 0; i + 2 < sz; ++i)
+    {
+        out->push_back(ptr[i]);
+
+        if (ptr[i] == '\x00')
+        {
+            ++i;
+        }
+    }
+
+    return true;
+}
@@ -29,8 +29,12 @@
 #define hyperdex_common_ordered_encoding_h_
 
 // C
+#include <stddef.h>
 #include <stdint.h>
 
+// STL
+#include <vector>
+
 // HyperDex
 #include "namespace.h"
 
@@ -48,6 +52,21 @@ ordered_decode_int64(uint64_t x);
 uint64_t
 ordered_encode_double(double x);
 
+// Append [data, data + sz) with each 0x00 escaped as 0x00 0xff and then the
+// terminator 0x00 0x01.  memcmp orders concatenations of escaped strings by
+// the first string, then the second, and so on.
+void
+ordered_encode_escaped(const char* data, size_t sz, std::vector<char>* out);
+
+// the size, terminator included, of the escaped string at the start of
+// [ptr, ptr + sz); false if it is not terminated
+bool
+ordered_escaped_size(const char* ptr, size_t sz, size_t* esc_sz);
+
+// undo ordered_encode_escaped for exactly one escaped string
+bool
+ordered_decode_escaped(const char* ptr, size_t sz, std::vector<char>* out);
+
 END_HYPERDEX_NAMESPACE
 
 #endif // hyperdex_common_ordered_encoding_h_
@@ -0,0 +1,64 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_common_projection_h_
+#define hyperdex_common_projection_h_
+
+// STL
+#include <vector>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "common/schema.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// A projection names the attributes a read should return.  The empty
+// projection returns every attribute.  Otherwise it is a strictly increasing
+// list of attribute numbers.  The key (attribute 0) may appear in the list,
+// but it never occupies a slot in the value.
+
+bool
+validate_projection(const schema& sc, const std::vector<uint16_t>& projection);
+
+// Drop the value's attributes that the projection does not name.
+void
+apply_projection(const std::vector<uint16_t>& projection,
+                 std::vector<e::slice>* value);
+
+// The attribute number of each slot in a value returned under projection.
+void
+projected_attrs(const schema& sc,
+                const std::vector<uint16_t>& projection,
+                std::vector<uint16_t>* attrs);
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_common_projection_h_
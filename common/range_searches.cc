@@ -42,9 +42,13 @@ using hyperdex::range;
 //  * HYPERPREDICATE_EQUAL
 //  * HYPERPREDICATE_LESS_EQUAL
 //  * HYPERPREDICATE_GREATER_EQUAL
-// will be used to construct the returned ranges.  If you break this assumption,
-// you will need to look at the way indices are picked in the data layer and the
-// way ranges are picked for hyperspace hashing.
+// will be used to construct exact ranges.  A compiled HYPERPREDICATE_REGEX
+// with a literal prefix, or a compiled HYPERPREDICATE_PREFIX, also yields a
+// range, but one that only bounds the matches (every string with the prefix,
+// and possibly the limit itself), so the data layer must never consider it to
+// cover the check.  If you break these assumptions, you will need to look at
+// the way indices are picked in the data layer and the way ranges are picked
+// for hyperspace hashing.
 static bool
 range_search(const attribute_check& check, range* r)
 {
@@ -75,9 +79,23 @@ range_search(const attribute_check& check, range* r)
             r->has_end = false;
             r->invalid = false;
             return true;
+        case HYPERPREDICATE_REGEX:
+        case HYPERPREDICATE_PREFIX:
+            if (!check.regex.get() || !check.regex->has_prefix())
+            {
+                return false;
+            }
+
+            r->attr = check.attr;
+            r->type = check.datatype;
+            r->start = check.regex->prefix();
+            r->end = check.regex->prefix_limit();
+            r->has_start = true;
+            r->has_end = !r->end.empty();
+            r->invalid = false;
+            return true;
         case HYPERPREDICATE_FAIL:
         case HYPERPREDICATE_CONTAINS_LESS_THAN:
-        case HYPERPREDICATE_REGEX:
         case HYPERPREDICATE_LENGTH_EQUALS:
         case HYPERPREDICATE_LENGTH_LESS_EQUAL:
         case HYPERPREDICATE_LENGTH_GREATER_EQUAL:
@@ -1,107 +1,323 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
 // C
 #include <cassert>
+#include <cstring>
+
+// STL
+#include <algorithm>
+#include <map>
 
 // HyperDex
 #include "common/regex_match.h"
 
-static bool
-anchored(const char* regex, const char* regex_end,
-         const char* text,  const char* text_end);
+// The most DFA states a pattern may compile to before falling back to
+// simulating the NFA
+#define REGEX_MAX_STATES 1024
 
-static bool
-starred(int c,
-        const char* regex, const char* regex_end,
-        const char* text,  const char* text_end);
+using hyperdex::regex_program;
 
-bool
-anchored(const char* regex, const char* regex_end,
-         const char* text,  const char* text_end)
+regex_program :: regex_program()
+    : m_items()
+    , m_anchor_start(false)
+    , m_anchor_end(false)
+    , m_class_byte()
+    , m_trans()
+    , m_accept()
+    , m_dead()
+    , m_prefix()
+    , m_prefix_limit()
+{
+    memset(m_class, 0, sizeof(m_class));
+}
+
+regex_program :: ~regex_program() throw ()
 {
-    assert(regex <= regex_end);
-    assert(text <= text_end);
+}
+
+void
+regex_program :: compile(const uint8_t* _regex, size_t regex_sz)
+{
+    const char* regex = reinterpret_cast<const char*>(_regex);
+    const char* regex_end = regex + regex_sz;
+    m_items.clear();
+    m_anchor_start = false;
+    m_anchor_end = false;
 
-    if (regex == regex_end)
+    if (regex < regex_end && *regex == '^')
     {
-        return true;
+        m_anchor_start = true;
+        ++regex;
     }
 
-    if (regex[0] == '\\')
+    while (regex < regex_end)
     {
-        if (regex + 1 < regex_end &&
-            text < text_end &&
-            regex[1] == text[0])
+        item it;
+
+        if (*regex == '\\')
+        {
+            // a trailing backslash escapes nothing and never matches
+            it.fail = regex + 1 == regex_end;
+            it.byte = it.fail ? 0 : regex[1];
+            regex += it.fail ? 1 : 2;
+        }
+        else if (regex + 1 < regex_end && regex[1] == '*')
+        {
+            it.any = *regex == '.';
+            it.byte = *regex;
+            it.star = true;
+            regex += 2;
+        }
+        else if (*regex == '$' && regex + 1 == regex_end)
         {
-            return anchored(regex + 2, regex_end, text + 1, text_end);
+            m_anchor_end = true;
+            ++regex;
+            continue;
         }
+        else
+        {
+            it.any = *regex == '.';
+            it.byte = *regex;
+            ++regex;
+        }
+
+        m_items.push_back(it);
+    }
+
+    // bytes that some item names get a class each; all others share class 0
+    memset(m_class, 0, sizeof(m_class));
+    m_class_byte.assign(1, 0);
 
-        return false;
+    for (size_t i = 0; i < m_items.size(); ++i)
+    {
+        const item& it(m_items[i]);
+
+        if (!it.any && !it.fail && m_class[it.byte] == 0)
+        {
+            m_class[it.byte] = m_class_byte.size();
+            m_class_byte.push_back(it.byte);
+        }
     }
 
-    if (regex + 1 < regex_end && regex[1] == '*')
+    // an anchored regex that starts with literals only matches strings that
+    // start with the same literals
+    m_prefix.clear();
+    m_prefix_limit.clear();
+
+    for (size_t i = 0; m_anchor_start && i < m_items.size(); ++i)
     {
-        return starred(regex[0], regex + 2, regex_end, text, text_end);
+        if (m_items[i].any || m_items[i].star || m_items[i].fail)
+        {
+            break;
+        }
+
+        m_prefix.push_back(m_items[i].byte);
     }
 
-    if (regex[0] == '$' && regex + 1 == regex_end)
+    m_prefix_limit = m_prefix;
+
+    while (!m_prefix_limit.empty() &&
+           static_cast<uint8_t>(m_prefix_limit[m_prefix_limit.size() - 1]) == 0xff)
     {
-        return text == text_end;
+        m_prefix_limit.resize(m_prefix_limit.size() - 1);
     }
 
-    if (text < text_end && (regex[0] == '.' || regex[0] == text[0]))
+    if (!m_prefix_limit.empty())
     {
-        return anchored(regex + 1, regex_end, text + 1, text_end);
+        ++m_prefix_limit[m_prefix_limit.size() - 1];
     }
 
-    return false;
+    if (!build_dfa())
+    {
+        m_trans.clear();
+        m_accept.clear();
+        m_dead.clear();
+    }
 }
 
 bool
-starred(int c,
-        const char* regex, const char* regex_end,
-        const char* text,  const char* text_end)
+regex_program :: match(const uint8_t* text, size_t text_sz) const
 {
-    for (; text <= text_end; ++text)
+    const uint8_t* const end = text + text_sz;
+
+    if (!m_trans.empty())
     {
-        if (anchored(regex, regex_end, text, text_end))
+        const size_t classes = m_class_byte.size();
+        uint32_t s = 0;
+
+        for (; text < end; ++text)
         {
-            return true;
+            if (m_accept[s] && !m_anchor_end)
+            {
+                return true;
+            }
+
+            s = m_trans[s * classes + m_class[*text]];
+
+            if (m_dead[s])
+            {
+                return false;
+            }
         }
 
-        if (text < text_end && *text != c && c != '.')
+        return m_accept[s];
+    }
+
+    state_set s(m_items.size() + 1, 0);
+    state_set t;
+    s[0] = 1;
+    closure(&s);
+
+    for (; text < end; ++text)
+    {
+        if (accepting(s) && !m_anchor_end)
         {
-            break;
+            return true;
         }
+
+        step(s, m_class[*text], &t);
+        s.swap(t);
     }
 
-    return false;
+    return accepting(s);
 }
 
-bool
-hyperdex :: regex_match(const uint8_t* _regex, size_t regex_sz,
-                        const uint8_t* _text, size_t text_sz)
+e::slice
+regex_program :: prefix() const
 {
-    const char* regex = reinterpret_cast<const char*>(_regex);
-    const char* text  = reinterpret_cast<const char*>(_text);
-    const char* regex_end = regex + regex_sz;
-    const char* text_end  = text + text_sz;
+    return e::slice(m_prefix.data(), m_prefix.size());
+}
 
-    if (regex_sz == 0)
+e::slice
+regex_program :: prefix_limit() const
+{
+    return e::slice(m_prefix_limit.data(), m_prefix_limit.size());
+}
+
+void
+regex_program :: closure(state_set* s) const
+{
+    // a starred item may match nothing, so being before it is being after it
+    for (size_t i = 0; i < m_items.size(); ++i)
     {
-        return true;
+        if ((*s)[i] && m_items[i].star)
+        {
+            (*s)[i + 1] = 1;
+        }
+    }
+}
+
+void
+regex_program :: step(const state_set& s, unsigned cls, state_set* t) const
+{
+    t->assign(m_items.size() + 1, 0);
+
+    for (size_t i = 0; i < m_items.size(); ++i)
+    {
+        const item& it(m_items[i]);
+
+        if (!s[i] || it.fail ||
+            (!it.any && (cls == 0 || m_class_byte[cls] != it.byte)))
+        {
+            continue;
+        }
+
+        (*t)[it.star ? i : i + 1] = 1;
     }
 
-    if (regex[0] == '^')
+    // an unanchored regex may begin matching at any byte
+    if (!m_anchor_start)
     {
-        return anchored(regex + 1, regex_end, text, text_end);
+        (*t)[0] = 1;
     }
 
-    for (; text <= text_end; ++text)
+    closure(t);
+}
+
+bool
+regex_program :: accepting(const state_set& s) const
+{
+    return s[m_items.size()];
+}
+
+bool
+regex_program :: build_dfa()
+{
+    const size_t classes = m_class_byte.size();
+    std::vector<state_set> states;
+    std::map<state_set, uint32_t> ids;
+    m_trans.clear();
+    m_accept.clear();
+    m_dead.clear();
+
+    state_set init(m_items.size() + 1, 0);
+    init[0] = 1;
+    closure(&init);
+    states.push_back(init);
+    ids[init] = 0;
+    state_set t;
+
+    // states are numbered in the order they are found, so each one's row
+    // of transitions is appended in turn
+    for (size_t i = 0; i < states.size(); ++i)
     {
-        if (anchored(regex, regex_end, text, text_end))
+        m_accept.push_back(accepting(states[i]));
+        m_dead.push_back(std::find(states[i].begin(), states[i].end(), 1) == states[i].end());
+
+        for (size_t c = 0; c < classes; ++c)
         {
-            return true;
+            step(states[i], c, &t);
+            std::map<state_set, uint32_t>::iterator it = ids.find(t);
+
+            if (it == ids.end())
+            {
+                if (states.size() >= REGEX_MAX_STATES)
+                {
+                    return false;
+                }
+
+                it = ids.insert(std::make_pair(t, static_cast<uint32_t>(states.size()))).first;
+                states.push_back(t);
+            }
+
+            m_trans.push_back(it->second);
         }
     }
 
-    return false;
+    assert(m_trans.size() == states.size() * classes);
+    return true;
+}
+
+bool
+hyperdex :: regex_match(const uint8_t* regex, size_t regex_sz,
+                        const uint8_t* text, size_t text_sz)
+{
+    regex_program re;
+    re.compile(regex, regex_sz);
+    return re.match(text, text_sz);
 }
@@ -32,11 +32,74 @@
 #include <cstdlib>
 #include <stdint.h>
 
+// STL
+#include <string>
+#include <vector>
+
+// e
+#include <e/slice.h>
+
 // HyperDex
 #include "namespace.h"
 
 BEGIN_HYPERDEX_NAMESPACE
 
+// A regex in HyperDex's dialect (literals, '.', 'c*', '\c', and the anchors
+// '^' and '$') compiled into a DFA so that matching one text costs a single
+// table lookup per byte.  Patterns whose DFA would be too large are matched by
+// simulating the NFA instead, which is still linear in the text.
+class regex_program
+{
+    public:
+        regex_program();
+        ~regex_program() throw ();
+
+    public:
+        void compile(const uint8_t* regex, size_t regex_sz);
+        bool match(const uint8_t* text, size_t text_sz) const;
+        // the literal every match must start with, and the smallest string
+        // greater than every string starting with it (empty when there is
+        // none); only anchored regexes have a prefix
+        bool has_prefix() const { return !m_prefix.empty(); }
+        e::slice prefix() const;
+        e::slice prefix_limit() const;
+
+    private:
+        // one position of the pattern: a byte (or any byte when "any"),
+        // optionally repeated; "fail" matches nothing
+        struct item
+        {
+            item() : byte(), any(false), star(false), fail(false) {}
+            uint8_t byte;
+            bool any;
+            bool star;
+            bool fail;
+        };
+        // one flag per position of the pattern, plus one for the end
+        typedef std::vector<uint8_t> state_set;
+
+    private:
+        void closure(state_set* s) const;
+        void step(const state_set& s, unsigned cls, state_set* t) const;
+        bool accepting(const state_set& s) const;
+        bool build_dfa();
+
+    private:
+        std::vector<item> m_items;
+        bool m_anchor_start;
+        bool m_anchor_end;
+        // every byte maps to a class of bytes the items cannot tell apart
+        uint16_t m_class[256];
+        std::vector<uint8_t> m_class_byte;
+        // the DFA: m_trans[s * classes + c] is the state after s reads a byte
+        // of class c; empty if the NFA is simulated instead
+        std::vector<uint32_t> m_trans;
+        std::vector<uint8_t> m_accept;
+        std::vector<uint8_t> m_dead;
+        std::string m_prefix;
+        std::string m_prefix_limit;
+};
+
 bool
 regex_match(const uint8_t* regex, size_t regex_sz,
             const uint8_t* text, size_t text_sz);
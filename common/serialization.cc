@@ -25,6 +25,9 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// C
+#include <string.h>
+
 // HyperDex
 #include "common/serialization.h"
 
@@ -277,3 +280,73 @@ hyperdex :: pack_size(const e::slice& s)
 {
     return sizeof(uint32_t) + s.size();
 }
+
+namespace
+{
+
+uint64_t
+double_bits(double d)
+{
+    uint64_t x;
+    memmove(&x, &d, sizeof(x));
+    return x;
+}
+
+double
+bits_double(uint64_t x)
+{
+    double d;
+    memmove(&d, &x, sizeof(d));
+    return d;
+}
+
+} // namespace
+
+e::buffer::packer
+hyperdex :: operator << (e::buffer::packer lhs, const aggregate_stats& rhs)
+{
+    return lhs << double_bits(rhs.lower)
+               << double_bits(rhs.upper)
+               << rhs.count
+               << static_cast<uint64_t>(rhs.int_sum)
+               << double_bits(rhs.sum)
+               << double_bits(rhs.min)
+               << double_bits(rhs.max)
+               << rhs.below
+               << rhs.above
+               << rhs.buckets;
+}
+
+e::unpacker
+hyperdex :: operator >> (e::unpacker lhs, aggregate_stats& rhs)
+{
+    uint64_t lower;
+    uint64_t upper;
+    uint64_t int_sum;
+    uint64_t sum;
+    uint64_t min;
+    uint64_t max;
+    lhs = lhs >> lower
+              >> upper
+              >> rhs.count
+              >> int_sum
+              >> sum
+              >> min
+              >> max
+              >> rhs.below
+              >> rhs.above
+              >> rhs.buckets;
+    rhs.lower = bits_double(lower);
+    rhs.upper = bits_double(upper);
+    rhs.int_sum = static_cast<int64_t>(int_sum);
+    rhs.sum = bits_double(sum);
+    rhs.min = bits_double(min);
+    rhs.max = bits_double(max);
+    return lhs;
+}
+
+size_t
+hyperdex :: pack_size(const aggregate_stats& rhs)
+{
+    return 9 * sizeof(uint64_t) + pack_size(rhs.buckets);
+}
@@ -38,6 +38,7 @@
 // HyperDex
 #include "namespace.h"
 #include "hyperdex.h"
+#include "common/aggregate.h"
 #include "common/attribute_check.h"
 #include "common/funcall.h"
 
@@ -71,6 +72,13 @@ operator >> (e::unpacker lhs, attribute_check& rhs);
 size_t
 pack_size(const attribute_check& rhs);
 
+e::buffer::packer
+operator << (e::buffer::packer lhs, const aggregate_stats& rhs);
+e::unpacker
+operator >> (e::unpacker lhs, aggregate_stats& rhs);
+size_t
+pack_size(const aggregate_stats& rhs);
+
 e::buffer::packer
 operator << (e::buffer::packer lhs, const funcall_t& rhs);
 e::unpacker
@@ -99,6 +107,9 @@ operator >> (e::unpacker lhs, hyperpredicate& rhs);
 size_t
 pack_size(const hyperpredicate& p);
 
+inline size_t
+pack_size(uint16_t) { return sizeof(uint16_t); }
+
 inline size_t
 pack_size(uint64_t) { return sizeof(uint64_t); }
 
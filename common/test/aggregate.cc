@@ -0,0 +1,136 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/aggregate.h"
+
+using hyperdex::aggregate_stats;
+using hyperdex::aggregate_value;
+
+static std::string
+int64_value(int64_t x)
+{
+    char buf[sizeof(int64_t)];
+    e::pack64le(x, buf);
+    return std::string(buf, sizeof(buf));
+}
+
+static std::string
+float_value(double x)
+{
+    char buf[sizeof(double)];
+    e::packdoublele(x, buf);
+    return std::string(buf, sizeof(buf));
+}
+
+TEST(Aggregate, Histogram)
+{
+    aggregate_stats stats(0, 10, 5);
+    stats.add_float(-1);
+    stats.add_float(0);
+    stats.add_float(1.9);
+    stats.add_float(2);
+    stats.add_float(9.99);
+    stats.add_float(10);
+    ASSERT_EQ(6U, stats.count);
+    ASSERT_EQ(1U, stats.below);
+    ASSERT_EQ(1U, stats.above);
+    ASSERT_EQ(2U, stats.buckets[0]);
+    ASSERT_EQ(1U, stats.buckets[1]);
+    ASSERT_EQ(0U, stats.buckets[2]);
+    ASSERT_EQ(0U, stats.buckets[3]);
+    ASSERT_EQ(1U, stats.buckets[4]);
+    ASSERT_EQ(-1, stats.min);
+    ASSERT_EQ(10, stats.max);
+}
+
+TEST(Aggregate, ExactIntegerSum)
+{
+    // each term is past the 53 bits a double holds exactly
+    const int64_t big = (int64_t(1) << 60) + 1;
+    aggregate_stats stats;
+    stats.add_int(big);
+    stats.add_int(1);
+    stats.add_int(-big);
+    ASSERT_EQ(3U, stats.count);
+    ASSERT_EQ(1, stats.int_sum);
+    ASSERT_EQ(1, stats.total());
+}
+
+TEST(Aggregate, Merge)
+{
+    aggregate_stats a(0, 4, 2);
+    aggregate_stats b(0, 4, 2);
+    aggregate_stats empty(0, 4, 2);
+    a.add_int(1);
+    a.add_int(5);
+    b.add_int(-3);
+    b.add_float(2.5);
+    a.merge(empty);
+    a.merge(b);
+    ASSERT_EQ(4U, a.count);
+    ASSERT_EQ(3, a.int_sum);
+    ASSERT_EQ(2.5, a.sum);
+    ASSERT_EQ(5.5, a.total());
+    ASSERT_EQ(-3, a.min);
+    ASSERT_EQ(5, a.max);
+    ASSERT_EQ(1U, a.below);
+    ASSERT_EQ(1U, a.above);
+    ASSERT_EQ(1U, a.buckets[0]);
+    ASSERT_EQ(1U, a.buckets[1]);
+
+    // merging into an empty summary takes the other's bounds
+    empty.merge(a);
+    ASSERT_EQ(-3, empty.min);
+    ASSERT_EQ(5, empty.max);
+}
+
+TEST(Aggregate, DecodeValues)
+{
+    aggregate_stats stats;
+    std::string i(int64_value(-42));
+    std::string f(float_value(0.5));
+    ASSERT_TRUE(aggregate_value(HYPERDATATYPE_INT64, e::slice(i.data(), i.size()), &stats));
+    ASSERT_TRUE(aggregate_value(HYPERDATATYPE_FLOAT, e::slice(f.data(), f.size()), &stats));
+    // an empty value is zero
+    ASSERT_TRUE(aggregate_value(HYPERDATATYPE_INT64, e::slice(), &stats));
+    ASSERT_EQ(3U, stats.count);
+    ASSERT_EQ(-42, stats.int_sum);
+    ASSERT_EQ(0.5, stats.sum);
+    ASSERT_EQ(-42, stats.min);
+    ASSERT_EQ(0.5, stats.max);
+
+    // values of the wrong size or type are not counted
+    ASSERT_FALSE(aggregate_value(HYPERDATATYPE_INT64, e::slice("abc", 3), &stats));
+    ASSERT_FALSE(aggregate_value(HYPERDATATYPE_STRING, e::slice(i.data(), i.size()), &stats));
+    ASSERT_EQ(3U, stats.count);
+}
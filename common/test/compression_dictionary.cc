@@ -0,0 +1,101 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <cstdio>
+
+// HyperDex
+#include "test/th.h"
+#include "common/compression_dictionary.h"
+
+using hyperdex::compression_dictionary;
+
+static std::string
+roundtrip(const compression_dictionary& dict, const std::string& in, size_t* compressed_sz)
+{
+    std::string c;
+    std::string out;
+    dict.compress(reinterpret_cast<const uint8_t*>(in.data()), in.size(), &c);
+    *compressed_sz = c.size();
+
+    if (!dict.decompress(reinterpret_cast<const uint8_t*>(c.data()), c.size(), in.size(), &out))
+    {
+        return "<corrupt>";
+    }
+
+    return out;
+}
+
+static std::string
+record(unsigned i)
+{
+    char buf[128];
+    sprintf(buf, "{\"user\": \"user%u\", \"status\": \"active\", \"score\": %u}", i, i * 7);
+    return buf;
+}
+
+TEST(CompressionDictionary, EmptyDictionary)
+{
+    compression_dictionary dict;
+    size_t sz;
+    ASSERT_EQ("", roundtrip(dict, "", &sz));
+    ASSERT_EQ("abc", roundtrip(dict, "abc", &sz));
+    ASSERT_EQ("abcabcabcabcabcabc", roundtrip(dict, "abcabcabcabcabcabc", &sz));
+    ASSERT_LT(sz, 18U);
+}
+
+TEST(CompressionDictionary, Trained)
+{
+    std::vector<std::string> samples;
+
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        samples.push_back(record(i));
+    }
+
+    compression_dictionary dict;
+    dict.train(samples, 1024);
+    ASSERT_LT(0U, dict.contents().size());
+    ASSERT_LE(dict.contents().size(), 1024U);
+
+    compression_dictionary loaded;
+    loaded.load(dict.contents());
+    std::string r = record(1000);
+    size_t sz;
+    ASSERT_EQ(r, roundtrip(loaded, r, &sz));
+    ASSERT_LT(sz * 2, r.size());
+}
+
+TEST(CompressionDictionary, Corrupt)
+{
+    compression_dictionary dict;
+    std::string out;
+    const uint8_t bad[] = {0, 9, 1};
+    ASSERT_FALSE(dict.decompress(bad, sizeof(bad), 5, &out));
+    const uint8_t truncated[] = {5, 'a', 'b'};
+    ASSERT_FALSE(dict.decompress(truncated, sizeof(truncated), 5, &out));
+}
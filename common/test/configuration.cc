@@ -0,0 +1,188 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// STL
+#include <algorithm>
+#include <memory>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "common/configuration.h"
+#include "common/hash.h"
+
+using hyperdex::attribute;
+using hyperdex::attribute_check;
+using hyperdex::configuration;
+using hyperdex::region;
+using hyperdex::replica;
+using hyperdex::schema;
+using hyperdex::server_id;
+using hyperdex::space;
+using hyperdex::subspace;
+using hyperdex::virtual_server_id;
+
+// the region of a subspace over one attribute that holds hash h when the
+// subspace is split into four equal regions
+static uint64_t
+quarter(uint64_t h)
+{
+    return h >> 62;
+}
+
+// space "kv" with a string key "k" and an int64 "v"; the key subspace and a
+// subspace over "v" each have four regions, served by virtual servers
+// 100-103 and 200-203 respectively
+static void
+make_config(configuration* config)
+{
+    attribute attrs[2] = {attribute("k", HYPERDATATYPE_STRING),
+                          attribute("v", HYPERDATATYPE_INT64)};
+    schema sc;
+    sc.attrs_sz = 2;
+    sc.attrs = attrs;
+    space s("kv", sc);
+    s.id = hyperdex::space_id(1);
+    s.subspaces.resize(2);
+
+    for (uint16_t ss = 0; ss < 2; ++ss)
+    {
+        s.subspaces[ss].id = hyperdex::subspace_id(ss + 1);
+        s.subspaces[ss].attrs.push_back(ss);
+        s.subspaces[ss].regions.resize(4);
+
+        for (uint64_t q = 0; q < 4; ++q)
+        {
+            region& r(s.subspaces[ss].regions[q]);
+            r.id = hyperdex::region_id(ss * 4 + q + 1);
+            r.lower_coord.push_back(q << 62);
+            r.upper_coord.push_back(q == 3 ? UINT64_MAX : ((q + 1) << 62) - 1);
+            r.replicas.push_back(replica(server_id(1), virtual_server_id((ss + 1) * 100 + q)));
+        }
+    }
+
+    const size_t sz = 5 * sizeof(uint64_t) + pack_size(s);
+    std::auto_ptr<e::buffer> buf(e::buffer::create(sz));
+    buf->pack_at(0) << uint64_t(1) << uint64_t(1)
+                    << uint64_t(0) << uint64_t(1) << uint64_t(0) << s;
+    e::unpacker up = buf->unpack_from(0);
+    up = up >> *config;
+    ASSERT_FALSE(up.error());
+}
+
+// the check "v IN values"
+static attribute_check
+make_in(const std::vector<int64_t>& values, std::string* backing)
+{
+    backing->clear();
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        char buf[sizeof(int64_t)];
+        e::pack64le(values[i], buf);
+        backing->append(buf, sizeof(buf));
+    }
+
+    attribute_check chk;
+    chk.attr = 1;
+    chk.value = e::slice(*backing);
+    chk.datatype = HYPERDATATYPE_LIST_INT64;
+    chk.predicate = HYPERPREDICATE_IN;
+    return chk;
+}
+
+static std::vector<uint64_t>
+lookup(const configuration& config, const std::vector<attribute_check>& chks)
+{
+    std::vector<virtual_server_id> servers;
+    config.lookup_search("kv", chks, &servers);
+    std::vector<uint64_t> ids;
+
+    for (size_t i = 0; i < servers.size(); ++i)
+    {
+        ids.push_back(servers[i].get());
+    }
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(Configuration, LookupSearchAll)
+{
+    configuration config;
+    make_config(&config);
+    std::vector<attribute_check> chks;
+    ASSERT_EQ(4U, lookup(config, chks).size());
+}
+
+TEST(Configuration, LookupSearchIn)
+{
+    configuration config;
+    make_config(&config);
+    std::vector<int64_t> values;
+    values.push_back(1);
+    values.push_back(2);
+    std::string backing;
+    std::vector<attribute_check> chks;
+    chks.push_back(make_in(values, &backing));
+
+    // only the regions of "v" that hold a candidate's hash are contacted
+    std::vector<uint64_t> expected;
+
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        char buf[sizeof(int64_t)];
+        e::pack64le(values[i], buf);
+        uint64_t h = hyperdex::hash(HYPERDATATYPE_INT64, e::slice(buf, sizeof(buf)));
+        expected.push_back(200 + quarter(h));
+    }
+
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    std::vector<uint64_t> got = lookup(config, chks);
+    ASSERT_EQ(expected.size(), got.size());
+
+    for (size_t i = 0; i < expected.size(); ++i)
+    {
+        ASSERT_EQ(expected[i], got[i]);
+    }
+}
+
+TEST(Configuration, LookupSearchEmptyIn)
+{
+    configuration config;
+    make_config(&config);
+    std::vector<int64_t> values;
+    std::string backing;
+    std::vector<attribute_check> chks;
+    chks.push_back(make_in(values, &backing));
+    // nothing can match, so no server is contacted
+    ASSERT_EQ(0U, lookup(config, chks).size());
+}
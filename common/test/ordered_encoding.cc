@@ -30,6 +30,11 @@
 // C
 #include <cmath>
 #include <stdint.h>
+#include <string.h>
+
+// STL
+#include <string>
+#include <vector>
 
 // HyperDex
 #include "test/th.h"
@@ -38,6 +43,33 @@
 using hyperdex::ordered_encode_int64;
 using hyperdex::ordered_decode_int64;
 using hyperdex::ordered_encode_double;
+using hyperdex::ordered_encode_escaped;
+using hyperdex::ordered_escaped_size;
+using hyperdex::ordered_decode_escaped;
+
+static std::vector<char>
+escape_pair(const std::string& a, const std::string& b)
+{
+    std::vector<char> out;
+    ordered_encode_escaped(a.data(), a.size(), &out);
+    ordered_encode_escaped(b.data(), b.size(), &out);
+    return out;
+}
+
+// compare as unsigned bytes, the way LevelDB orders keys
+static int
+compare_bytes(const char* lhs, size_t lhs_sz, const char* rhs, size_t rhs_sz)
+{
+    size_t sz = lhs_sz < rhs_sz ? lhs_sz : rhs_sz;
+    int cmp = sz > 0 ? memcmp(lhs, rhs, sz) : 0;
+
+    if (cmp != 0)
+    {
+        return cmp < 0 ? -1 : 1;
+    }
+
+    return lhs_sz < rhs_sz ? -1 : (lhs_sz > rhs_sz ? 1 : 0);
+}
 
 TEST(OrderedEncoding, EncodeInt64)
 {
@@ -121,3 +153,84 @@ TEST(IndexEncode, Double)
         }
     }
 }
+
+TEST(OrderedEncoding, EscapedExact)
+{
+    std::vector<char> out;
+    ordered_encode_escaped("", 0, &out);
+    ASSERT_EQ(std::string("\x00\x01", 2), std::string(out.begin(), out.end()));
+    out.clear();
+    ordered_encode_escaped("a\x00" "b", 3, &out);
+    ASSERT_EQ(std::string("a\x00\xff" "b\x00\x01", 6), std::string(out.begin(), out.end()));
+}
+
+TEST(OrderedEncoding, EscapedRoundTrip)
+{
+    const char* strs[] = {"", "a", "\x00", "\x00\x01", "\x01\x00", "\xff\x00\xff", "abc\x00\x00" "def"};
+    const size_t lens[] = {0, 1, 1, 2, 2, 3, 8};
+
+    for (size_t i = 0; i < sizeof(lens) / sizeof(size_t); ++i)
+    {
+        std::vector<char> enc;
+        ordered_encode_escaped(strs[i], lens[i], &enc);
+        // a second string after the first must not change where it ends
+        ordered_encode_escaped("\x00\x01", 2, &enc);
+        size_t esc_sz = 0;
+        ASSERT_TRUE(ordered_escaped_size(&enc.front(), enc.size(), &esc_sz));
+        std::vector<char> dec;
+        ASSERT_TRUE(ordered_decode_escaped(&enc.front(), esc_sz, &dec));
+        ASSERT_EQ(std::string(strs[i], lens[i]), std::string(dec.begin(), dec.end()));
+    }
+}
+
+TEST(OrderedEncoding, EscapedOrdering)
+{
+    // every string of up to two bytes drawn from those that need care
+    const char alphabet[] = {'\x00', '\x01', 'a', '\xff'};
+    std::vector<std::string> strs(1, std::string());
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        strs.push_back(std::string(1, alphabet[i]));
+
+        for (size_t j = 0; j < 4; ++j)
+        {
+            strs.push_back(std::string(1, alphabet[i]) + alphabet[j]);
+        }
+    }
+
+    for (size_t a1 = 0; a1 < strs.size(); ++a1)
+    for (size_t a2 = 0; a2 < strs.size(); ++a2)
+    for (size_t b1 = 0; b1 < strs.size(); ++b1)
+    for (size_t b2 = 0; b2 < strs.size(); ++b2)
+    {
+        int expected = compare_bytes(strs[a1].data(), strs[a1].size(),
+                                     strs[b1].data(), strs[b1].size());
+
+        if (expected == 0)
+        {
+            expected = compare_bytes(strs[a2].data(), strs[a2].size(),
+                                     strs[b2].data(), strs[b2].size());
+        }
+
+        std::vector<char> a(escape_pair(strs[a1], strs[a2]));
+        std::vector<char> b(escape_pair(strs[b1], strs[b2]));
+        ASSERT_EQ(expected, compare_bytes(&a.front(), a.size(), &b.front(), b.size()));
+    }
+}
+
+TEST(OrderedEncoding, EscapedMalformed)
+{
+    size_t esc_sz;
+    std::vector<char> dec;
+    // unterminated
+    ASSERT_FALSE(ordered_escaped_size("abc", 3, &esc_sz));
+    ASSERT_FALSE(ordered_escaped_size("a\x00\xff", 3, &esc_sz));
+    ASSERT_FALSE(ordered_escaped_size("a\x00", 2, &esc_sz));
+    // 0x00 followed by neither escape nor terminator
+    ASSERT_FALSE(ordered_escaped_size("a\x00" "b\x00\x01", 5, &esc_sz));
+    // trailing bytes after the terminator
+    ASSERT_FALSE(ordered_decode_escaped("a\x00\x01" "b", 4, &dec));
+    ASSERT_TRUE(ordered_decode_escaped("a\x00\x01", 3, &dec));
+    ASSERT_EQ(std::string("a"), std::string(dec.begin(), dec.end()));
+}
@@ -0,0 +1,105 @@
+// Copyright (c) 2012-2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <cstring>
+
+// HyperDex
+#include "test/th.h"
+#include "common/regex_match.h"
+
+using hyperdex::regex_program;
+
+static bool
+matches(const char* regex, const char* text)
+{
+    regex_program re;
+    re.compile(reinterpret_cast<const uint8_t*>(regex), strlen(regex));
+    return re.match(reinterpret_cast<const uint8_t*>(text), strlen(text));
+}
+
+TEST(RegexMatch, Literal)
+{
+    ASSERT_TRUE(matches("abc", "abc"));
+    ASSERT_TRUE(matches("abc", "xxabcxx"));
+    ASSERT_FALSE(matches("abc", "abxc"));
+    ASSERT_TRUE(matches("", ""));
+    ASSERT_TRUE(matches("", "anything"));
+}
+
+TEST(RegexMatch, DotAndStar)
+{
+    ASSERT_TRUE(matches("a.c", "abc"));
+    ASSERT_FALSE(matches("a.c", "ac"));
+    ASSERT_TRUE(matches("^ab*c$", "ac"));
+    ASSERT_TRUE(matches("^ab*c$", "abbbc"));
+    ASSERT_FALSE(matches("^ab*c$", "abxc"));
+    ASSERT_TRUE(matches("^a.*z$", "abcz"));
+    ASSERT_FALSE(matches("^a.*z$", "abcza"));
+}
+
+TEST(RegexMatch, Anchors)
+{
+    ASSERT_TRUE(matches("^abc", "abcdef"));
+    ASSERT_FALSE(matches("^abc", "xabc"));
+    ASSERT_TRUE(matches("def$", "abcdef"));
+    ASSERT_FALSE(matches("def$", "defx"));
+    ASSERT_TRUE(matches("^$", ""));
+    ASSERT_FALSE(matches("^$", "a"));
+}
+
+TEST(RegexMatch, Escape)
+{
+    ASSERT_TRUE(matches("a\\.c", "a.c"));
+    ASSERT_FALSE(matches("a\\.c", "abc"));
+    ASSERT_TRUE(matches("a\\*", "a*"));
+    ASSERT_FALSE(matches("a\\", "a"));
+    ASSERT_FALSE(matches("a\\", "a\\"));
+}
+
+TEST(RegexMatch, Prefix)
+{
+    regex_program re;
+    re.compile(reinterpret_cast<const uint8_t*>("^ab.*"), 5);
+    ASSERT_TRUE(re.has_prefix());
+    ASSERT_TRUE(re.prefix() == e::slice("ab", 2));
+    ASSERT_TRUE(re.prefix_limit() == e::slice("ac", 2));
+
+    re.compile(reinterpret_cast<const uint8_t*>("^a\xff\xff"), 4);
+    ASSERT_TRUE(re.has_prefix());
+    ASSERT_TRUE(re.prefix_limit() == e::slice("b", 1));
+
+    re.compile(reinterpret_cast<const uint8_t*>("^\xff"), 2);
+    ASSERT_TRUE(re.has_prefix());
+    ASSERT_TRUE(re.prefix_limit().empty());
+
+    re.compile(reinterpret_cast<const uint8_t*>("ab"), 2);
+    ASSERT_FALSE(re.has_prefix());
+
+    re.compile(reinterpret_cast<const uint8_t*>("^a*b"), 4);
+    ASSERT_FALSE(re.has_prefix());
+}
@@ -503,6 +503,96 @@ coordinator :: space_rm(replicant_state_machine_context* ctx, const char* name)
     }
 }
 
+void
+coordinator :: index_add(replicant_state_machine_context* ctx,
+                         const char* name, const char* attr_name)
+{
+    FILE* log = replicant_state_machine_log_stream(ctx);
+    space_map_t::iterator it;
+    it = m_spaces.find(std::string(name));
+
+    if (it == m_spaces.end())
+    {
+        fprintf(log, "could not add index to space \"%s\" because it doesn't exist\n", name);
+        return generate_response(ctx, COORD_NOT_FOUND);
+    }
+
+    space* s = it->second.get();
+    uint16_t attr = s->sc.lookup_attr(attr_name);
+
+    if (attr == s->sc.attrs_sz)
+    {
+        fprintf(log, "could not add index on \"%s\" to space \"%s\" because there is no such attribute\n", attr_name, name);
+        return generate_response(ctx, COORD_NOT_FOUND);
+    }
+
+    if (attr == 0)
+    {
+        fprintf(log, "could not add index on \"%s\" to space \"%s\" because it is the key\n", attr_name, name);
+        return generate_response(ctx, COORD_NO_CAN_DO);
+    }
+
+    // index every subspace, as a search may be served by any of them
+    bool added = false;
+
+    for (size_t i = 0; i < s->subspaces.size(); ++i)
+    {
+        if (!s->subspaces[i].indexed(attr))
+        {
+            s->subspaces[i].indices.push_back(attr);
+            added = true;
+        }
+    }
+
+    if (!added)
+    {
+        fprintf(log, "could not add index on \"%s\" to space \"%s\" because it is already indexed\n", attr_name, name);
+        return generate_response(ctx, COORD_DUPLICATE);
+    }
+
+    fprintf(log, "successfully added index on \"%s\" to space \"%s\"\n", attr_name, name);
+    generate_next_configuration(ctx);
+    return generate_response(ctx, COORD_SUCCESS);
+}
+
+void
+coordinator :: index_rm(replicant_state_machine_context* ctx,
+                        const char* name, const char* attr_name)
+{
+    FILE* log = replicant_state_machine_log_stream(ctx);
+    space_map_t::iterator it;
+    it = m_spaces.find(std::string(name));
+
+    if (it == m_spaces.end())
+    {
+        fprintf(log, "could not remove index from space \"%s\" because it doesn't exist\n", name);
+        return generate_response(ctx, COORD_NOT_FOUND);
+    }
+
+    space* s = it->second.get();
+    uint16_t attr = s->sc.lookup_attr(attr_name);
+    bool removed = false;
+
+    // indices implied by a subspace's own attributes stay
+    for (size_t i = 0; attr < s->sc.attrs_sz && i < s->subspaces.size(); ++i)
+    {
+        std::vector<uint16_t>& indices(s->subspaces[i].indices);
+        size_t sz = indices.size();
+        indices.erase(std::remove(indices.begin(), indices.end(), attr), indices.end());
+        removed = removed || indices.size() != sz;
+    }
+
+    if (!removed)
+    {
+        fprintf(log, "could not remove index on \"%s\" from space \"%s\" because there is no such index\n", attr_name, name);
+        return generate_response(ctx, COORD_NOT_FOUND);
+    }
+
+    fprintf(log, "successfully removed index on \"%s\" from space \"%s\"\n", attr_name, name);
+    generate_next_configuration(ctx);
+    return generate_response(ctx, COORD_SUCCESS);
+}
+
 void
 coordinator :: transfer_go_live(replicant_state_machine_context* ctx,
                                 uint64_t version,
@@ -1239,6 +1329,12 @@ coordinator :: generate_next_configuration(replicant_state_machine_context* ctx)
         sz += pack_size(m_transfers[i]);
     }
 
+    for (std::map<std::string, std::tr1::shared_ptr<space> >::iterator it = m_spaces.begin();
+            it != m_spaces.end(); ++it)
+    {
+        sz += pack_size_index_extensions(*it->second);
+    }
+
     std::auto_ptr<e::buffer> new_config(e::buffer::create(sz));
     e::buffer::packer pa = new_config->pack_at(0);
     pa = pa << m_cluster << m_version
@@ -1262,6 +1358,14 @@ coordinator :: generate_next_configuration(replicant_state_machine_context* ctx)
         pa = pa << m_transfers[i];
     }
 
+    // after the transfers so that daemons and clients which predate these
+    // blocks stop reading before them
+    for (std::map<std::string, std::tr1::shared_ptr<space> >::iterator it = m_spaces.begin();
+            it != m_spaces.end(); ++it)
+    {
+        pa = pack_index_extensions(pa, *it->second);
+    }
+
     m_latest_config = new_config;
 }
 
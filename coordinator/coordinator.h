@@ -84,6 +84,10 @@ class coordinator
     public:
         void space_add(replicant_state_machine_context* ctx, const space& s);
         void space_rm(replicant_state_machine_context* ctx, const char* name);
+        void index_add(replicant_state_machine_context* ctx,
+                       const char* space, const char* attr);
+        void index_rm(replicant_state_machine_context* ctx,
+                      const char* space, const char* attr);
 
     // transfers management
     public:
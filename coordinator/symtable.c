@@ -53,6 +53,8 @@ struct replicant_state_machine HYPERDEX_API rsm = {
      {"server_suspect", hyperdex_coordinator_server_suspect},
      {"space_add", hyperdex_coordinator_space_add},
      {"space_rm", hyperdex_coordinator_space_rm},
+     {"index_add", hyperdex_coordinator_index_add},
+     {"index_rm", hyperdex_coordinator_index_rm},
      {"transfer_go_live", hyperdex_coordinator_transfer_go_live},
      {"transfer_complete", hyperdex_coordinator_transfer_complete},
      {"checkpoint_stable", hyperdex_coordinator_checkpoint_stable},
@@ -29,6 +29,7 @@
 #include <new>
 
 // STL
+#include <algorithm>
 #include <string>
 
 // HyperDex
@@ -75,6 +76,24 @@ using namespace hyperdex;
         } \
     } while (0)
 
+// index transitions carry "space\0attr\0"
+static bool
+unpack_index_message(const char* data, size_t data_sz,
+                     const char** space, const char** attr)
+{
+    const char* end = data + data_sz;
+    const char* nul = std::find(data, end, '\0');
+
+    if (nul == end || end[-1] != '\0' || nul + 1 == end)
+    {
+        return false;
+    }
+
+    *space = data;
+    *attr = nul + 1;
+    return true;
+}
+
 extern "C"
 {
 
@@ -340,6 +359,13 @@ hyperdex_coordinator_space_add(struct replicant_state_machine_context* ctx,
     space s;
     e::unpacker up(data, data_sz);
     up = up >> s;
+
+    // admin tools that predate covering and composite indices send no block
+    if (!up.error() && up.remain())
+    {
+        up = unpack_index_extensions(up, &s);
+    }
+
     CHECK_UNPACK(space_add);
     c->space_add(ctx, s);
 }
@@ -361,6 +387,44 @@ hyperdex_coordinator_space_rm(struct replicant_state_machine_context* ctx,
     c->space_rm(ctx, data);
 }
 
+void
+hyperdex_coordinator_index_add(struct replicant_state_machine_context* ctx,
+                               void* obj, const char* data, size_t data_sz)
+{
+    PROTECT_UNINITIALIZED;
+    FILE* log = replicant_state_machine_log_stream(ctx);
+    coordinator* c = static_cast<coordinator*>(obj);
+    const char* space;
+    const char* attr;
+
+    if (!unpack_index_message(data, data_sz, &space, &attr))
+    {
+        fprintf(log, "received malformed \"index_add\" message\n");
+        return generate_response(ctx, COORD_MALFORMED);
+    }
+
+    c->index_add(ctx, space, attr);
+}
+
+void
+hyperdex_coordinator_index_rm(struct replicant_state_machine_context* ctx,
+                              void* obj, const char* data, size_t data_sz)
+{
+    PROTECT_UNINITIALIZED;
+    FILE* log = replicant_state_machine_log_stream(ctx);
+    coordinator* c = static_cast<coordinator*>(obj);
+    const char* space;
+    const char* attr;
+
+    if (!unpack_index_message(data, data_sz, &space, &attr))
+    {
+        fprintf(log, "received malformed \"index_rm\" message\n");
+        return generate_response(ctx, COORD_MALFORMED);
+    }
+
+    c->index_rm(ctx, space, attr);
+}
+
 void
 hyperdex_coordinator_transfer_go_live(struct replicant_state_machine_context* ctx,
                                       void* obj, const char* data, size_t data_sz)
@@ -71,6 +71,8 @@ TRANSITION(server_suspect);
 
 TRANSITION(space_add);
 TRANSITION(space_rm);
+TRANSITION(index_add);
+TRANSITION(index_rm);
 
 TRANSITION(transfer_go_live);
 TRANSITION(transfer_complete);
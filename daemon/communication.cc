@@ -522,4 +522,9 @@ communication :: handle_disruption(uint64_t id)
         // will cause a deadlock.
         // m_daemon->m_stm.retransmit(server_id(id));
     }
+    else
+    {
+        // a client went away; release the snapshots its searches hold
+        m_daemon->m_sm.disconnect(server_id(id));
+    }
 }
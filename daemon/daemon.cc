@@ -42,6 +42,7 @@
 
 // HyperDex
 #include "common/coordinator_returncode.h"
+#include "common/projection.h"
 #include "common/serialization.h"
 #include "daemon/daemon.h"
 
@@ -107,13 +108,16 @@ daemon :: daemon()
     , m_config()
     , m_perf_req_get()
     , m_perf_req_atomic()
+    , m_perf_req_atomic_batch()
     , m_perf_req_search_start()
     , m_perf_req_search_next()
     , m_perf_req_search_stop()
     , m_perf_req_sorted_search()
     , m_perf_req_group_del()
+    , m_perf_req_group_atomic()
     , m_perf_req_count()
     , m_perf_req_search_describe()
+    , m_perf_req_aggregate()
     , m_perf_chain_op()
     , m_perf_chain_subspace()
     , m_perf_chain_ack()
@@ -174,7 +178,15 @@ daemon :: run(bool daemonize,
               po6::net::location bind_to,
               bool set_coordinator,
               po6::net::hostname coordinator,
-              unsigned threads)
+              unsigned threads,
+              uint64_t snapshot_window,
+              uint64_t search_cache,
+              uint64_t search_idle_timeout,
+              uint64_t search_max_per_client,
+              uint64_t search_max_open,
+              uint64_t commit_latency,
+              uint64_t object_cache,
+              uint64_t dictionary_size)
 {
     if (!install_signal_handler(SIGHUP, exit_on_signal))
     {
@@ -258,6 +270,13 @@ daemon :: run(bool daemonize,
     po6::net::location saved_bind_to;
     po6::net::hostname saved_coordinator;
     LOG(INFO) << "initializing local storage";
+    m_data.set_snapshot_window(snapshot_window * 1000ULL * 1000ULL);
+    m_sm.set_result_cache_size(search_cache);
+    m_sm.set_search_limits(search_idle_timeout * 1000ULL * 1000ULL * 1000ULL,
+                           search_max_per_client, search_max_open);
+    m_data.set_commit_latency(commit_latency * 1000ULL);
+    m_data.set_object_cache_size(object_cache * 1024ULL * 1024ULL);
+    m_data.set_dictionary_size(dictionary_size * 1024ULL);
 
     if (!m_data.initialize(data, &saved, &saved_us, &saved_bind_to, &saved_coordinator))
     {
@@ -346,6 +365,7 @@ daemon :: run(bool daemonize,
             s_alarm = false;
             alarm(ALARM_INTERVAL);
             m_repl.trip_periodic();
+            m_sm.reap_idle();
         }
 
         if (s_debug)
@@ -543,6 +563,10 @@ daemon :: loop(size_t thread)
                 process_req_atomic(from, vfrom, vto, msg, up);
                 m_perf_req_atomic.tap();
                 break;
+            case REQ_ATOMIC_BATCH:
+                process_req_atomic_batch(from, vfrom, vto, msg, up);
+                m_perf_req_atomic_batch.tap();
+                break;
             case REQ_SEARCH_START:
                 process_req_search_start(from, vfrom, vto, msg, up);
                 m_perf_req_search_start.tap();
@@ -563,6 +587,10 @@ daemon :: loop(size_t thread)
                 process_req_group_del(from, vfrom, vto, msg, up);
                 m_perf_req_group_del.tap();
                 break;
+            case REQ_GROUP_ATOMIC:
+                process_req_group_atomic(from, vfrom, vto, msg, up);
+                m_perf_req_group_atomic.tap();
+                break;
             case REQ_COUNT:
                 process_req_count(from, vfrom, vto, msg, up);
                 m_perf_req_count.tap();
@@ -571,6 +599,10 @@ daemon :: loop(size_t thread)
                 process_req_search_describe(from, vfrom, vto, msg, up);
                 m_perf_req_search_describe.tap();
                 break;
+            case REQ_AGGREGATE:
+                process_req_aggregate(from, vfrom, vto, msg, up);
+                m_perf_req_aggregate.tap();
+                break;
             case CHAIN_OP:
                 process_chain_op(from, vfrom, vto, msg, up);
                 m_perf_chain_op.tap();
@@ -622,10 +654,13 @@ daemon :: loop(size_t thread)
             case RESP_ATOMIC:
             case RESP_SEARCH_ITEM:
             case RESP_SEARCH_DONE:
+            case RESP_SEARCH_ERROR:
             case RESP_SORTED_SEARCH:
             case RESP_GROUP_DEL:
+            case RESP_GROUP_ATOMIC:
             case RESP_COUNT:
             case RESP_SEARCH_DESCRIBE:
+            case RESP_AGGREGATE:
             case CONFIGMISMATCH:
             case PACKET_NOP:
             default:
@@ -646,34 +681,46 @@ daemon :: process_req_get(server_id from,
 {
     uint64_t nonce;
     e::slice key;
+    std::vector<uint16_t> projection;
 
-    if ((up >> nonce >> key).error())
+    if ((up >> nonce >> key >> projection).error())
     {
         LOG(WARNING) << "unpack of REQ_GET failed; here's some hex:  " << msg->hex();
         return;
     }
 
+    region_id ri(m_config.get_region_id(vto));
+    const schema* sc = m_config.get_schema(ri);
     std::vector<e::slice> value;
     uint64_t version;
     datalayer::reference ref;
     network_returncode result;
 
-    switch (m_data.get(m_config.get_region_id(vto), key, &value, &version, &ref))
+    if (!sc || !validate_projection(*sc, projection))
     {
-        case datalayer::SUCCESS:
-            result = NET_SUCCESS;
-            break;
-        case datalayer::NOT_FOUND:
-            result = NET_NOTFOUND;
-            break;
-        case datalayer::BAD_ENCODING:
-        case datalayer::CORRUPTION:
-        case datalayer::IO_ERROR:
-        case datalayer::LEVELDB_ERROR:
-        default:
-            LOG(ERROR) << "GET returned unacceptable error code.";
-            result = NET_SERVERERROR;
-            break;
+        LOG(WARNING) << "REQ_GET carries an invalid projection; here's some hex:  " << msg->hex();
+        result = NET_BADDIMSPEC;
+    }
+    else
+    {
+        switch (m_data.get(ri, key, &value, &version, &ref))
+        {
+            case datalayer::SUCCESS:
+                apply_projection(projection, &value);
+                result = NET_SUCCESS;
+                break;
+            case datalayer::NOT_FOUND:
+                result = NET_NOTFOUND;
+                break;
+            case datalayer::BAD_ENCODING:
+            case datalayer::CORRUPTION:
+            case datalayer::IO_ERROR:
+            case datalayer::LEVELDB_ERROR:
+            default:
+                LOG(ERROR) << "GET returned unacceptable error code.";
+                result = NET_SERVERERROR;
+                break;
+        }
     }
 
     size_t sz = HYPERDEX_HEADER_SIZE_VC
@@ -712,6 +759,32 @@ daemon :: process_req_atomic(server_id from,
     m_repl.client_atomic(from, vto, nonce, erase, fail_if_not_found, fail_if_found, key, checks, funcs);
 }
 
+void
+daemon :: process_req_atomic_batch(server_id from,
+                                   virtual_server_id,
+                                   virtual_server_id vto,
+                                   std::auto_ptr<e::buffer> msg,
+                                   e::unpacker up)
+{
+    uint64_t nonce;
+    std::vector<e::slice> keys;
+    uint8_t flags;
+    std::vector<attribute_check> checks;
+    std::vector<funcall> funcs;
+    up = up >> nonce >> keys >> flags >> checks >> funcs;
+
+    if (up.error())
+    {
+        LOG(WARNING) << "unpack of REQ_ATOMIC_BATCH failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    bool erase = !(flags & 128);
+    bool fail_if_not_found = flags & 1;
+    bool fail_if_found = flags & 2;
+    m_repl.client_atomic_batch(from, vto, erase, fail_if_not_found, fail_if_found, keys, checks, funcs);
+}
+
 void
 daemon :: process_req_search_start(server_id from,
                                    virtual_server_id,
@@ -722,14 +795,19 @@ daemon :: process_req_search_start(server_id from,
     uint64_t nonce;
     uint64_t search_id;
     std::vector<attribute_check> checks;
+    std::vector<uint16_t> projection;
+    uint64_t max_objects;
+    uint64_t max_bytes;
+    uint64_t limit;
+    up = up >> nonce >> search_id >> checks >> projection >> max_objects >> max_bytes >> limit;
 
-    if ((up >> nonce >> search_id >> checks).error())
+    if (up.error())
     {
         LOG(WARNING) << "unpack of REQ_SEARCH_START failed; here's some hex:  " << msg->hex();
         return;
     }
 
-    m_sm.start(from, vto, msg, nonce, search_id, &checks);
+    m_sm.start(from, vto, msg, nonce, search_id, &checks, &projection, max_objects, max_bytes, limit);
 }
 
 void
@@ -741,14 +819,16 @@ daemon :: process_req_search_next(server_id from,
 {
     uint64_t nonce;
     uint64_t search_id;
+    uint64_t max_objects;
+    uint64_t max_bytes;
 
-    if ((up >> nonce >> search_id).error())
+    if ((up >> nonce >> search_id >> max_objects >> max_bytes).error())
     {
         LOG(WARNING) << "unpack of REQ_SEARCH_NEXT failed; here's some hex:  " << msg->hex();
         return;
     }
 
-    m_sm.next(from, vto, nonce, search_id);
+    m_sm.next(from, vto, nonce, search_id, max_objects, max_bytes);
 }
 
 void
@@ -782,14 +862,15 @@ daemon :: process_req_sorted_search(server_id from,
     uint64_t limit;
     uint16_t sort_by;
     uint8_t flags;
+    std::vector<uint16_t> projection;
 
-    if ((up >> nonce >> checks >> limit >> sort_by >> flags).error())
+    if ((up >> nonce >> checks >> limit >> sort_by >> flags >> projection).error())
     {
         LOG(WARNING) << "unpack of REQ_SORTED_SEARCH failed; here's some hex:  " << msg->hex();
         return;
     }
 
-    m_sm.sorted_search(from, vto, nonce, &checks, limit, sort_by, flags & 0x1);
+    m_sm.sorted_search(from, vto, nonce, &checks, limit, sort_by, flags & 0x1, projection);
 }
 
 void
@@ -809,7 +890,29 @@ daemon :: process_req_group_del(server_id from,
     }
 
     e::slice sl("\x01\x00\x00\x00\x00\x00\x00\x00\x00", 9);
-    m_sm.group_keyop(from, vto, nonce, &checks, REQ_ATOMIC, sl, RESP_GROUP_DEL);
+    m_sm.group_keyop(from, vto, nonce, &checks, REQ_ATOMIC_BATCH, sl, RESP_GROUP_DEL);
+}
+
+void
+daemon :: process_req_group_atomic(server_id from,
+                                   virtual_server_id,
+                                   virtual_server_id vto,
+                                   std::auto_ptr<e::buffer> msg,
+                                   e::unpacker up)
+{
+    uint64_t nonce;
+    std::vector<attribute_check> checks;
+
+    if ((up >> nonce >> checks).error())
+    {
+        LOG(WARNING) << "unpack of REQ_GROUP_ATOMIC failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    // the remainder is the flags, checks and funcs of a REQ_ATOMIC, and is
+    // validated by the point leader of each matching key
+    e::slice sl = up.as_slice();
+    m_sm.group_keyop(from, vto, nonce, &checks, REQ_ATOMIC_BATCH, sl, RESP_GROUP_ATOMIC);
 }
 
 void
@@ -850,6 +953,27 @@ daemon :: process_req_search_describe(server_id from,
     m_sm.search_describe(from, vto, nonce, &checks);
 }
 
+void
+daemon :: process_req_aggregate(server_id from,
+                                virtual_server_id,
+                                virtual_server_id vto,
+                                std::auto_ptr<e::buffer> msg,
+                                e::unpacker up)
+{
+    uint64_t nonce;
+    std::vector<attribute_check> checks;
+    uint16_t attr;
+    aggregate_stats stats;
+
+    if ((up >> nonce >> checks >> attr >> stats).error())
+    {
+        LOG(WARNING) << "unpack of REQ_AGGREGATE failed; here's some hex:  " << msg->hex();
+        return;
+    }
+
+    m_sm.aggregate(from, vto, nonce, &checks, attr, &stats);
+}
+
 void
 daemon :: process_chain_op(server_id,
                            virtual_server_id vfrom,
@@ -1158,6 +1282,8 @@ daemon :: collect_stats()
         collect_stats_msgs(&ret);
         collect_stats_leveldb(&ret);
         collect_stats_io(&ret);
+        m_sm.collect_stats(&ret);
+        m_data.collect_stats(&ret);
         ret << "\n";
         std::string out = ret.str();
 
@@ -1179,13 +1305,16 @@ daemon :: collect_stats_msgs(std::ostringstream* ret)
 {
     *ret << " msgs.req_get=" << m_perf_req_get.read();
     *ret << " msgs.req_atomic=" << m_perf_req_atomic.read();
+    *ret << " msgs.req_atomic_batch=" << m_perf_req_atomic_batch.read();
     *ret << " msgs.req_search_start=" << m_perf_req_search_start.read();
     *ret << " msgs.req_search_next=" << m_perf_req_search_next.read();
     *ret << " msgs.req_search_stop=" << m_perf_req_search_stop.read();
     *ret << " msgs.req_sorted_search=" << m_perf_req_sorted_search.read();
     *ret << " msgs.req_group_del=" << m_perf_req_group_del.read();
+    *ret << " msgs.req_group_atomic=" << m_perf_req_group_atomic.read();
     *ret << " msgs.req_count=" << m_perf_req_count.read();
     *ret << " msgs.req_search_describe=" << m_perf_req_search_describe.read();
+    *ret << " msgs.req_aggregate=" << m_perf_req_aggregate.read();
     *ret << " msgs.chain_op=" << m_perf_chain_op.read();
     *ret << " msgs.chain_subspace=" << m_perf_chain_subspace.read();
     *ret << " msgs.chain_ack=" << m_perf_chain_ack.read();
@@ -68,19 +68,30 @@ class daemon
                 po6::net::location bind_to,
                 bool set_coordinator,
                 po6::net::hostname coordinator,
-                unsigned threads);
+                unsigned threads,
+                uint64_t snapshot_window,
+                uint64_t search_cache,
+                uint64_t search_idle_timeout,
+                uint64_t search_max_per_client,
+                uint64_t search_max_open,
+                uint64_t commit_latency,
+                uint64_t object_cache,
+                uint64_t dictionary_size);
 
     private:
         void loop(size_t thread);
         void process_req_get(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_atomic(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_req_atomic_batch(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_start(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_next(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_stop(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_sorted_search(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_group_del(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_req_group_atomic(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_count(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_req_search_describe(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
+        void process_req_aggregate(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_chain_op(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_chain_subspace(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
         void process_chain_ack(server_id from, virtual_server_id vfrom, virtual_server_id vto, std::auto_ptr<e::buffer> msg, e::unpacker up);
@@ -123,13 +134,16 @@ class daemon
         // counters
         performance_counter m_perf_req_get;
         performance_counter m_perf_req_atomic;
+        performance_counter m_perf_req_atomic_batch;
         performance_counter m_perf_req_search_start;
         performance_counter m_perf_req_search_next;
         performance_counter m_perf_req_search_stop;
         performance_counter m_perf_req_sorted_search;
         performance_counter m_perf_req_group_del;
+        performance_counter m_perf_req_group_atomic;
         performance_counter m_perf_req_count;
         performance_counter m_perf_req_search_describe;
+        performance_counter m_perf_req_aggregate;
         performance_counter m_perf_chain_op;
         performance_counter m_perf_chain_subspace;
         performance_counter m_perf_chain_ack;
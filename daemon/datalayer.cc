@@ -33,12 +33,16 @@
 
 // POSIX
 #include <signal.h>
+#include <time.h>
 
 // STL
 #include <algorithm>
 #include <sstream>
 #include <string>
 
+// Google CityHash
+#include <city.h>
+
 // Google Log
 #include <glog/logging.h>
 
@@ -47,7 +51,9 @@
 #include <hyperleveldb/filter_policy.h>
 
 // e
+#include <e/atomic.h>
 #include <e/endian.h>
+#include <e/time.h>
 
 // HyperDex
 #include "common/datatypes.h"
@@ -58,29 +64,120 @@
 #include "daemon/datalayer.h"
 #include "daemon/datalayer_encodings.h"
 #include "daemon/datalayer_iterator.h"
+#include "daemon/index_composite.h"
+#include "daemon/index_info.h"
 
 #define STRLENOF(x)	(sizeof(x)-1)
 
+// Relative costs used by the search planner:  reading an object while scanning
+// a region, reading one index entry, and fetching an object by its key.
+#define PLAN_COST_SCAN 1.0
+#define PLAN_COST_INDEX 1.0
+#define PLAN_COST_FETCH 4.0
+// The assumed selectivity of checks the statistics say nothing about
+#define PLAN_DEFAULT_SELECTIVITY 0.1
+// Objects scanned between checks for a pending reconfiguration
+#define STATS_PAUSE_CHECK 4096
+// Entries written or wiped per step of an online index build, and the most
+// objects per second the build may touch so that it leaves room for clients
+#define INDEX_BUILD_BATCH 1024
+#define INDEX_BUILD_RATE 16384
+// Regions share write epochs modulo this many counters
+#define REGION_EPOCH_STRIPES 1024
+// A group commit leader stops waiting for company at this many writers and
+// commits at most this many at once
+#define GROUP_COMMIT_MAX_WRITERS 256
+// A space's first dictionary is trained from this many times its size in
+// values; afterwards every Nth value is sampled to train the next version
+#define DICTIONARY_SAMPLE_RATIO 8
+#define DICTIONARY_RESAMPLE_INTERVAL 64
+// A new dictionary replaces the current one only if it stores the samples in
+// at least 1/Nth fewer bytes; each one that does not halves the sampling rate
+#define DICTIONARY_MIN_GAIN 32
+#define DICTIONARY_MAX_RESAMPLE_INTERVAL (1ULL << 24)
+
 // ASSUME:  all keys put into leveldb have a first byte without the high bit set
 
 using hyperdex::datalayer;
 using hyperdex::reconfigure_returncode;
 
+// the bytes compress_value would store for samples under dict, or under no
+// dictionary at all when dict is NULL
+static uint64_t
+stored_size(const std::vector<std::string>& samples,
+            const hyperdex::compression_dictionary* dict)
+{
+    uint64_t sz = 0;
+    std::string compressed;
+
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        size_t s = samples[i].size();
+
+        if (dict)
+        {
+            dict->compress(reinterpret_cast<const uint8_t*>(samples[i].data()),
+                           samples[i].size(), &compressed);
+            s = std::min(s, COMPRESSED_VALUE_HEADER_SIZE + compressed.size());
+        }
+
+        sz += s;
+    }
+
+    return sz;
+}
+
 datalayer :: datalayer(daemon* d)
     : m_daemon(d)
     , m_db()
     , m_checkpointer(std::tr1::bind(&datalayer::checkpointer, this))
     , m_wiper(std::tr1::bind(&datalayer::wiper, this))
+    , m_statistician(std::tr1::bind(&datalayer::statistician, this))
+    , m_indexer(std::tr1::bind(&datalayer::indexer, this))
+    , m_trainer(std::tr1::bind(&datalayer::trainer, this))
     , m_protect()
     , m_wakeup_checkpointer(&m_protect)
     , m_wakeup_wiper(&m_protect)
+    , m_wakeup_statistician(&m_protect)
+    , m_wakeup_indexer(&m_protect)
+    , m_wakeup_trainer(&m_protect)
     , m_wakeup_reconfigurer(&m_protect)
     , m_shutdown(true)
     , m_need_pause(false)
     , m_checkpointer_paused(false)
     , m_wiper_paused(false)
+    , m_statistician_paused(false)
+    , m_indexer_paused(false)
+    , m_trainer_paused(false)
     , m_checkpoint_gc(0)
     , m_wiping()
+    , m_stats_refresh()
+    , m_stats()
+    , m_index_builds()
+    , m_dict_training()
+    , m_replay_floor()
+    , m_key_locks(1024)
+    , m_write_epoch(0)
+    , m_search_snapshot_lock()
+    , m_search_snapshot()
+    , m_search_snapshot_epoch(0)
+    , m_search_snapshot_time(0)
+    , m_search_snapshot_expiry(0)
+    , m_snapshot_window(0)
+    , m_region_epochs(REGION_EPOCH_STRIPES, 0)
+    , m_commit_lock()
+    , m_commit_cond(&m_commit_lock)
+    , m_commit_queue()
+    , m_committing(false)
+    , m_commit_latency(0)
+    , m_objects()
+    , m_dict_lock()
+    , m_dicts()
+    , m_space_compression()
+    , m_dict_next(1)
+    , m_dict_size(0)
+    , m_compress_raw_bytes(0)
+    , m_compress_stored_bytes(0)
 {
     po6::threads::mutex::hold hold(&m_protect);
 }
@@ -211,10 +308,18 @@ datalayer :: initialize(const po6::pathname& path,
         return false;
     }
 
+    if (!load_index_builds() || !load_dictionaries())
+    {
+        return false;
+    }
+
     {
         po6::threads::mutex::hold hold(&m_protect);
         m_checkpointer.start();
         m_wiper.start();
+        m_statistician.start();
+        m_indexer.start();
+        m_trainer.start();
         m_shutdown = false;
     }
 
@@ -269,22 +374,29 @@ datalayer :: unpause()
     assert(m_need_pause);
     m_wakeup_checkpointer.broadcast();
     m_wakeup_wiper.broadcast();
+    m_wakeup_statistician.broadcast();
+    m_wakeup_indexer.broadcast();
+    m_wakeup_trainer.broadcast();
     m_need_pause = false;
 }
 
 void
 datalayer :: reconfigure(const configuration&,
-                         const configuration&,
-                         const server_id&)
+                         const configuration& new_config,
+                         const server_id& us)
 {
     {
         po6::threads::mutex::hold hold(&m_protect);
         assert(m_need_pause);
 
-        while (!m_checkpointer_paused || !m_wiper_paused)
+        while (!m_checkpointer_paused || !m_wiper_paused ||
+               !m_statistician_paused || !m_indexer_paused ||
+               !m_trainer_paused)
         {
             m_wakeup_reconfigurer.wait();
         }
+
+        plan_index_builds(new_config, us);
     }
 }
 
@@ -315,6 +427,16 @@ datalayer :: approximate_size()
     return ret;
 }
 
+void
+datalayer :: collect_stats(std::ostringstream* ret)
+{
+    m_objects.collect_stats(ret);
+    *ret << " compression.raw_bytes=" << e::atomic::load_64_acquire(&m_compress_raw_bytes);
+    *ret << " compression.stored_bytes=" << e::atomic::load_64_acquire(&m_compress_stored_bytes);
+    po6::threads::mutex::hold hold(&m_dict_lock);
+    *ret << " compression.dictionaries=" << m_dicts.size();
+}
+
 datalayer::returncode
 datalayer :: get(const region_id& ri,
                  const e::slice& key,
@@ -328,17 +450,49 @@ datalayer :: get(const region_id& ri,
     // create the encoded key
     leveldb::Slice lkey;
     encode_key(ri, sc.attrs[0].type, key, &scratch, &lkey);
+    e::slice ckey(lkey.data(), lkey.size());
+
+    // serve hot objects without touching LevelDB
+    object_cache::object_ptr cached;
+    uint64_t ticket = 0;
+
+    if (m_objects.lookup(ckey, &cached, &ticket))
+    {
+        *value = cached->value;
+        *version = cached->version;
+        ref->m_object = cached;
+        return SUCCESS;
+    }
 
     // perform the read
+    std::tr1::shared_ptr<object_cache::object> obj(new object_cache::object());
     leveldb::ReadOptions opts;
     opts.fill_cache = true;
     opts.verify_checksums = true;
-    leveldb::Status st = m_db->Get(opts, lkey, &ref->m_backing);
+    leveldb::Status st = m_db->Get(opts, lkey, &obj->backing);
 
     if (st.ok())
     {
-        e::slice v(ref->m_backing.data(), ref->m_backing.size());
-        return decode_value(v, value, version);
+        returncode rc = expand_value(&obj->backing);
+
+        if (rc != SUCCESS)
+        {
+            return rc;
+        }
+
+        e::slice v(obj->backing.data(), obj->backing.size());
+        rc = decode_value(v, &obj->value, &obj->version);
+
+        if (rc != SUCCESS)
+        {
+            return rc;
+        }
+
+        m_objects.fill(ckey, ticket, obj);
+        *value = obj->value;
+        *version = obj->version;
+        ref->m_object = obj;
+        return SUCCESS;
     }
     else if (st.IsNotFound())
     {
@@ -384,12 +538,19 @@ datalayer :: del(const region_id& ri,
     }
 
     // Perform the write
-    leveldb::WriteOptions opts;
-    opts.sync = false;
-    leveldb::Status st = m_db->Write(opts, &updates);
+    leveldb::Status st;
+
+    {
+        e::striped_lock<po6::threads::mutex>::hold hold(&m_key_locks, CityHash64(lkey.data(), lkey.size()));
+        st = group_commit(&updates);
+        cache_write(lkey, NULL, st);
+    }
+
+    note_write(ri);
 
     if (st.ok())
     {
+        m_stats.object_removed(ri);
         return SUCCESS;
     }
     else if (st.IsNotFound())
@@ -422,9 +583,13 @@ datalayer :: put(const region_id& ri,
     // create the encoded value
     leveldb::Slice lval;
     encode_value(new_value, version, &scratch2, &lval);
+    std::vector<char> scratch3;
+    leveldb::Slice sval(lval);
+    std::tr1::shared_ptr<compression_dictionary> dict;
+    compress_value(ri, lval, &scratch3, &sval, &dict);
 
     // put the actual object
-    updates.Put(lkey, lval);
+    updates.Put(lkey, sval);
 
     // put the index entries
     const subspace& sub(*m_daemon->m_config.get_subspace(ri));
@@ -442,12 +607,19 @@ datalayer :: put(const region_id& ri,
     }
 
     // Perform the write
-    leveldb::WriteOptions opts;
-    opts.sync = false;
-    leveldb::Status st = m_db->Write(opts, &updates);
+    leveldb::Status st;
+
+    {
+        e::striped_lock<po6::threads::mutex>::hold hold(&m_key_locks, CityHash64(lkey.data(), lkey.size()));
+        st = group_commit(&updates);
+        cache_write(lkey, &lval, st);
+    }
+
+    note_write(ri);
 
     if (st.ok())
     {
+        m_stats.object_added(ri);
         return SUCCESS;
     }
     else
@@ -477,9 +649,13 @@ datalayer :: overput(const region_id& ri,
     // create the encoded value
     leveldb::Slice lval;
     encode_value(new_value, version, &scratch2, &lval);
+    std::vector<char> scratch3;
+    leveldb::Slice sval(lval);
+    std::tr1::shared_ptr<compression_dictionary> dict;
+    compress_value(ri, lval, &scratch3, &sval, &dict);
 
     // put the actual object
-    updates.Put(lkey, lval);
+    updates.Put(lkey, sval);
 
     // put the index entries
     const subspace& sub(*m_daemon->m_config.get_subspace(ri));
@@ -497,12 +673,19 @@ datalayer :: overput(const region_id& ri,
     }
 
     // Perform the write
-    leveldb::WriteOptions opts;
-    opts.sync = false;
-    leveldb::Status st = m_db->Write(opts, &updates);
+    leveldb::Status st;
+
+    {
+        e::striped_lock<po6::threads::mutex>::hold hold(&m_key_locks, CityHash64(lkey.data(), lkey.size()));
+        st = group_commit(&updates);
+        cache_write(lkey, &lval, st);
+    }
+
+    note_write(ri);
 
     if (st.ok())
     {
+        m_stats.object_changed(ri);
         return SUCCESS;
     }
     else
@@ -533,8 +716,15 @@ datalayer :: uncertain_del(const region_id& ri,
     {
         std::vector<e::slice> old_value;
         uint64_t old_version;
-        returncode rc = decode_value(e::slice(ref.data(), ref.size()),
-                                     &old_value, &old_version);
+        returncode rc = expand_value(&ref);
+
+        if (rc != SUCCESS)
+        {
+            return rc;
+        }
+
+        rc = decode_value(e::slice(ref.data(), ref.size()),
+                          &old_value, &old_version);
 
         if (rc != SUCCESS)
         {
@@ -582,8 +772,15 @@ datalayer :: uncertain_put(const region_id& ri,
     {
         std::vector<e::slice> old_value;
         uint64_t old_version;
-        returncode rc = decode_value(e::slice(ref.data(), ref.size()),
-                                     &old_value, &old_version);
+        returncode rc = expand_value(&ref);
+
+        if (rc != SUCCESS)
+        {
+            return rc;
+        }
+
+        rc = decode_value(e::slice(ref.data(), ref.size()),
+                          &old_value, &old_version);
 
         if (rc != SUCCESS)
         {
@@ -789,6 +986,267 @@ datalayer :: make_snapshot()
     return leveldb_snapshot_ptr(m_db, m_db->GetSnapshot());
 }
 
+datalayer::snapshot
+datalayer :: make_search_snapshot()
+{
+    uint64_t epoch = e::atomic::load_64_acquire(&m_write_epoch);
+    uint64_t now = e::time();
+    po6::threads::mutex::hold hold(&m_search_snapshot_lock);
+
+    if (!m_search_snapshot.get() ||
+        (m_search_snapshot_epoch != epoch &&
+         m_search_snapshot_time + m_snapshot_window <= now))
+    {
+        m_search_snapshot = make_snapshot();
+        m_search_snapshot_epoch = epoch;
+        m_search_snapshot_time = now;
+        e::atomic::store_64_release(&m_search_snapshot_expiry,
+                                    std::max(now + m_snapshot_window, static_cast<uint64_t>(1)));
+    }
+
+    return m_search_snapshot;
+}
+
+void
+datalayer :: expire_search_snapshot()
+{
+    // Searches that started on the shared snapshot keep their own reference;
+    // ours only pins the versions that writes replace, so it is dropped by
+    // the first write after the window rather than held until the next search.
+    uint64_t expiry = e::atomic::load_64_acquire(&m_search_snapshot_expiry);
+
+    if (expiry == 0 || e::time() < expiry)
+    {
+        return;
+    }
+
+    snapshot old;
+    po6::threads::mutex::hold hold(&m_search_snapshot_lock);
+    expiry = m_search_snapshot_expiry;
+
+    if (expiry != 0 && e::time() >= expiry)
+    {
+        old = m_search_snapshot;
+        m_search_snapshot = snapshot();
+        e::atomic::store_64_release(&m_search_snapshot_expiry, 0);
+    }
+}
+
+void
+datalayer :: set_snapshot_window(uint64_t nanos)
+{
+    po6::threads::mutex::hold hold(&m_search_snapshot_lock);
+    m_snapshot_window = nanos;
+}
+
+uint64_t
+datalayer :: region_epoch(const region_id& ri)
+{
+    return e::atomic::load_64_acquire(&m_region_epochs[ri.get() % m_region_epochs.size()]);
+}
+
+void
+datalayer :: set_commit_latency(uint64_t nanos)
+{
+    po6::threads::mutex::hold hold(&m_commit_lock);
+    m_commit_latency = nanos;
+}
+
+class datalayer::commit_waiter
+{
+    public:
+        commit_waiter(leveldb::WriteBatch* u) : updates(u), status(), done(false) {}
+        ~commit_waiter() throw () {}
+
+    public:
+        leveldb::WriteBatch* updates;
+        leveldb::Status status;
+        bool done;
+
+    private:
+        commit_waiter(const commit_waiter&);
+        commit_waiter& operator = (const commit_waiter&);
+};
+
+namespace
+{
+
+// copies every update of the batches it iterates into one batch
+class batch_appender : public leveldb::WriteBatch::Handler
+{
+    public:
+        batch_appender(leveldb::WriteBatch* to) : m_to(to) {}
+        virtual ~batch_appender() throw () {}
+
+    public:
+        virtual void Put(const leveldb::Slice& key, const leveldb::Slice& value)
+        { m_to->Put(key, value); }
+        virtual void Delete(const leveldb::Slice& key)
+        { m_to->Delete(key); }
+
+    private:
+        batch_appender(const batch_appender&);
+        batch_appender& operator = (const batch_appender&);
+
+    private:
+        leveldb::WriteBatch* m_to;
+};
+
+} // namespace
+
+leveldb::Status
+datalayer :: group_commit(leveldb::WriteBatch* updates)
+{
+    commit_waiter w(updates);
+    m_commit_lock.lock();
+    m_commit_queue.push_back(&w);
+
+    while (true)
+    {
+        // writers that queue while a leader writes are committed by a later one
+        while (!w.done && m_committing)
+        {
+            m_commit_cond.wait();
+        }
+
+        if (w.done)
+        {
+            m_commit_lock.unlock();
+            return w.status;
+        }
+
+        m_committing = true;
+
+        if (m_commit_latency > 0 &&
+            m_commit_queue.size() < GROUP_COMMIT_MAX_WRITERS)
+        {
+            struct timespec ts;
+            ts.tv_sec = m_commit_latency / 1000000000ULL;
+            ts.tv_nsec = m_commit_latency % 1000000000ULL;
+            m_commit_lock.unlock();
+            nanosleep(&ts, NULL);
+            m_commit_lock.lock();
+        }
+
+        // the oldest writers go first; this one may have to lead again if it
+        // queued behind a full group
+        std::list<commit_waiter*>::iterator end = m_commit_queue.begin();
+
+        for (size_t i = 0; i < GROUP_COMMIT_MAX_WRITERS &&
+                end != m_commit_queue.end(); ++i)
+        {
+            ++end;
+        }
+
+        std::list<commit_waiter*> group;
+        group.splice(group.begin(), m_commit_queue, m_commit_queue.begin(), end);
+        m_commit_lock.unlock();
+
+        leveldb::WriteOptions opts;
+        opts.sync = false;
+        leveldb::Status st;
+
+        if (group.size() == 1)
+        {
+            st = m_db->Write(opts, group.front()->updates);
+        }
+        else
+        {
+            leveldb::WriteBatch merged;
+            batch_appender appender(&merged);
+
+            for (std::list<commit_waiter*>::iterator it = group.begin();
+                    st.ok() && it != group.end(); ++it)
+            {
+                st = (*it)->updates->Iterate(&appender);
+            }
+
+            if (st.ok())
+            {
+                st = m_db->Write(opts, &merged);
+            }
+        }
+
+        m_commit_lock.lock();
+
+        for (std::list<commit_waiter*>::iterator it = group.begin();
+                it != group.end(); ++it)
+        {
+            (*it)->status = st;
+            (*it)->done = true;
+        }
+
+        m_committing = false;
+        m_commit_cond.broadcast();
+    }
+}
+
+void
+datalayer :: set_object_cache_size(uint64_t bytes)
+{
+    m_objects.set_capacity(bytes);
+}
+
+void
+datalayer :: set_dictionary_size(uint64_t bytes)
+{
+    po6::threads::mutex::hold hold(&m_dict_lock);
+    m_dict_size = bytes;
+}
+
+class datalayer::space_compression
+{
+    public:
+        space_compression()
+            : current(0), writes(0), interval(1), samples(), sample_bytes(0), training(false) {}
+        ~space_compression() throw () {}
+
+    public:
+        // the dictionary new values are compressed with; 0 for none yet
+        uint32_t current;
+        uint64_t writes;
+        // every interval-th value written is sampled
+        uint64_t interval;
+        std::vector<std::string> samples;
+        uint64_t sample_bytes;
+        bool training;
+
+    private:
+        space_compression(const space_compression&);
+        space_compression& operator = (const space_compression&);
+};
+
+void
+datalayer :: cache_write(const leveldb::Slice& lkey,
+                         const leveldb::Slice* lval,
+                         const leveldb::Status& st)
+{
+    e::slice ckey(lkey.data(), lkey.size());
+    std::tr1::shared_ptr<object_cache::object> obj;
+
+    if (st.ok() && lval)
+    {
+        obj.reset(new object_cache::object());
+        obj->backing.assign(lval->data(), lval->size());
+        e::slice v(obj->backing.data(), obj->backing.size());
+
+        if (decode_value(v, &obj->value, &obj->version) != SUCCESS)
+        {
+            obj.reset();
+        }
+    }
+
+    m_objects.update(ckey, obj);
+}
+
+void
+datalayer :: note_write(const region_id& ri)
+{
+    e::atomic::increment_64_nobarrier(&m_write_epoch, 1);
+    e::atomic::increment_64_nobarrier(&m_region_epochs[ri.get() % m_region_epochs.size()], 1);
+    expire_search_snapshot();
+}
+
 datalayer::iterator*
 datalayer :: make_region_iterator(snapshot snap,
                                   const region_id& ri,
@@ -815,527 +1273,2104 @@ datalayer::iterator*
 datalayer :: make_search_iterator(snapshot snap,
                                   const region_id& ri,
                                   const std::vector<attribute_check>& checks,
+                                  const std::vector<uint16_t>* projection,
                                   std::ostringstream* ostr)
 {
-    const schema& sc(*m_daemon->m_config.get_schema(ri));
-    std::vector<e::intrusive_ptr<index_iterator> > iterators;
-
-    // pull a set of range queries from checks
-    std::vector<range> ranges;
-    range_searches(checks, &ranges);
-    index_info* ki = index_info::lookup(sc.attrs[0].type);
-    const subspace& sub(*m_daemon->m_config.get_subspace(ri));
+    e::intrusive_ptr<index_iterator> best;
+    bool covered = false;
 
-    // for each range query, construct an iterator
-    for (size_t i = 0; i < ranges.size(); ++i)
+    if (!plan_search(snap, ri, checks, ostr, &best, &covered))
     {
-        if (ranges[i].invalid)
-        {
-            if (ostr) *ostr << "encountered invalid range; returning no results\n";
-            return new dummy_iterator();
-        }
+        return new dummy_iterator();
+    }
 
-        assert(ranges[i].attr < sc.attrs_sz);
-        assert(ranges[i].type == sc.attrs[ranges[i].attr].type);
+    bool cover = covering(ri, checks, projection);
+    if (ostr) *ostr << "covering index " << (cover ? "answers" : "cannot answer") << " the search\n";
+    return new search_iterator(this, ri, best, ostr, &checks, cover);
+}
 
-        if (ostr) *ostr << "considering attr " << ranges[i].attr << " Range("
-                        << ranges[i].start.hex() << ", " << ranges[i].end.hex() << " " << ranges[i].type << " "
-                        << (ranges[i].has_start ? "[" : "<") << "-" << (ranges[i].has_end ? "]" : ">")
-                        << " " << (ranges[i].invalid ? "invalid" : "valid") << "\n";
+void
+datalayer :: make_count_iterator(snapshot snap,
+                                 const region_id& ri,
+                                 const std::vector<attribute_check>& checks,
+                                 e::intrusive_ptr<iterator>* iter)
+{
+    e::intrusive_ptr<index_iterator> best;
+    bool covered = false;
+
+    if (!plan_search(snap, ri, checks, NULL, &best, &covered))
+    {
+        *iter = new dummy_iterator();
+    }
+    // the index entries alone decide every check, so skip the objects
+    else if (covered)
+    {
+        *iter = best.get();
+    }
+    else
+    {
+        // counting reads nothing but the checked attributes
+        std::vector<uint16_t> checked;
 
-        if (!sub.indexed(ranges[i].attr))
+        for (size_t i = 0; i < checks.size(); ++i)
         {
-            continue;
+            checked.push_back(checks[i].attr);
         }
 
-        index_info* ii = index_info::lookup(ranges[i].type);
+        *iter = new search_iterator(this, ri, best, NULL, &checks,
+                                    covering(ri, checks, &checked));
+    }
+}
 
-        if (ii)
-        {
-            e::intrusive_ptr<index_iterator> it = ii->iterator_from_range(snap, ri, ranges[i], ki);
+bool
+datalayer :: covering(const region_id& ri,
+                      const std::vector<attribute_check>& checks,
+                      const std::vector<uint16_t>* projection)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    const subspace& sub(*m_daemon->m_config.get_subspace(ri));
 
-            if (it)
-            {
-                iterators.push_back(it);
-            }
-        }
+    if (!projection || sub.covering.empty())
+    {
+        return false;
     }
 
-    // for everything that is not a range query, construct an iterator
     for (size_t i = 0; i < checks.size(); ++i)
     {
-        if (checks[i].predicate == HYPERPREDICATE_EQUALS ||
-            checks[i].predicate == HYPERPREDICATE_LESS_EQUAL ||
-            checks[i].predicate == HYPERPREDICATE_GREATER_EQUAL)
+        if (!sub.covers(checks[i].attr))
         {
-            continue;
+            return false;
         }
+    }
 
-        if (!sub.indexed(checks[i].attr))
+    for (size_t i = 0; i < projection->size(); ++i)
+    {
+        if (!sub.covers((*projection)[i]))
         {
-            continue;
+            return false;
         }
+    }
 
-        index_info* ii = index_info::lookup(sc.attrs[checks[i].attr].type);
-
-        if (ii)
+    // an empty projection reads every attribute
+    for (uint16_t attr = 1; projection->empty() && attr < sc.attrs_sz; ++attr)
+    {
+        if (!sub.covers(attr))
         {
-            e::intrusive_ptr<index_iterator> it = ii->iterator_from_check(snap, ri, checks[i], ki);
-
-            if (it)
-            {
-                iterators.push_back(it);
-            }
+            return false;
         }
     }
 
-    // figure out the cost of accessing all objects
-    e::intrusive_ptr<index_iterator> full_scan;
-    range scan;
-    scan.attr = 0;
-    scan.type = sc.attrs[0].type;
+    return true;
+}
+
+bool
+datalayer :: index_ready(const region_id& ri, const subspace& sub, uint16_t attr)
+{
+    if (!sub.indexed(attr))
+    {
+        return false;
+    }
+
+    po6::threads::mutex::hold hold(&m_protect);
+    index_build_map_t::iterator it = m_index_builds.find(ri);
+
+    for (size_t i = 0; it != m_index_builds.end() && i < it->second.size(); ++i)
+    {
+        if (it->second[i].attr == attr)
+        {
+            return it->second[i].phase == INDEX_BUILT;
+        }
+    }
+
+    return true;
+}
+
+bool
+datalayer :: plan_search(snapshot snap,
+                         const region_id& ri,
+                         const std::vector<attribute_check>& checks,
+                         std::ostringstream* ostr,
+                         e::intrusive_ptr<index_iterator>* _best,
+                         bool* covered)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    std::vector<e::intrusive_ptr<index_iterator> > iterators;
+    // the attributes whose ranges each iterator matches exactly; empty for
+    // iterators that may return more than their checks admit
+    std::vector<std::vector<uint16_t> > exact;
+    // the estimated fraction of objects each iterator returns, or negative
+    // when unknown
+    std::vector<double> selectivity;
+
+    // statistics are rebuilt in the background; until the first summary for
+    // the region exists, fall back to asking LevelDB about each range
+    uint64_t objects = 0;
+    bool refresh = false;
+    index_stats::summary_ptr stats = m_stats.lookup(ri, &objects, &refresh);
+
+    if (refresh)
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+        m_stats_refresh.push_back(ri);
+        m_wakeup_statistician.signal();
+    }
+
+    // pull a set of range queries from checks
+    std::vector<range> ranges;
+    range_searches(checks, &ranges);
+    index_info* ki = index_info::lookup(sc.attrs[0].type);
+    const subspace& sub(*m_daemon->m_config.get_subspace(ri));
+
+    // for each range query, construct an iterator
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        if (ranges[i].invalid)
+        {
+            if (ostr) *ostr << "encountered invalid range; returning no results\n";
+            return false;
+        }
+
+        assert(ranges[i].attr < sc.attrs_sz);
+        assert(ranges[i].type == sc.attrs[ranges[i].attr].type);
+
+        if (ostr) *ostr << "considering attr " << ranges[i].attr << " Range("
+                        << ranges[i].start.hex() << ", " << ranges[i].end.hex() << " " << ranges[i].type << " "
+                        << (ranges[i].has_start ? "[" : "<") << "-" << (ranges[i].has_end ? "]" : ">")
+                        << " " << (ranges[i].invalid ? "invalid" : "valid") << "\n";
+
+        if (!index_ready(ri, sub, ranges[i].attr))
+        {
+            continue;
+        }
+
+        index_info* ii = index_info::lookup(ranges[i].type);
+
+        if (ii)
+        {
+            e::intrusive_ptr<index_iterator> it = ii->iterator_from_range(snap, ri, ranges[i], ki);
+
+            if (it)
+            {
+                iterators.push_back(it);
+                exact.push_back(std::vector<uint16_t>(1, ranges[i].attr));
+                selectivity.push_back(stats ? stats->selectivity(ranges[i]) : -1);
+            }
+        }
+    }
+
+    // a composite index answers equalities on its leading attributes and a
+    // range on the next one with a single walk
+    for (size_t i = 0; i < sub.composites.size(); ++i)
+    {
+        index_composite ci(sc, sub, i);
+        std::vector<uint16_t> bound;
+        e::intrusive_ptr<index_iterator> it = ci.iterator_from_ranges(snap, ri, ranges, ki, &bound);
+
+        // binding only an attribute with its own index gains nothing
+        if (!it || (bound.size() == 1 && index_ready(ri, sub, bound[0])))
+        {
+            continue;
+        }
+
+        double sel = stats ? 1 : -1;
+
+        for (size_t j = 0; stats && j < ranges.size(); ++j)
+        {
+            if (std::find(bound.begin(), bound.end(), ranges[j].attr) != bound.end())
+            {
+                double s = stats->selectivity(ranges[j]);
+                sel = s < 0 || sel < 0 ? -1 : sel * s;
+            }
+        }
+
+        if (ostr) *ostr << "composite index " << i << " binds " << bound.size() << " attributes\n";
+        iterators.push_back(it);
+        exact.push_back(bound);
+        selectivity.push_back(sel);
+    }
+
+    // for everything that is not a range query, construct an iterator
+    for (size_t i = 0; i < checks.size(); ++i)
+    {
+        if (checks[i].predicate == HYPERPREDICATE_EQUALS ||
+            checks[i].predicate == HYPERPREDICATE_LESS_EQUAL ||
+            checks[i].predicate == HYPERPREDICATE_GREATER_EQUAL)
+        {
+            continue;
+        }
+
+        if (!index_ready(ri, sub, checks[i].attr))
+        {
+            continue;
+        }
+
+        index_info* ii = index_info::lookup(sc.attrs[checks[i].attr].type);
+
+        // an IN-list is the union of one equality walk per candidate
+        if (ii && checks[i].predicate == HYPERPREDICATE_IN)
+        {
+            std::vector<e::slice> elems;
+
+            if (!unpack_in_check(sc, checks[i], &elems))
+            {
+                continue;
+            }
+
+            std::vector<e::intrusive_ptr<index_iterator> > alternatives;
+            double sel = stats ? 0 : -1;
+
+            for (size_t j = 0; j < elems.size(); ++j)
+            {
+                range r;
+                r.attr = checks[i].attr;
+                r.type = sc.attrs[checks[i].attr].type;
+                r.start = elems[j];
+                r.end = elems[j];
+                r.has_start = true;
+                r.has_end = true;
+                r.invalid = false;
+                e::intrusive_ptr<index_iterator> it = ii->iterator_from_range(snap, ri, r, ki);
+
+                if (!it)
+                {
+                    alternatives.clear();
+                    break;
+                }
+
+                alternatives.push_back(it);
+                double s = stats ? stats->selectivity(r) : -1;
+                sel = s < 0 || sel < 0 ? -1 : std::min(sel + s, 1.0);
+            }
+
+            if (alternatives.empty() && !elems.empty())
+            {
+                continue;
+            }
+
+            if (ostr) *ostr << "IN-list on attr " << checks[i].attr << " has "
+                            << elems.size() << " candidates\n";
+            iterators.push_back(new union_iterator(snap, alternatives));
+            exact.push_back(std::vector<uint16_t>());
+            selectivity.push_back(sel);
+            continue;
+        }
+
+        if (ii)
+        {
+            e::intrusive_ptr<index_iterator> it = ii->iterator_from_check(snap, ri, checks[i], ki);
+
+            if (it)
+            {
+                iterators.push_back(it);
+                exact.push_back(std::vector<uint16_t>());
+                selectivity.push_back(-1);
+            }
+        }
+    }
+
+    // the iterator for accessing all objects
+    e::intrusive_ptr<index_iterator> full_scan;
+    range scan;
+    scan.attr = 0;
+    scan.type = sc.attrs[0].type;
     scan.has_start = false;
     scan.has_end = false;
     scan.invalid = false;
     full_scan = ki->iterator_from_range(snap, ri, scan, ki);
-    if (ostr) *ostr << "accessing all objects has cost " << full_scan->cost(m_db.get()) << "\n";
 
-    // figure out the cost of each iterator
-    // we do this here and not below so that iterators can cache the size and we
-    // don't ping-pong between HyperDex and LevelDB.
-    for (size_t i = 0; i < iterators.size(); ++i)
+    e::intrusive_ptr<index_iterator> best;
+    std::vector<uint16_t> best_exact;
+
+    if (stats)
+    {
+        plan_from_statistics(snap, objects, iterators, exact, selectivity,
+                             full_scan, ostr, &best, &best_exact);
+    }
+    else
+    {
+        if (ostr) *ostr << "no statistics for region; estimating from LevelDB\n";
+        if (ostr) *ostr << "accessing all objects has cost " << full_scan->cost(m_db.get()) << "\n";
+
+        // figure out the cost of each iterator
+        // we do this here and not below so that iterators can cache the size and we
+        // don't ping-pong between HyperDex and LevelDB.
+        std::vector<uint64_t> costs;
+
+        for (size_t i = 0; i < iterators.size(); ++i)
+        {
+            costs.push_back(iterators[i]->cost(m_db.get()));
+            if (ostr) *ostr << "iterator " << *iterators[i] << " has cost " << costs.back() << "\n";
+        }
+
+        std::vector<e::intrusive_ptr<index_iterator> > sorted;
+        std::vector<e::intrusive_ptr<index_iterator> > unsorted;
+        std::vector<uint64_t> sorted_costs;
+        std::vector<uint16_t> sorted_exact;
+        std::vector<uint16_t> unsorted_exact;
+
+        for (size_t i = 0; i < iterators.size(); ++i)
+        {
+            if (iterators[i]->sorted())
+            {
+                sorted.push_back(iterators[i]);
+                sorted_costs.push_back(costs[i]);
+                sorted_exact.insert(sorted_exact.end(), exact[i].begin(), exact[i].end());
+            }
+            else
+            {
+                unsorted.push_back(iterators[i]);
+                unsorted_exact.insert(unsorted_exact.end(), exact[i].begin(), exact[i].end());
+            }
+        }
+
+        if (!sorted.empty())
+        {
+            best = new intersect_iterator(snap, sorted, sorted_costs);
+            best_exact = sorted_exact;
+        }
+
+        if (!best || best->cost(m_db.get()) * 4 > full_scan->cost(m_db.get()))
+        {
+            best = full_scan;
+            best_exact.clear();
+        }
+
+        // intersect the unsorted iterators, and whatever the sorted ones
+        // narrowed the search to, through a hash set of keys
+        if (!unsorted.empty())
+        {
+            std::vector<uint64_t> unsorted_costs;
+
+            for (size_t i = 0; i < iterators.size(); ++i)
+            {
+                if (!iterators[i]->sorted())
+                {
+                    unsorted_costs.push_back(costs[i]);
+                }
+            }
+
+            std::vector<uint16_t> narrowed_exact(unsorted_exact);
+
+            if (best != full_scan)
+            {
+                unsorted.push_back(best);
+                unsorted_costs.push_back(best->cost(m_db.get()));
+                narrowed_exact.insert(narrowed_exact.end(), best_exact.begin(), best_exact.end());
+            }
+
+            e::intrusive_ptr<index_iterator> narrowed;
+            uint64_t narrowed_cost = unsorted_costs[0];
+
+            if (unsorted.size() == 1)
+            {
+                narrowed = unsorted[0];
+            }
+            else
+            {
+                narrowed = new hash_intersect_iterator(snap, unsorted, unsorted_costs);
+                narrowed_cost = narrowed->cost(m_db.get());
+            }
+
+            if (narrowed_cost * 4 <= full_scan->cost(m_db.get()))
+            {
+                best = narrowed;
+                best_exact = narrowed_exact;
+            }
+        }
+    }
+
+    assert(best);
+    if (ostr) *ostr << "choosing to use " << *best << "\n";
+
+    // only range predicates are enforced by the index; everything else needs
+    // the object itself
+    *covered = true;
+
+    for (size_t i = 0; *covered && i < checks.size(); ++i)
+    {
+        *covered = (checks[i].predicate == HYPERPREDICATE_EQUALS ||
+                    checks[i].predicate == HYPERPREDICATE_LESS_EQUAL ||
+                    checks[i].predicate == HYPERPREDICATE_GREATER_EQUAL) &&
+                   std::find(best_exact.begin(), best_exact.end(), checks[i].attr) != best_exact.end();
+    }
+
+    if (ostr) *ostr << "index " << (*covered ? "covers" : "does not cover") << " all checks\n";
+    *_best = best;
+    return true;
+}
+
+void
+datalayer :: plan_from_statistics(snapshot snap,
+                                  uint64_t objects,
+                                  const std::vector<e::intrusive_ptr<index_iterator> >& iterators,
+                                  const std::vector<std::vector<uint16_t> >& exact,
+                                  const std::vector<double>& selectivity,
+                                  e::intrusive_ptr<index_iterator> full_scan,
+                                  std::ostringstream* ostr,
+                                  e::intrusive_ptr<index_iterator>* best,
+                                  std::vector<uint16_t>* best_exact)
+{
+    double best_cost = objects * PLAN_COST_SCAN;
+    *best = full_scan;
+    best_exact->clear();
+    if (ostr) *ostr << "accessing all " << objects << " objects has estimated cost " << best_cost << "\n";
+
+    // (selectivity, iterator) for every iterator
+    std::vector<std::pair<double, size_t> > candidates;
+
+    for (size_t i = 0; i < iterators.size(); ++i)
+    {
+        double sel = selectivity[i] < 0 ? PLAN_DEFAULT_SELECTIVITY : selectivity[i];
+        if (ostr) *ostr << "iterator " << *iterators[i] << " has estimated selectivity " << sel << "\n";
+        candidates.push_back(std::make_pair(sel, i));
+    }
+
+    // Intersect iterators, most selective first, for as long as each one
+    // saves more in fetched objects than it costs to walk.  Checks are
+    // assumed to be independent.
+    std::sort(candidates.begin(), candidates.end());
+    double walked = 0;
+    double fraction = 1;
+    double intersect_cost = 0;
+    size_t chosen = 0;
+
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        double w = walked + objects * candidates[i].first * PLAN_COST_INDEX;
+        double f = fraction * candidates[i].first;
+        double cost = w + objects * f * PLAN_COST_FETCH;
+
+        if (chosen > 0 && cost >= intersect_cost)
+        {
+            break;
+        }
+
+        walked = w;
+        fraction = f;
+        intersect_cost = cost;
+        ++chosen;
+    }
+
+    if (chosen == 0 || intersect_cost >= best_cost)
+    {
+        if (ostr) *ostr << "chosen plan has estimated cost " << best_cost << "\n";
+        return;
+    }
+
+    // sorted iterators intersect by seeking each other; any unsorted ones
+    // are intersected with that result through a hash set of keys
+    std::vector<e::intrusive_ptr<index_iterator> > sorted;
+    std::vector<uint64_t> sorted_costs;
+    std::vector<e::intrusive_ptr<index_iterator> > unsorted;
+    std::vector<uint64_t> unsorted_costs;
+    best_exact->clear();
+
+    for (size_t i = 0; i < chosen; ++i)
+    {
+        e::intrusive_ptr<index_iterator> it = iterators[candidates[i].second];
+        uint64_t cost = objects * candidates[i].first;
+        const std::vector<uint16_t>& ex(exact[candidates[i].second]);
+        best_exact->insert(best_exact->end(), ex.begin(), ex.end());
+
+        if (it->sorted())
+        {
+            sorted.push_back(it);
+            sorted_costs.push_back(cost);
+        }
+        else
+        {
+            unsorted.push_back(it);
+            unsorted_costs.push_back(cost);
+        }
+    }
+
+    if (sorted.size() == 1)
+    {
+        unsorted.push_back(sorted[0]);
+        unsorted_costs.push_back(sorted_costs[0]);
+    }
+    else if (sorted.size() > 1)
+    {
+        e::intrusive_ptr<index_iterator> it = new intersect_iterator(snap, sorted, sorted_costs);
+        unsorted.push_back(it);
+        unsorted_costs.push_back(*std::min_element(sorted_costs.begin(), sorted_costs.end()));
+    }
+
+    if (unsorted.size() == 1)
+    {
+        *best = unsorted[0];
+    }
+    else
+    {
+        *best = new hash_intersect_iterator(snap, unsorted, unsorted_costs);
+    }
+
+    best_cost = intersect_cost;
+    if (ostr) *ostr << "chosen plan has estimated cost " << best_cost << "\n";
+}
+
+
+datalayer::iterator*
+datalayer :: make_ordered_search_iterator(snapshot snap,
+                                          const region_id& ri,
+                                          const std::vector<attribute_check>& checks,
+                                          uint16_t sort_by,
+                                          bool reverse)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    const subspace& sub(*m_daemon->m_config.get_subspace(ri));
+
+    if (sort_by >= sc.attrs_sz ||
+        (sort_by != 0 && !index_ready(ri, sub, sort_by)))
+    {
+        return NULL;
+    }
+
+    // an equality check on another indexed attribute narrows the search far
+    // more than walking the sort order would; leave it to the regular plan
+    for (size_t i = 0; i < checks.size(); ++i)
+    {
+        if (checks[i].attr != sort_by &&
+            checks[i].predicate == HYPERPREDICATE_EQUALS &&
+            (checks[i].attr == 0 || index_ready(ri, sub, checks[i].attr)))
+        {
+            return NULL;
+        }
+    }
+
+    // bound the walk by whatever range the checks place on sort_by
+    std::vector<range> ranges;
+    range_searches(checks, &ranges);
+    range r;
+    r.attr = sort_by;
+    r.type = sc.attrs[sort_by].type;
+    r.has_start = false;
+    r.has_end = false;
+    r.invalid = false;
+
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        if (ranges[i].attr == sort_by)
+        {
+            r = ranges[i];
+            break;
+        }
+    }
+
+    if (r.invalid)
+    {
+        return new dummy_iterator();
+    }
+
+    index_info* ki = index_info::lookup(sc.attrs[0].type);
+    index_info* ii = index_info::lookup(r.type);
+
+    if (!ki || !ii)
+    {
+        return NULL;
+    }
+
+    e::intrusive_ptr<index_iterator> it = ii->ordered_iterator_from_range(snap, ri, r, reverse, ki);
+
+    if (!it)
+    {
+        return NULL;
+    }
+
+    return new search_iterator(this, ri, it, NULL, &checks, false);
+}
+
+datalayer::returncode
+datalayer :: get_from_iterator(const region_id& ri,
+                               iterator* iter,
+                               const std::vector<uint16_t>* reads,
+                               e::slice* key,
+                               std::vector<e::slice>* value,
+                               uint64_t* version,
+                               reference* ref)
+{
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    std::vector<char> scratch;
+    e::slice covered = iter->covered();
+
+    // the key is kept apart from the value so that neither is copied to
+    // make room for the other
+    e::slice ikey = iter->key();
+    ref->m_key.assign(reinterpret_cast<const char*>(ikey.data()), ikey.size());
+    *key = e::slice(ref->m_key.data(), ref->m_key.size());
+
+    if (!covered.empty())
+    {
+        ref->m_backing.assign(reinterpret_cast<const char*>(covered.data()), covered.size());
+        *version = 0;
+        e::slice v(ref->m_backing.data(), ref->m_backing.size());
+        return decode_covering(sc, *m_daemon->m_config.get_subspace(ri), v, value);
+    }
+
+    // the iterator may have read the object while evaluating checks, in
+    // which case its buffer is handed over rather than copied
+    leveldb::Status st;
+
+    if (!iter->take_prefetched(&ref->m_backing))
+    {
+        // create the encoded key
+        leveldb::Slice lkey;
+        encode_key(ri, sc.attrs[0].type, *key, &scratch, &lkey);
+
+        // perform the read
+        leveldb::ReadOptions opts;
+        opts.fill_cache = true;
+        opts.verify_checksums = true;
+        opts.snapshot = iter->snap().get();
+        st = m_db->Get(opts, lkey, &ref->m_backing);
+    }
+
+    if (st.ok())
+    {
+        returncode rc = expand_value(&ref->m_backing);
+
+        if (rc != SUCCESS)
+        {
+            return rc;
+        }
+
+        e::slice v(ref->m_backing.data(), ref->m_backing.size());
+        return decode_value_attrs(v, reads, value, version);
+    }
+    else if (st.IsNotFound())
+    {
+        return NOT_FOUND;
+    }
+    else
+    {
+        return handle_error(st);
+    }
+}
+
+datalayer::returncode
+datalayer :: create_checkpoint(const region_timestamp& rt)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+
+    for (wipe_list_t::iterator it = m_wiping.begin(); it != m_wiping.end(); ++it)
+    {
+        if (it->second == rt.rid)
+        {
+            return SUCCESS;
+        }
+    }
+
+    char cbacking[CHECKPOINT_BUF_SIZE + 1024];
+    encode_checkpoint(rt.rid, rt.checkpoint, cbacking);
+    leveldb::WriteOptions opts;
+    opts.sync = false;
+    leveldb::Slice ckey(cbacking, CHECKPOINT_BUF_SIZE);
+    leveldb::Slice val(rt.local_timestamp);
+    leveldb::Status st = m_db->Put(opts, ckey, val);
+
+    if (!st.ok())
+    {
+        return handle_error(st);
+    }
+
+    return SUCCESS;
+}
+
+void
+datalayer :: set_checkpoint_lower_gc(uint64_t checkpoint_gc)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    m_checkpoint_gc = std::max(checkpoint_gc, m_checkpoint_gc);
+    m_wakeup_checkpointer.signal();
+}
+
+void
+datalayer :: largest_checkpoint_for(const region_id& ri, uint64_t* checkpoint)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+
+    for (wipe_list_t::iterator it = m_wiping.begin(); it != m_wiping.end(); ++it)
+    {
+        if (it->second == ri)
+        {
+            *checkpoint = 0;
+            return;
+        }
+    }
+
+    leveldb::ReadOptions opts;
+    opts.verify_checksums = true;
+    std::auto_ptr<leveldb::Iterator> it;
+    it.reset(m_db->NewIterator(opts));
+    char cbacking[CHECKPOINT_BUF_SIZE];
+    encode_checkpoint(ri, 0, cbacking);
+    it->Seek(leveldb::Slice(cbacking, CHECKPOINT_BUF_SIZE));
+    *checkpoint = 0;
+
+    while (it->Valid())
+    {
+        region_timestamp rt;
+        e::slice key(it->key().data(), it->key().size());
+        returncode rc = decode_checkpoint(key, &rt.rid, &rt.checkpoint);
+
+        if (rc != datalayer::SUCCESS)
+        {
+            break;
+        }
+
+        if (rt.rid != ri)
+        {
+            break;
+        }
+
+        *checkpoint = std::max(*checkpoint, rt.checkpoint);
+        it->Next();
+    }
+}
+
+void
+datalayer :: request_wipe(const transfer_id& xid,
+                          const region_id& ri)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    m_wiping.push_back(std::make_pair(xid, ri));
+    m_wakeup_wiper.broadcast();
+}
+
+datalayer::replay_iterator*
+datalayer :: replay_region_from_checkpoint(const region_id& ri,
+                                           uint64_t checkpoint,
+                                           bool* wipe)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    leveldb::ReadOptions opts;
+    opts.verify_checksums = true;
+    std::auto_ptr<leveldb::Iterator> it;
+    it.reset(m_db->NewIterator(opts));
+    char cbacking[CHECKPOINT_BUF_SIZE];
+    encode_checkpoint(ri, 0, cbacking);
+    it->Seek(leveldb::Slice(cbacking, CHECKPOINT_BUF_SIZE));
+    std::string local_timestamp("all");
+
+    while (it->Valid())
+    {
+        region_timestamp rt;
+        e::slice key(it->key().data(), it->key().size());
+        returncode rc = decode_checkpoint(key, &rt.rid, &rt.checkpoint);
+
+        if (rc != datalayer::SUCCESS)
+        {
+            break;
+        }
+
+        if (rt.rid != ri || rt.checkpoint > checkpoint)
+        {
+            break;
+        }
+
+        local_timestamp.assign(it->value().data(), it->value().size());
+        it->Next();
+    }
+
+    for (wipe_list_t::iterator w = m_wiping.begin(); w != m_wiping.end(); ++w)
+    {
+        if (w->second == ri)
+        {
+            local_timestamp = "all";
+            break;
+        }
+    }
+
+    *wipe = local_timestamp == "all";
+    leveldb::ReplayIterator* iter;
+    leveldb::Status st = m_db->GetReplayIterator(local_timestamp, &iter);
+
+    if (!st.ok())
+    {
+        LOG(ERROR) << "LevelDB corruption: invalid timestamp";
+        abort();
+    }
+
+    leveldb_replay_iterator_ptr ptr(m_db, iter);
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
+    return new replay_iterator(this, ri, ptr, index_info::lookup(sc.attrs[0].type));
+}
+
+void
+datalayer :: collect_lower_checkpoints(uint64_t checkpoint_gc)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    leveldb::ReadOptions opts;
+    opts.verify_checksums = true;
+    std::auto_ptr<leveldb::Iterator> it;
+    it.reset(m_db->NewIterator(opts));
+    it->Seek(leveldb::Slice("c", 1));
+    std::string lower_bound_timestamp("now");
+    std::string now;
+    m_db->GetReplayTimestamp(&now);
+
+    while (it->Valid())
+    {
+        region_timestamp rt;
+        e::slice key(it->key().data(), it->key().size());
+        returncode rc = decode_checkpoint(key, &rt.rid, &rt.checkpoint);
+
+        if (rc != datalayer::SUCCESS)
+        {
+            break;
+        }
+
+        rt.local_timestamp = std::string(it->value().data(), it->value().size());
+
+        if (rt.checkpoint >= checkpoint_gc &&
+            m_db->ValidateTimestamp(rt.local_timestamp))
+        {
+            if (m_db->CompareTimestamps(rt.local_timestamp, lower_bound_timestamp) < 0)
+            {
+                lower_bound_timestamp = rt.local_timestamp;
+            }
+
+            it->Next();
+            continue;
+        }
+
+        leveldb::WriteOptions wopts;
+        wopts.sync = false;
+        leveldb::Status st = m_db->Delete(wopts, it->key());
+
+        if (!st.ok())
+        {
+            break;
+        }
+
+        it->Next();
+    }
+
+    m_db->AllowGarbageCollectBeforeTimestamp(lower_bound_timestamp);
+    m_replay_floor = lower_bound_timestamp == "now" ? now : lower_bound_timestamp;
+    m_wakeup_trainer.broadcast();
+}
+
+bool
+datalayer :: only_key_is_hyperdex_key()
+{
+    leveldb::ReadOptions opts;
+    opts.fill_cache = false;
+    opts.verify_checksums = true;
+    opts.snapshot = NULL;
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
+    it->SeekToFirst();
+    bool seen = false;
+
+    while (it->Valid())
+    {
+        if (it->key().compare(leveldb::Slice("hyperdex", 8)) != 0)
+        {
+            return false;
+        }
+
+        it->Next();
+        seen = true;
+    }
+
+    return seen;
+}
+
+void
+datalayer :: checkpointer()
+{
+    LOG(INFO) << "checkpoint thread started";
+    sigset_t ss;
+
+    if (sigfillset(&ss) < 0)
+    {
+        PLOG(ERROR) << "sigfillset";
+        return;
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    {
+        PLOG(ERROR) << "could not block signals";
+        return;
+    }
+
+    bool need_checkpoint_gc = false;
+    uint64_t checkpoint_gc = 0;
+
+    while (true)
+    {
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+
+            while ((checkpoint_gc >= m_checkpoint_gc && !m_shutdown) ||
+                   m_need_pause)
+            {
+                m_checkpointer_paused = true;
+
+                if (m_need_pause)
+                {
+                    m_wakeup_reconfigurer.signal();
+                }
+
+                m_wakeup_checkpointer.wait();
+                m_checkpointer_paused = false;
+            }
+
+            if (m_shutdown)
+            {
+                break;
+            }
+
+            need_checkpoint_gc = checkpoint_gc < m_checkpoint_gc;
+            checkpoint_gc = m_checkpoint_gc;
+        }
+
+        if (need_checkpoint_gc)
+        {
+            collect_lower_checkpoints(checkpoint_gc);
+        }
+    }
+
+    LOG(INFO) << "checkpoint thread shutting down";
+}
+
+void
+datalayer :: wiper()
+{
+    LOG(INFO) << "wiping thread started";
+    sigset_t ss;
+
+    if (sigfillset(&ss) < 0)
+    {
+        PLOG(ERROR) << "sigfillset";
+        return;
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    {
+        PLOG(ERROR) << "could not block signals";
+        return;
+    }
+
+    while (true)
+    {
+        transfer_id xid;
+        region_id rid;
+
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+
+            while ((m_wiping.empty() && !m_shutdown) || m_need_pause)
+            {
+                m_wiper_paused = true;
+
+                if (m_need_pause)
+                {
+                    m_wakeup_reconfigurer.signal();
+                }
+
+                m_wakeup_wiper.wait();
+                m_wiper_paused = false;
+            }
+
+            if (m_shutdown)
+            {
+                break;
+            }
+
+            if (!m_wiping.empty())
+            {
+                xid = m_wiping.front().first;
+                rid = m_wiping.front().second;
+            }
+        }
+
+        assert(rid != region_id());
+        wipe_checkpoints(rid);
+        wipe_statistics(rid);
+        note_write(rid);
+
+        if (wipe_some_indices(rid) &&
+            wipe_some_objects(rid))
+        {
+            m_objects.clear();
+            m_daemon->m_stm.report_wiped(xid);
+            po6::threads::mutex::hold hold(&m_protect);
+            m_wiping.pop_front();
+        }
+    }
+
+    LOG(INFO) << "wiping thread shutting down";
+}
+
+void
+datalayer :: statistician()
+{
+    LOG(INFO) << "statistics thread started";
+    sigset_t ss;
+
+    if (sigfillset(&ss) < 0)
+    {
+        PLOG(ERROR) << "sigfillset";
+        return;
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    {
+        PLOG(ERROR) << "could not block signals";
+        return;
+    }
+
+    while (true)
+    {
+        region_id ri;
+
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+
+            while ((m_stats_refresh.empty() && !m_shutdown) || m_need_pause)
+            {
+                m_statistician_paused = true;
+
+                if (m_need_pause)
+                {
+                    m_wakeup_reconfigurer.signal();
+                }
+
+                m_wakeup_statistician.wait();
+                m_statistician_paused = false;
+            }
+
+            if (m_shutdown)
+            {
+                break;
+            }
+
+            ri = m_stats_refresh.front();
+            m_stats_refresh.pop_front();
+        }
+
+        // a persisted summary is good enough to start with; the write path
+        // will mark it stale if the region has changed much since
+        uint64_t objects;
+        bool refresh;
+
+        if (!m_stats.lookup(ri, &objects, &refresh) && load_statistics(ri))
+        {
+            continue;
+        }
+
+        if (!refresh_statistics(ri))
+        {
+            // interrupted by a reconfiguration; keep using the summary we
+            // have and let the next search retry
+            m_stats.abandon(ri);
+        }
+    }
+
+    LOG(INFO) << "statistics thread shutting down";
+}
+
+void
+datalayer :: indexer()
+{
+    LOG(INFO) << "indexing thread started";
+    sigset_t ss;
+
+    if (sigfillset(&ss) < 0)
+    {
+        PLOG(ERROR) << "sigfillset";
+        return;
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    {
+        PLOG(ERROR) << "could not block signals";
+        return;
+    }
+
+    // objects are filled from one snapshot per build; anything written after
+    // it was taken got its entries from the write path
+    snapshot snap;
+    region_id snap_ri;
+    uint16_t snap_attr = 0;
+
+    while (true)
+    {
+        region_id ri;
+        index_build build;
+
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+
+            while ((!next_index_build(&ri, &build) && !m_shutdown) || m_need_pause)
+            {
+                m_indexer_paused = true;
+
+                if (m_need_pause)
+                {
+                    m_wakeup_reconfigurer.signal();
+                }
+
+                m_wakeup_indexer.wait();
+                m_indexer_paused = false;
+            }
+
+            if (m_shutdown)
+            {
+                break;
+            }
+        }
+
+        uint64_t start = e::time();
+        bool done = true;
+
+        if (build.phase == INDEX_FILLING)
+        {
+            if (!snap.get() || build.resume.empty() ||
+                snap_ri != ri || snap_attr != build.attr)
+            {
+                snap = make_snapshot();
+                snap_ri = ri;
+                snap_attr = build.attr;
+            }
+
+            done = fill_some_index(snap, ri, build.attr, &build.resume);
+        }
+        else
+        {
+            done = wipe_some_index(ri, build.attr);
+        }
+
+        if (done || build.phase != INDEX_FILLING)
+        {
+            snap = snapshot();
+        }
+
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+            index_build_map_t::iterator it = m_index_builds.find(ri);
+
+            for (size_t i = 0; it != m_index_builds.end() && i < it->second.size(); ++i)
+            {
+                index_build* b = &it->second[i];
+
+                if (b->attr != build.attr || b->phase != build.phase)
+                {
+                    continue;
+                }
+
+                if (!done)
+                {
+                    b->resume = build.resume;
+                }
+                else if (b->phase == INDEX_CLEARING)
+                {
+                    b->phase = INDEX_FILLING;
+                    b->resume.clear();
+                }
+                else if (b->phase == INDEX_FILLING)
+                {
+                    LOG(INFO) << "finished building the index of attribute "
+                              << b->attr << " for " << ri;
+                    b->phase = INDEX_BUILT;
+                    b->resume.clear();
+                }
+                else
+                {
+                    LOG(INFO) << "finished dropping the index of attribute "
+                              << b->attr << " for " << ri;
+                    it->second.erase(it->second.begin() + i);
+                }
+
+                save_index_builds(ri);
+                break;
+            }
+        }
+
+        // throttle to INDEX_BUILD_RATE objects per second
+        uint64_t target = INDEX_BUILD_BATCH * 1000000000ULL / INDEX_BUILD_RATE;
+        uint64_t elapsed = e::time() - start;
+
+        if (elapsed < target)
+        {
+            struct timespec ts;
+            ts.tv_sec = (target - elapsed) / 1000000000ULL;
+            ts.tv_nsec = (target - elapsed) % 1000000000ULL;
+            nanosleep(&ts, NULL);
+        }
+    }
+
+    LOG(INFO) << "indexing thread shutting down";
+}
+
+void
+datalayer :: trainer()
+{
+    LOG(INFO) << "compression thread started";
+    sigset_t ss;
+
+    if (sigfillset(&ss) < 0)
+    {
+        PLOG(ERROR) << "sigfillset";
+        return;
+    }
+
+    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    {
+        PLOG(ERROR) << "could not block signals";
+        return;
+    }
+
+    // dictionaries no stored value names, with the time at which the last
+    // value naming them could have been overwritten
+    std::map<uint32_t, std::string> retiring;
+    std::string replay_floor;
+    bool need_retire = false;
+
+    while (true)
+    {
+        uint64_t space = 0;
+        bool train = false;
+
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+
+            while ((m_dict_training.empty() && !need_retire &&
+                    (retiring.empty() || replay_floor == m_replay_floor) &&
+                    !m_shutdown) || m_need_pause)
+            {
+                m_trainer_paused = true;
+
+                if (m_need_pause)
+                {
+                    m_wakeup_reconfigurer.signal();
+                }
+
+                m_wakeup_trainer.wait();
+                m_trainer_paused = false;
+            }
+
+            if (m_shutdown)
+            {
+                break;
+            }
+
+            if (!m_dict_training.empty())
+            {
+                space = m_dict_training.front();
+                m_dict_training.pop_front();
+                train = true;
+            }
+
+            replay_floor = m_replay_floor;
+        }
+
+        if (train && train_dictionary(space))
+        {
+            need_retire = true;
+        }
+
+        if (need_retire && retire_dictionaries(&retiring))
+        {
+            need_retire = false;
+        }
+
+        drop_dictionaries(&retiring, replay_floor);
+    }
+
+    LOG(INFO) << "compression thread shutting down";
+}
+
+bool
+datalayer :: refresh_statistics(const region_id& ri)
+{
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+    const subspace* sub = m_daemon->m_config.get_subspace(ri);
+
+    if (!sc || !sub)
+    {
+        m_stats.forget(ri);
+        return true;
+    }
+
+    index_stats::builder b(*sc, *sub);
+    leveldb::ReadOptions opts;
+    opts.fill_cache = false;
+    opts.verify_checksums = true;
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
+    std::vector<char> scratch;
+    leveldb::Slice prefix;
+    encode_object_region(ri, &scratch, &prefix);
+    it->Seek(prefix);
+
+    for (uint64_t i = 1; it->Valid() && it->key().starts_with(prefix); ++i)
+    {
+        if (i % STATS_PAUSE_CHECK == 0)
+        {
+            po6::threads::mutex::hold hold(&m_protect);
+
+            if (m_need_pause || m_shutdown)
+            {
+                return false;
+            }
+        }
+
+        region_id tmp;
+        e::slice key;
+        std::vector<e::slice> value;
+        uint64_t version;
+        std::string scratch;
+        e::slice v;
+
+        if (decode_key(it->key(), &tmp, &key) &&
+            expand_value(e::slice(it->value().data(), it->value().size()),
+                         &scratch, &v) == SUCCESS &&
+            decode_value(v, &value, &version) == SUCCESS)
+        {
+            b.add(key, value);
+        }
+
+        it->Next();
+    }
+
+    index_stats::summary_ptr s = b.finish();
+    std::vector<char> encoded;
+    s->encode(&encoded);
+    char key[INDEX_STATS_BUF_SIZE];
+    encode_index_stats(ri, key);
+    leveldb::Status st = m_db->Put(leveldb::WriteOptions(),
+                                   leveldb::Slice(key, INDEX_STATS_BUF_SIZE),
+                                   leveldb::Slice(&encoded.front(), encoded.size()));
+
+    if (!st.ok())
+    {
+        LOG(WARNING) << "could not save statistics for " << ri << ": " << st.ToString();
+    }
+
+    m_stats.install(ri, s);
+    return true;
+}
+
+bool
+datalayer :: load_statistics(const region_id& ri)
+{
+    char key[INDEX_STATS_BUF_SIZE];
+    encode_index_stats(ri, key);
+    std::string value;
+    leveldb::Status st = m_db->Get(leveldb::ReadOptions(),
+                                   leveldb::Slice(key, INDEX_STATS_BUF_SIZE),
+                                   &value);
+
+    if (!st.ok())
     {
-        uint64_t iterator_cost = iterators[i]->cost(m_db.get());
-        if (ostr) *ostr << "iterator " << *iterators[i] << " has cost " << iterator_cost << "\n";
+        return false;
     }
 
-    std::vector<e::intrusive_ptr<index_iterator> > sorted;
-    std::vector<e::intrusive_ptr<index_iterator> > unsorted;
+    std::tr1::shared_ptr<index_stats::summary> s(new index_stats::summary());
 
-    for (size_t i = 0; i < iterators.size(); ++i)
+    if (!s->decode(e::slice(value.data(), value.size())))
     {
-        if (iterators[i]->sorted())
-        {
-            sorted.push_back(iterators[i]);
-        }
-        else
-        {
-            unsorted.push_back(iterators[i]);
-        }
+        LOG(WARNING) << "discarding corrupt statistics for " << ri;
+        return false;
     }
 
-    e::intrusive_ptr<index_iterator> best;
+    m_stats.install(ri, s);
+    return true;
+}
 
-    if (!sorted.empty())
-    {
-        best = new intersect_iterator(snap, sorted);
-    }
+void
+datalayer :: plan_index_builds(const configuration& config,
+                               const server_id& us)
+{
+    std::vector<region_id> mapped;
+    config.mapped_regions(us, &mapped);
+    std::sort(mapped.begin(), mapped.end());
 
-    if (!best || best->cost(m_db.get()) * 4 > full_scan->cost(m_db.get()))
+    // regions we no longer hold get wiped whole
+    for (index_build_map_t::iterator it = m_index_builds.begin();
+            it != m_index_builds.end(); )
     {
-        best = full_scan;
+        if (std::binary_search(mapped.begin(), mapped.end(), it->first))
+        {
+            ++it;
+            continue;
+        }
+
+        region_id ri = it->first;
+        m_index_builds.erase(it++);
+        save_index_builds(ri);
     }
 
-    // just pick one; do something smart later
-    if (!unsorted.empty() && !best)
+    for (size_t i = 0; i < mapped.size(); ++i)
     {
-        best = unsorted[0];
+        const region_id& ri(mapped[i]);
+        const subspace* sub = config.get_subspace(ri);
+
+        if (!sub)
+        {
+            continue;
+        }
+
+        // the first time we see a region, the write path has maintained every
+        // one of its indices since the region's first object
+        bool known = m_index_builds.find(ri) != m_index_builds.end();
+        std::vector<index_build>& builds(m_index_builds[ri]);
+        bool changed = !known;
+
+        for (size_t j = 0; j < builds.size(); ++j)
+        {
+            if (!sub->indexed(builds[j].attr) &&
+                builds[j].phase != INDEX_DROPPING)
+            {
+                LOG(INFO) << "dropping the index of attribute " << builds[j].attr
+                          << " for " << ri;
+                builds[j].phase = INDEX_DROPPING;
+                builds[j].resume.clear();
+                changed = true;
+            }
+        }
+
+        for (size_t j = 0; j < sub->indices.size(); ++j)
+        {
+            uint16_t attr = sub->indices[j];
+            size_t k = 0;
+
+            while (k < builds.size() && builds[k].attr != attr)
+            {
+                ++k;
+            }
+
+            if (k == builds.size())
+            {
+                builds.push_back(index_build(attr, known ? INDEX_CLEARING : INDEX_BUILT));
+                changed = true;
+            }
+            // entries from before the drop may be stale, so start over
+            else if (builds[k].phase == INDEX_DROPPING)
+            {
+                builds[k].phase = INDEX_CLEARING;
+                changed = true;
+            }
+            else
+            {
+                continue;
+            }
+
+            if (known)
+            {
+                LOG(INFO) << "building the index of attribute " << attr
+                          << " for " << ri;
+            }
+        }
+
+        if (changed)
+        {
+            save_index_builds(ri);
+        }
     }
 
-    assert(best);
-    if (ostr) *ostr << "choosing to use " << *best << "\n";
-    return new search_iterator(this, ri, best, ostr, &checks);
+    m_wakeup_indexer.broadcast();
 }
 
-datalayer::returncode
-datalayer :: get_from_iterator(const region_id& ri,
-                               iterator* iter,
-                               e::slice* key,
-                               std::vector<e::slice>* value,
-                               uint64_t* version,
-                               reference* ref)
+bool
+datalayer :: next_index_build(region_id* ri, index_build* build)
 {
-    const schema& sc(*m_daemon->m_config.get_schema(ri));
-    std::vector<char> scratch;
+    for (index_build_map_t::iterator it = m_index_builds.begin();
+            it != m_index_builds.end(); ++it)
+    {
+        for (size_t i = 0; i < it->second.size(); ++i)
+        {
+            if (it->second[i].phase != INDEX_BUILT)
+            {
+                *ri = it->first;
+                *build = it->second[i];
+                return true;
+            }
+        }
+    }
 
-    // create the encoded key
-    leveldb::Slice lkey;
-    encode_key(ri, sc.attrs[0].type, iter->key(), &scratch, &lkey);
+    return false;
+}
 
-    // perform the read
+bool
+datalayer :: load_index_builds()
+{
     leveldb::ReadOptions opts;
-    opts.fill_cache = true;
+    opts.fill_cache = false;
     opts.verify_checksums = true;
-    opts.snapshot = iter->snap().get();
-    leveldb::Status st = m_db->Get(opts, lkey, &ref->m_backing);
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
+    leveldb::Slice prefix("b", 1);
+    it->Seek(prefix);
 
-    if (st.ok())
+    for (; it->Valid() && it->key().starts_with(prefix); it->Next())
     {
-        ref->m_backing += std::string(reinterpret_cast<const char*>(iter->key().data()), iter->key().size());
-        *key = e::slice(ref->m_backing.data()
-                        + ref->m_backing.size()
-                        - iter->key().size(),
-                        iter->key().size());
-        e::slice v(ref->m_backing.data(), ref->m_backing.size() - iter->key().size());
-        return decode_value(v, value, version);
+        region_id ri;
+        e::slice key(it->key().data(), it->key().size());
+
+        if (decode_index_build(key, &ri) != SUCCESS)
+        {
+            LOG(ERROR) << "could not restore from LevelDB because of a corrupt index build";
+            return false;
+        }
+
+        std::vector<index_build>& builds(m_index_builds[ri]);
+        const char* ptr = it->value().data();
+        const char* end = ptr + it->value().size();
+
+        while (ptr < end)
+        {
+            const size_t hdr = sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint32_t);
+            uint16_t attr;
+            uint8_t phase;
+            uint32_t resume_sz;
+
+            if (static_cast<size_t>(end - ptr) < hdr)
+            {
+                LOG(ERROR) << "could not restore from LevelDB because of a corrupt index build";
+                return false;
+            }
+
+            ptr = e::unpack16be(ptr, &attr);
+            ptr = e::unpack8be(ptr, &phase);
+            ptr = e::unpack32be(ptr, &resume_sz);
+
+            if (phase > INDEX_DROPPING || static_cast<size_t>(end - ptr) < resume_sz)
+            {
+                LOG(ERROR) << "could not restore from LevelDB because of a corrupt index build";
+                return false;
+            }
+
+            builds.push_back(index_build(attr, static_cast<index_phase>(phase)));
+            builds.back().resume.assign(ptr, resume_sz);
+            ptr += resume_sz;
+        }
     }
-    else if (st.IsNotFound())
+
+    return true;
+}
+
+void
+datalayer :: save_index_builds(const region_id& ri)
+{
+    char key[INDEX_BUILD_BUF_SIZE];
+    encode_index_build(ri, key);
+    leveldb::Slice lkey(key, INDEX_BUILD_BUF_SIZE);
+    index_build_map_t::iterator it = m_index_builds.find(ri);
+    leveldb::Status st;
+
+    if (it == m_index_builds.end())
     {
-        return NOT_FOUND;
+        st = m_db->Delete(leveldb::WriteOptions(), lkey);
     }
     else
     {
-        return handle_error(st);
+        std::string value;
+
+        for (size_t i = 0; i < it->second.size(); ++i)
+        {
+            const index_build& b(it->second[i]);
+            char hdr[sizeof(uint16_t) + sizeof(uint8_t) + sizeof(uint32_t)];
+            char* ptr = hdr;
+            ptr = e::pack16be(b.attr, ptr);
+            ptr = e::pack8be(b.phase, ptr);
+            ptr = e::pack32be(b.resume.size(), ptr);
+            value.append(hdr, ptr - hdr);
+            value.append(b.resume);
+        }
+
+        st = m_db->Put(leveldb::WriteOptions(), lkey, leveldb::Slice(value));
+    }
+
+    if (!st.ok())
+    {
+        LOG(WARNING) << "could not save index builds for " << ri << ": " << st.ToString();
     }
 }
 
-datalayer::returncode
-datalayer :: create_checkpoint(const region_timestamp& rt)
+bool
+datalayer :: load_dictionaries()
 {
-    po6::threads::mutex::hold hold(&m_protect);
+    leveldb::ReadOptions opts;
+    opts.fill_cache = false;
+    opts.verify_checksums = true;
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
+    leveldb::Slice prefix("d", 1);
+    it->Seek(prefix);
+    po6::threads::mutex::hold hold(&m_dict_lock);
 
-    for (wipe_list_t::iterator it = m_wiping.begin(); it != m_wiping.end(); ++it)
+    for (; it->Valid() && it->key().starts_with(prefix); it->Next())
     {
-        if (it->second == rt.rid)
+        uint32_t dict_id;
+        uint64_t space;
+        e::slice key(it->key().data(), it->key().size());
+
+        if (decode_dictionary(key, &dict_id) != SUCCESS ||
+            it->value().size() < sizeof(uint64_t))
         {
-            return SUCCESS;
+            LOG(ERROR) << "could not restore from LevelDB because of a corrupt compression dictionary";
+            return false;
         }
-    }
 
-    char cbacking[CHECKPOINT_BUF_SIZE + 1024];
-    encode_checkpoint(rt.rid, rt.checkpoint, cbacking);
-    leveldb::WriteOptions opts;
-    opts.sync = false;
-    leveldb::Slice ckey(cbacking, CHECKPOINT_BUF_SIZE);
-    leveldb::Slice val(rt.local_timestamp);
-    leveldb::Status st = m_db->Put(opts, ckey, val);
+        e::unpack64be(it->value().data(), &space);
+        std::tr1::shared_ptr<compression_dictionary> dict(new compression_dictionary());
+        dict->load(std::string(it->value().data() + sizeof(uint64_t),
+                               it->value().size() - sizeof(uint64_t)));
+        m_dicts[dict_id] = dict;
+        m_dict_next = std::max(m_dict_next, dict_id + 1);
 
-    if (!st.ok())
+        // dictionaries are stored in the order they were trained
+        std::tr1::shared_ptr<space_compression>& sc(m_space_compression[space]);
+
+        if (!sc)
+        {
+            sc.reset(new space_compression());
+        }
+
+        sc->current = dict_id;
+        sc->interval = DICTIONARY_RESAMPLE_INTERVAL;
+    }
+
+    if (!it->status().ok())
     {
-        return handle_error(st);
+        LOG(ERROR) << "could not restore compression dictionaries from LevelDB: " << it->status().ToString();
+        return false;
     }
 
-    return SUCCESS;
+    return true;
 }
 
 void
-datalayer :: set_checkpoint_lower_gc(uint64_t checkpoint_gc)
+datalayer :: compress_value(const region_id& ri,
+                            const leveldb::Slice& raw,
+                            std::vector<char>* backing,
+                            leveldb::Slice* out,
+                            std::tr1::shared_ptr<compression_dictionary>* dict)
 {
-    po6::threads::mutex::hold hold(&m_protect);
-    m_checkpoint_gc = std::max(checkpoint_gc, m_checkpoint_gc);
-    m_wakeup_checkpointer.signal();
+    if (e::atomic::load_64_acquire(&m_dict_size) == 0)
+    {
+        return;
+    }
+
+    uint64_t space = m_daemon->m_config.space_of(ri).get();
+    uint32_t dict_id = 0;
+    bool train = false;
+
+    {
+        po6::threads::mutex::hold hold(&m_dict_lock);
+        std::tr1::shared_ptr<space_compression>& sc(m_space_compression[space]);
+
+        if (!sc)
+        {
+            sc.reset(new space_compression());
+        }
+
+        if (sc->current != 0)
+        {
+            dict_id = sc->current;
+            *dict = m_dicts[dict_id];
+        }
+
+        ++sc->writes;
+
+        if (!sc->training && sc->writes % sc->interval == 0)
+        {
+            sc->samples.push_back(std::string(raw.data(), raw.size()));
+            sc->sample_bytes += raw.size();
+
+            if (sc->sample_bytes >= m_dict_size * DICTIONARY_SAMPLE_RATIO)
+            {
+                sc->training = true;
+                train = true;
+            }
+        }
+    }
+
+    // the trainer builds the space's next dictionary; writers carry on with
+    // the current one meanwhile
+    if (train)
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+        m_dict_training.push_back(space);
+        m_wakeup_trainer.signal();
+    }
+
+    if (!*dict)
+    {
+        return;
+    }
+
+    std::string compressed;
+    (*dict)->compress(reinterpret_cast<const uint8_t*>(raw.data()), raw.size(), &compressed);
+
+    if (COMPRESSED_VALUE_HEADER_SIZE + compressed.size() >= raw.size())
+    {
+        return;
+    }
+
+    encode_compressed_value(dict_id, raw.size(), compressed, backing, out);
+    e::atomic::increment_64_nobarrier(&m_compress_raw_bytes, raw.size());
+    e::atomic::increment_64_nobarrier(&m_compress_stored_bytes, out->size());
 }
 
-void
-datalayer :: largest_checkpoint_for(const region_id& ri, uint64_t* checkpoint)
+bool
+datalayer :: train_dictionary(uint64_t space)
 {
-    po6::threads::mutex::hold hold(&m_protect);
+    std::vector<std::string> samples;
+    std::tr1::shared_ptr<compression_dictionary> current;
 
-    for (wipe_list_t::iterator it = m_wiping.begin(); it != m_wiping.end(); ++it)
     {
-        if (it->second == ri)
+        po6::threads::mutex::hold hold(&m_dict_lock);
+        std::tr1::shared_ptr<space_compression>& sc(m_space_compression[space]);
+        assert(sc);
+        sc->samples.swap(samples);
+        sc->sample_bytes = 0;
+
+        if (sc->current != 0)
         {
-            *checkpoint = 0;
-            return;
+            current = m_dicts[sc->current];
         }
     }
 
-    leveldb::ReadOptions opts;
-    opts.verify_checksums = true;
-    std::auto_ptr<leveldb::Iterator> it;
-    it.reset(m_db->NewIterator(opts));
-    char cbacking[CHECKPOINT_BUF_SIZE];
-    encode_checkpoint(ri, 0, cbacking);
-    it->Seek(leveldb::Slice(cbacking, CHECKPOINT_BUF_SIZE));
-    *checkpoint = 0;
+    std::tr1::shared_ptr<compression_dictionary> dict(new compression_dictionary());
+    dict->train(samples, e::atomic::load_64_acquire(&m_dict_size));
+    uint32_t dict_id = 0;
 
-    while (it->Valid())
-    {
-        region_timestamp rt;
-        e::slice key(it->key().data(), it->key().size());
-        returncode rc = decode_checkpoint(key, &rt.rid, &rt.checkpoint);
+    // a dictionary that does not pay for itself only adds to those that must
+    // be kept around
+    uint64_t current_sz = stored_size(samples, current.get());
+    uint64_t dict_sz = stored_size(samples, dict.get());
 
-        if (rc != datalayer::SUCCESS)
+    if (!dict->contents().empty() &&
+        dict_sz + current_sz / DICTIONARY_MIN_GAIN < current_sz)
+    {
         {
-            break;
+            po6::threads::mutex::hold hold(&m_dict_lock);
+            dict_id = m_dict_next;
+            ++m_dict_next;
         }
 
-        if (rt.rid != ri)
+        // persist the dictionary before any value can refer to it
+        char key[DICTIONARY_BUF_SIZE];
+        encode_dictionary(dict_id, key);
+        std::string value(sizeof(uint64_t), '\0');
+        e::pack64be(space, &value[0]);
+        value += dict->contents();
+        leveldb::WriteOptions opts;
+        opts.sync = true;
+        leveldb::Status st = m_db->Put(opts, leveldb::Slice(key, DICTIONARY_BUF_SIZE), value);
+
+        if (!st.ok())
         {
-            break;
+            LOG(WARNING) << "could not save compression dictionary: " << st.ToString();
+            dict_id = 0;
         }
+    }
 
-        *checkpoint = std::max(*checkpoint, rt.checkpoint);
-        it->Next();
+    po6::threads::mutex::hold hold(&m_dict_lock);
+    std::tr1::shared_ptr<space_compression>& sc(m_space_compression[space]);
+    assert(sc);
+    sc->training = false;
+
+    if (dict_id != 0)
+    {
+        m_dicts[dict_id] = dict;
+        sc->current = dict_id;
+        sc->interval = std::max(sc->interval, static_cast<uint64_t>(DICTIONARY_RESAMPLE_INTERVAL));
+        return true;
     }
-}
 
-void
-datalayer :: request_wipe(const transfer_id& xid,
-                          const region_id& ri)
-{
-    po6::threads::mutex::hold hold(&m_protect);
-    m_wiping.push_back(std::make_pair(xid, ri));
-    m_wakeup_wiper.broadcast();
+    // the space's values are as compressible as they are going to get, so
+    // sample them ever more rarely
+    sc->interval = std::min(sc->interval * 2, static_cast<uint64_t>(DICTIONARY_MAX_RESAMPLE_INTERVAL));
+    return false;
 }
 
-datalayer::replay_iterator*
-datalayer :: replay_region_from_checkpoint(const region_id& ri,
-                                           uint64_t checkpoint,
-                                           bool* wipe)
+bool
+datalayer :: retire_dictionaries(std::map<uint32_t, std::string>* retiring)
 {
-    po6::threads::mutex::hold hold(&m_protect);
+    std::set<uint32_t> candidates;
+
+    {
+        po6::threads::mutex::hold hold(&m_dict_lock);
+        std::set<uint32_t> current;
+
+        for (space_compression_map_t::iterator it = m_space_compression.begin();
+                it != m_space_compression.end(); ++it)
+        {
+            current.insert(it->second->current);
+        }
+
+        // a dictionary held outside m_dicts may be compressing a value that
+        // is yet to be written; it is considered again after the next install
+        for (dictionary_map_t::iterator it = m_dicts.begin(); it != m_dicts.end(); ++it)
+        {
+            if (current.find(it->first) == current.end() &&
+                retiring->find(it->first) == retiring->end() &&
+                it->second.unique())
+            {
+                candidates.insert(it->first);
+            }
+        }
+    }
+
+    if (candidates.empty())
+    {
+        return true;
+    }
+
+    // no new value can use the candidates now, so the values that do are
+    // all visible to this scan or overwritten before it
+    std::string timestamp;
+    m_db->GetReplayTimestamp(&timestamp);
     leveldb::ReadOptions opts;
+    opts.fill_cache = false;
     opts.verify_checksums = true;
-    std::auto_ptr<leveldb::Iterator> it;
-    it.reset(m_db->NewIterator(opts));
-    char cbacking[CHECKPOINT_BUF_SIZE];
-    encode_checkpoint(ri, 0, cbacking);
-    it->Seek(leveldb::Slice(cbacking, CHECKPOINT_BUF_SIZE));
-    std::string local_timestamp("all");
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
+    leveldb::Slice prefix("o", 1);
+    it->Seek(prefix);
 
-    while (it->Valid())
+    for (uint64_t i = 1; it->Valid() && it->key().starts_with(prefix); ++i)
     {
-        region_timestamp rt;
-        e::slice key(it->key().data(), it->key().size());
-        returncode rc = decode_checkpoint(key, &rt.rid, &rt.checkpoint);
-
-        if (rc != datalayer::SUCCESS)
+        if (i % STATS_PAUSE_CHECK == 0)
         {
-            break;
+            po6::threads::mutex::hold hold(&m_protect);
+
+            if (m_need_pause || m_shutdown)
+            {
+                return false;
+            }
         }
 
-        if (rt.rid != ri || rt.checkpoint > checkpoint)
+        uint32_t dict_id;
+        uint32_t raw_sz;
+        e::slice compressed;
+
+        if (decode_compressed_value(e::slice(it->value().data(), it->value().size()),
+                                    &dict_id, &raw_sz, &compressed))
         {
-            break;
+            candidates.erase(dict_id);
+
+            if (candidates.empty())
+            {
+                return true;
+            }
         }
 
-        local_timestamp.assign(it->value().data(), it->value().size());
         it->Next();
     }
 
-    for (wipe_list_t::iterator w = m_wiping.begin(); w != m_wiping.end(); ++w)
+    if (!it->status().ok())
     {
-        if (w->second == ri)
-        {
-            local_timestamp = "all";
-            break;
-        }
+        LOG(WARNING) << "could not scan for unused compression dictionaries: " << it->status().ToString();
+        return true;
     }
 
-    *wipe = local_timestamp == "all";
-    leveldb::ReplayIterator* iter;
-    leveldb::Status st = m_db->GetReplayIterator(local_timestamp, &iter);
-
-    if (!st.ok())
+    // older values may still be replayed from checkpoints taken before now
+    for (std::set<uint32_t>::iterator c = candidates.begin(); c != candidates.end(); ++c)
     {
-        LOG(ERROR) << "LevelDB corruption: invalid timestamp";
-        abort();
+        (*retiring)[*c] = timestamp;
     }
 
-    leveldb_replay_iterator_ptr ptr(m_db, iter);
-    const schema& sc(*m_daemon->m_config.get_schema(ri));
-    return new replay_iterator(ri, ptr, index_info::lookup(sc.attrs[0].type));
+    return true;
 }
 
 void
-datalayer :: collect_lower_checkpoints(uint64_t checkpoint_gc)
+datalayer :: drop_dictionaries(std::map<uint32_t, std::string>* retiring,
+                               const std::string& replay_floor)
 {
-    po6::threads::mutex::hold hold(&m_protect);
-    leveldb::ReadOptions opts;
-    opts.verify_checksums = true;
-    std::auto_ptr<leveldb::Iterator> it;
-    it.reset(m_db->NewIterator(opts));
-    it->Seek(leveldb::Slice("c", 1));
-    std::string lower_bound_timestamp("now");
-
-    while (it->Valid())
+    if (replay_floor.empty() || !m_db->ValidateTimestamp(replay_floor))
     {
-        region_timestamp rt;
-        e::slice key(it->key().data(), it->key().size());
-        returncode rc = decode_checkpoint(key, &rt.rid, &rt.checkpoint);
+        return;
+    }
 
-        if (rc != datalayer::SUCCESS)
+    std::map<uint32_t, std::string>::iterator it = retiring->begin();
+
+    while (it != retiring->end())
+    {
+        if (m_db->CompareTimestamps(it->second, replay_floor) > 0)
         {
-            break;
+            ++it;
+            continue;
         }
 
-        rt.local_timestamp = std::string(it->value().data(), it->value().size());
+        char key[DICTIONARY_BUF_SIZE];
+        encode_dictionary(it->first, key);
+        leveldb::Status st = m_db->Delete(leveldb::WriteOptions(), leveldb::Slice(key, DICTIONARY_BUF_SIZE));
 
-        if (rt.checkpoint >= checkpoint_gc &&
-            m_db->ValidateTimestamp(rt.local_timestamp))
+        if (!st.ok())
         {
-            if (m_db->CompareTimestamps(rt.local_timestamp, lower_bound_timestamp) < 0)
-            {
-                lower_bound_timestamp = rt.local_timestamp;
-            }
-
-            it->Next();
+            LOG(WARNING) << "could not delete compression dictionary " << it->first << ": " << st.ToString();
+            ++it;
             continue;
         }
 
-        leveldb::WriteOptions wopts;
-        wopts.sync = false;
-        leveldb::Status st = m_db->Delete(wopts, it->key());
-
-        if (!st.ok())
         {
-            break;
+            po6::threads::mutex::hold hold(&m_dict_lock);
+            m_dicts.erase(it->first);
         }
 
-        it->Next();
+        retiring->erase(it++);
     }
-
-    m_db->AllowGarbageCollectBeforeTimestamp(lower_bound_timestamp);
 }
 
-bool
-datalayer :: only_key_is_hyperdex_key()
+datalayer::returncode
+datalayer :: expand_value(std::string* backing)
 {
-    leveldb::ReadOptions opts;
-    opts.fill_cache = false;
-    opts.verify_checksums = true;
-    opts.snapshot = NULL;
-    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
-    it->SeekToFirst();
-    bool seen = false;
+    std::string scratch;
+    e::slice out;
+    returncode rc = expand_value(e::slice(backing->data(), backing->size()), &scratch, &out);
 
-    while (it->Valid())
+    if (rc == SUCCESS && out.data() == reinterpret_cast<const uint8_t*>(scratch.data()))
     {
-        if (it->key().compare(leveldb::Slice("hyperdex", 8)) != 0)
-        {
-            return false;
-        }
-
-        it->Next();
-        seen = true;
+        backing->swap(scratch);
     }
 
-    return seen;
+    return rc;
 }
 
-void
-datalayer :: checkpointer()
+datalayer::returncode
+datalayer :: expand_value(const e::slice& in,
+                          std::string* scratch,
+                          e::slice* out)
 {
-    LOG(INFO) << "checkpoint thread started";
-    sigset_t ss;
-
-    if (sigfillset(&ss) < 0)
-    {
-        PLOG(ERROR) << "sigfillset";
-        return;
-    }
+    uint32_t dict_id;
+    uint32_t raw_sz;
+    e::slice compressed;
 
-    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    if (!decode_compressed_value(in, &dict_id, &raw_sz, &compressed))
     {
-        PLOG(ERROR) << "could not block signals";
-        return;
+        *out = in;
+        return SUCCESS;
     }
 
-    bool need_checkpoint_gc = false;
-    uint64_t checkpoint_gc = 0;
+    std::tr1::shared_ptr<compression_dictionary> dict;
 
-    while (true)
     {
+        po6::threads::mutex::hold hold(&m_dict_lock);
+        dictionary_map_t::iterator it = m_dicts.find(dict_id);
+
+        if (it != m_dicts.end())
         {
-            po6::threads::mutex::hold hold(&m_protect);
+            dict = it->second;
+        }
+    }
 
-            while ((checkpoint_gc >= m_checkpoint_gc && !m_shutdown) ||
-                   m_need_pause)
-            {
-                m_checkpointer_paused = true;
+    if (!dict || !dict->decompress(compressed.data(), compressed.size(), raw_sz, scratch))
+    {
+        LOG(ERROR) << "could not expand a value compressed with dictionary " << dict_id;
+        return CORRUPTION;
+    }
 
-                if (m_need_pause)
-                {
-                    m_wakeup_reconfigurer.signal();
-                }
+    *out = e::slice(scratch->data(), scratch->size());
+    return SUCCESS;
+}
 
-                m_wakeup_checkpointer.wait();
-                m_checkpointer_paused = false;
-            }
+bool
+datalayer :: fill_some_index(snapshot snap,
+                             const region_id& ri,
+                             uint16_t attr,
+                             std::string* resume)
+{
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+    const subspace* sub = m_daemon->m_config.get_subspace(ri);
 
-            if (m_shutdown)
-            {
-                break;
-            }
+    if (!sc || !sub || attr == 0 || attr >= sc->attrs_sz)
+    {
+        return true;
+    }
 
-            need_checkpoint_gc = checkpoint_gc < m_checkpoint_gc;
-            checkpoint_gc = m_checkpoint_gc;
-        }
+    leveldb::ReadOptions opts;
+    opts.fill_cache = false;
+    opts.verify_checksums = true;
+    opts.snapshot = snap.get();
+    std::auto_ptr<leveldb::Iterator> it(m_db->NewIterator(opts));
+    std::vector<char> scratch;
+    leveldb::Slice prefix;
+    encode_object_region(ri, &scratch, &prefix);
+    it->Seek(resume->empty() ? prefix : leveldb::Slice(*resume));
 
-        if (need_checkpoint_gc)
+    for (size_t i = 0; i < INDEX_BUILD_BATCH; ++i)
+    {
+        if (!it->Valid() || !it->key().starts_with(prefix))
         {
-            collect_lower_checkpoints(checkpoint_gc);
+            return true;
         }
+
+        fill_index_entry(*sc, *sub, ri, attr, it->key());
+        it->Next();
     }
 
-    LOG(INFO) << "checkpoint thread shutting down";
+    if (!it->Valid() || !it->key().starts_with(prefix))
+    {
+        return true;
+    }
+
+    *resume = it->key().ToString();
+    return false;
 }
 
 void
-datalayer :: wiper()
+datalayer :: fill_index_entry(const schema& sc,
+                              const subspace& sub,
+                              const region_id& ri,
+                              uint16_t attr,
+                              const leveldb::Slice& lkey)
 {
-    LOG(INFO) << "wiping thread started";
-    sigset_t ss;
+    index_info* ki = index_info::lookup(sc.attrs[0].type);
+    index_info* ai = index_info::lookup(sc.attrs[attr].type);
+    region_id tmp;
+    e::slice key;
 
-    if (sigfillset(&ss) < 0)
+    if (!ki || !ai || !decode_key(lkey, &tmp, &key))
     {
-        PLOG(ERROR) << "sigfillset";
         return;
     }
 
-    if (pthread_sigmask(SIG_BLOCK, &ss, NULL) < 0)
+    // the snapshot may be stale, so index the object as it is now, with its
+    // writers held off until the entry is in place
+    e::striped_lock<po6::threads::mutex>::hold hold(&m_key_locks, CityHash64(lkey.data(), lkey.size()));
+    std::string backing;
+    leveldb::ReadOptions opts;
+    opts.fill_cache = false;
+    opts.verify_checksums = true;
+    leveldb::Status st = m_db->Get(opts, lkey, &backing);
+
+    if (!st.ok() || expand_value(&backing) != SUCCESS)
     {
-        PLOG(ERROR) << "could not block signals";
         return;
     }
 
-    while (true)
-    {
-        transfer_id xid;
-        region_id rid;
-
-        {
-            po6::threads::mutex::hold hold(&m_protect);
-
-            while ((m_wiping.empty() && !m_shutdown) || m_need_pause)
-            {
-                m_wiper_paused = true;
-
-                if (m_need_pause)
-                {
-                    m_wakeup_reconfigurer.signal();
-                }
+    std::vector<e::slice> value;
+    uint64_t version;
 
-                m_wakeup_wiper.wait();
-                m_wiper_paused = false;
-            }
+    if (decode_value(e::slice(backing.data(), backing.size()), &value, &version) != SUCCESS ||
+        value.size() + 1 != sc.attrs_sz)
+    {
+        return;
+    }
 
-            if (m_shutdown)
-            {
-                break;
-            }
+    leveldb::WriteBatch updates;
+    ai->index_changes(ri, attr, ki, key, NULL, &value[attr - 1], &updates);
 
-            if (!m_wiping.empty())
-            {
-                xid = m_wiping.front().first;
-                rid = m_wiping.front().second;
-            }
-        }
+    if (!sub.covering.empty())
+    {
+        std::vector<char> payload_backing;
+        leveldb::Slice payload;
+        encode_covering(sub, value, &payload_backing, &payload);
+        ai->covering_changes(ri, attr, ki, key, value[attr - 1],
+                             e::slice(payload.data(), payload.size()), &updates);
+    }
 
-        assert(rid != region_id());
-        wipe_checkpoints(rid);
+    st = m_db->Write(leveldb::WriteOptions(), &updates);
+    e::atomic::increment_64_nobarrier(&m_write_epoch, 1);
+    expire_search_snapshot();
 
-        if (wipe_some_indices(rid) &&
-            wipe_some_objects(rid))
-        {
-            m_daemon->m_stm.report_wiped(xid);
-            po6::threads::mutex::hold hold(&m_protect);
-            m_wiping.pop_front();
-        }
+    if (!st.ok())
+    {
+        LOG(WARNING) << "could not backfill index of attribute " << attr
+                     << " for " << ri << ": " << st.ToString();
     }
-
-    LOG(INFO) << "wiping thread shutting down";
 }
 
 void
@@ -1364,6 +3399,15 @@ datalayer :: wipe_checkpoints(const region_id& ri)
     }
 }
 
+void
+datalayer :: wipe_statistics(const region_id& ri)
+{
+    char key[INDEX_STATS_BUF_SIZE];
+    encode_index_stats(ri, key);
+    m_db->Delete(leveldb::WriteOptions(), leveldb::Slice(key, INDEX_STATS_BUF_SIZE));
+    m_stats.forget(ri);
+}
+
 bool
 datalayer :: wipe_some_indices(const region_id& ri)
 {
@@ -1401,6 +3445,33 @@ datalayer :: wipe_some_common(uint8_t c, const region_id& ri)
     return false;
 }
 
+bool
+datalayer :: wipe_some_index(const region_id& ri, uint16_t attr)
+{
+    std::auto_ptr<leveldb::Iterator> it;
+    it.reset(m_db->NewIterator(leveldb::ReadOptions()));
+    char backing[sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint16_t)];
+    char* ptr = backing;
+    ptr = e::pack8be('i', ptr);
+    ptr = e::pack64be(ri.get(), ptr);
+    ptr = e::pack16be(attr, ptr);
+    leveldb::Slice prefix(backing, sizeof(backing));
+    it->Seek(prefix);
+
+    for (uint64_t i = 0; i < INDEX_BUILD_BATCH && it->Valid(); ++i)
+    {
+        if (!it->key().starts_with(prefix))
+        {
+            return true;
+        }
+
+        m_db->Delete(leveldb::WriteOptions(), it->key());
+        it->Next();
+    }
+
+    return !it->Valid() || !it->key().starts_with(prefix);
+}
+
 void
 datalayer :: shutdown()
 {
@@ -1410,6 +3481,9 @@ datalayer :: shutdown()
         po6::threads::mutex::hold hold(&m_protect);
         m_wakeup_checkpointer.broadcast();
         m_wakeup_wiper.broadcast();
+        m_wakeup_statistician.broadcast();
+        m_wakeup_indexer.broadcast();
+        m_wakeup_trainer.broadcast();
         is_shutdown = m_shutdown;
         m_shutdown = true;
     }
@@ -1418,6 +3492,9 @@ datalayer :: shutdown()
     {
         m_checkpointer.join();
         m_wiper.join();
+        m_statistician.join();
+        m_indexer.join();
+        m_trainer.join();
     }
 }
 
@@ -1443,6 +3520,8 @@ datalayer :: handle_error(leveldb::Status st)
 
 datalayer :: reference :: reference()
     : m_backing()
+    , m_key()
+    , m_object()
 {
 }
 
@@ -1454,6 +3533,8 @@ void
 datalayer :: reference :: swap(reference* ref)
 {
     m_backing.swap(ref->m_backing);
+    m_key.swap(ref->m_key);
+    m_object.swap(ref->m_object);
 }
 
 std::ostream&
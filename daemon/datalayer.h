@@ -30,6 +30,7 @@
 
 // STL
 #include <list>
+#include <map>
 #include <set>
 #include <sstream>
 #include <string>
@@ -47,14 +48,21 @@
 #include <po6/threads/mutex.h>
 #include <po6/threads/thread.h>
 
+// e
+#include <e/intrusive_ptr.h>
+#include <e/striped_lock.h>
+
 // HyperDex
 #include "namespace.h"
 #include "common/attribute_check.h"
+#include "common/compression_dictionary.h"
 #include "common/configuration.h"
 #include "common/datatypes.h"
 #include "common/ids.h"
 #include "common/schema.h"
+#include "daemon/index_stats.h"
 #include "daemon/leveldb.h"
+#include "daemon/object_cache.h"
 #include "daemon/reconfigure_returncode.h"
 #include "daemon/region_timestamp.h"
 
@@ -83,6 +91,8 @@ class datalayer
         class sorted_iterator;
         class unsorted_iterator;
         class intersect_iterator;
+        class hash_intersect_iterator;
+        class union_iterator;
         typedef leveldb_snapshot_ptr snapshot;
 
     public:
@@ -110,6 +120,7 @@ class datalayer
                           std::string* value);
         std::string get_timestamp();
         uint64_t approximate_size();
+        void collect_stats(std::ostringstream* ret);
 
     public:
         // retrieve the current value of a key
@@ -159,17 +170,51 @@ class datalayer
                          uint64_t seq_id);
         // leveldb provides no failure mechanism for this, neither do we
         snapshot make_snapshot();
+        // a snapshot shared by the searches that start while no write has
+        // been applied, or within the staleness window of its creation
+        snapshot make_search_snapshot();
+        void set_snapshot_window(uint64_t nanos);
+        // changes whenever an object in the region is written or wiped; an
+        // unchanged epoch means results computed under it still hold
+        uint64_t region_epoch(const region_id& ri);
+        // how long the first of several concurrent writers waits for others
+        // to join its group commit
+        void set_commit_latency(uint64_t nanos);
+        // bound the memory held by recently read or written objects
+        void set_object_cache_size(uint64_t bytes);
+        // compress values with per-space dictionaries of this many bytes
+        // trained from the values written; 0 stores new values uncompressed
+        void set_dictionary_size(uint64_t bytes);
         // create iterators from snapshots
         iterator* make_region_iterator(snapshot snap,
                                        const region_id& ri,
                                        returncode* error);
+        // projection names the attributes the caller will read (empty for
+        // all of them), or is NULL when the caller needs whole objects
         iterator* make_search_iterator(snapshot snap,
                                        const region_id& ri,
                                        const std::vector<attribute_check>& checks,
+                                       const std::vector<uint16_t>* projection,
                                        std::ostringstream* ostr);
-        // get the object pointed to by the iterator
+        // iterate the keys of objects passing checks; the objects themselves
+        // are read only when the indices cannot decide every check
+        void make_count_iterator(snapshot snap,
+                                 const region_id& ri,
+                                 const std::vector<attribute_check>& checks,
+                                 e::intrusive_ptr<iterator>* iter);
+        // walk objects passing checks in order of sort_by, or return NULL
+        // when sort_by is not indexed in an order-preserving way
+        iterator* make_ordered_search_iterator(snapshot snap,
+                                               const region_id& ri,
+                                               const std::vector<attribute_check>& checks,
+                                               uint16_t sort_by,
+                                               bool reverse);
+        // get the object pointed to by the iterator; objects answered from a
+        // covering index hold only the covered attributes and have version 0;
+        // when reads is not NULL, only the attributes it names are decoded
         returncode get_from_iterator(const region_id& ri,
                                      iterator* iter,
+                                     const std::vector<uint16_t>* reads,
                                      e::slice* key,
                                      std::vector<e::slice>* value,
                                      uint64_t* version,
@@ -185,6 +230,30 @@ class datalayer
         // used on startup
         bool only_key_is_hyperdex_key();
 
+    private:
+        // the progress of adding or dropping one index of one region; every
+        // region's list is mirrored to disk so that it survives restarts
+        enum index_phase
+        {
+            INDEX_BUILT = 0,     // entries are complete; the planner may use it
+            INDEX_CLEARING = 1,  // deleting entries left from before the build
+            INDEX_FILLING = 2,   // adding entries for the existing objects
+            INDEX_DROPPING = 3   // deleting entries of an index no longer wanted
+        };
+        struct index_build
+        {
+            index_build()
+                : attr(), phase(INDEX_BUILT), resume() {}
+            index_build(uint16_t a, index_phase p)
+                : attr(a), phase(p), resume() {}
+            ~index_build() throw () {}
+            uint16_t attr;
+            index_phase phase;
+            // the object key at which to continue filling
+            std::string resume;
+        };
+        typedef std::map<region_id, std::vector<index_build> > index_build_map_t;
+
     private:
         datalayer(const datalayer&);
         datalayer& operator = (const datalayer&);
@@ -192,30 +261,171 @@ class datalayer
     private:
         void checkpointer();
         void wiper();
+        void statistician();
+        void indexer();
+        void trainer();
+        // compare the indices of the regions we hold against new_config and
+        // queue the work to build or drop each difference; requires m_protect
+        void plan_index_builds(const configuration& new_config,
+                               const server_id& us);
+        bool next_index_build(region_id* ri, index_build* build);
+        bool load_index_builds();
+        void save_index_builds(const region_id& ri);
+        // value compression: values are compressed with the current dictionary
+        // of their space, and expanded in place after being read
+        bool load_dictionaries();
+        // dict holds the dictionary used, if any; keep it until the value is
+        // written so that the dictionary cannot be retired in the meantime
+        void compress_value(const region_id& ri,
+                            const leveldb::Slice& raw,
+                            std::vector<char>* backing,
+                            leveldb::Slice* out,
+                            std::tr1::shared_ptr<compression_dictionary>* dict);
+        // train a candidate from the space's samples and install it if it
+        // compresses them better than the current dictionary; true if installed
+        bool train_dictionary(uint64_t space);
+        // find the dictionaries no longer used by new or stored values, and
+        // note them in retiring along with the time they were last needed;
+        // false if interrupted
+        bool retire_dictionaries(std::map<uint32_t, std::string>* retiring);
+        // delete the retiring dictionaries that no replay can reach any more
+        void drop_dictionaries(std::map<uint32_t, std::string>* retiring,
+                               const std::string& replay_floor);
+        returncode expand_value(std::string* backing);
+        // out is in itself, or scratch when in was compressed
+        returncode expand_value(const e::slice& in,
+                                std::string* scratch,
+                                e::slice* out);
+        // add the entries for a batch of objects; true when none are left
+        bool fill_some_index(snapshot snap,
+                             const region_id& ri,
+                             uint16_t attr,
+                             std::string* resume);
+        void fill_index_entry(const schema& sc,
+                              const subspace& sub,
+                              const region_id& ri,
+                              uint16_t attr,
+                              const leveldb::Slice& lkey);
+        bool wipe_some_index(const region_id& ri, uint16_t attr);
+        // can the planner use the index of attr in ri?
+        bool index_ready(const region_id& ri, const subspace& sub, uint16_t attr);
+        // rebuild the planner's statistics for a region; false if interrupted
+        bool refresh_statistics(const region_id& ri);
+        bool load_statistics(const region_id& ri);
         void wipe_checkpoints(const region_id& rid);
+        void wipe_statistics(const region_id& rid);
         bool wipe_some_indices(const region_id& rid);
         bool wipe_some_objects(const region_id& rid);
         bool wipe_some_common(uint8_t c, const region_id& rid);
         void shutdown();
         returncode handle_error(leveldb::Status st);
+        // pick the index iterator for a search; false if nothing can match
+        bool plan_search(snapshot snap,
+                         const region_id& ri,
+                         const std::vector<attribute_check>& checks,
+                         std::ostringstream* ostr,
+                         e::intrusive_ptr<index_iterator>* best,
+                         bool* covered);
+        // can the covering index of ri answer the checks and projection
+        // without reading objects?
+        bool covering(const region_id& ri,
+                      const std::vector<attribute_check>& checks,
+                      const std::vector<uint16_t>* projection);
+        // pick the cheapest plan using the estimates from the region's statistics
+        void plan_from_statistics(snapshot snap,
+                                  uint64_t objects,
+                                  const std::vector<e::intrusive_ptr<index_iterator> >& iterators,
+                                  const std::vector<std::vector<uint16_t> >& exact,
+                                  const std::vector<double>& selectivity,
+                                  e::intrusive_ptr<index_iterator> full_scan,
+                                  std::ostringstream* ostr,
+                                  e::intrusive_ptr<index_iterator>* best,
+                                  std::vector<uint16_t>* best_exact);
         void collect_lower_checkpoints(uint64_t checkpoint_gc);
+        // advance the write epochs after writing an object of ri
+        void note_write(const region_id& ri);
+        // drop the shared search snapshot if its window has passed
+        void expire_search_snapshot();
+        // write updates in one LevelDB batch with those of any concurrent
+        // callers, and return the outcome of that batch
+        leveldb::Status group_commit(leveldb::WriteBatch* updates);
+        // make the object cache reflect a write of lkey; a NULL lval, or a
+        // failed write, removes the key
+        void cache_write(const leveldb::Slice& lkey,
+                         const leveldb::Slice* lval,
+                         const leveldb::Status& st);
+
+    private:
+        class commit_waiter;
+        class space_compression;
+        typedef std::map<uint32_t, std::tr1::shared_ptr<compression_dictionary> > dictionary_map_t;
+        typedef std::map<uint64_t, std::tr1::shared_ptr<space_compression> > space_compression_map_t;
 
     private:
         daemon* m_daemon;
         leveldb_db_ptr m_db;
         po6::threads::thread m_checkpointer;
         po6::threads::thread m_wiper;
+        po6::threads::thread m_statistician;
+        po6::threads::thread m_indexer;
+        po6::threads::thread m_trainer;
         po6::threads::mutex m_protect;
         po6::threads::cond m_wakeup_checkpointer;
         po6::threads::cond m_wakeup_wiper;
+        po6::threads::cond m_wakeup_statistician;
+        po6::threads::cond m_wakeup_indexer;
+        po6::threads::cond m_wakeup_trainer;
         po6::threads::cond m_wakeup_reconfigurer;
         bool m_shutdown;
         bool m_need_pause;
         bool m_checkpointer_paused;
         bool m_wiper_paused;
+        bool m_statistician_paused;
+        bool m_indexer_paused;
+        bool m_trainer_paused;
         uint64_t m_checkpoint_gc;
         typedef std::list<std::pair<transfer_id, region_id> > wipe_list_t;
         wipe_list_t m_wiping;
+        // regions whose planner statistics should be rebuilt
+        std::list<region_id> m_stats_refresh;
+        index_stats m_stats;
+        index_build_map_t m_index_builds;
+        // spaces whose samples are ready to train their next dictionary
+        std::list<uint64_t> m_dict_training;
+        // no replay starts before this timestamp; empty until the first
+        // checkpoint collection
+        std::string m_replay_floor;
+        // serializes each object's write with the backfill of its entries
+        e::striped_lock<po6::threads::mutex> m_key_locks;
+        // bumped after every write that a search could observe
+        uint64_t m_write_epoch;
+        po6::threads::mutex m_search_snapshot_lock;
+        snapshot m_search_snapshot;
+        uint64_t m_search_snapshot_epoch;
+        uint64_t m_search_snapshot_time;
+        // while the shared snapshot is held, the time after which the next
+        // write releases it; zero when none is held
+        uint64_t m_search_snapshot_expiry;
+        uint64_t m_snapshot_window;
+        // per-region write epochs, striped by region id
+        std::vector<uint64_t> m_region_epochs;
+        // writers queued for the next group commit; one of them, the leader,
+        // writes for all while m_committing
+        po6::threads::mutex m_commit_lock;
+        po6::threads::cond m_commit_cond;
+        std::list<commit_waiter*> m_commit_queue;
+        bool m_committing;
+        uint64_t m_commit_latency;
+        object_cache m_objects;
+        // every dictionary that stored values may still name, and the
+        // sampling state of each space
+        po6::threads::mutex m_dict_lock;
+        dictionary_map_t m_dicts;
+        space_compression_map_t m_space_compression;
+        uint32_t m_dict_next;
+        uint64_t m_dict_size;
+        uint64_t m_compress_raw_bytes;
+        uint64_t m_compress_stored_bytes;
 };
 
 class datalayer::reference
@@ -232,6 +442,9 @@ class datalayer::reference
 
     private:
         std::string m_backing;
+        std::string m_key;
+        // set instead of m_backing when the value came from the object cache
+        object_cache::object_ptr m_object;
 };
 
 std::ostream&
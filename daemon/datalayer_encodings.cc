@@ -25,6 +25,9 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// STL
+#include <algorithm>
+
 // LevelDB
 #include <hyperleveldb/write_batch.h>
 
@@ -33,6 +36,7 @@
 
 // HyperDex
 #include "daemon/datalayer_encodings.h"
+#include "daemon/index_composite.h"
 #include "daemon/index_info.h"
 
 using hyperdex::datalayer;
@@ -97,86 +101,6 @@ hyperdex :: decode_key(const leveldb::Slice& in,
     return true;
 }
 
-void
-hyperdex :: encode_value(const std::vector<e::slice>& attrs,
-                         uint64_t version,
-                         std::vector<char>* backing,
-                         leveldb::Slice* out)
-{
-    assert(attrs.size() < 65536);
-    size_t sz = sizeof(uint64_t) + sizeof(uint16_t);
-
-    for (size_t i = 0; i < attrs.size(); ++i)
-    {
-        sz += sizeof(uint32_t) + attrs[i].size();
-    }
-
-    backing->resize(sz);
-    char* ptr = &backing->front();
-    ptr = e::pack64be(version, ptr);
-    ptr = e::pack16be(attrs.size(), ptr);
-
-    for (size_t i = 0; i < attrs.size(); ++i)
-    {
-        ptr = e::pack32be(attrs[i].size(), ptr);
-        memmove(ptr, attrs[i].data(), attrs[i].size());
-        ptr += attrs[i].size();
-    }
-
-    *out = leveldb::Slice(&backing->front(), sz);
-}
-
-datalayer::returncode
-hyperdex :: decode_value(const e::slice& in,
-                         std::vector<e::slice>* attrs,
-                         uint64_t* version)
-{
-    const uint8_t* ptr = in.data();
-    const uint8_t* end = ptr + in.size();
-
-    if (ptr + sizeof(uint64_t) <= end)
-    {
-        ptr = e::unpack64be(ptr, version);
-    }
-    else
-    {
-        return datalayer::BAD_ENCODING;
-    }
-
-    uint16_t num_attrs;
-
-    if (ptr + sizeof(uint16_t) <= end)
-    {
-        ptr = e::unpack16be(ptr, &num_attrs);
-    }
-    else
-    {
-        return datalayer::BAD_ENCODING;
-    }
-
-    attrs->clear();
-
-    for (size_t i = 0; i < num_attrs; ++i)
-    {
-        uint32_t sz = 0;
-
-        if (ptr + sizeof(uint32_t) <= end)
-        {
-            ptr = e::unpack32be(ptr, &sz);
-        }
-        else
-        {
-            return datalayer::BAD_ENCODING;
-        }
-
-        e::slice s(reinterpret_cast<const uint8_t*>(ptr), sz);
-        ptr += sz;
-        attrs->push_back(s);
-    }
-
-    return datalayer::SUCCESS;
-}
-
 void
 hyperdex :: encode_acked(const region_id& ri, /*region we saw an ack for*/
                          const region_id& reg_id, /*region of the point leader*/
@@ -245,6 +169,123 @@ hyperdex :: decode_checkpoint(const e::slice& in,
     return t == 'c' ? datalayer::SUCCESS : datalayer::BAD_ENCODING;
 }
 
+void
+hyperdex :: encode_index_stats(const region_id& ri,
+                               char* out)
+{
+    char* ptr = out;
+    ptr = e::pack8be('p', ptr);
+    ptr = e::pack64be(ri.get(), ptr);
+}
+
+void
+hyperdex :: encode_index_build(const region_id& ri,
+                               char* out)
+{
+    char* ptr = out;
+    ptr = e::pack8be('b', ptr);
+    ptr = e::pack64be(ri.get(), ptr);
+}
+
+datalayer::returncode
+hyperdex :: decode_index_build(const e::slice& in,
+                               region_id* ri)
+{
+    if (in.size() != INDEX_BUILD_BUF_SIZE)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    const uint8_t* ptr = in.data();
+    uint8_t t;
+    uint64_t _ri;
+    ptr = e::unpack8be(ptr, &t);
+    ptr = e::unpack64be(ptr, &_ri);
+    *ri = region_id(_ri);
+    return t == 'b' ? datalayer::SUCCESS : datalayer::BAD_ENCODING;
+}
+
+void
+hyperdex :: encode_dictionary(uint32_t dict_id,
+                              char* out)
+{
+    char* ptr = out;
+    ptr = e::pack8be('d', ptr);
+    ptr = e::pack32be(dict_id, ptr);
+}
+
+datalayer::returncode
+hyperdex :: decode_dictionary(const e::slice& in,
+                              uint32_t* dict_id)
+{
+    if (in.size() != DICTIONARY_BUF_SIZE)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    const uint8_t* ptr = in.data();
+    uint8_t t;
+    ptr = e::unpack8be(ptr, &t);
+    ptr = e::unpack32be(ptr, dict_id);
+    return t == 'd' ? datalayer::SUCCESS : datalayer::BAD_ENCODING;
+}
+
+void
+hyperdex :: encode_covering(const subspace& sub,
+                            const std::vector<e::slice>& value,
+                            std::vector<char>* backing,
+                            leveldb::Slice* out)
+{
+    std::vector<e::slice> covered;
+    covered.reserve(sub.covering.size());
+
+    for (size_t i = 0; i < sub.covering.size(); ++i)
+    {
+        assert(sub.covering[i] > 0 && sub.covering[i] <= value.size());
+        covered.push_back(value[sub.covering[i] - 1]);
+    }
+
+    // the version is left out so that entries need not be rewritten on every
+    // write to the object
+    encode_value(covered, 0, backing, out);
+}
+
+datalayer::returncode
+hyperdex :: decode_covering(const schema& sc,
+                            const subspace& sub,
+                            const e::slice& in,
+                            std::vector<e::slice>* value)
+{
+    std::vector<e::slice> covered;
+    uint64_t version;
+    datalayer::returncode rc = decode_value(in, &covered, &version);
+
+    if (rc != datalayer::SUCCESS)
+    {
+        return rc;
+    }
+
+    if (covered.size() != sub.covering.size())
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    value->clear();
+    value->resize(sc.attrs_sz - 1);
+
+    for (size_t i = 0; i < sub.covering.size(); ++i)
+    {
+        if (sub.covering[i] == 0 || sub.covering[i] >= sc.attrs_sz)
+        {
+            return datalayer::BAD_ENCODING;
+        }
+
+        (*value)[sub.covering[i] - 1] = covered[i];
+    }
+
+    return datalayer::SUCCESS;
+}
+
 void
 hyperdex :: create_index_changes(const schema& sc,
                                  const subspace& sub,
@@ -300,6 +341,66 @@ hyperdex :: create_index_changes(const schema& sc,
                           new_value ? &(*new_value)[attr - 1] : NULL,
                           updates);
     }
+
+    std::vector<char> payload_backing;
+    leveldb::Slice payload;
+    bool covered_changed = false;
+
+    if (!sub.covering.empty() && new_value)
+    {
+        covered_changed = !old_value;
+
+        for (size_t i = 0; !covered_changed && i < sub.covering.size(); ++i)
+        {
+            uint16_t attr = sub.covering[i];
+            covered_changed = (*old_value)[attr - 1] != (*new_value)[attr - 1];
+        }
+
+        encode_covering(sub, *new_value, &payload_backing, &payload);
+    }
+
+    for (size_t i = 0; i < sub.composites.size(); ++i)
+    {
+        index_composite ci(sc, sub, i);
+        ci.index_changes(ri, index_info::lookup(sc.attrs[0].type), key,
+                         old_value, new_value,
+                         e::slice(payload.data(), payload.size()),
+                         covered_changed, updates);
+    }
+
+    if (sub.covering.empty() || !new_value)
+    {
+        return;
+    }
+
+    // rewrite the entries whose indexed value changed (index_changes left them
+    // without a payload) and, when a covered value changed, all the others
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        uint16_t attr = attrs[i];
+
+        if (attr == 0 || !sub.indexed(attr))
+        {
+            continue;
+        }
+
+        if (!covered_changed &&
+            (*old_value)[attr - 1] == (*new_value)[attr - 1])
+        {
+            continue;
+        }
+
+        index_info* ki = index_info::lookup(sc.attrs[0].type);
+        index_info* ai = index_info::lookup(sc.attrs[attr].type);
+
+        if (!ai)
+        {
+            continue;
+        }
+
+        ai->covering_changes(ri, attr, ki, key, (*new_value)[attr - 1],
+                             e::slice(payload.data(), payload.size()), updates);
+    }
 }
 
 void
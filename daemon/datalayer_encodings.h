@@ -35,6 +35,7 @@
 #include "namespace.h"
 #include "common/ids.h"
 #include "daemon/datalayer.h"
+#include "daemon/datalayer_values.h"
 
 BEGIN_HYPERDEX_NAMESPACE
 
@@ -55,16 +56,6 @@ decode_key(const leveldb::Slice& in,
            region_id* ri,
            e::slice* internal_key);
 
-void
-encode_value(const std::vector<e::slice>& attrs,
-             uint64_t version,
-             std::vector<char>* backing,
-             leveldb::Slice* out);
-datalayer::returncode
-decode_value(const e::slice& in,
-             std::vector<e::slice>* attrs,
-             uint64_t* version);
-
 // Encode the record of an operation for which we have sent an ACK
 #define ACKED_BUF_SIZE (sizeof(uint8_t) + 3 * sizeof(uint64_t))
 void
@@ -89,6 +80,44 @@ decode_checkpoint(const e::slice& in,
                   region_id* ri,
                   uint64_t* checkpoint);
 
+// planner statistics
+#define INDEX_STATS_BUF_SIZE (sizeof(uint8_t) + sizeof(uint64_t))
+void
+encode_index_stats(const region_id& ri,
+                   char* out);
+
+// indices being built or dropped online
+#define INDEX_BUILD_BUF_SIZE (sizeof(uint8_t) + sizeof(uint64_t))
+void
+encode_index_build(const region_id& ri,
+                   char* out);
+datalayer::returncode
+decode_index_build(const e::slice& in,
+                   region_id* ri);
+
+// value compression dictionaries, stored with the id of their space
+#define DICTIONARY_BUF_SIZE (sizeof(uint8_t) + sizeof(uint32_t))
+void
+encode_dictionary(uint32_t dict_id,
+                  char* out);
+datalayer::returncode
+decode_dictionary(const e::slice& in,
+                  uint32_t* dict_id);
+
+// covering indices: the values of a subspace's covered attributes, stored
+// alongside each of its primitive index entries
+void
+encode_covering(const subspace& sub,
+                const std::vector<e::slice>& value,
+                std::vector<char>* backing,
+                leveldb::Slice* out);
+// expand the covered values into a full value with every other attribute empty
+datalayer::returncode
+decode_covering(const schema& sc,
+                const subspace& sub,
+                const e::slice& in,
+                std::vector<e::slice>* value);
+
 void
 create_index_changes(const schema& sc,
                      const subspace& sub,
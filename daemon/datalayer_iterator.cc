@@ -27,6 +27,11 @@
 
 #define __STDC_LIMIT_MACROS
 
+// STL
+#include <algorithm>
+#include <memory>
+#include <utility>
+
 // e
 #include <e/endian.h>
 
@@ -35,6 +40,11 @@
 #include "daemon/datalayer_encodings.h"
 #include "daemon/datalayer_iterator.h"
 
+// The number of index entries a search pulls ahead of evaluation, at first
+// and at most; objects for a window are read in key order
+#define SEARCH_WINDOW_MIN 8
+#define SEARCH_WINDOW_MAX 256
+
 using hyperdex::datalayer;
 using hyperdex::leveldb_snapshot_ptr;
 
@@ -74,6 +84,18 @@ datalayer :: iterator :: iterator(leveldb_snapshot_ptr s)
 {
 }
 
+e::slice
+datalayer :: iterator :: covered()
+{
+    return e::slice();
+}
+
+bool
+datalayer :: iterator :: take_prefetched(std::string*)
+{
+    return false;
+}
+
 leveldb_snapshot_ptr
 datalayer :: iterator :: snap()
 {
@@ -86,10 +108,12 @@ datalayer :: iterator :: ~iterator() throw ()
 
 ///////////////////////////// class replay_iterator ////////////////////////////
 
-datalayer :: replay_iterator :: replay_iterator(const region_id& ri,
+datalayer :: replay_iterator :: replay_iterator(datalayer* dl,
+                                                const region_id& ri,
                                                 leveldb_replay_iterator_ptr ptr,
                                                 index_info* di)
-    : m_ri(ri)
+    : m_dl(dl)
+    , m_ri(ri)
     , m_iter(ptr.get())
     , m_ptr(ptr)
     , m_decoded()
@@ -154,6 +178,13 @@ datalayer :: replay_iterator :: unpack_value(std::vector<e::slice>* value,
                                              reference* ref)
 {
     ref->m_backing.assign(m_iter->value().data(), m_iter->value().size());
+    datalayer::returncode rc = m_dl->expand_value(&ref->m_backing);
+
+    if (rc != SUCCESS)
+    {
+        return rc;
+    }
+
     e::slice v(ref->m_backing.data(), ref->m_backing.size());
     return decode_value(v, value, version);
 }
@@ -312,22 +343,30 @@ datalayer :: index_iterator :: ~index_iterator() throw ()
 {
 }
 
+e::slice
+datalayer :: index_iterator :: payload()
+{
+    return e::slice();
+}
+
 //////////////////////////// class intersect_iterator ////////////////////////////
 
 datalayer :: intersect_iterator :: intersect_iterator(leveldb_snapshot_ptr s,
-                                                      const std::vector<e::intrusive_ptr<index_iterator> >& iterators)
+                                                      const std::vector<e::intrusive_ptr<index_iterator> >& iterators,
+                                                      const std::vector<uint64_t>& costs)
     : index_iterator(s)
     , m_iters()
     , m_cost(0)
     , m_invalid(false)
 {
     assert(!iterators.empty());
+    assert(iterators.size() == costs.size());
     std::vector<std::pair<uint64_t, e::intrusive_ptr<index_iterator> > > iters;
 
     for (size_t i = 0; i < iterators.size(); ++i)
     {
         assert(iterators[i]->sorted());
-        iters.push_back(std::make_pair(iterators[i]->cost(s.db()), iterators[i]));
+        iters.push_back(std::make_pair(costs[i], iterators[i]));
     }
 
     std::sort(iters.begin(), iters.end());
@@ -434,6 +473,12 @@ datalayer :: intersect_iterator :: internal_key()
     return m_iters[0]->internal_key();
 }
 
+e::slice
+datalayer :: intersect_iterator :: payload()
+{
+    return m_iters[0]->payload();
+}
+
 bool
 datalayer :: intersect_iterator :: sorted()
 {
@@ -446,13 +491,330 @@ datalayer :: intersect_iterator :: seek(const e::slice& k)
     return m_iters[0]->seek(k);
 }
 
+////////////////////////// class hash_intersect_iterator /////////////////////////
+
+datalayer :: hash_intersect_iterator :: hash_intersect_iterator(leveldb_snapshot_ptr s,
+                                                                const std::vector<e::intrusive_ptr<index_iterator> >& iterators,
+                                                                const std::vector<uint64_t>& costs)
+    : index_iterator(s)
+    , m_iters()
+    , m_cost(0)
+    , m_materialized(false)
+    , m_candidates()
+{
+    assert(iterators.size() > 1);
+    assert(iterators.size() == costs.size());
+    std::vector<std::pair<uint64_t, e::intrusive_ptr<index_iterator> > > iters;
+
+    for (size_t i = 0; i < iterators.size(); ++i)
+    {
+        iters.push_back(std::make_pair(costs[i], iterators[i]));
+    }
+
+    std::sort(iters.begin(), iters.end());
+    m_iters.resize(iters.size());
+
+    for (size_t i = 0; i < iters.size(); ++i)
+    {
+        m_cost += iters[i].first;
+        m_iters[i] = iters[i].second;
+    }
+}
+
+datalayer :: hash_intersect_iterator :: ~hash_intersect_iterator() throw ()
+{
+}
+
+bool
+datalayer :: hash_intersect_iterator :: valid()
+{
+    if (!m_materialized)
+    {
+        materialize();
+    }
+
+    index_iterator* last = m_iters.back().get();
+
+    while (!m_candidates.empty() && last->valid())
+    {
+        e::slice ik = last->internal_key();
+
+        if (m_candidates.find(std::string(reinterpret_cast<const char*>(ik.data()), ik.size()))
+                != m_candidates.end())
+        {
+            return true;
+        }
+
+        last->next();
+    }
+
+    return false;
+}
+
+void
+datalayer :: hash_intersect_iterator :: next()
+{
+    // forget the key so that an iterator with repeated entries (e.g. one
+    // over container elements) returns each object once
+    e::slice ik = m_iters.back()->internal_key();
+    m_candidates.erase(std::string(reinterpret_cast<const char*>(ik.data()), ik.size()));
+    m_iters.back()->next();
+}
+
+uint64_t
+datalayer :: hash_intersect_iterator :: cost(leveldb::DB*)
+{
+    return m_cost;
+}
+
+e::slice
+datalayer :: hash_intersect_iterator :: key()
+{
+    return m_iters.back()->key();
+}
+
+std::ostream&
+datalayer :: hash_intersect_iterator :: describe(std::ostream& out) const
+{
+    out << "hash_intersect_iterator(";
+
+    for (size_t i = 0; i < m_iters.size(); ++i)
+    {
+        if (i > 0)
+        {
+            out << ", ";
+        }
+
+        out << *m_iters[i];
+    }
+
+    return out << ")";
+}
+
+e::slice
+datalayer :: hash_intersect_iterator :: internal_key()
+{
+    return m_iters.back()->internal_key();
+}
+
+e::slice
+datalayer :: hash_intersect_iterator :: payload()
+{
+    return m_iters.back()->payload();
+}
+
+bool
+datalayer :: hash_intersect_iterator :: sorted()
+{
+    return false;
+}
+
+void
+datalayer :: hash_intersect_iterator :: seek(const e::slice&)
+{
+    abort();
+}
+
+void
+datalayer :: hash_intersect_iterator :: materialize()
+{
+    m_materialized = true;
+
+    for (; m_iters[0]->valid(); m_iters[0]->next())
+    {
+        e::slice ik = m_iters[0]->internal_key();
+        m_candidates.insert(std::string(reinterpret_cast<const char*>(ik.data()), ik.size()));
+    }
+
+    // narrow the candidates with every iterator but the last
+    for (size_t i = 1; !m_candidates.empty() && i + 1 < m_iters.size(); ++i)
+    {
+        candidate_set_t narrowed;
+
+        for (; m_iters[i]->valid(); m_iters[i]->next())
+        {
+            e::slice ik = m_iters[i]->internal_key();
+            std::string k(reinterpret_cast<const char*>(ik.data()), ik.size());
+
+            if (m_candidates.find(k) != m_candidates.end())
+            {
+                narrowed.insert(k);
+            }
+        }
+
+        m_candidates.swap(narrowed);
+    }
+}
+
+///////////////////////////// class union_iterator /////////////////////////////
+
+datalayer :: union_iterator :: union_iterator(leveldb_snapshot_ptr s,
+                                              const std::vector<e::intrusive_ptr<index_iterator> >& iterators)
+    : index_iterator(s)
+    , m_iters(iterators)
+    , m_sorted(true)
+    , m_cur(0)
+    , m_settled(false)
+    , m_seen()
+{
+    for (size_t i = 0; i < m_iters.size(); ++i)
+    {
+        m_sorted = m_sorted && m_iters[i]->sorted();
+    }
+}
+
+datalayer :: union_iterator :: ~union_iterator() throw ()
+{
+}
+
+bool
+datalayer :: union_iterator :: valid()
+{
+    if (!m_sorted)
+    {
+        for (; m_cur < m_iters.size(); ++m_cur)
+        {
+            for (; m_iters[m_cur]->valid(); m_iters[m_cur]->next())
+            {
+                e::slice ik = m_iters[m_cur]->internal_key();
+
+                if (m_seen.find(std::string(reinterpret_cast<const char*>(ik.data()), ik.size()))
+                        == m_seen.end())
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    if (!m_settled)
+    {
+        m_cur = m_iters.size();
+
+        for (size_t i = 0; i < m_iters.size(); ++i)
+        {
+            if (m_iters[i]->valid() &&
+                (m_cur == m_iters.size() ||
+                 internal_key_compare(m_iters[i]->internal_key(),
+                                      m_iters[m_cur]->internal_key()) < 0))
+            {
+                m_cur = i;
+            }
+        }
+
+        m_settled = true;
+    }
+
+    return m_cur < m_iters.size();
+}
+
+void
+datalayer :: union_iterator :: next()
+{
+    e::slice ik = m_iters[m_cur]->internal_key();
+    std::string k(reinterpret_cast<const char*>(ik.data()), ik.size());
+
+    if (!m_sorted)
+    {
+        m_seen.insert(k);
+        m_iters[m_cur]->next();
+        return;
+    }
+
+    // step past the key in every iterator that holds it
+    for (size_t i = 0; i < m_iters.size(); ++i)
+    {
+        if (m_iters[i]->valid() &&
+            internal_key_compare(m_iters[i]->internal_key(), e::slice(k)) == 0)
+        {
+            m_iters[i]->next();
+        }
+    }
+
+    m_settled = false;
+}
+
+uint64_t
+datalayer :: union_iterator :: cost(leveldb::DB* db)
+{
+    uint64_t c = 0;
+
+    for (size_t i = 0; i < m_iters.size(); ++i)
+    {
+        c += m_iters[i]->cost(db);
+    }
+
+    return c;
+}
+
+e::slice
+datalayer :: union_iterator :: key()
+{
+    return m_iters[m_cur]->key();
+}
+
+std::ostream&
+datalayer :: union_iterator :: describe(std::ostream& out) const
+{
+    out << "union_iterator(";
+
+    for (size_t i = 0; i < m_iters.size(); ++i)
+    {
+        if (i > 0)
+        {
+            out << ", ";
+        }
+
+        out << *m_iters[i];
+    }
+
+    return out << ")";
+}
+
+e::slice
+datalayer :: union_iterator :: internal_key()
+{
+    return m_iters[m_cur]->internal_key();
+}
+
+e::slice
+datalayer :: union_iterator :: payload()
+{
+    return m_iters[m_cur]->payload();
+}
+
+bool
+datalayer :: union_iterator :: sorted()
+{
+    return m_sorted;
+}
+
+void
+datalayer :: union_iterator :: seek(const e::slice& k)
+{
+    if (!m_sorted)
+    {
+        abort();
+    }
+
+    for (size_t i = 0; i < m_iters.size(); ++i)
+    {
+        m_iters[i]->seek(k);
+    }
+
+    m_settled = false;
+}
+
 ///////////////////////////// class search_iterator ////////////////////////////
 
 datalayer :: search_iterator :: search_iterator(datalayer* dl,
                                                 const region_id& ri,
                                                 e::intrusive_ptr<index_iterator> iter,
                                                 std::ostringstream* ostr,
-                                                const std::vector<attribute_check>* checks)
+                                                const std::vector<attribute_check>* checks,
+                                                bool covering)
     : iterator(iter->snap())
     , m_dl(dl)
     , m_ri(ri)
@@ -461,7 +823,17 @@ datalayer :: search_iterator :: search_iterator(datalayer* dl,
     , m_ostr(ostr)
     , m_num_gets(0)
     , m_checks(checks)
+    , m_check_reads()
+    , m_covering(covering)
+    , m_covered()
+    , m_window()
+    , m_window_pos(0)
+    , m_window_sz(SEARCH_WINDOW_MIN)
 {
+    for (size_t i = 0; i < m_checks->size(); ++i)
+    {
+        m_check_reads.push_back((*m_checks)[i].attr);
+    }
 }
 
 datalayer :: search_iterator :: ~search_iterator() throw ()
@@ -488,57 +860,75 @@ datalayer :: search_iterator :: valid()
 
     uint64_t version;
     std::vector<e::slice> value;
-    reference ref;
 
-    // while the most selective iterator is valid and not past the end
-    while (m_iter->valid())
+    // while there are entries left in the window or the index
+    while (m_window_pos < m_window.size() || fill_window(sc))
     {
-        leveldb::ReadOptions opts;
-        opts.fill_cache = true;
-        opts.verify_checksums = true;
-        std::vector<char> kbacking;
-        leveldb::Slice lkey;
-        encode_key(m_ri, sc.attrs[0].type, m_iter->key(), &kbacking, &lkey);
-
-        leveldb::Status st = m_dl->m_db->Get(opts, lkey, &ref.m_backing);
+        candidate* c = &m_window[m_window_pos];
+        e::slice key(c->key.data(), c->key.size());
+        m_covered = e::slice();
 
-        if (st.ok())
+        if (!c->payload.empty())
         {
-            e::slice v(ref.m_backing.data(), ref.m_backing.size());
-            datalayer::returncode rc = decode_value(v, &value, &version);
+            e::slice payload(c->payload.data(), c->payload.size());
 
-            if (rc != SUCCESS)
+            if (decode_covering(sc, *m_dl->m_daemon->m_config.get_subspace(m_ri),
+                                payload, &value) == SUCCESS)
             {
-                m_error = rc;
-                return false;
+                if (passes_attribute_checks(sc, *m_checks, key, value) == m_checks->size())
+                {
+                    m_covered = payload;
+                    return true;
+                }
+
+                ++m_window_pos;
+                continue;
             }
-
-            ++m_num_gets;
         }
-        else
+
+        if (!c->fetched && !fetch(sc, c))
         {
-            m_error = m_dl->handle_error(st);
             return false;
         }
 
-        if (passes_attribute_checks(sc, *m_checks, m_iter->key(), value) == m_checks->size())
+        // a stale index entry for an object the snapshot does not hold
+        if (c->value.empty())
         {
-            return true;
+            ++m_window_pos;
+            continue;
+        }
+
+        // expanded in place, so take_prefetched() hands out the raw value
+        datalayer::returncode rc = m_dl->expand_value(&c->value);
+
+        if (rc == SUCCESS)
+        {
+            rc = decode_value_attrs(e::slice(c->value.data(), c->value.size()),
+                                    &m_check_reads, &value, &version);
         }
-        else
+
+        if (rc != SUCCESS)
+        {
+            m_error = rc;
+            return false;
+        }
+
+        if (passes_attribute_checks(sc, *m_checks, key, value) == m_checks->size())
         {
-            m_iter->next();
+            return true;
         }
+
+        ++m_window_pos;
     }
 
-    if (m_ostr) *m_ostr << " iterator retrieved " << m_num_gets << " objects from disk\n";
+    if (m_ostr && m_error == SUCCESS) *m_ostr << " iterator retrieved " << m_num_gets << " objects from disk\n";
     return false;
 }
 
 void
 datalayer :: search_iterator :: next()
 {
-    m_iter->next();
+    ++m_window_pos;
 }
 
 uint64_t
@@ -550,5 +940,142 @@ datalayer :: search_iterator :: cost(leveldb::DB* db)
 e::slice
 datalayer :: search_iterator :: key()
 {
-    return m_iter->key();
+    const candidate& c(m_window[m_window_pos]);
+    return e::slice(c.key.data(), c.key.size());
+}
+
+e::slice
+datalayer :: search_iterator :: covered()
+{
+    return m_covered;
+}
+
+bool
+datalayer :: search_iterator :: take_prefetched(std::string* value)
+{
+    candidate& c(m_window[m_window_pos]);
+
+    if (!m_covered.empty() || !c.fetched || c.value.empty())
+    {
+        return false;
+    }
+
+    value->swap(c.value);
+    c.value.clear();
+    c.fetched = false;
+    return true;
+}
+
+bool
+datalayer :: search_iterator :: fill_window(const schema& sc)
+{
+    m_window.clear();
+    m_window_pos = 0;
+
+    while (m_window.size() < m_window_sz && m_iter->valid())
+    {
+        m_window.push_back(candidate());
+        candidate* c = &m_window.back();
+        e::slice key = m_iter->key();
+        c->key.assign(reinterpret_cast<const char*>(key.data()), key.size());
+
+        if (m_covering)
+        {
+            e::slice payload = m_iter->payload();
+            c->payload.assign(reinterpret_cast<const char*>(payload.data()), payload.size());
+        }
+
+        m_iter->next();
+    }
+
+    m_window_sz = std::min(m_window_sz * 2, static_cast<size_t>(SEARCH_WINDOW_MAX));
+
+    // the index hands out keys in index order; read the objects in key
+    // order instead so that one iterator sweeps forward through the region
+    std::vector<std::pair<std::string, size_t> > order;
+
+    for (size_t i = 0; i < m_window.size(); ++i)
+    {
+        if (!m_window[i].payload.empty())
+        {
+            continue;
+        }
+
+        std::vector<char> kbacking;
+        leveldb::Slice lkey;
+        encode_key(m_ri, sc.attrs[0].type,
+                   e::slice(m_window[i].key.data(), m_window[i].key.size()),
+                   &kbacking, &lkey);
+        order.push_back(std::make_pair(lkey.ToString(), i));
+    }
+
+    std::sort(order.begin(), order.end());
+
+    if (order.size() > 1)
+    {
+        leveldb::ReadOptions opts;
+        opts.fill_cache = true;
+        opts.verify_checksums = true;
+        opts.snapshot = snap().get();
+        std::auto_ptr<leveldb::Iterator> it(m_dl->m_db->NewIterator(opts));
+
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+            leveldb::Slice lkey(order[i].first);
+            candidate* c = &m_window[order[i].second];
+
+            if (!it->Valid() || it->key().compare(lkey) < 0)
+            {
+                it->Seek(lkey);
+            }
+
+            if (!it->status().ok())
+            {
+                m_error = m_dl->handle_error(it->status());
+                return false;
+            }
+
+            c->fetched = true;
+
+            if (it->Valid() && it->key() == lkey)
+            {
+                c->value.assign(it->value().data(), it->value().size());
+                ++m_num_gets;
+            }
+        }
+    }
+
+    return !m_window.empty();
+}
+
+bool
+datalayer :: search_iterator :: fetch(const schema& sc, candidate* c)
+{
+    leveldb::ReadOptions opts;
+    opts.fill_cache = true;
+    opts.verify_checksums = true;
+    opts.snapshot = snap().get();
+    std::vector<char> kbacking;
+    leveldb::Slice lkey;
+    encode_key(m_ri, sc.attrs[0].type,
+               e::slice(c->key.data(), c->key.size()),
+               &kbacking, &lkey);
+    leveldb::Status st = m_dl->m_db->Get(opts, lkey, &c->value);
+    c->fetched = true;
+
+    if (st.ok())
+    {
+        ++m_num_gets;
+        return true;
+    }
+    else if (st.IsNotFound())
+    {
+        c->value.clear();
+        return true;
+    }
+    else
+    {
+        m_error = m_dl->handle_error(st);
+        return false;
+    }
 }
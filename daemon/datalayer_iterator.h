@@ -28,6 +28,11 @@
 #ifndef hyperdex_daemon_datalayer_iterator_h_
 #define hyperdex_daemon_datalayer_iterator_h_
 
+// STL
+#include <string>
+#include <tr1/unordered_set>
+#include <vector>
+
 // e
 #include <e/intrusive_ptr.h>
 
@@ -51,6 +56,16 @@ class datalayer::iterator
         // REQUIRES: valid
         virtual e::slice key() = 0;
         virtual std::ostream& describe(std::ostream&) const = 0;
+        // REQUIRES: valid
+        // the encoded covered values of the current object when they were
+        // read from a covering index, or an empty slice if the object itself
+        // must be read
+        virtual e::slice covered();
+        // REQUIRES: valid
+        // if the iterator already read the encoded current object from the
+        // snapshot, swap it into value and return true; the iterator reads
+        // the object again if it is needed later
+        virtual bool take_prefetched(std::string* value);
 
     public:
         leveldb_snapshot_ptr snap();
@@ -69,7 +84,7 @@ class datalayer::iterator
 class datalayer::replay_iterator
 {
     public:
-        replay_iterator(const region_id& ri, leveldb_replay_iterator_ptr ptr, index_info* di);
+        replay_iterator(datalayer* dl, const region_id& ri, leveldb_replay_iterator_ptr ptr, index_info* di);
 
     public:
         bool valid();
@@ -82,6 +97,7 @@ class datalayer::replay_iterator
         leveldb::Status status();
 
     private:
+        datalayer* m_dl;
         region_id m_ri;
         leveldb::ReplayIterator* m_iter;
         leveldb_replay_iterator_ptr m_ptr;
@@ -145,6 +161,9 @@ class datalayer::index_iterator : public iterator
 
     public:
         virtual e::slice internal_key() = 0;
+        // the value stored with the current index entry; empty unless the
+        // entry belongs to a covering index
+        virtual e::slice payload();
         virtual bool sorted() = 0;
         virtual void seek(const e::slice& internal_key) = 0;
 
@@ -155,8 +174,10 @@ class datalayer::index_iterator : public iterator
 class datalayer::intersect_iterator : public index_iterator
 {
     public:
+        // iterators are walked in ascending order of their estimated costs
         intersect_iterator(leveldb_snapshot_ptr snap,
-                           const std::vector<e::intrusive_ptr<index_iterator> >& iterators);
+                           const std::vector<e::intrusive_ptr<index_iterator> >& iterators,
+                           const std::vector<uint64_t>& costs);
         virtual ~intersect_iterator() throw ();
 
     public:
@@ -166,6 +187,7 @@ class datalayer::intersect_iterator : public index_iterator
         virtual e::slice key();
         virtual std::ostream& describe(std::ostream&) const;
         virtual e::slice internal_key();
+        virtual e::slice payload();
         virtual bool sorted();
         virtual void seek(const e::slice& internal_key);
 
@@ -175,14 +197,82 @@ class datalayer::intersect_iterator : public index_iterator
         bool m_invalid;
 };
 
+// Intersect iterators that cannot seek.  The keys of all but the last
+// iterator are gathered into a set of candidates, smallest iterator first, and
+// the last iterator is walked returning only the candidates.
+class datalayer::hash_intersect_iterator : public index_iterator
+{
+    public:
+        // iterators are consumed in ascending order of their estimated costs
+        hash_intersect_iterator(leveldb_snapshot_ptr snap,
+                                const std::vector<e::intrusive_ptr<index_iterator> >& iterators,
+                                const std::vector<uint64_t>& costs);
+        virtual ~hash_intersect_iterator() throw ();
+
+    public:
+        virtual bool valid();
+        virtual void next();
+        virtual uint64_t cost(leveldb::DB*);
+        virtual e::slice key();
+        virtual std::ostream& describe(std::ostream&) const;
+        virtual e::slice internal_key();
+        virtual e::slice payload();
+        virtual bool sorted();
+        virtual void seek(const e::slice& internal_key);
+
+    private:
+        void materialize();
+
+    private:
+        typedef std::tr1::unordered_set<std::string> candidate_set_t;
+        std::vector<e::intrusive_ptr<index_iterator> > m_iters;
+        uint64_t m_cost;
+        bool m_materialized;
+        candidate_set_t m_candidates;
+};
+
+// Return each key that any of several iterators returns once.  Sorted
+// iterators are merged by internal key; if any iterator is unsorted they are
+// walked one after another, skipping keys already returned.
+class datalayer::union_iterator : public index_iterator
+{
+    public:
+        union_iterator(leveldb_snapshot_ptr snap,
+                       const std::vector<e::intrusive_ptr<index_iterator> >& iterators);
+        virtual ~union_iterator() throw ();
+
+    public:
+        virtual bool valid();
+        virtual void next();
+        virtual uint64_t cost(leveldb::DB*);
+        virtual e::slice key();
+        virtual std::ostream& describe(std::ostream&) const;
+        virtual e::slice internal_key();
+        virtual e::slice payload();
+        virtual bool sorted();
+        virtual void seek(const e::slice& internal_key);
+
+    private:
+        typedef std::tr1::unordered_set<std::string> seen_set_t;
+        std::vector<e::intrusive_ptr<index_iterator> > m_iters;
+        bool m_sorted;
+        // the iterator holding the current key, valid once m_settled
+        size_t m_cur;
+        bool m_settled;
+        seen_set_t m_seen;
+};
+
 class datalayer::search_iterator : public iterator
 {
     public:
+        // when covering, objects are evaluated from the covered values stored
+        // in the index entries, and read only when an entry has none
         search_iterator(datalayer* dl,
                         const region_id& ri,
                         e::intrusive_ptr<index_iterator> iter,
                         std::ostringstream* ostr,
-                        const std::vector<attribute_check>* checks);
+                        const std::vector<attribute_check>* checks,
+                        bool covering);
         virtual ~search_iterator() throw ();
 
     public:
@@ -191,11 +281,31 @@ class datalayer::search_iterator : public iterator
         virtual uint64_t cost(leveldb::DB*);
         virtual e::slice key();
         virtual std::ostream& describe(std::ostream&) const;
+        virtual e::slice covered();
+        virtual bool take_prefetched(std::string* value);
+
+    private:
+        // an index entry pulled ahead of evaluation, with its object once read
+        struct candidate
+        {
+            candidate() : key(), payload(), value(), fetched(false) {}
+            ~candidate() throw () {}
+            std::string key;
+            std::string payload;
+            std::string value;
+            bool fetched;
+        };
 
     private:
         search_iterator(const search_iterator&);
         search_iterator& operator = (const search_iterator&);
 
+    private:
+        // pull the next window of entries from m_iter and read their objects
+        // in key order; false if there are none or reading failed
+        bool fill_window(const schema& sc);
+        bool fetch(const schema& sc, candidate* c);
+
     private:
         datalayer* m_dl;
         region_id m_ri;
@@ -204,6 +314,15 @@ class datalayer::search_iterator : public iterator
         std::ostringstream* m_ostr;
         uint64_t m_num_gets;
         const std::vector<attribute_check>* m_checks;
+        // the attributes the checks need decoded from each object
+        std::vector<uint16_t> m_check_reads;
+        bool m_covering;
+        e::slice m_covered;
+        // entries are evaluated from m_window in index order; the window
+        // doubles up to a limit so short searches read little ahead
+        std::vector<candidate> m_window;
+        size_t m_window_pos;
+        size_t m_window_sz;
 };
 
 inline std::ostream&
@@ -0,0 +1,299 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <assert.h>
+#include <string.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "daemon/datalayer_values.h"
+
+using hyperdex::datalayer;
+
+// Values used to start directly with their 64-bit version and hold
+// length-prefixed attributes one after another.  They now start with a marker
+// byte that no version reaches in its high byte, a format byte, the version,
+// and a table holding the end offset of each attribute so that any one
+// attribute can be found without walking those before it.
+#define VALUE_MARKER 0xff
+#define VALUE_FORMAT_OFFSETS 1
+#define VALUE_FORMAT_COMPRESSED 2
+#define VALUE_HEADER_SIZE (2 * sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint16_t))
+
+void
+hyperdex :: encode_value(const std::vector<e::slice>& attrs,
+                         uint64_t version,
+                         std::vector<char>* backing,
+                         leveldb::Slice* out)
+{
+    assert(attrs.size() < 65536);
+    size_t sz = VALUE_HEADER_SIZE;
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        sz += sizeof(uint32_t) + attrs[i].size();
+    }
+
+    backing->resize(sz);
+    char* ptr = &backing->front();
+    ptr = e::pack8be(VALUE_MARKER, ptr);
+    ptr = e::pack8be(VALUE_FORMAT_OFFSETS, ptr);
+    ptr = e::pack64be(version, ptr);
+    ptr = e::pack16be(attrs.size(), ptr);
+    uint32_t off = 0;
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        off += attrs[i].size();
+        ptr = e::pack32be(off, ptr);
+    }
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        memmove(ptr, attrs[i].data(), attrs[i].size());
+        ptr += attrs[i].size();
+    }
+
+    *out = leveldb::Slice(&backing->front(), sz);
+}
+
+static datalayer::returncode
+decode_offset_value(const uint8_t* ptr,
+                    const uint8_t* end,
+                    const std::vector<uint16_t>* reads,
+                    std::vector<e::slice>* attrs,
+                    uint64_t* version)
+{
+    uint16_t num_attrs;
+
+    if (ptr + VALUE_HEADER_SIZE > end)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    ptr += 2 * sizeof(uint8_t);
+    ptr = e::unpack64be(ptr, version);
+    ptr = e::unpack16be(ptr, &num_attrs);
+    const uint8_t* table = ptr;
+    const uint8_t* data = table + num_attrs * sizeof(uint32_t);
+
+    if (data > end)
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    const size_t data_sz = end - data;
+    attrs->assign(num_attrs, e::slice());
+
+    for (size_t i = 0; i < (reads ? reads->size() : num_attrs); ++i)
+    {
+        size_t idx = i;
+
+        if (reads)
+        {
+            // attribute 0 is the key, which is not part of the value
+            if ((*reads)[i] == 0)
+            {
+                continue;
+            }
+
+            idx = (*reads)[i] - 1;
+        }
+
+        if (idx >= num_attrs)
+        {
+            return datalayer::BAD_ENCODING;
+        }
+
+        uint32_t start = 0;
+        uint32_t limit = 0;
+
+        if (idx > 0)
+        {
+            e::unpack32be(table + (idx - 1) * sizeof(uint32_t), &start);
+        }
+
+        e::unpack32be(table + idx * sizeof(uint32_t), &limit);
+
+        if (start > limit || limit > data_sz)
+        {
+            return datalayer::BAD_ENCODING;
+        }
+
+        (*attrs)[idx] = e::slice(data + start, limit - start);
+    }
+
+    return datalayer::SUCCESS;
+}
+
+static datalayer::returncode
+decode_sequential_value(const uint8_t* ptr,
+                        const uint8_t* end,
+                        const std::vector<uint16_t>* reads,
+                        std::vector<e::slice>* attrs,
+                        uint64_t* version)
+{
+    if (ptr + sizeof(uint64_t) <= end)
+    {
+        ptr = e::unpack64be(ptr, version);
+    }
+    else
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    uint16_t num_attrs;
+
+    if (ptr + sizeof(uint16_t) <= end)
+    {
+        ptr = e::unpack16be(ptr, &num_attrs);
+    }
+    else
+    {
+        return datalayer::BAD_ENCODING;
+    }
+
+    // walk no further than the last attribute read
+    size_t walk = num_attrs;
+
+    if (reads)
+    {
+        walk = 0;
+
+        for (size_t i = 0; i < reads->size(); ++i)
+        {
+            if ((*reads)[i] > num_attrs)
+            {
+                return datalayer::BAD_ENCODING;
+            }
+
+            walk = std::max(walk, static_cast<size_t>((*reads)[i]));
+        }
+    }
+
+    attrs->assign(num_attrs, e::slice());
+
+    for (size_t i = 0; i < walk; ++i)
+    {
+        uint32_t sz = 0;
+
+        if (ptr + sizeof(uint32_t) <= end)
+        {
+            ptr = e::unpack32be(ptr, &sz);
+        }
+        else
+        {
+            return datalayer::BAD_ENCODING;
+        }
+
+        if (sz > static_cast<size_t>(end - ptr))
+        {
+            return datalayer::BAD_ENCODING;
+        }
+
+        (*attrs)[i] = e::slice(reinterpret_cast<const uint8_t*>(ptr), sz);
+        ptr += sz;
+    }
+
+    return datalayer::SUCCESS;
+}
+
+datalayer::returncode
+hyperdex :: decode_value(const e::slice& in,
+                         std::vector<e::slice>* attrs,
+                         uint64_t* version)
+{
+    return decode_value_attrs(in, NULL, attrs, version);
+}
+
+datalayer::returncode
+hyperdex :: decode_value_attrs(const e::slice& in,
+                               const std::vector<uint16_t>* reads,
+                               std::vector<e::slice>* attrs,
+                               uint64_t* version)
+{
+    const uint8_t* ptr = in.data();
+    const uint8_t* end = ptr + in.size();
+
+    if (ptr + 2 * sizeof(uint8_t) <= end && ptr[0] == VALUE_MARKER)
+    {
+        if (ptr[1] == VALUE_FORMAT_OFFSETS)
+        {
+            return decode_offset_value(ptr, end, reads, attrs, version);
+        }
+
+        // compressed values are expanded by the datalayer
+        return datalayer::BAD_ENCODING;
+    }
+
+    return decode_sequential_value(ptr, end, reads, attrs, version);
+}
+
+void
+hyperdex :: encode_compressed_value(uint32_t dict_id,
+                                    size_t raw_sz,
+                                    const std::string& compressed,
+                                    std::vector<char>* backing,
+                                    leveldb::Slice* out)
+{
+    size_t sz = COMPRESSED_VALUE_HEADER_SIZE + compressed.size();
+    backing->resize(sz);
+    char* ptr = &backing->front();
+    ptr = e::pack8be(VALUE_MARKER, ptr);
+    ptr = e::pack8be(VALUE_FORMAT_COMPRESSED, ptr);
+    ptr = e::pack32be(dict_id, ptr);
+    ptr = e::pack32be(raw_sz, ptr);
+    memmove(ptr, compressed.data(), compressed.size());
+    *out = leveldb::Slice(&backing->front(), sz);
+}
+
+bool
+hyperdex :: decode_compressed_value(const e::slice& in,
+                                    uint32_t* dict_id,
+                                    uint32_t* raw_sz,
+                                    e::slice* compressed)
+{
+    const uint8_t* ptr = in.data();
+
+    if (in.size() < COMPRESSED_VALUE_HEADER_SIZE ||
+        ptr[0] != VALUE_MARKER || ptr[1] != VALUE_FORMAT_COMPRESSED)
+    {
+        return false;
+    }
+
+    ptr += 2 * sizeof(uint8_t);
+    ptr = e::unpack32be(ptr, dict_id);
+    ptr = e::unpack32be(ptr, raw_sz);
+    *compressed = e::slice(ptr, in.size() - COMPRESSED_VALUE_HEADER_SIZE);
+    return true;
+}
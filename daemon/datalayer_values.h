@@ -0,0 +1,82 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_daemon_datalayer_values_h_
+#define hyperdex_daemon_datalayer_values_h_
+
+// STL
+#include <string>
+#include <vector>
+
+// LevelDB
+#include <hyperleveldb/slice.h>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "daemon/datalayer.h"
+
+// The encoding of the LevelDB value that holds an object.
+
+BEGIN_HYPERDEX_NAMESPACE
+
+void
+encode_value(const std::vector<e::slice>& attrs,
+             uint64_t version,
+             std::vector<char>* backing,
+             leveldb::Slice* out);
+datalayer::returncode
+decode_value(const e::slice& in,
+             std::vector<e::slice>* attrs,
+             uint64_t* version);
+// decode only the attributes named in reads (numbered as in the schema) and
+// leave the others empty; a NULL reads decodes every attribute
+datalayer::returncode
+decode_value_attrs(const e::slice& in,
+                   const std::vector<uint16_t>* reads,
+                   std::vector<e::slice>* attrs,
+                   uint64_t* version);
+// a value compressed with the given dictionary, which must be expanded into
+// its raw_sz byte encoding before being decoded
+void
+encode_compressed_value(uint32_t dict_id,
+                        size_t raw_sz,
+                        const std::string& compressed,
+                        std::vector<char>* backing,
+                        leveldb::Slice* out);
+bool
+decode_compressed_value(const e::slice& in,
+                        uint32_t* dict_id,
+                        uint32_t* raw_sz,
+                        e::slice* compressed);
+#define COMPRESSED_VALUE_HEADER_SIZE (2 * sizeof(uint8_t) + 2 * sizeof(uint32_t))
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_datalayer_values_h_
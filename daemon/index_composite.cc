@@ -0,0 +1,490 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "common/ordered_encoding.h"
+#include "daemon/datalayer_encodings.h"
+#include "daemon/datalayer_iterator.h"
+#include "daemon/index_composite.h"
+
+using hyperdex::datalayer;
+using hyperdex::index_composite;
+
+namespace
+{
+
+using hyperdex::index_info;
+using hyperdex::leveldb_iterator_ptr;
+using hyperdex::ordered_encode_escaped;
+using hyperdex::ordered_escaped_size;
+using hyperdex::leveldb_snapshot_ptr;
+using hyperdex::region_id;
+
+// Append the encoding of one attribute's value.  Fixed-size encodings are
+// appended as is.  Variable-size encodings escape each 0x00 as 0x00 0xff and
+// end with 0x00 0x01, so that memcmp orders the concatenation of several
+// values by the first value, then the second, and so on.
+void
+encode_component(index_info* ii, const e::slice& value, std::vector<char>* out)
+{
+    size_t sz = ii->encoded_size(value);
+    size_t off = out->size();
+    out->resize(off + sz);
+
+    if (sz > 0)
+    {
+        ii->encode(value, &(*out)[off]);
+    }
+
+    if (ii->encoding_fixed())
+    {
+        return;
+    }
+
+    std::vector<char> raw(out->begin() + off, out->end());
+    out->resize(off);
+    ordered_encode_escaped(raw.empty() ? NULL : &raw.front(), raw.size(), out);
+}
+
+// the size of the encoded component at the start of [ptr, ptr + sz)
+bool
+component_size(index_info* ii, const char* ptr, size_t sz, size_t* comp_sz)
+{
+    if (ii->encoding_fixed())
+    {
+        *comp_sz = ii->encoded_size(e::slice());
+        return *comp_sz <= sz;
+    }
+
+    return ordered_escaped_size(ptr, sz, comp_sz);
+}
+
+int
+compare_component(const char* lhs, size_t lhs_sz, const char* rhs, size_t rhs_sz)
+{
+    size_t sz = std::min(lhs_sz, rhs_sz);
+    int cmp = sz > 0 ? memcmp(lhs, rhs, sz) : 0;
+
+    if (cmp != 0)
+    {
+        return cmp;
+    }
+
+    return lhs_sz < rhs_sz ? -1 : (lhs_sz > rhs_sz ? 1 : 0);
+}
+
+class composite_iterator : public datalayer::index_iterator
+{
+    public:
+        // prefix holds every entry in the walk; when range_ii is set, the
+        // component following the prefix must lie within [start, end]
+        composite_iterator(leveldb_snapshot_ptr snap,
+                           const std::vector<char>& prefix,
+                           index_info* range_ii,
+                           const std::vector<char>* start,
+                           const std::vector<char>* end,
+                           const std::vector<index_info*>& suffix_iis,
+                           index_info* key_ii);
+        virtual ~composite_iterator() throw ();
+
+    public:
+        virtual bool valid();
+        virtual void next();
+        virtual uint64_t cost(leveldb::DB*);
+        virtual e::slice key();
+        virtual std::ostream& describe(std::ostream&) const;
+        virtual e::slice internal_key();
+        virtual e::slice payload();
+        virtual bool sorted();
+        virtual void seek(const e::slice& internal_key);
+
+    private:
+        composite_iterator(const composite_iterator&);
+        composite_iterator& operator = (const composite_iterator&);
+
+    private:
+        leveldb_iterator_ptr m_iter;
+        std::vector<char> m_prefix;
+        index_info* m_range_ii;
+        bool m_has_start;
+        bool m_has_end;
+        std::vector<char> m_start;
+        std::vector<char> m_end;
+        // the attributes stored after the prefix, range attribute first
+        std::vector<index_info*> m_suffix_iis;
+        index_info* m_key_ii;
+        std::vector<char> m_scratch;
+        bool m_invalid;
+};
+
+composite_iterator :: composite_iterator(leveldb_snapshot_ptr s,
+                                         const std::vector<char>& prefix,
+                                         index_info* range_ii,
+                                         const std::vector<char>* start,
+                                         const std::vector<char>* end,
+                                         const std::vector<index_info*>& suffix_iis,
+                                         index_info* key_ii)
+    : index_iterator(s)
+    , m_iter()
+    , m_prefix(prefix)
+    , m_range_ii(range_ii)
+    , m_has_start(start != NULL)
+    , m_has_end(end != NULL)
+    , m_start(start ? *start : std::vector<char>())
+    , m_end(end ? *end : std::vector<char>())
+    , m_suffix_iis(suffix_iis)
+    , m_key_ii(key_ii)
+    , m_scratch()
+    , m_invalid(false)
+{
+    leveldb::ReadOptions opts;
+    opts.fill_cache = true;
+    opts.verify_checksums = true;
+    opts.snapshot = s.get();
+    m_iter.reset(s, s.db()->NewIterator(opts));
+    std::vector<char> first(m_prefix);
+    first.insert(first.end(), m_start.begin(), m_start.end());
+    m_iter->Seek(leveldb::Slice(&first.front(), first.size()));
+}
+
+composite_iterator :: ~composite_iterator() throw ()
+{
+}
+
+bool
+composite_iterator :: valid()
+{
+    while (!m_invalid && m_iter->Valid())
+    {
+        leveldb::Slice k = m_iter->key();
+
+        if (k.size() < m_prefix.size() ||
+            memcmp(k.data(), &m_prefix.front(), m_prefix.size()) != 0)
+        {
+            m_invalid = true;
+            return false;
+        }
+
+        if (!m_range_ii)
+        {
+            return true;
+        }
+
+        const char* comp = k.data() + m_prefix.size();
+        size_t comp_sz = 0;
+
+        if (!component_size(m_range_ii, comp, k.size() - m_prefix.size(), &comp_sz))
+        {
+            m_invalid = true;
+            return false;
+        }
+
+        if (m_has_start &&
+            compare_component(comp, comp_sz, &m_start.front(), m_start.size()) < 0)
+        {
+            m_iter->Next();
+            continue;
+        }
+
+        if (m_has_end &&
+            compare_component(comp, comp_sz, &m_end.front(), m_end.size()) > 0)
+        {
+            m_invalid = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void
+composite_iterator :: next()
+{
+    m_iter->Next();
+}
+
+uint64_t
+composite_iterator :: cost(leveldb::DB* db)
+{
+    std::vector<char> lower(m_prefix);
+    std::vector<char> upper(m_prefix);
+    lower.insert(lower.end(), m_start.begin(), m_start.end());
+    upper.insert(upper.end(), m_end.begin(), m_end.end());
+    hyperdex::encode_bump(&upper.front(), &upper.front() + upper.size());
+    leveldb::Range r;
+    r.start = leveldb::Slice(&lower.front(), lower.size());
+    r.limit = leveldb::Slice(&upper.front(), upper.size());
+    uint64_t ret;
+    db->GetApproximateSizes(&r, 1, &ret);
+    return ret;
+}
+
+e::slice
+composite_iterator :: key()
+{
+    e::slice ik = this->internal_key();
+    size_t decoded_sz = m_key_ii->decoded_size(ik);
+
+    if (m_scratch.size() < decoded_sz)
+    {
+        m_scratch.resize(decoded_sz);
+    }
+
+    m_key_ii->decode(ik, &m_scratch.front());
+    return e::slice(&m_scratch.front(), decoded_sz);
+}
+
+std::ostream&
+composite_iterator :: describe(std::ostream& out) const
+{
+    return out << "composite_iterator(" << (m_range_ii ? "range" : "equality") << ")";
+}
+
+e::slice
+composite_iterator :: internal_key()
+{
+    leveldb::Slice k = m_iter->key();
+    const char* ptr = k.data() + m_prefix.size();
+    size_t rem = k.size() - m_prefix.size();
+
+    for (size_t i = 0; i < m_suffix_iis.size(); ++i)
+    {
+        size_t comp_sz = 0;
+
+        if (!component_size(m_suffix_iis[i], ptr, rem, &comp_sz))
+        {
+            return e::slice();
+        }
+
+        ptr += comp_sz;
+        rem -= comp_sz;
+    }
+
+    return e::slice(ptr, rem);
+}
+
+e::slice
+composite_iterator :: payload()
+{
+    leveldb::Slice v = m_iter->value();
+    return e::slice(v.data(), v.size());
+}
+
+bool
+composite_iterator :: sorted()
+{
+    // with every attribute fixed by the prefix, entries follow key order
+    return m_suffix_iis.empty();
+}
+
+void
+composite_iterator :: seek(const e::slice& ik)
+{
+    assert(sorted());
+    std::vector<char> target(m_prefix);
+    const char* ikp = reinterpret_cast<const char*>(ik.data());
+    target.insert(target.end(), ikp, ikp + ik.size());
+    m_iter->Seek(leveldb::Slice(&target.front(), target.size()));
+}
+
+} // namespace
+
+index_composite :: index_composite(const schema& sc, const subspace& sub, size_t idx)
+    : m_tag(sc.attrs_sz + idx)
+    , m_attrs(sub.composites[idx])
+    , m_iis()
+{
+    for (size_t i = 0; i < m_attrs.size(); ++i)
+    {
+        m_iis.push_back(index_info::lookup(sc.attrs[m_attrs[i]].type));
+        assert(m_iis.back());
+    }
+}
+
+index_composite :: ~index_composite() throw ()
+{
+}
+
+void
+index_composite :: index_changes(const region_id& ri,
+                                 index_info* key_ii,
+                                 const e::slice& key,
+                                 const std::vector<e::slice>* old_value,
+                                 const std::vector<e::slice>* new_value,
+                                 const e::slice& payload,
+                                 bool covered_changed,
+                                 leveldb::WriteBatch* updates)
+{
+    bool same = old_value && new_value;
+
+    for (size_t i = 0; same && i < m_attrs.size(); ++i)
+    {
+        same = (*old_value)[m_attrs[i] - 1] == (*new_value)[m_attrs[i] - 1];
+    }
+
+    if (same && !covered_changed)
+    {
+        return;
+    }
+
+    std::vector<char> entry;
+
+    if (old_value && !same)
+    {
+        encode_entry(ri, key_ii, key, *old_value, &entry);
+        updates->Delete(leveldb::Slice(&entry.front(), entry.size()));
+    }
+
+    if (new_value)
+    {
+        encode_entry(ri, key_ii, key, *new_value, &entry);
+        updates->Put(leveldb::Slice(&entry.front(), entry.size()),
+                     leveldb::Slice(reinterpret_cast<const char*>(payload.data()), payload.size()));
+    }
+}
+
+datalayer::index_iterator*
+index_composite :: iterator_from_ranges(leveldb_snapshot_ptr snap,
+                                        const region_id& ri,
+                                        const std::vector<range>& ranges,
+                                        index_info* key_ii,
+                                        std::vector<uint16_t>* bound)
+{
+    std::vector<char> prefix;
+    encode_entry(ri, NULL, e::slice(), std::vector<e::slice>(), &prefix);
+    index_info* range_ii = NULL;
+    std::vector<char> start;
+    std::vector<char> end;
+    bool has_start = false;
+    bool has_end = false;
+    size_t idx = 0;
+
+    for (; idx < m_attrs.size(); ++idx)
+    {
+        const range* r = NULL;
+
+        for (size_t i = 0; i < ranges.size(); ++i)
+        {
+            if (ranges[i].attr == m_attrs[idx])
+            {
+                r = &ranges[i];
+            }
+        }
+
+        if (!r)
+        {
+            break;
+        }
+
+        bound->push_back(m_attrs[idx]);
+
+        if (r->has_start && r->has_end && r->start == r->end)
+        {
+            encode_component(m_iis[idx], r->start, &prefix);
+            continue;
+        }
+
+        range_ii = m_iis[idx];
+        has_start = r->has_start;
+        has_end = r->has_end;
+
+        if (has_start)
+        {
+            encode_component(range_ii, r->start, &start);
+        }
+
+        if (has_end)
+        {
+            encode_component(range_ii, r->end, &end);
+        }
+
+        ++idx;
+        break;
+    }
+
+    if (bound->empty())
+    {
+        return NULL;
+    }
+
+    // the attributes stored between the prefix and the key
+    std::vector<index_info*> suffix_iis;
+
+    if (range_ii)
+    {
+        suffix_iis.push_back(range_ii);
+    }
+
+    suffix_iis.insert(suffix_iis.end(), m_iis.begin() + idx, m_iis.end());
+    return new composite_iterator(snap, prefix, range_ii,
+                                  has_start ? &start : NULL,
+                                  has_end ? &end : NULL,
+                                  suffix_iis, key_ii);
+}
+
+void
+index_composite :: encode_entry(const region_id& ri,
+                                index_info* key_ii,
+                                const e::slice& key,
+                                const std::vector<e::slice>& value,
+                                std::vector<char>* entry)
+{
+    entry->resize(sizeof(uint8_t) + sizeof(uint64_t) + sizeof(uint16_t));
+    char* ptr = &entry->front();
+    ptr = e::pack8be('i', ptr);
+    ptr = e::pack64be(ri.get(), ptr);
+    ptr = e::pack16be(m_tag, ptr);
+
+    // an empty value encodes just the prefix shared by every entry
+    for (size_t i = 0; !value.empty() && i < m_attrs.size(); ++i)
+    {
+        encode_component(m_iis[i], value[m_attrs[i] - 1], entry);
+    }
+
+    if (key_ii)
+    {
+        size_t off = entry->size();
+        size_t sz = key_ii->encoded_size(key);
+        entry->resize(off + sz);
+
+        if (sz > 0)
+        {
+            key_ii->encode(key, &(*entry)[off]);
+        }
+    }
+}
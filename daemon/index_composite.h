@@ -0,0 +1,91 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_daemon_index_composite_h_
+#define hyperdex_daemon_index_composite_h_
+
+// STL
+#include <vector>
+
+// HyperDex
+#include "namespace.h"
+#include "common/hyperspace.h"
+#include "common/schema.h"
+#include "daemon/index_info.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// An index over several primitive attributes of one subspace.  Each entry
+// holds the encoded values of the attributes in order, followed by the key,
+// so that an equality on a prefix of the attributes and a range on the next
+// one select a contiguous run of entries.  Entries are stored under the
+// attribute number attrs_sz + i for the subspace's i'th composite index.
+class index_composite
+{
+    public:
+        index_composite(const schema& sc, const subspace& sub, size_t idx);
+        ~index_composite() throw ();
+
+    public:
+        // apply to updates all the writes necessary to move the entry for key
+        // from old_value to new_value; payload is stored with the entry and
+        // forces a rewrite when covered_changed
+        void index_changes(const region_id& ri,
+                           index_info* key_ii,
+                           const e::slice& key,
+                           const std::vector<e::slice>* old_value,
+                           const std::vector<e::slice>* new_value,
+                           const e::slice& payload,
+                           bool covered_changed,
+                           leveldb::WriteBatch* updates);
+        // return an iterator over exactly the keys matching the ranges on the
+        // leading attributes: equalities on each of the first few attributes
+        // and, optionally, any range on the one after them.  The attributes
+        // whose ranges the iterator enforces are appended to bound.  If the
+        // ranges do not bind the first attribute, return NULL.
+        datalayer::index_iterator* iterator_from_ranges(leveldb_snapshot_ptr snap,
+                                                        const region_id& ri,
+                                                        const std::vector<range>& ranges,
+                                                        index_info* key_ii,
+                                                        std::vector<uint16_t>* bound);
+
+    private:
+        void encode_entry(const region_id& ri,
+                          index_info* key_ii,
+                          const e::slice& key,
+                          const std::vector<e::slice>& value,
+                          std::vector<char>* entry);
+
+    private:
+        uint16_t m_tag;
+        std::vector<uint16_t> m_attrs;
+        std::vector<index_info*> m_iis;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_index_composite_h_
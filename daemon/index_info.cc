@@ -119,6 +119,17 @@ index_info :: ~index_info() throw ()
 {
 }
 
+void
+index_info :: covering_changes(const region_id&,
+                               uint16_t,
+                               index_info*,
+                               const e::slice&,
+                               const e::slice&,
+                               const e::slice&,
+                               leveldb::WriteBatch*)
+{
+}
+
 datalayer::index_iterator*
 index_info :: iterator_from_range(leveldb_snapshot_ptr,
                                   const region_id&,
@@ -136,3 +147,13 @@ index_info :: iterator_from_check(leveldb_snapshot_ptr,
 {
     return NULL;
 }
+
+datalayer::index_iterator*
+index_info :: ordered_iterator_from_range(leveldb_snapshot_ptr,
+                                          const region_id&,
+                                          const range&,
+                                          bool,
+                                          index_info*)
+{
+    return NULL;
+}
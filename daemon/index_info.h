@@ -82,6 +82,15 @@ class index_info
                                    const e::slice* old_value,
                                    const e::slice* new_value,
                                    leveldb::WriteBatch* updates) = 0;
+        // store payload (the object's covered values) with the index entry
+        // for value; types whose entries cannot carry a payload ignore this
+        virtual void covering_changes(const region_id& ri,
+                                      uint16_t attr,
+                                      index_info* key_ii,
+                                      const e::slice& key,
+                                      const e::slice& value,
+                                      const e::slice& payload,
+                                      leveldb::WriteBatch* updates);
         // return an iterator that retrieves at least the keys matching r
         // if not indexable (full scan), return NULL
         virtual datalayer::index_iterator* iterator_from_range(leveldb_snapshot_ptr snap,
@@ -94,6 +103,14 @@ class index_info
                                                                const region_id& ri,
                                                                const attribute_check& c,
                                                                index_info* key_ii);
+        // return an iterator that retrieves exactly the keys matching r in
+        // ascending order of the indexed value (descending if reverse)
+        // if the index cannot be walked in value order, return NULL
+        virtual datalayer::index_iterator* ordered_iterator_from_range(leveldb_snapshot_ptr snap,
+                                                                       const region_id& ri,
+                                                                       const range& r,
+                                                                       bool reverse,
+                                                                       index_info* key_ii);
 };
 
 END_HYPERDEX_NAMESPACE
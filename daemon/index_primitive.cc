@@ -25,6 +25,12 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+
 // e
 #include <e/endian.h>
 
@@ -74,6 +80,21 @@ index_primitive :: index_changes(const region_id& ri,
     }
 }
 
+void
+index_primitive :: covering_changes(const region_id& ri,
+                                    uint16_t attr,
+                                    index_info* key_ii,
+                                    const e::slice& key,
+                                    const e::slice& value,
+                                    const e::slice& payload,
+                                    leveldb::WriteBatch* updates)
+{
+    std::vector<char> scratch;
+    leveldb::Slice slice;
+    index_entry(ri, attr, key_ii, key, value, &scratch, &slice);
+    updates->Put(slice, leveldb::Slice(reinterpret_cast<const char*>(payload.data()), payload.size()));
+}
+
 void
 index_primitive :: index_entry(const region_id& ri,
                                uint16_t attr,
@@ -250,12 +271,34 @@ decode_entry(const leveldb::Slice& in,
     return true;
 }
 
+// encode a range bound the same way index entries encode values so that the
+// two may be compared with memcmp
+void
+encode_bound(index_info* ii, const e::slice& bound, std::vector<char>* encoded)
+{
+    encoded->resize(ii->encoded_size(bound));
+
+    if (!encoded->empty())
+    {
+        ii->encode(bound, &encoded->front());
+    }
+}
+
+// compare a bound to an encoded value using only their common prefix
+int
+compare_bound(const std::vector<char>& bound, const e::slice& v)
+{
+    size_t sz = std::min(bound.size(), v.size());
+    return sz > 0 ? memcmp(&bound.front(), v.data(), sz) : 0;
+}
+
 class range_iterator : public datalayer::index_iterator
 {
     public:
         range_iterator(leveldb_snapshot_ptr snap,
                        const region_id& ri,
                        const range& r,
+                       bool reverse,
                        index_primitive* val_ii,
                        index_info* key_ii);
         virtual ~range_iterator() throw ();
@@ -267,6 +310,7 @@ class range_iterator : public datalayer::index_iterator
         virtual e::slice key();
         virtual std::ostream& describe(std::ostream&) const;
         virtual e::slice internal_key();
+        virtual e::slice payload();
         virtual bool sorted();
         virtual void seek(const e::slice& internal_key);
 
@@ -278,8 +322,11 @@ class range_iterator : public datalayer::index_iterator
         leveldb_iterator_ptr m_iter;
         region_id m_ri;
         range m_range;
+        bool m_reverse;
         index_primitive* m_val_ii;
         index_info* m_key_ii;
+        std::vector<char> m_start;
+        std::vector<char> m_end;
         std::vector<char> m_scratch;
         bool m_invalid;
 };
@@ -287,14 +334,18 @@ class range_iterator : public datalayer::index_iterator
 range_iterator :: range_iterator(leveldb_snapshot_ptr s,
                                  const region_id& ri,
                                  const range& r,
+                                 bool reverse,
                                  index_primitive* val_ii,
                                  index_info* key_ii)
     : index_iterator(s)
     , m_iter()
     , m_ri(ri)
     , m_range(r)
+    , m_reverse(reverse)
     , m_val_ii(val_ii)
     , m_key_ii(key_ii)
+    , m_start()
+    , m_end()
     , m_scratch()
     , m_invalid(false)
 {
@@ -304,8 +355,45 @@ range_iterator :: range_iterator(leveldb_snapshot_ptr s,
     opts.snapshot = s.get();
     m_iter.reset(s, s.db()->NewIterator(opts));
 
+    if (m_range.has_start)
+    {
+        encode_bound(m_val_ii, m_range.start, &m_start);
+    }
+
+    if (m_range.has_end)
+    {
+        encode_bound(m_val_ii, m_range.end, &m_end);
+    }
+
     leveldb::Slice slice;
 
+    if (m_reverse)
+    {
+        // position on the last entry at or before the end of the range
+        if (m_range.has_end)
+        {
+            m_val_ii->index_entry(m_ri, m_range.attr, m_range.end, &m_scratch, &slice);
+        }
+        else
+        {
+            m_val_ii->index_entry(m_ri, m_range.attr, &m_scratch, &slice);
+        }
+
+        hyperdex::encode_bump(&m_scratch.front(), &m_scratch.front() + slice.size());
+        m_iter->Seek(slice);
+
+        if (m_iter->Valid())
+        {
+            m_iter->Prev();
+        }
+        else
+        {
+            m_iter->SeekToLast();
+        }
+
+        return;
+    }
+
     if (m_range.has_start)
     {
         m_val_ii->index_entry(m_ri, m_range.attr, m_range.start, &m_scratch, &slice);
@@ -339,6 +427,48 @@ range_iterator :: valid()
             return false;
         }
 
+        if (m_reverse)
+        {
+            if (ri < m_ri || attr < m_range.attr)
+            {
+                m_invalid = true;
+                return false;
+            }
+
+            // walking backwards, values past the end are skipped and values
+            // before the start terminate the walk
+            if (m_range.has_end)
+            {
+                int cmp = compare_bound(m_end, v);
+
+                if (cmp < 0 ||
+                    (cmp == 0 && m_end.size() < v.size()))
+                {
+                    m_iter->Prev();
+                    continue;
+                }
+            }
+
+            if (m_range.has_start)
+            {
+                int cmp = compare_bound(m_start, v);
+
+                if (cmp > 0)
+                {
+                    m_invalid = true;
+                    return false;
+                }
+
+                if (cmp == 0 && m_start.size() > v.size())
+                {
+                    m_iter->Prev();
+                    continue;
+                }
+            }
+
+            return true;
+        }
+
         if (m_ri < ri || m_range.attr < attr)
         {
             m_invalid = true;
@@ -349,11 +479,10 @@ range_iterator :: valid()
         // the iterator
         if (m_range.has_start)
         {
-            size_t sz = std::min(m_range.start.size(), v.size());
-            int cmp = memcmp(m_range.start.data(), v.data(), sz);
+            int cmp = compare_bound(m_start, v);
 
             if (cmp > 0 ||
-                (cmp == 0 && m_range.start.size() > v.size()))
+                (cmp == 0 && m_start.size() > v.size()))
             {
                 m_iter->Next();
                 continue;
@@ -365,8 +494,7 @@ range_iterator :: valid()
         // advance to the end
         if (m_range.has_end)
         {
-            size_t sz = std::min(m_range.end.size(), v.size());
-            int cmp = memcmp(m_range.end.data(), v.data(), sz);
+            int cmp = compare_bound(m_end, v);
 
             if (cmp < 0)
             {
@@ -374,7 +502,7 @@ range_iterator :: valid()
                 return false;
             }
 
-            if (cmp == 0 && m_range.end.size() < v.size())
+            if (cmp == 0 && m_end.size() < v.size())
             {
                 m_iter->Next();
                 continue;
@@ -391,15 +519,40 @@ range_iterator :: valid()
 void
 range_iterator :: next()
 {
-    m_iter->Next();
+    if (m_reverse)
+    {
+        m_iter->Prev();
+    }
+    else
+    {
+        m_iter->Next();
+    }
 }
 
 uint64_t
 range_iterator :: cost(leveldb::DB* db)
 {
-    assert(this->sorted());
+    assert(this->sorted() || m_reverse);
+    std::vector<char> lower_scratch;
+    leveldb::Slice lower;
     leveldb::Slice upper;
 
+    if (m_reverse)
+    {
+        if (m_range.has_start)
+        {
+            m_val_ii->index_entry(m_ri, m_range.attr, m_range.start, &lower_scratch, &lower);
+        }
+        else
+        {
+            m_val_ii->index_entry(m_ri, m_range.attr, &lower_scratch, &lower);
+        }
+    }
+    else
+    {
+        lower = m_iter->key();
+    }
+
     if (m_range.has_end)
     {
         m_val_ii->index_entry(m_ri, m_range.attr, m_range.end, &m_scratch, &upper);
@@ -409,10 +562,10 @@ range_iterator :: cost(leveldb::DB* db)
         m_val_ii->index_entry(m_ri, m_range.attr, &m_scratch, &upper);
     }
 
-    hyperdex::encode_bump(&m_scratch.front(), &m_scratch.front() + m_scratch.size());
+    hyperdex::encode_bump(&m_scratch.front(), &m_scratch.front() + upper.size());
     // create the range
     leveldb::Range r;
-    r.start = m_iter->key();
+    r.start = lower;
     r.limit = upper;
     // ask leveldb for the size of the range
     uint64_t ret;
@@ -438,7 +591,7 @@ range_iterator :: key()
 std::ostream&
 range_iterator :: describe(std::ostream& out) const
 {
-    return out << "primitive range_iterator()";
+    return out << "primitive range_iterator(" << (m_reverse ? "reverse" : "forward") << ")";
 }
 
 e::slice
@@ -453,10 +606,17 @@ range_iterator :: internal_key()
     return k;
 }
 
+e::slice
+range_iterator :: payload()
+{
+    leveldb::Slice v = m_iter->value();
+    return e::slice(v.data(), v.size());
+}
+
 bool
 range_iterator :: sorted()
 {
-    return m_range.has_start && m_range.has_end && m_range.start == m_range.end;
+    return !m_reverse && m_range.has_start && m_range.has_end && m_range.start == m_range.end;
 }
 
 void
@@ -474,6 +634,7 @@ class key_iterator : public datalayer::index_iterator
         key_iterator(leveldb_snapshot_ptr snap,
                      const region_id& ri,
                      const range& r,
+                     bool reverse,
                      index_info* key_ii);
         virtual ~key_iterator() throw ();
 
@@ -495,7 +656,10 @@ class key_iterator : public datalayer::index_iterator
         leveldb_iterator_ptr m_iter;
         region_id m_ri;
         range m_range;
+        bool m_reverse;
         index_info* m_key_ii;
+        std::vector<char> m_start;
+        std::vector<char> m_end;
         std::vector<char> m_scratch;
         bool m_invalid;
 };
@@ -503,12 +667,16 @@ class key_iterator : public datalayer::index_iterator
 key_iterator :: key_iterator(leveldb_snapshot_ptr s,
                              const region_id& ri,
                              const range& r,
+                             bool reverse,
                              index_info* key_ii)
     : index_iterator(s)
     , m_iter()
     , m_ri(ri)
     , m_range(r)
+    , m_reverse(reverse)
     , m_key_ii(key_ii)
+    , m_start()
+    , m_end()
     , m_scratch()
     , m_invalid(false)
 {
@@ -519,8 +687,45 @@ key_iterator :: key_iterator(leveldb_snapshot_ptr s,
     opts.snapshot = s.get();
     m_iter.reset(s, s.db()->NewIterator(opts));
 
+    if (m_range.has_start)
+    {
+        encode_bound(m_key_ii, m_range.start, &m_start);
+    }
+
+    if (m_range.has_end)
+    {
+        encode_bound(m_key_ii, m_range.end, &m_end);
+    }
+
     leveldb::Slice slice;
 
+    if (m_reverse)
+    {
+        // position on the last object at or before the end of the range
+        if (m_range.has_end)
+        {
+            encode_key(m_ri, m_range.type, m_range.end, &m_scratch, &slice);
+        }
+        else
+        {
+            encode_object_region(m_ri, &m_scratch, &slice);
+        }
+
+        hyperdex::encode_bump(&m_scratch.front(), &m_scratch.front() + slice.size());
+        m_iter->Seek(slice);
+
+        if (m_iter->Valid())
+        {
+            m_iter->Prev();
+        }
+        else
+        {
+            m_iter->SeekToLast();
+        }
+
+        return;
+    }
+
     if (m_range.has_start)
     {
         encode_key(m_ri, m_range.type, m_range.start, &m_scratch, &slice);
@@ -547,22 +752,50 @@ key_iterator :: valid()
         e::slice k;
 
         if (!decode_key(_k, &ri, &k) ||
-            m_ri < ri)
+            (m_reverse ? ri < m_ri : m_ri < ri))
         {
             m_invalid = true;
             return false;
         }
 
+        if (m_reverse)
+        {
+            if (m_range.has_end)
+            {
+                int cmp = compare_bound(m_end, k);
+
+                if (cmp < 0 ||
+                    (cmp == 0 && m_end.size() < k.size()))
+                {
+                    m_iter->Prev();
+                    continue;
+                }
+            }
+
+            if (m_range.has_start)
+            {
+                int cmp = compare_bound(m_start, k);
+
+                if (cmp > 0 ||
+                    (cmp == 0 && m_start.size() > k.size()))
+                {
+                    m_invalid = true;
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
         if (!m_range.has_end)
         {
             return true;
         }
 
-        size_t sz = std::min(m_range.end.size(), k.size());
-        int cmp = memcmp(m_range.end.data(), k.data(), sz);
+        int cmp = compare_bound(m_end, k);
 
-        if (cmp > 0 ||
-            (cmp == 0 && m_range.end.size() < k.size()))
+        if (cmp < 0 ||
+            (cmp == 0 && m_end.size() < k.size()))
         {
             m_invalid = true;
             return false;
@@ -577,15 +810,40 @@ key_iterator :: valid()
 void
 key_iterator :: next()
 {
-    m_iter->Next();
+    if (m_reverse)
+    {
+        m_iter->Prev();
+    }
+    else
+    {
+        m_iter->Next();
+    }
 }
 
 uint64_t
 key_iterator :: cost(leveldb::DB* db)
 {
-    assert(this->sorted());
+    assert(this->sorted() || m_reverse);
+    std::vector<char> lower_scratch;
+    leveldb::Slice lower;
     leveldb::Slice upper;
 
+    if (m_reverse)
+    {
+        if (m_range.has_start)
+        {
+            encode_key(m_ri, m_range.type, m_range.start, &lower_scratch, &lower);
+        }
+        else
+        {
+            encode_object_region(m_ri, &lower_scratch, &lower);
+        }
+    }
+    else
+    {
+        lower = m_iter->key();
+    }
+
     if (m_range.has_end)
     {
         encode_key(m_ri, m_range.type, m_range.end, &m_scratch, &upper);
@@ -595,10 +853,10 @@ key_iterator :: cost(leveldb::DB* db)
         encode_object_region(m_ri, &m_scratch, &upper);
     }
 
-    hyperdex::encode_bump(&m_scratch.front(), &m_scratch.front() + m_scratch.size());
+    hyperdex::encode_bump(&m_scratch.front(), &m_scratch.front() + upper.size());
     // create the range
     leveldb::Range r;
-    r.start = m_iter->key();
+    r.start = lower;
     r.limit = upper;
     // ask leveldb for the size of the range
     uint64_t ret;
@@ -624,7 +882,7 @@ key_iterator :: key()
 std::ostream&
 key_iterator :: describe(std::ostream& out) const
 {
-    return out << "key_iterator()";
+    return out << "key_iterator(" << (m_reverse ? "reverse" : "forward") << ")";
 }
 
 e::slice
@@ -640,12 +898,13 @@ key_iterator :: internal_key()
 bool
 key_iterator :: sorted()
 {
-    return true;
+    return !m_reverse;
 }
 
 void
 key_iterator :: seek(const e::slice& ik)
 {
+    assert(sorted());
     leveldb::Slice slice;
     encode_key(m_ri, m_range.type, ik, &m_scratch, &slice);
     m_iter->Seek(slice);
@@ -666,10 +925,36 @@ index_primitive :: iterator_from_range(leveldb_snapshot_ptr snap,
 
     if (r.attr != 0)
     {
-        return new range_iterator(snap, ri, r, this, key_ii);
+        return new range_iterator(snap, ri, r, false, this, key_ii);
     }
     else
     {
-        return new key_iterator(snap, ri, r, key_ii);
+        return new key_iterator(snap, ri, r, false, key_ii);
+    }
+}
+
+datalayer::index_iterator*
+index_primitive :: ordered_iterator_from_range(leveldb_snapshot_ptr snap,
+                                               const region_id& ri,
+                                               const range& r,
+                                               bool reverse,
+                                               index_info* key_ii)
+{
+    if (r.invalid)
+    {
+        return NULL;
     }
+
+    if (r.attr == 0)
+    {
+        return new key_iterator(snap, ri, r, reverse, key_ii);
+    }
+
+    // a variable-length value followed by its key does not sort by value
+    if (!this->encoding_fixed())
+    {
+        return NULL;
+    }
+
+    return new range_iterator(snap, ri, r, reverse, this, key_ii);
 }
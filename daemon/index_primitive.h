@@ -48,10 +48,22 @@ class index_primitive : public index_info
                                    const e::slice* old_value,
                                    const e::slice* new_value,
                                    leveldb::WriteBatch* updates);
+        virtual void covering_changes(const region_id& ri,
+                                      uint16_t attr,
+                                      index_info* key_ii,
+                                      const e::slice& key,
+                                      const e::slice& value,
+                                      const e::slice& payload,
+                                      leveldb::WriteBatch* updates);
         virtual datalayer::index_iterator* iterator_from_range(leveldb_snapshot_ptr snap,
                                                                const region_id& ri,
                                                                const range& r,
                                                                index_info* key_ii);
+        virtual datalayer::index_iterator* ordered_iterator_from_range(leveldb_snapshot_ptr snap,
+                                                                       const region_id& ri,
+                                                                       const range& r,
+                                                                       bool reverse,
+                                                                       index_info* key_ii);
 
     public:
         void index_entry(const region_id& ri,
@@ -0,0 +1,431 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <cassert>
+
+// STL
+#include <algorithm>
+
+// Google CityHash
+#include <city.h>
+
+// e
+#include <e/buffer.h>
+
+// HyperDex
+#include "common/serialization.h"
+#include "daemon/index_info.h"
+#include "daemon/index_stats.h"
+
+using hyperdex::index_info;
+using hyperdex::index_stats;
+
+// The values kept per attribute to build the histogram
+#define INDEX_STATS_SAMPLE 4096
+// The number of buckets in each equi-depth histogram
+#define INDEX_STATS_BUCKETS 64
+// The number of hashes kept to estimate the number of distinct values
+#define INDEX_STATS_DISTINCT_HASHES 256
+// A summary is rebuilt once writes exceed this, or a fifth of the objects
+#define INDEX_STATS_MIN_WRITES 4096
+#define INDEX_STATS_STALE_FRACTION 5
+
+namespace
+{
+
+bool
+summarizable(hyperdatatype t)
+{
+    return t == HYPERDATATYPE_STRING ||
+           t == HYPERDATATYPE_INT64 ||
+           t == HYPERDATATYPE_FLOAT;
+}
+
+void
+index_encode(hyperdatatype t, const e::slice& value, std::string* out)
+{
+    index_info* ii = index_info::lookup(t);
+    assert(ii);
+    std::vector<char> scratch(ii->encoded_size(value));
+
+    if (!scratch.empty())
+    {
+        ii->encode(value, &scratch.front());
+    }
+
+    out->assign(scratch.begin(), scratch.end());
+}
+
+// where "value" falls in the histogram, measured in buckets
+double
+position(const std::vector<std::string>& bounds, const std::string& value)
+{
+    size_t buckets = bounds.size() - 1;
+    size_t idx = std::upper_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+
+    if (idx == 0)
+    {
+        return 0;
+    }
+
+    if (idx > buckets)
+    {
+        return buckets;
+    }
+
+    // assume the value sits in the middle of its bucket
+    return idx - 0.5;
+}
+
+} // namespace
+
+index_stats :: index_stats()
+    : m_protect()
+    , m_regions()
+{
+}
+
+index_stats :: ~index_stats() throw ()
+{
+}
+
+void
+index_stats :: object_added(const region_id& ri)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    region_state& rs(m_regions[ri]);
+    ++rs.delta;
+    ++rs.writes;
+}
+
+void
+index_stats :: object_removed(const region_id& ri)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    region_state& rs(m_regions[ri]);
+    --rs.delta;
+    ++rs.writes;
+}
+
+void
+index_stats :: object_changed(const region_id& ri)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    ++m_regions[ri].writes;
+}
+
+index_stats::summary_ptr
+index_stats :: lookup(const region_id& ri, uint64_t* objects, bool* refresh)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    region_state& rs(m_regions[ri]);
+    int64_t objs = rs.delta;
+    bool stale = true;
+
+    if (rs.current)
+    {
+        objs += rs.current->objects;
+        uint64_t threshold = rs.current->objects / INDEX_STATS_STALE_FRACTION;
+        stale = rs.writes > std::max(threshold, static_cast<uint64_t>(INDEX_STATS_MIN_WRITES));
+    }
+
+    *objects = objs > 0 ? objs : 0;
+    *refresh = stale && !rs.refreshing;
+
+    if (*refresh)
+    {
+        rs.refreshing = true;
+    }
+
+    return rs.current;
+}
+
+void
+index_stats :: install(const region_id& ri, summary_ptr s)
+{
+    assert(s);
+    po6::threads::mutex::hold hold(&m_protect);
+    region_state& rs(m_regions[ri]);
+    rs.refreshing = false;
+    rs.current = s;
+    rs.delta = 0;
+    rs.writes = 0;
+}
+
+void
+index_stats :: abandon(const region_id& ri)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    std::map<region_id, region_state>::iterator it = m_regions.find(ri);
+
+    if (it != m_regions.end())
+    {
+        it->second.refreshing = false;
+    }
+}
+
+void
+index_stats :: forget(const region_id& ri)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    m_regions.erase(ri);
+}
+
+///////////////////////////////// class summary ////////////////////////////////
+
+index_stats :: summary :: summary()
+    : objects(0)
+    , attrs()
+{
+}
+
+index_stats :: summary :: ~summary() throw ()
+{
+}
+
+double
+index_stats :: summary :: selectivity(const range& r) const
+{
+    if (r.attr >= attrs.size() || !attrs[r.attr].indexed || !summarizable(r.type))
+    {
+        return -1;
+    }
+
+    if (r.invalid)
+    {
+        return 0;
+    }
+
+    const attribute& a(attrs[r.attr]);
+    double floor = 1.0 / std::max(objects, static_cast<uint64_t>(1));
+    std::string start;
+    std::string end;
+
+    if (r.has_start)
+    {
+        index_encode(r.type, r.start, &start);
+    }
+
+    if (r.has_end)
+    {
+        index_encode(r.type, r.end, &end);
+    }
+
+    if (r.has_start && r.has_end && start == end)
+    {
+        return a.distinct > 0 ? std::max(1.0 / a.distinct, floor) : floor;
+    }
+
+    if (a.bounds.size() < 2)
+    {
+        return -1;
+    }
+
+    double buckets = a.bounds.size() - 1;
+    double lower = r.has_start ? position(a.bounds, start) : 0;
+    double upper = r.has_end ? position(a.bounds, end) : buckets;
+    return std::max((upper - lower) / buckets, floor);
+}
+
+void
+index_stats :: summary :: encode(std::vector<char>* out) const
+{
+    size_t sz = sizeof(uint64_t) + sizeof(uint16_t);
+    std::vector<std::vector<e::slice> > bounds(attrs.size());
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        for (size_t j = 0; j < attrs[i].bounds.size(); ++j)
+        {
+            const std::string& b(attrs[i].bounds[j]);
+            bounds[i].push_back(e::slice(b.data(), b.size()));
+        }
+
+        sz += sizeof(uint8_t) + sizeof(uint64_t) + hyperdex::pack_size(bounds[i]);
+    }
+
+    std::auto_ptr<e::buffer> buf(e::buffer::create(sz));
+    e::buffer::packer pa = buf->pack_at(0);
+    pa = pa << objects << static_cast<uint16_t>(attrs.size());
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        uint8_t indexed = attrs[i].indexed ? 1 : 0;
+        pa = pa << indexed << attrs[i].distinct << bounds[i];
+    }
+
+    out->assign(buf->data(), buf->data() + buf->size());
+}
+
+bool
+index_stats :: summary :: decode(const e::slice& in)
+{
+    std::auto_ptr<e::buffer> buf(e::buffer::create(reinterpret_cast<const char*>(in.data()), in.size()));
+    e::unpacker up = buf->unpack_from(0);
+    uint16_t attrs_sz = 0;
+    up = up >> objects >> attrs_sz;
+    attrs.resize(attrs_sz);
+
+    for (size_t i = 0; !up.error() && i < attrs.size(); ++i)
+    {
+        uint8_t indexed = 0;
+        std::vector<e::slice> bounds;
+        up = up >> indexed >> attrs[i].distinct >> bounds;
+        attrs[i].indexed = indexed != 0;
+        attrs[i].bounds.clear();
+
+        for (size_t j = 0; j < bounds.size(); ++j)
+        {
+            attrs[i].bounds.push_back(std::string(reinterpret_cast<const char*>(bounds[j].data()), bounds[j].size()));
+        }
+    }
+
+    return !up.error();
+}
+
+///////////////////////////////// class builder ////////////////////////////////
+
+index_stats :: builder :: builder(const schema& sc, const subspace& sub)
+    : m_objects(0)
+    , m_rng(0x9e3779b97f4a7c15ULL)
+    , m_types(sc.attrs_sz)
+    , m_indexed(sc.attrs_sz, false)
+    , m_samples(sc.attrs_sz)
+    , m_scratch()
+{
+    for (uint16_t attr = 0; attr < sc.attrs_sz; ++attr)
+    {
+        m_types[attr] = sc.attrs[attr].type;
+        m_indexed[attr] = (attr == 0 || sub.indexed(attr)) &&
+                          summarizable(sc.attrs[attr].type);
+    }
+}
+
+index_stats :: builder :: ~builder() throw ()
+{
+}
+
+void
+index_stats :: builder :: add(const e::slice& key, const std::vector<e::slice>& value)
+{
+    ++m_objects;
+
+    if (m_indexed[0])
+    {
+        observe(0, key);
+    }
+
+    for (size_t i = 0; i < value.size() && i + 1 < m_indexed.size(); ++i)
+    {
+        if (m_indexed[i + 1])
+        {
+            std::string encoded;
+            index_encode(m_types[i + 1], value[i], &encoded);
+            observe(i + 1, e::slice(encoded.data(), encoded.size()));
+        }
+    }
+}
+
+void
+index_stats :: builder :: observe(uint16_t attr, const e::slice& encoded)
+{
+    sample& s(m_samples[attr]);
+    uint64_t h = CityHash64(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+
+    if (s.hashes.size() < INDEX_STATS_DISTINCT_HASHES)
+    {
+        s.hashes.insert(h);
+    }
+    else if (h < *s.hashes.rbegin() && s.hashes.find(h) == s.hashes.end())
+    {
+        s.hashes.insert(h);
+        s.hashes.erase(--s.hashes.end());
+    }
+
+    // reservoir sampling keeps a uniform sample of the values seen so far
+    std::string v(reinterpret_cast<const char*>(encoded.data()), encoded.size());
+
+    if (s.values.size() < INDEX_STATS_SAMPLE)
+    {
+        s.values.push_back(v);
+        return;
+    }
+
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 7;
+    m_rng ^= m_rng << 17;
+    uint64_t idx = m_rng % m_objects;
+
+    if (idx < INDEX_STATS_SAMPLE)
+    {
+        s.values[idx] = v;
+    }
+}
+
+index_stats::summary_ptr
+index_stats :: builder :: finish()
+{
+    std::tr1::shared_ptr<summary> s(new summary());
+    s->objects = m_objects;
+    s->attrs.resize(m_samples.size());
+
+    for (size_t attr = 0; attr < m_samples.size(); ++attr)
+    {
+        sample& smp(m_samples[attr]);
+        summary::attribute& a(s->attrs[attr]);
+        a.indexed = m_indexed[attr];
+
+        if (!a.indexed || smp.values.empty())
+        {
+            continue;
+        }
+
+        // with k hashes kept, the k-th smallest of n distinct uniform hashes
+        // lands near k/n of the hash space
+        if (smp.hashes.size() < INDEX_STATS_DISTINCT_HASHES)
+        {
+            a.distinct = smp.hashes.size();
+        }
+        else
+        {
+            double kth = static_cast<double>(*smp.hashes.rbegin()) / 18446744073709551616.0;
+            a.distinct = (INDEX_STATS_DISTINCT_HASHES - 1) / kth;
+        }
+
+        std::sort(smp.values.begin(), smp.values.end());
+        size_t n = smp.values.size();
+        size_t buckets = std::min(n, static_cast<size_t>(INDEX_STATS_BUCKETS));
+
+        for (size_t i = 0; i <= buckets; ++i)
+        {
+            a.bounds.push_back(smp.values[i * (n - 1) / buckets]);
+        }
+    }
+
+    return s;
+}
@@ -0,0 +1,170 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_daemon_index_stats_h_
+#define hyperdex_daemon_index_stats_h_
+
+// STL
+#include <map>
+#include <set>
+#include <string>
+#include <tr1/memory>
+#include <vector>
+
+// po6
+#include <po6/threads/mutex.h>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "common/hyperspace.h"
+#include "common/ids.h"
+#include "common/range.h"
+#include "common/schema.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// Per-region statistics about the values of indexed attributes, used by the
+// search planner to estimate how many objects each check admits.  Summaries
+// are built in the background from a scan of the region and persisted; the
+// object count is kept current by the write path between refreshes.
+class index_stats
+{
+    public:
+        class summary;
+        class builder;
+        typedef std::tr1::shared_ptr<const summary> summary_ptr;
+
+    public:
+        index_stats();
+        ~index_stats() throw ();
+
+    public:
+        // called on every write to a region
+        void object_added(const region_id& ri);
+        void object_removed(const region_id& ri);
+        void object_changed(const region_id& ri);
+        // return the current summary for ri (possibly NULL) and the estimated
+        // number of objects in ri.  "refresh" is set the first time the summary
+        // is found to be missing or stale, and the caller should then arrange
+        // for a new one to be built.
+        summary_ptr lookup(const region_id& ri, uint64_t* objects, bool* refresh);
+        void install(const region_id& ri, summary_ptr s);
+        // give up on a refresh started by lookup; the summary it would have
+        // replaced stays in use and a later lookup asks again
+        void abandon(const region_id& ri);
+        void forget(const region_id& ri);
+
+    private:
+        struct region_state
+        {
+            region_state() : current(), delta(0), writes(0), refreshing(false) {}
+            summary_ptr current;
+            int64_t delta;
+            uint64_t writes;
+            bool refreshing;
+        };
+
+    private:
+        index_stats(const index_stats&);
+        index_stats& operator = (const index_stats&);
+
+    private:
+        po6::threads::mutex m_protect;
+        std::map<region_id, region_state> m_regions;
+};
+
+class index_stats::summary
+{
+    public:
+        struct attribute
+        {
+            attribute() : indexed(false), distinct(0), bounds() {}
+            bool indexed;
+            uint64_t distinct;
+            // equi-depth histogram over the index encoding of the values
+            std::vector<std::string> bounds;
+        };
+
+    public:
+        summary();
+        ~summary() throw ();
+
+    public:
+        // the fraction of objects whose value for r.attr falls in r, or a
+        // negative number if nothing is known about r.attr
+        double selectivity(const range& r) const;
+        // the persistent form of the summary
+        void encode(std::vector<char>* out) const;
+        bool decode(const e::slice& in);
+
+    public:
+        uint64_t objects;
+        std::vector<attribute> attrs;
+};
+
+class index_stats::builder
+{
+    public:
+        builder(const schema& sc, const subspace& sub);
+        ~builder() throw ();
+
+    public:
+        // the key is given in its index encoding, as it is stored
+        void add(const e::slice& key, const std::vector<e::slice>& value);
+        summary_ptr finish();
+
+    private:
+        struct sample
+        {
+            sample() : values(), hashes() {}
+            std::vector<std::string> values;
+            // the smallest hashes seen, for estimating distinct values
+            std::set<uint64_t> hashes;
+        };
+
+    private:
+        builder(const builder&);
+        builder& operator = (const builder&);
+
+    private:
+        void observe(uint16_t attr, const e::slice& encoded);
+
+    private:
+        uint64_t m_objects;
+        uint64_t m_rng;
+        std::vector<hyperdatatype> m_types;
+        std::vector<bool> m_indexed;
+        std::vector<sample> m_samples;
+        std::vector<char> m_scratch;
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_index_stats_h_
@@ -55,6 +55,14 @@ static const char* _coordinator_host = "127.0.0.1";
 static unsigned long _coordinator_port = 1982;
 static bool _coordinator = false;
 static long _threads = 0;
+static long _snapshot_window = 0;
+static long _search_cache = 0;
+static long _search_idle_timeout = 300;
+static long _search_max_per_client = 64;
+static long _search_max_open = 4096;
+static long _commit_latency = 0;
+static long _object_cache = 0;
+static long _dictionary_size = 0;
 
 extern "C"
 {
@@ -86,6 +94,30 @@ static struct poptOption popts[] = {
     {"threads", 't', POPT_ARG_LONG, &_threads, 't',
      "the number of threads which will handle network traffic",
      "N"},
+    {"snapshot-window", 'w', POPT_ARG_LONG, &_snapshot_window, 'w',
+     "let searches share a snapshot that misses up to this many milliseconds of writes (default: 0)",
+     "ms"},
+    {"search-cache", 's', POPT_ARG_LONG, &_search_cache, 's',
+     "cache the replies to this many count and sorted search requests (default: 0)",
+     "N"},
+    {"search-idle-timeout", 'i', POPT_ARG_LONG, &_search_idle_timeout, 'i',
+     "reap searches not advanced for this many seconds; 0 never reaps (default: 300)",
+     "sec"},
+    {"searches-per-client", 'n', POPT_ARG_LONG, &_search_max_per_client, 'n',
+     "refuse new searches from a client with this many open; 0 for no limit (default: 64)",
+     "N"},
+    {"open-searches", 'o', POPT_ARG_LONG, &_search_max_open, 'o',
+     "refuse new searches while this many are open; 0 for no limit (default: 4096)",
+     "N"},
+    {"commit-latency", 'g', POPT_ARG_LONG, &_commit_latency, 'g',
+     "delay each group commit this many microseconds to batch concurrent writes (default: 0)",
+     "us"},
+    {"object-cache", 'm', POPT_ARG_LONG, &_object_cache, 'm',
+     "keep up to this many megabytes of recently used objects in memory (default: 0, no cache)",
+     "MB"},
+    {"compression-dictionary", 'z', POPT_ARG_LONG, &_dictionary_size, 'z',
+     "compress values with per-space dictionaries of this many kilobytes (default: 0, no compression)",
+     "KB"},
     POPT_TABLEEND
 };
 
@@ -165,6 +197,70 @@ main(int argc, const char* argv[])
                 _coordinator = true;
                 break;
             case 't':
+                break;
+            case 'w':
+                if (_snapshot_window < 0)
+                {
+                    std::cerr << "snapshot window cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 's':
+                if (_search_cache < 0)
+                {
+                    std::cerr << "search cache size cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'i':
+                if (_search_idle_timeout < 0)
+                {
+                    std::cerr << "search idle timeout cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'n':
+                if (_search_max_per_client < 0)
+                {
+                    std::cerr << "searches per client cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'o':
+                if (_search_max_open < 0)
+                {
+                    std::cerr << "open searches cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'g':
+                if (_commit_latency < 0)
+                {
+                    std::cerr << "commit latency cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'm':
+                if (_object_cache < 0)
+                {
+                    std::cerr << "object cache size cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
+                break;
+            case 'z':
+                if (_dictionary_size < 0)
+                {
+                    std::cerr << "compression dictionary size cannot be negative" << std::endl;
+                    return EXIT_FAILURE;
+                }
+
                 break;
             case POPT_ERROR_NOARG:
             case POPT_ERROR_BADOPT:
@@ -224,7 +320,7 @@ main(int argc, const char* argv[])
             return EXIT_FAILURE;
         }
 
-        return d.run(_daemonize, data, log, _listen, bind_to, _coordinator, coord, _threads);
+        return d.run(_daemonize, data, log, _listen, bind_to, _coordinator, coord, _threads, _snapshot_window, _search_cache, _search_idle_timeout, _search_max_per_client, _search_max_open, _commit_latency, _object_cache, _dictionary_size);
     }
     catch (po6::error& e)
     {
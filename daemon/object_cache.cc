@@ -0,0 +1,243 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// STL
+#include <sstream>
+
+// Google CityHash
+#include <city.h>
+
+// HyperDex
+#include "daemon/object_cache.h"
+
+// Number of independently locked shards
+#define OBJECT_CACHE_SHARDS 16
+// Bookkeeping bytes charged to every entry in addition to its contents
+#define OBJECT_CACHE_OVERHEAD 128
+
+using hyperdex::object_cache;
+
+class object_cache::shard
+{
+    public:
+        typedef std::list<std::pair<std::string, object_ptr> > lru_t;
+        typedef std::tr1::unordered_map<std::string, lru_t::iterator> map_t;
+
+    public:
+        shard() : lock(), lru(), map(), bytes(0), ticket(0) {}
+        ~shard() throw () {}
+
+    public:
+        po6::threads::mutex lock;
+        // most recently used at the front
+        lru_t lru;
+        map_t map;
+        uint64_t bytes;
+        uint64_t ticket;
+
+    private:
+        shard(const shard&);
+        shard& operator = (const shard&);
+};
+
+uint64_t
+object_cache :: object :: size() const
+{
+    return backing.size() + value.size() * sizeof(e::slice) + OBJECT_CACHE_OVERHEAD;
+}
+
+object_cache :: object_cache()
+    : m_shards()
+    , m_capacity(0)
+    , m_perf_hit()
+    , m_perf_miss()
+    , m_perf_evicted()
+{
+    for (size_t i = 0; i < OBJECT_CACHE_SHARDS; ++i)
+    {
+        m_shards.push_back(std::tr1::shared_ptr<shard>(new shard()));
+    }
+}
+
+object_cache :: ~object_cache() throw ()
+{
+}
+
+void
+object_cache :: set_capacity(uint64_t bytes)
+{
+    m_capacity = bytes / OBJECT_CACHE_SHARDS;
+
+    for (size_t i = 0; i < m_shards.size(); ++i)
+    {
+        po6::threads::mutex::hold hold(&m_shards[i]->lock);
+        evict(m_shards[i].get(), m_capacity);
+    }
+}
+
+bool
+object_cache :: lookup(const e::slice& key, object_ptr* obj, uint64_t* ticket)
+{
+    if (m_capacity == 0)
+    {
+        return false;
+    }
+
+    shard* s = get_shard(key);
+    po6::threads::mutex::hold hold(&s->lock);
+    shard::map_t::iterator it = s->map.find(std::string(reinterpret_cast<const char*>(key.data()), key.size()));
+
+    if (it == s->map.end())
+    {
+        *ticket = s->ticket;
+        m_perf_miss.tap();
+        return false;
+    }
+
+    s->lru.splice(s->lru.begin(), s->lru, it->second);
+    *obj = it->second->second;
+    m_perf_hit.tap();
+    return true;
+}
+
+void
+object_cache :: fill(const e::slice& key, uint64_t ticket, object_ptr obj)
+{
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    shard* s = get_shard(key);
+    po6::threads::mutex::hold hold(&s->lock);
+
+    if (s->ticket == ticket)
+    {
+        insert(s, key, obj);
+    }
+}
+
+void
+object_cache :: update(const e::slice& key, object_ptr obj)
+{
+    shard* s = get_shard(key);
+    po6::threads::mutex::hold hold(&s->lock);
+    ++s->ticket;
+
+    if (m_capacity == 0 || !obj)
+    {
+        shard::map_t::iterator it = s->map.find(std::string(reinterpret_cast<const char*>(key.data()), key.size()));
+
+        if (it != s->map.end())
+        {
+            s->bytes -= it->first.size() + it->second->second->size();
+            s->lru.erase(it->second);
+            s->map.erase(it);
+        }
+
+        return;
+    }
+
+    insert(s, key, obj);
+}
+
+void
+object_cache :: clear()
+{
+    for (size_t i = 0; i < m_shards.size(); ++i)
+    {
+        shard* s = m_shards[i].get();
+        po6::threads::mutex::hold hold(&s->lock);
+        ++s->ticket;
+        s->lru.clear();
+        s->map.clear();
+        s->bytes = 0;
+    }
+}
+
+void
+object_cache :: collect_stats(std::ostringstream* ret)
+{
+    uint64_t bytes = 0;
+    uint64_t objects = 0;
+
+    for (size_t i = 0; i < m_shards.size(); ++i)
+    {
+        po6::threads::mutex::hold hold(&m_shards[i]->lock);
+        bytes += m_shards[i]->bytes;
+        objects += m_shards[i]->map.size();
+    }
+
+    *ret << " objcache.hit=" << m_perf_hit.read();
+    *ret << " objcache.miss=" << m_perf_miss.read();
+    *ret << " objcache.evicted=" << m_perf_evicted.read();
+    *ret << " objcache.objects=" << objects;
+    *ret << " objcache.bytes=" << bytes;
+}
+
+object_cache::shard*
+object_cache :: get_shard(const e::slice& key)
+{
+    uint64_t h = CityHash64(reinterpret_cast<const char*>(key.data()), key.size());
+    return m_shards[h % m_shards.size()].get();
+}
+
+void
+object_cache :: insert(shard* s, const e::slice& key, object_ptr obj)
+{
+    std::string k(reinterpret_cast<const char*>(key.data()), key.size());
+    shard::map_t::iterator it = s->map.find(k);
+
+    if (it != s->map.end())
+    {
+        s->bytes -= it->first.size() + it->second->second->size();
+        it->second->second = obj;
+        s->lru.splice(s->lru.begin(), s->lru, it->second);
+    }
+    else
+    {
+        s->lru.push_front(std::make_pair(k, obj));
+        s->map.insert(std::make_pair(k, s->lru.begin()));
+    }
+
+    s->bytes += k.size() + obj->size();
+    evict(s, m_capacity);
+}
+
+void
+object_cache :: evict(shard* s, uint64_t capacity)
+{
+    while (s->bytes > capacity && !s->lru.empty())
+    {
+        shard::lru_t::iterator last = s->lru.end();
+        --last;
+        s->bytes -= last->first.size() + last->second->size();
+        s->map.erase(last->first);
+        s->lru.pop_back();
+        m_perf_evicted.tap();
+    }
+}
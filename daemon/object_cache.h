@@ -0,0 +1,117 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_daemon_object_cache_h_
+#define hyperdex_daemon_object_cache_h_
+
+// STL
+#include <list>
+#include <sstream>
+#include <string>
+#include <tr1/memory>
+#include <tr1/unordered_map>
+#include <vector>
+
+// po6
+#include <po6/threads/mutex.h>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "daemon/performance_counter.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// A size-bounded cache of decoded objects keyed by their encoded LevelDB key
+// (which embeds the region).  It is split into shards, each with its own lock
+// and LRU list, so that concurrent readers of different keys rarely contend.
+class object_cache
+{
+    public:
+        class object;
+        typedef std::tr1::shared_ptr<const object> object_ptr;
+
+    public:
+        object_cache();
+        ~object_cache() throw ();
+
+    public:
+        // bound the cache to this many bytes; 0 disables it
+        void set_capacity(uint64_t bytes);
+        // on a miss, ticket is set so that a later fill of key is discarded
+        // if any write to the shard happened in between
+        bool lookup(const e::slice& key, object_ptr* obj, uint64_t* ticket);
+        // insert obj, read from LevelDB after lookup returned ticket
+        void fill(const e::slice& key, uint64_t ticket, object_ptr obj);
+        // replace the entry for key after a write; a NULL obj removes it
+        void update(const e::slice& key, object_ptr obj);
+        void clear();
+        void collect_stats(std::ostringstream* ret);
+
+    private:
+        class shard;
+        shard* get_shard(const e::slice& key);
+        void insert(shard* s, const e::slice& key, object_ptr obj);
+        void evict(shard* s, uint64_t capacity);
+
+    private:
+        std::vector<std::tr1::shared_ptr<shard> > m_shards;
+        uint64_t m_capacity;
+        performance_counter m_perf_hit;
+        performance_counter m_perf_miss;
+        performance_counter m_perf_evicted;
+
+    private:
+        object_cache(const object_cache&);
+        object_cache& operator = (const object_cache&);
+};
+
+// the encoded value of an object and its decoding, which points into it
+class object_cache::object
+{
+    public:
+        object() : backing(), value(), version() {}
+        ~object() throw () {}
+
+    public:
+        uint64_t size() const;
+
+    public:
+        std::string backing;
+        std::vector<e::slice> value;
+        uint64_t version;
+
+    private:
+        object(const object&);
+        object& operator = (const object&);
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_object_cache_h_
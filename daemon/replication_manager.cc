@@ -251,34 +251,60 @@ replication_manager :: client_atomic(const server_id& from,
         return;
     }
 
-    key_map_t::state_reference ksr;
-    key_state* ks = get_or_create_key_state(ri, key, &ksr);
     network_returncode nrc;
 
-    if (!ks->check_against_latest_version(sc, erase, fail_if_not_found, fail_if_found, checks, &nrc))
+    if (!atomic_key(from, to, nonce, ri, sc, erase, fail_if_not_found, fail_if_found, key, checks, funcs, &nrc))
     {
         respond_to_client(to, from, nonce, nrc);
-        return;
     }
+}
 
-    uint64_t seq_id;
-    bool found = m_idgen.generate_id(ri, &seq_id);
-    assert(found);
+void
+replication_manager :: client_atomic_batch(const server_id& from,
+                                           const virtual_server_id& to,
+                                           bool erase,
+                                           bool fail_if_not_found,
+                                           bool fail_if_found,
+                                           const std::vector<e::slice>& keys,
+                                           const std::vector<attribute_check>& checks,
+                                           const std::vector<funcall>& funcs)
+{
+    const region_id ri(m_daemon->m_config.get_region_id(to));
+    const schema& sc(*m_daemon->m_config.get_schema(ri));
 
-    if (erase)
+    if (validate_attribute_checks(sc, checks) != checks.size() ||
+        validate_funcs(sc, funcs) != funcs.size() ||
+        (erase && !funcs.empty()))
     {
-        ks->delete_latest(sc, ri, seq_id, from, nonce);
+        LOG(ERROR) << "dropping batch of " << keys.size() << " keys from server=" << from
+                   << " because the checks or funcs don't validate";
+        return;
     }
-    else
+
+    datatype_info* key_di = datatype_info::lookup(sc.attrs[0].type);
+    size_t dropped = 0;
+
+    for (size_t i = 0; i < keys.size(); ++i)
     {
-        if (!ks->put_from_funcs(sc, ri, seq_id, funcs, from, nonce))
+        if (!key_di->validate(keys[i]) ||
+            m_daemon->m_config.point_leader(ri, keys[i]) != to)
         {
-            respond_to_client(to, from, nonce, NET_OVERFLOW);
-            return;
+            ++dropped;
+            continue;
         }
+
+        // the sender does not wait on individual keys, so there is no client
+        // to notify on completion, and a failed check just means the object
+        // changed since it was matched
+        network_returncode nrc;
+        atomic_key(server_id(), to, 0, ri, sc, erase, fail_if_not_found, fail_if_found, keys[i], checks, funcs, &nrc);
     }
 
-    ks->move_operations_between_queues(this, to, ri, sc);
+    if (dropped > 0)
+    {
+        LOG(ERROR) << "dropped " << dropped << " of " << keys.size() << " keys in batch from server=" << from
+                   << " because they don't validate or don't map to " << ri;
+    }
 }
 
 void
@@ -653,6 +679,49 @@ replication_manager :: get_or_create_key_state(const region_id& ri,
     }
 }
 
+bool
+replication_manager :: atomic_key(const server_id& from,
+                                  const virtual_server_id& to,
+                                  uint64_t nonce,
+                                  const region_id& ri,
+                                  const schema& sc,
+                                  bool erase,
+                                  bool fail_if_not_found,
+                                  bool fail_if_found,
+                                  const e::slice& key,
+                                  const std::vector<attribute_check>& checks,
+                                  const std::vector<funcall>& funcs,
+                                  network_returncode* nrc)
+{
+    key_map_t::state_reference ksr;
+    key_state* ks = get_or_create_key_state(ri, key, &ksr);
+
+    if (!ks->check_against_latest_version(sc, erase, fail_if_not_found, fail_if_found, checks, nrc))
+    {
+        return false;
+    }
+
+    uint64_t seq_id;
+    bool found = m_idgen.generate_id(ri, &seq_id);
+    assert(found);
+
+    if (erase)
+    {
+        ks->delete_latest(sc, ri, seq_id, from, nonce);
+    }
+    else
+    {
+        if (!ks->put_from_funcs(sc, ri, seq_id, funcs, from, nonce))
+        {
+            *nrc = NET_OVERFLOW;
+            return false;
+        }
+    }
+
+    ks->move_operations_between_queues(this, to, ri, sc);
+    return true;
+}
+
 void
 replication_manager :: send_message(const virtual_server_id& us,
                                     bool retransmission,
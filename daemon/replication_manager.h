@@ -91,6 +91,16 @@ class replication_manager
                            const e::slice& key,
                            const std::vector<attribute_check>& checks,
                            const std::vector<funcall>& funcs);
+        // Apply the same operation to many keys on behalf of a group
+        // operation.  No response is sent for individual keys.
+        void client_atomic_batch(const server_id& from,
+                                 const virtual_server_id& to,
+                                 bool erase,
+                                 bool fail_if_not_found,
+                                 bool fail_if_found,
+                                 const std::vector<e::slice>& keys,
+                                 const std::vector<attribute_check>& checks,
+                                 const std::vector<funcall>& funcs);
         // These are called in response to messages from other hosts.
         void chain_op(const virtual_server_id& from,
                       const virtual_server_id& to,
@@ -148,6 +158,20 @@ class replication_manager
         key_state* get_or_create_key_state(const region_id& ri,
                                            const e::slice& key,
                                            key_map_t::state_reference* ksr);
+        // Check and enqueue one client operation on a key this server leads.
+        // Returns false and sets nrc if the operation cannot be applied.
+        bool atomic_key(const server_id& from,
+                        const virtual_server_id& to,
+                        uint64_t nonce,
+                        const region_id& ri,
+                        const schema& sc,
+                        bool erase,
+                        bool fail_if_not_found,
+                        bool fail_if_found,
+                        const e::slice& key,
+                        const std::vector<attribute_check>& checks,
+                        const std::vector<funcall>& funcs,
+                        network_returncode* nrc);
         // Send a response to the specified client.
         void send_message(const virtual_server_id& us,
                           bool retransmission,
@@ -0,0 +1,192 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+// C
+#include <string.h>
+
+// STL
+#include <algorithm>
+
+// HyperDex
+#include "daemon/result_cache.h"
+
+using hyperdex::result_cache;
+
+static bool
+check_order(const hyperdex::attribute_check& lhs,
+            const hyperdex::attribute_check& rhs)
+{
+    if (lhs.attr != rhs.attr)
+    {
+        return lhs.attr < rhs.attr;
+    }
+
+    if (lhs.predicate != rhs.predicate)
+    {
+        return lhs.predicate < rhs.predicate;
+    }
+
+    if (lhs.datatype != rhs.datatype)
+    {
+        return lhs.datatype < rhs.datatype;
+    }
+
+    int cmp = memcmp(lhs.value.data(), rhs.value.data(),
+                     std::min(lhs.value.size(), rhs.value.size()));
+    return cmp < 0 || (cmp == 0 && lhs.value.size() < rhs.value.size());
+}
+
+static void
+key_append(std::string* key, uint64_t x)
+{
+    key->append(reinterpret_cast<const char*>(&x), sizeof(x));
+}
+
+result_cache :: result_cache()
+    : m_lock()
+    , m_lru()
+    , m_map()
+    , m_capacity(0)
+    , m_perf_hit()
+    , m_perf_miss()
+{
+}
+
+result_cache :: ~result_cache() throw ()
+{
+}
+
+void
+result_cache :: set_capacity(size_t entries)
+{
+    po6::threads::mutex::hold hold(&m_lock);
+    m_capacity = entries;
+    m_map.clear();
+    m_lru.clear();
+}
+
+bool
+result_cache :: key(char op,
+                    const region_id& ri,
+                    const std::vector<attribute_check>& _checks,
+                    const std::string& params,
+                    std::string* key)
+{
+    {
+        po6::threads::mutex::hold hold(&m_lock);
+
+        if (m_capacity == 0)
+        {
+            return false;
+        }
+    }
+
+    // the same checks in any order are the same request
+    std::vector<attribute_check> checks(_checks);
+    std::sort(checks.begin(), checks.end(), check_order);
+    key->assign(1, op);
+    key_append(key, ri.get());
+    key_append(key, params.size());
+    key->append(params);
+
+    for (size_t i = 0; i < checks.size(); ++i)
+    {
+        key_append(key, checks[i].attr);
+        key_append(key, checks[i].predicate);
+        key_append(key, checks[i].datatype);
+        key_append(key, checks[i].value.size());
+        key->append(reinterpret_cast<const char*>(checks[i].value.data()),
+                    checks[i].value.size());
+    }
+
+    return true;
+}
+
+bool
+result_cache :: lookup(const std::string& key, uint64_t epoch, std::string* reply)
+{
+    po6::threads::mutex::hold hold(&m_lock);
+    map_t::iterator it = m_map.find(key);
+
+    if (it == m_map.end() || it->second->second.first != epoch)
+    {
+        m_perf_miss.tap();
+        return false;
+    }
+
+    m_perf_hit.tap();
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    *reply = it->second->second.second;
+    return true;
+}
+
+void
+result_cache :: insert(const std::string& key, uint64_t epoch, const e::slice& reply)
+{
+    po6::threads::mutex::hold hold(&m_lock);
+
+    if (m_capacity == 0)
+    {
+        return;
+    }
+
+    map_t::iterator it = m_map.find(key);
+
+    if (it != m_map.end())
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+    }
+    else
+    {
+        while (!m_lru.empty() && m_map.size() >= m_capacity)
+        {
+            m_map.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+
+        m_lru.push_front(std::make_pair(key, std::pair<uint64_t, std::string>()));
+        m_map[key] = m_lru.begin();
+    }
+
+    m_lru.front().second.first = epoch;
+    m_lru.front().second.second.assign(reinterpret_cast<const char*>(reply.data()), reply.size());
+}
+
+void
+result_cache :: clear()
+{
+    po6::threads::mutex::hold hold(&m_lock);
+    m_map.clear();
+    m_lru.clear();
+}
+
+void
+result_cache :: collect_stats(std::ostringstream* ret)
+{
+    *ret << " search.cache_hit=" << m_perf_hit.read();
+    *ret << " search.cache_miss=" << m_perf_miss.read();
+}
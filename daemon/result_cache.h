@@ -0,0 +1,97 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#ifndef hyperdex_daemon_result_cache_h_
+#define hyperdex_daemon_result_cache_h_
+
+// STL
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// po6
+#include <po6/threads/mutex.h>
+
+// e
+#include <e/slice.h>
+
+// HyperDex
+#include "namespace.h"
+#include "common/attribute_check.h"
+#include "common/ids.h"
+#include "daemon/performance_counter.h"
+
+BEGIN_HYPERDEX_NAMESPACE
+
+// Replies to searches that summarize a region (sorted searches and counts)
+// keyed by operation, region and normalized checks.  Each reply carries the
+// region's write epoch when it was computed and is only returned for the
+// same epoch, so a write to the region invalidates it.
+class result_cache
+{
+    public:
+        result_cache();
+        ~result_cache() throw ();
+
+    public:
+        // keep at most this many replies; 0 disables the cache
+        void set_capacity(size_t entries);
+        // the cache key for a request, or false if the cache is disabled
+        bool key(char op,
+                 const region_id& ri,
+                 const std::vector<attribute_check>& checks,
+                 const std::string& params,
+                 std::string* key);
+        // the reply cached for key if the region has not been written since
+        bool lookup(const std::string& key, uint64_t epoch, std::string* reply);
+        void insert(const std::string& key, uint64_t epoch, const e::slice& reply);
+        void clear();
+        void collect_stats(std::ostringstream* ret);
+
+    private:
+        // the most recently used at the front; the map indexes it by key
+        typedef std::list<std::pair<std::string, std::pair<uint64_t, std::string> > > lru_t;
+        typedef std::map<std::string, lru_t::iterator> map_t;
+
+    private:
+        po6::threads::mutex m_lock;
+        lru_t m_lru;
+        map_t m_map;
+        size_t m_capacity;
+        performance_counter m_perf_hit;
+        performance_counter m_perf_miss;
+
+    private:
+        result_cache(const result_cache&);
+        result_cache& operator = (const result_cache&);
+};
+
+END_HYPERDEX_NAMESPACE
+
+#endif // hyperdex_daemon_result_cache_h_
@@ -29,18 +29,24 @@
 
 // STL
 #include <algorithm>
+#include <list>
+#include <map>
 #include <sstream>
+#include <string>
 
 // Google Log
 #include <glog/logging.h>
 
 // e
+#include <e/atomic.h>
 #include <e/intrusive_ptr.h>
 #include <e/time.h>
 
 // HyperDex
+#include "common/aggregate.h"
 #include "common/attribute_check.h"
 #include "common/datatypes.h"
+#include "common/projection.h"
 #include "common/serialization.h"
 #include "daemon/daemon.h"
 #include "daemon/datalayer_iterator.h"
@@ -50,6 +56,10 @@ using hyperdex::datatype_info;
 using hyperdex::search_manager;
 using hyperdex::reconfigure_returncode;
 
+// Bounds on a single REQ_ATOMIC_BATCH sent by group_keyop
+#define GROUP_KEYOP_BATCH_KEYS 1024
+#define GROUP_KEYOP_BATCH_BYTES (1ULL << 20)
+
 /////////////////////////////// Search Manager ID //////////////////////////////
 
 class search_manager::id
@@ -112,15 +122,26 @@ class search_manager::state
     public:
         state(const region_id& region,
               std::auto_ptr<e::buffer> msg,
-              std::vector<attribute_check>* checks);
+              std::vector<attribute_check>* checks,
+              std::vector<uint16_t>* projection,
+              uint64_t limit);
         ~state() throw ();
 
+    public:
+        void touch() { e::atomic::store_64_nobarrier(&last_active, e::time()); }
+        uint64_t idle_since() { return e::atomic::load_64_nobarrier(&last_active); }
+
     public:
         po6::threads::mutex lock;
         const region_id region;
         const std::auto_ptr<e::buffer> backing;
         std::vector<attribute_check> checks;
+        std::vector<uint16_t> projection;
         e::intrusive_ptr<datalayer::iterator> iter;
+        // objects this region may still return before the search is done
+        uint64_t remaining;
+        // when the search was last started or advanced
+        uint64_t last_active;
 
     private:
         friend class e::intrusive_ptr<state>;
@@ -135,15 +156,21 @@ class search_manager::state
 
 search_manager :: state :: state(const region_id& r,
                                  std::auto_ptr<e::buffer> msg,
-                                 std::vector<attribute_check>* c)
+                                 std::vector<attribute_check>* c,
+                                 std::vector<uint16_t>* p,
+                                 uint64_t l)
     : lock()
     , region(r)
     , backing(msg)
     , checks()
+    , projection()
     , iter()
+    , remaining(l)
+    , last_active(e::time())
     , m_ref(0)
 {
     checks.swap(*c);
+    projection.swap(*p);
 }
 
 search_manager :: state :: ~state() throw ()
@@ -155,6 +182,17 @@ search_manager :: state :: ~state() throw ()
 search_manager :: search_manager(daemon* d)
     : m_daemon(d)
     , m_searches(10)
+    , m_protect()
+    , m_open(0)
+    , m_open_by_client()
+    , m_idle_timeout(0)
+    , m_max_per_client(0)
+    , m_max_open(0)
+    , m_perf_reaped_idle()
+    , m_perf_reaped_disconnect()
+    , m_perf_reaped_reconfigure()
+    , m_perf_refused()
+    , m_results()
 {
 }
 
@@ -185,10 +223,136 @@ search_manager :: unpause()
 
 void
 search_manager :: reconfigure(const configuration&,
-                              const configuration&,
-                              const server_id&)
+                              const configuration& new_config,
+                              const server_id& us)
+{
+    std::vector<id> dead;
+
+    for (search_map_t::iterator it = m_searches.begin();
+            it != m_searches.end(); ++it)
+    {
+        if (new_config.get_virtual(it.key().region, us) == virtual_server_id())
+        {
+            dead.push_back(it.key());
+        }
+    }
+
+    for (size_t i = 0; i < dead.size(); ++i)
+    {
+        if (reclaim(dead[i]))
+        {
+            m_perf_reaped_reconfigure.tap();
+        }
+    }
+
+    // regions may have moved, and their epochs say nothing about data that
+    // arrives with them
+    m_results.clear();
+}
+
+void
+search_manager :: reap_idle()
+{
+    uint64_t timeout;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+        timeout = m_idle_timeout;
+    }
+
+    if (timeout == 0)
+    {
+        return;
+    }
+
+    uint64_t now = e::time();
+    std::vector<id> idle;
+
+    for (search_map_t::iterator it = m_searches.begin();
+            it != m_searches.end(); ++it)
+    {
+        uint64_t since = it.value()->idle_since();
+
+        if (since < now && now - since > timeout)
+        {
+            idle.push_back(it.key());
+        }
+    }
+
+    for (size_t i = 0; i < idle.size(); ++i)
+    {
+        if (reclaim(idle[i]))
+        {
+            m_perf_reaped_idle.tap();
+        }
+    }
+}
+
+void
+search_manager :: disconnect(const server_id& client)
+{
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+
+        if (m_open_by_client.find(client) == m_open_by_client.end())
+        {
+            return;
+        }
+    }
+
+    std::vector<id> orphaned;
+
+    for (search_map_t::iterator it = m_searches.begin();
+            it != m_searches.end(); ++it)
+    {
+        if (it.key().client == client)
+        {
+            orphaned.push_back(it.key());
+        }
+    }
+
+    for (size_t i = 0; i < orphaned.size(); ++i)
+    {
+        if (reclaim(orphaned[i]))
+        {
+            m_perf_reaped_disconnect.tap();
+        }
+    }
+}
+
+void
+search_manager :: collect_stats(std::ostringstream* ret)
+{
+    uint64_t open;
+
+    {
+        po6::threads::mutex::hold hold(&m_protect);
+        open = m_open;
+    }
+
+    *ret << " search.open=" << open;
+    *ret << " search.reaped_idle=" << m_perf_reaped_idle.read();
+    *ret << " search.reaped_disconnect=" << m_perf_reaped_disconnect.read();
+    *ret << " search.reaped_reconfigure=" << m_perf_reaped_reconfigure.read();
+    *ret << " search.refused=" << m_perf_refused.read();
+    m_results.collect_stats(ret);
+}
+
+void
+search_manager :: set_result_cache_size(size_t entries)
 {
-    // XXX cleanup dead or old searches
+    m_results.set_capacity(entries);
+}
+
+void
+search_manager :: set_search_limits(uint64_t idle_timeout,
+                                    uint64_t max_per_client,
+                                    uint64_t max_open)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    m_idle_timeout = idle_timeout;
+    m_max_per_client = max_per_client;
+    m_max_open = max_open;
 }
 
 void
@@ -197,7 +361,11 @@ search_manager :: start(const server_id& from,
                         std::auto_ptr<e::buffer> msg,
                         uint64_t nonce,
                         uint64_t search_id,
-                        std::vector<attribute_check>* checks)
+                        std::vector<attribute_check>* checks,
+                        std::vector<uint16_t>* projection,
+                        uint64_t max_objects,
+                        uint64_t max_bytes,
+                        uint64_t limit)
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
     id sid(ri, from, search_id);
@@ -209,11 +377,33 @@ search_manager :: start(const server_id& from,
         return;
     }
 
-    e::intrusive_ptr<state> st = new state(ri, msg, checks);
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+
+    if (!sc || !validate_projection(*sc, *projection))
+    {
+        LOG(WARNING) << "received request for search " << search_id << " from client "
+                     << from << " with an invalid projection";
+        send_search_error(from, to, nonce);
+        return;
+    }
+
+    // Searches already open are never cut short to make room; a new one
+    // past the cap is refused and the client sees an error.
+    if (!admit(from))
+    {
+        LOG(INFO) << "refusing search " << search_id << " from client "
+                  << from << " to stay within the open search limit";
+        m_perf_refused.tap();
+        send_search_error(from, to, nonce);
+        return;
+    }
+
+    e::intrusive_ptr<state> st = new state(ri, msg, checks, projection, limit);
     std::stable_sort(st->checks.begin(), st->checks.end());
+    compile_attribute_checks(&st->checks);
     datalayer::returncode rc = datalayer::SUCCESS;
-    datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
-    st->iter = m_daemon->m_data.make_search_iterator(snap, ri, st->checks, NULL);
+    datalayer::snapshot snap = m_daemon->m_data.make_search_snapshot();
+    st->iter = m_daemon->m_data.make_search_iterator(snap, ri, st->checks, &st->projection, NULL);
 
     switch (rc)
     {
@@ -225,57 +415,144 @@ search_manager :: start(const server_id& from,
         case datalayer::IO_ERROR:
         case datalayer::LEVELDB_ERROR:
             LOG(ERROR) << "could not make snapshot for search:  " << rc;
+            release(from);
             return;
         default:
             abort();
     }
 
-    m_searches.insert(sid, st);
-    next(from, to, nonce, search_id);
+    if (!m_searches.insert(sid, st))
+    {
+        release(from);
+        LOG(WARNING) << "received request for search " << search_id << " from client "
+                     << from << " but the search is already in progress";
+        return;
+    }
+
+    next(from, to, nonce, search_id, max_objects, max_bytes);
 }
 
 void
 search_manager :: next(const server_id& from,
                        const virtual_server_id& to,
                        uint64_t nonce,
-                       uint64_t search_id)
+                       uint64_t search_id,
+                       uint64_t max_objects,
+                       uint64_t max_bytes)
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
     id sid(ri, from, search_id);
     e::intrusive_ptr<state> st;
 
+    // A search that finishes is stopped only after its last reply, so the
+    // client asks for more only of a search that was reaped or lost to a
+    // reconfiguration.  Saying so keeps a truncated result from looking
+    // complete.
     if (!m_searches.lookup(sid, &st))
+    {
+        send_search_error(from, to, nonce);
+        return;
+    }
+
+    po6::threads::mutex::hold hold(&st->lock);
+    st->touch();
+
+    if (!st->iter->valid() || st->remaining == 0)
     {
         std::auto_ptr<e::buffer> msg(e::buffer::create(HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t)));
         msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce;
         m_daemon->m_comm.send_client(to, from, RESP_SEARCH_DONE, msg);
+        stop(from, to, search_id);
         return;
     }
 
-    po6::threads::mutex::hold hold(&st->lock);
+    // Pull objects off the iterator while they fit in both budgets.  Every
+    // batch carries at least one object so that a tiny budget still makes
+    // progress; an object that does not fit is left under the iterator for
+    // the next batch.  The references are kept in a list so that the slices
+    // into their backing strings stay valid until the batch is packed.
+    std::vector<e::slice> keys;
+    std::vector<std::vector<e::slice> > vals;
+    std::list<datalayer::reference> refs;
+    size_t sz = HYPERDEX_HEADER_SIZE_VC
+              + sizeof(uint64_t)
+              + sizeof(uint64_t);
+    uint64_t bytes = 0;
 
-    if (st->iter->valid())
+    while (st->iter->valid() && keys.size() < st->remaining &&
+           (keys.empty() || keys.size() < max_objects))
     {
         e::slice key;
         std::vector<e::slice> val;
         uint64_t ver;
-        datalayer::reference tmp;
-        m_daemon->m_data.get_from_iterator(ri, st->iter.get(), &key, &val, &ver, &tmp);
-        size_t sz = HYPERDEX_HEADER_SIZE_VC
-                  + sizeof(uint64_t)
-                  + pack_size(key)
-                  + pack_size(val);
-        std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-        msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce << key << val;
-        m_daemon->m_comm.send_client(to, from, RESP_SEARCH_ITEM, msg);
+        refs.push_back(datalayer::reference());
+        datalayer::returncode rc;
+        rc = m_daemon->m_data.get_from_iterator(ri, st->iter.get(),
+                                                st->projection.empty() ? NULL : &st->projection,
+                                                &key, &val, &ver, &refs.back());
+
+        switch (rc)
+        {
+            case datalayer::SUCCESS:
+                break;
+            case datalayer::NOT_FOUND:
+                refs.pop_back();
+                st->iter->next();
+                continue;
+            case datalayer::BAD_ENCODING:
+            case datalayer::CORRUPTION:
+            case datalayer::IO_ERROR:
+            case datalayer::LEVELDB_ERROR:
+                LOG(ERROR) << "could not retrieve object for search:  " << rc;
+                refs.pop_back();
+                st->iter->next();
+                continue;
+            default:
+                abort();
+        }
+
+        apply_projection(st->projection, &val);
+        size_t obj_sz = pack_size(key) + pack_size(val);
+
+        if (!keys.empty() && bytes + obj_sz > max_bytes)
+        {
+            refs.pop_back();
+            break;
+        }
+
         st->iter->next();
+        keys.push_back(key);
+        vals.push_back(val);
+        bytes += obj_sz;
+        sz += obj_sz;
     }
-    else
+
+    if (keys.empty())
     {
         std::auto_ptr<e::buffer> msg(e::buffer::create(HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t)));
         msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce;
         m_daemon->m_comm.send_client(to, from, RESP_SEARCH_DONE, msg);
         stop(from, to, search_id);
+        return;
+    }
+
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    e::buffer::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_VC);
+    pa = pa << nonce << static_cast<uint64_t>(keys.size());
+
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+        pa = pa << keys[i] << vals[i];
+    }
+
+    m_daemon->m_comm.send_client(to, from, RESP_SEARCH_ITEM, msg);
+    st->remaining -= keys.size();
+
+    // Release the snapshot as soon as the limit is met rather than waiting
+    // for the client to ask for more.
+    if (st->remaining == 0)
+    {
+        stop(from, to, search_id);
     }
 }
 
@@ -286,7 +563,78 @@ search_manager :: stop(const server_id& from,
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
     id sid(ri, from, search_id);
-    m_searches.remove(sid);
+    reclaim(sid);
+}
+
+bool
+search_manager :: admit(const server_id& client)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    std::map<server_id, uint64_t>::iterator it = m_open_by_client.find(client);
+
+    if ((m_max_per_client > 0 && it != m_open_by_client.end() &&
+         it->second >= m_max_per_client) ||
+        (m_max_open > 0 && m_open >= m_max_open))
+    {
+        return false;
+    }
+
+    ++m_open;
+    ++m_open_by_client[client];
+    return true;
+}
+
+bool
+search_manager :: reclaim(const id& sid)
+{
+    if (!m_searches.remove(sid))
+    {
+        return false;
+    }
+
+    release(sid.client);
+    return true;
+}
+
+void
+search_manager :: release(const server_id& client)
+{
+    po6::threads::mutex::hold hold(&m_protect);
+    assert(m_open > 0);
+    --m_open;
+    std::map<server_id, uint64_t>::iterator it = m_open_by_client.find(client);
+
+    if (it != m_open_by_client.end() && --it->second == 0)
+    {
+        m_open_by_client.erase(it);
+    }
+}
+
+void
+search_manager :: send_search_error(const server_id& from,
+                                    const virtual_server_id& to,
+                                    uint64_t nonce)
+{
+    std::auto_ptr<e::buffer> msg(e::buffer::create(HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t)));
+    msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce;
+    m_daemon->m_comm.send_client(to, from, RESP_SEARCH_ERROR, msg);
+}
+
+void
+search_manager :: send_cached_reply(const server_id& from,
+                                    const virtual_server_id& to,
+                                    uint64_t nonce,
+                                    network_msgtype mt,
+                                    const std::string& reply)
+{
+    size_t sz = HYPERDEX_HEADER_SIZE_VC
+              + sizeof(uint64_t)
+              + reply.size();
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    e::buffer::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_VC);
+    pa = pa << nonce;
+    pa = pa.copy(e::slice(reply));
+    m_daemon->m_comm.send_client(to, from, mt, msg);
 }
 
 namespace hyperdex
@@ -421,14 +769,64 @@ search_manager :: sorted_search(const server_id& from,
                                 std::vector<attribute_check>* checks,
                                 uint64_t limit,
                                 uint16_t sort_by,
-                                bool maximize)
+                                bool maximize,
+                                const std::vector<uint16_t>& projection)
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+    assert(sc);
+
+    if (!validate_projection(*sc, projection))
+    {
+        LOG(WARNING) << "received sorted search from client " << from
+                     << " with an invalid projection";
+        send_search_error(from, to, nonce);
+        return;
+    }
+
     std::stable_sort(checks->begin(), checks->end());
+    compile_attribute_checks(checks);
+    uint64_t epoch = m_daemon->m_data.region_epoch(ri);
+    std::string ckey;
+    std::string reply;
+    std::string cparams;
+    cparams.append(reinterpret_cast<const char*>(&limit), sizeof(limit));
+    cparams.append(reinterpret_cast<const char*>(&sort_by), sizeof(sort_by));
+    cparams.append(1, maximize ? '1' : '0');
+
+    for (size_t i = 0; i < projection.size(); ++i)
+    {
+        cparams.append(reinterpret_cast<const char*>(&projection[i]), sizeof(uint16_t));
+    }
+
+    bool cache = m_results.key('s', ri, *checks, cparams, &ckey);
+
+    if (cache && m_results.lookup(ckey, epoch, &reply))
+    {
+        send_cached_reply(from, to, nonce, RESP_SORTED_SEARCH, reply);
+        return;
+    }
+
     datalayer::returncode rc = datalayer::SUCCESS;
-    datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
+    datalayer::snapshot snap = cache ? m_daemon->m_data.make_snapshot()
+                                     : m_daemon->m_data.make_search_snapshot();
     e::intrusive_ptr<datalayer::iterator> iter;
-    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL);
+    // when the sort attribute's index can be walked in order, the first
+    // "limit" matches are the answer and the walk stops there
+    iter = m_daemon->m_data.make_ordered_search_iterator(snap, ri, *checks, sort_by, maximize);
+    bool ordered = iter.get() != NULL;
+    // the sort attribute is read along with the projection
+    std::vector<uint16_t> reads(projection);
+
+    if (!reads.empty())
+    {
+        reads.push_back(sort_by);
+    }
+
+    if (!ordered)
+    {
+        iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, &reads, NULL);
+    }
 
     switch (rc)
     {
@@ -445,16 +843,27 @@ search_manager :: sorted_search(const server_id& from,
             abort();
     }
 
-    const schema* sc = m_daemon->m_config.get_schema(ri);
-    assert(sc);
     _sorted_search_params params(sc, sort_by, maximize);
     std::vector<_sorted_search_item> top_n;
     top_n.reserve(limit);
 
-    while (iter->valid())
+    while ((!ordered || top_n.size() < limit) && iter->valid())
     {
         top_n.push_back(_sorted_search_item(&params));
-        m_daemon->m_data.get_from_iterator(ri, iter.get(), &top_n.back().key, &top_n.back().value, &top_n.back().version, &top_n.back().ref);
+
+        if (m_daemon->m_data.get_from_iterator(ri, iter.get(), reads.empty() ? NULL : &reads, &top_n.back().key, &top_n.back().value, &top_n.back().version, &top_n.back().ref) != datalayer::SUCCESS)
+        {
+            top_n.pop_back();
+            iter->next();
+            continue;
+        }
+
+        if (ordered)
+        {
+            iter->next();
+            continue;
+        }
+
         std::push_heap(top_n.begin(), top_n.end());
 
         if (top_n.size() > limit)
@@ -466,11 +875,15 @@ search_manager :: sorted_search(const server_id& from,
         iter->next();
     }
 
-    std::sort(top_n.begin(), top_n.end(), std::greater<_sorted_search_item>());
+    if (!ordered)
+    {
+        std::sort(top_n.begin(), top_n.end(), std::greater<_sorted_search_item>());
+    }
     size_t sz = HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t) + sizeof(uint64_t);
 
     for (size_t i = 0; i < top_n.size(); ++i)
     {
+        apply_projection(projection, &top_n[i].value);
         sz += pack_size(top_n[i].key) + pack_size(top_n[i].value);
     }
 
@@ -483,9 +896,30 @@ search_manager :: sorted_search(const server_id& from,
         pa = pa << top_n[i].key << top_n[i].value;
     }
 
+    if (cache && rc == datalayer::SUCCESS)
+    {
+        const size_t off = HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t);
+        m_results.insert(ckey, epoch, e::slice(msg->data() + off, msg->size() - off));
+    }
+
     m_daemon->m_comm.send_client(to, from, RESP_SORTED_SEARCH, msg);
 }
 
+namespace hyperdex
+{
+
+// Keys matched by a group operation that share a point leader.  They are sent
+// together so that a bulk delete costs one message per batch, not per key.
+struct _group_keyop_batch
+{
+    _group_keyop_batch() : keys(), bytes(0) {}
+    ~_group_keyop_batch() throw () {}
+    std::vector<std::string> keys;
+    size_t bytes;
+};
+
+} // namespace hyperdex
+
 void
 search_manager :: group_keyop(const server_id& from,
                               const virtual_server_id& to,
@@ -497,10 +931,13 @@ search_manager :: group_keyop(const server_id& from,
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
     std::stable_sort(checks->begin(), checks->end());
+    compile_attribute_checks(checks);
     datalayer::returncode rc = datalayer::SUCCESS;
+    // the keys acted on must reflect every write acknowledged so far, so
+    // this never shares a possibly stale search snapshot
     datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
     e::intrusive_ptr<datalayer::iterator> iter;
-    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL);
+    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL, NULL);
     uint64_t result = 0;
 
     switch (rc)
@@ -519,31 +956,42 @@ search_manager :: group_keyop(const server_id& from,
             abort();
     }
 
+    std::map<virtual_server_id, _group_keyop_batch> batches;
+
     while (iter->valid() && result < UINT64_MAX)
     {
         e::slice key;
         std::vector<e::slice> val;
         uint64_t ver;
         datalayer::reference tmp;
-        m_daemon->m_data.get_from_iterator(ri, iter.get(), &key, &val, &ver, &tmp);
-        size_t sz = HYPERDEX_HEADER_SIZE_SV // SV because we imitate a client
-                  + sizeof(uint64_t)
-                  + pack_size(key)
-                  + remain.size();
-        std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
-        e::buffer::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_SV);
-        pa = pa << static_cast<uint64_t>(0) << key;
-        pa = pa.copy(remain);
+        // only the key is needed
+        std::vector<uint16_t> none;
+        m_daemon->m_data.get_from_iterator(ri, iter.get(), &none, &key, &val, &ver, &tmp);
         virtual_server_id vsi = m_daemon->m_config.point_leader(ri, key);
 
         if (vsi != virtual_server_id())
         {
-            m_daemon->m_comm.send(vsi, mt, msg);
+            _group_keyop_batch* batch = &batches[vsi];
+            batch->keys.push_back(std::string(reinterpret_cast<const char*>(key.data()), key.size()));
+            batch->bytes += pack_size(key);
+
+            if (batch->keys.size() >= GROUP_KEYOP_BATCH_KEYS ||
+                batch->bytes >= GROUP_KEYOP_BATCH_BYTES)
+            {
+                send_keyop_batch(vsi, mt, remain, &batch->keys);
+                batch->bytes = 0;
+            }
         }
 
         iter->next();
     }
 
+    for (std::map<virtual_server_id, _group_keyop_batch>::iterator it = batches.begin();
+            it != batches.end(); ++it)
+    {
+        send_keyop_batch(it->first, mt, remain, &it->second.keys);
+    }
+
     size_t sz = HYPERDEX_HEADER_SIZE_VC
               + sizeof(uint64_t)
               + sizeof(uint64_t);
@@ -552,6 +1000,41 @@ search_manager :: group_keyop(const server_id& from,
     m_daemon->m_comm.send_client(to, from, resp, msg);
 }
 
+void
+search_manager :: send_keyop_batch(const virtual_server_id& vsi,
+                                   network_msgtype mt,
+                                   const e::slice& remain,
+                                   std::vector<std::string>* keys)
+{
+    if (keys->empty())
+    {
+        return;
+    }
+
+    size_t sz = HYPERDEX_HEADER_SIZE_SV // SV because we imitate a client
+              + sizeof(uint64_t)
+              + sizeof(uint32_t)
+              + remain.size();
+
+    for (size_t i = 0; i < keys->size(); ++i)
+    {
+        sz += pack_size(e::slice((*keys)[i]));
+    }
+
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    e::buffer::packer pa = msg->pack_at(HYPERDEX_HEADER_SIZE_SV);
+    pa = pa << static_cast<uint64_t>(0) << static_cast<uint32_t>(keys->size());
+
+    for (size_t i = 0; i < keys->size(); ++i)
+    {
+        pa = pa << e::slice((*keys)[i]);
+    }
+
+    pa = pa.copy(remain);
+    m_daemon->m_comm.send(vsi, mt, msg);
+    keys->clear();
+}
+
 void
 search_manager :: count(const server_id& from,
                         const virtual_server_id& to,
@@ -560,10 +1043,25 @@ search_manager :: count(const server_id& from,
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
     std::stable_sort(checks->begin(), checks->end());
+    compile_attribute_checks(checks);
+    // read the epoch before the snapshot so a write between them only
+    // makes the cached reply look stale
+    uint64_t epoch = m_daemon->m_data.region_epoch(ri);
+    std::string ckey;
+    std::string reply;
+    bool cache = m_results.key('c', ri, *checks, std::string(), &ckey);
+
+    if (cache && m_results.lookup(ckey, epoch, &reply))
+    {
+        send_cached_reply(from, to, nonce, RESP_COUNT, reply);
+        return;
+    }
+
     datalayer::returncode rc = datalayer::SUCCESS;
-    datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
+    datalayer::snapshot snap = cache ? m_daemon->m_data.make_snapshot()
+                                     : m_daemon->m_data.make_search_snapshot();
     e::intrusive_ptr<datalayer::iterator> iter;
-    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL);
+    m_daemon->m_data.make_count_iterator(snap, ri, *checks, &iter);
     uint64_t result = 0;
 
     switch (rc)
@@ -593,9 +1091,81 @@ search_manager :: count(const server_id& from,
               + sizeof(uint64_t);
     std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
     msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce << result;
+
+    if (cache && result < UINT64_MAX)
+    {
+        const size_t off = HYPERDEX_HEADER_SIZE_VC + sizeof(uint64_t);
+        m_results.insert(ckey, epoch, e::slice(msg->data() + off, msg->size() - off));
+    }
+
     m_daemon->m_comm.send_client(to, from, RESP_COUNT, msg);
 }
 
+void
+search_manager :: aggregate(const server_id& from,
+                            const virtual_server_id& to,
+                            uint64_t nonce,
+                            std::vector<attribute_check>* checks,
+                            uint16_t attr,
+                            aggregate_stats* stats)
+{
+    region_id ri(m_daemon->m_config.get_region_id(to));
+    const schema* sc = m_daemon->m_config.get_schema(ri);
+    assert(sc);
+
+    if (attr >= sc->attrs_sz || !aggregatable(sc->attrs[attr].type) ||
+        stats->buckets.size() > HYPERDEX_MAX_AGGREGATE_BUCKETS)
+    {
+        LOG(WARNING) << "received aggregate from client " << from
+                     << " with an invalid attribute or histogram";
+        send_search_error(from, to, nonce);
+        return;
+    }
+
+    std::stable_sort(checks->begin(), checks->end());
+    compile_attribute_checks(checks);
+    datalayer::snapshot snap = m_daemon->m_data.make_search_snapshot();
+    e::intrusive_ptr<datalayer::iterator> iter;
+    std::vector<uint16_t> reads(1, attr);
+    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, &reads, NULL);
+
+    while (iter->valid())
+    {
+        e::slice key;
+        std::vector<e::slice> value;
+        uint64_t version;
+        datalayer::reference ref;
+        datalayer::returncode rc;
+        rc = m_daemon->m_data.get_from_iterator(ri, iter.get(), &reads, &key, &value, &version, &ref);
+
+        switch (rc)
+        {
+            case datalayer::SUCCESS:
+                aggregate_value(sc->attrs[attr].type, attr == 0 ? key : value[attr - 1], stats);
+                break;
+            case datalayer::NOT_FOUND:
+                break;
+            case datalayer::BAD_ENCODING:
+            case datalayer::CORRUPTION:
+            case datalayer::IO_ERROR:
+            case datalayer::LEVELDB_ERROR:
+                LOG(ERROR) << "error encountered while aggregating: " << rc;
+                break;
+            default:
+                abort();
+        }
+
+        iter->next();
+    }
+
+    size_t sz = HYPERDEX_HEADER_SIZE_VC
+              + sizeof(uint64_t)
+              + pack_size(*stats);
+    std::auto_ptr<e::buffer> msg(e::buffer::create(sz));
+    msg->pack_at(HYPERDEX_HEADER_SIZE_VC) << nonce << *stats;
+    m_daemon->m_comm.send_client(to, from, RESP_AGGREGATE, msg);
+}
+
 void
 search_manager :: search_describe(const server_id& from,
                                   const virtual_server_id& to,
@@ -604,16 +1174,17 @@ search_manager :: search_describe(const server_id& from,
 {
     region_id ri(m_daemon->m_config.get_region_id(to));
     std::stable_sort(checks->begin(), checks->end());
+    compile_attribute_checks(checks);
     datalayer::returncode rc = datalayer::SUCCESS;
     std::ostringstream ostr;
     ostr << "search\n";
     uint64_t t_start = e::time();
-    datalayer::snapshot snap = m_daemon->m_data.make_snapshot();
+    datalayer::snapshot snap = m_daemon->m_data.make_search_snapshot();
     uint64_t t_end = e::time();
     ostr << " snapshot took " << t_end - t_start << "ns\n";
     e::intrusive_ptr<datalayer::iterator> iter;
     t_start = e::time();
-    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, &ostr);
+    iter = m_daemon->m_data.make_search_iterator(snap, ri, *checks, NULL, &ostr);
     t_end = e::time();
     ostr << " iterator took " << t_end - t_start << "ns\n";
 
@@ -28,16 +28,29 @@
 #ifndef hyperdex_daemon_search_manager_h_
 #define hyperdex_daemon_search_manager_h_
 
+// STL
+#include <list>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// po6
+#include <po6/threads/mutex.h>
+
 // e
 #include <e/intrusive_ptr.h>
 #include <e/lockfree_hash_map.h>
 
 // HyperDex
 #include "namespace.h"
+#include "common/aggregate.h"
 #include "common/ids.h"
 #include "common/network_msgtype.h"
 #include "daemon/datalayer.h"
+#include "daemon/performance_counter.h"
 #include "daemon/reconfigure_returncode.h"
+#include "daemon/result_cache.h"
 
 BEGIN_HYPERDEX_NAMESPACE
 class daemon;
@@ -56,6 +69,19 @@ class search_manager
         void reconfigure(const configuration& old_config,
                          const configuration& new_config,
                          const server_id& us);
+        // reclaim searches that have not been advanced recently
+        void reap_idle();
+        // reclaim every search held open by a client that went away
+        void disconnect(const server_id& client);
+        void collect_stats(std::ostringstream* ret);
+        // remember the replies to count and sorted_search for up to entries
+        // distinct requests; zero disables the cache
+        void set_result_cache_size(size_t entries);
+        // reap searches idle for longer than idle_timeout nanoseconds, and
+        // refuse new ones past either cap; zero disables each limit
+        void set_search_limits(uint64_t idle_timeout,
+                               uint64_t max_per_client,
+                               uint64_t max_open);
 
     public:
         void start(const server_id& from,
@@ -63,11 +89,17 @@ class search_manager
                    std::auto_ptr<e::buffer> msg,
                    uint64_t nonce,
                    uint64_t search_id,
-                   std::vector<attribute_check>* checks);
+                   std::vector<attribute_check>* checks,
+                   std::vector<uint16_t>* projection,
+                   uint64_t max_objects,
+                   uint64_t max_bytes,
+                   uint64_t limit);
         void next(const server_id& from,
                   const virtual_server_id& to,
                   uint64_t nonce,
-                  uint64_t search_id);
+                  uint64_t search_id,
+                  uint64_t max_objects,
+                  uint64_t max_bytes);
         void stop(const server_id& from,
                   const virtual_server_id& to,
                   uint64_t search_id);
@@ -77,7 +109,8 @@ class search_manager
                            std::vector<attribute_check>* checks,
                            uint64_t limit,
                            uint16_t sort_by,
-                           bool maximize);
+                           bool maximize,
+                           const std::vector<uint16_t>& projection);
         void group_keyop(const server_id& from,
                          const virtual_server_id& to,
                          uint64_t nonce,
@@ -93,6 +126,12 @@ class search_manager
                              const virtual_server_id& to,
                              uint64_t nonce,
                              std::vector<attribute_check>* checks);
+        void aggregate(const server_id& from,
+                       const virtual_server_id& to,
+                       uint64_t nonce,
+                       std::vector<attribute_check>* checks,
+                       uint16_t attr,
+                       aggregate_stats* stats);
 
     private:
         class id;
@@ -104,10 +143,41 @@ class search_manager
 
     private:
         static uint64_t hash(const id&);
+        typedef e::lockfree_hash_map<id, e::intrusive_ptr<state>, hash> search_map_t;
+        void send_keyop_batch(const virtual_server_id& vsi,
+                              network_msgtype mt,
+                              const e::slice& remain,
+                              std::vector<std::string>* keys);
+        // tell the client the region will not answer the search
+        void send_search_error(const server_id& from,
+                               const virtual_server_id& to,
+                               uint64_t nonce);
+        // count a new search against the open search limits, or false if
+        // the client or server is at its cap
+        bool admit(const server_id& client);
+        void release(const server_id& client);
+        bool reclaim(const id& sid);
+        void send_cached_reply(const server_id& from,
+                               const virtual_server_id& to,
+                               uint64_t nonce,
+                               network_msgtype mt,
+                               const std::string& reply);
 
     private:
         daemon* m_daemon;
-        e::lockfree_hash_map<id, e::intrusive_ptr<state>, hash> m_searches;
+        search_map_t m_searches;
+        // open searches, in total and per client, and their limits
+        po6::threads::mutex m_protect;
+        uint64_t m_open;
+        std::map<server_id, uint64_t> m_open_by_client;
+        uint64_t m_idle_timeout;
+        uint64_t m_max_per_client;
+        uint64_t m_max_open;
+        performance_counter m_perf_reaped_idle;
+        performance_counter m_perf_reaped_disconnect;
+        performance_counter m_perf_reaped_reconfigure;
+        performance_counter m_perf_refused;
+        result_cache m_results;
 };
 
 END_HYPERDEX_NAMESPACE
@@ -0,0 +1,227 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// STL
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// HyperDex
+#include "test/th.h"
+#include "daemon/datalayer_iterator.h"
+
+using hyperdex::datalayer;
+using hyperdex::leveldb_snapshot_ptr;
+
+typedef e::intrusive_ptr<datalayer::index_iterator> index_iterator_ptr;
+
+// An index iterator over a fixed list of keys that notes when it was first
+// consumed, relative to the other iterators in the test.
+class list_iterator : public datalayer::index_iterator
+{
+    public:
+        list_iterator(const char* keys, bool sorted, unsigned* clock)
+            : index_iterator(leveldb_snapshot_ptr())
+            , m_keys()
+            , m_idx(0)
+            , m_sorted(sorted)
+            , m_clock(clock)
+            , m_first(0)
+        {
+            for (const char* k = keys; *k; ++k)
+            {
+                m_keys.push_back(std::string(1, *k));
+            }
+        }
+        virtual ~list_iterator() throw () {}
+
+    public:
+        virtual bool valid()
+        {
+            if (m_first == 0)
+            {
+                m_first = ++*m_clock;
+            }
+
+            return m_idx < m_keys.size();
+        }
+        virtual void next() { ++m_idx; }
+        virtual uint64_t cost(leveldb::DB*) { return m_keys.size(); }
+        virtual e::slice key() { return e::slice(m_keys[m_idx]); }
+        virtual std::ostream& describe(std::ostream& out) const { return out << "list_iterator"; }
+        virtual e::slice internal_key() { return e::slice(m_keys[m_idx]); }
+        virtual bool sorted() { return m_sorted; }
+        virtual void seek(const e::slice& ik)
+        {
+            std::string k(reinterpret_cast<const char*>(ik.data()), ik.size());
+            m_idx = std::lower_bound(m_keys.begin(), m_keys.end(), k) - m_keys.begin();
+        }
+
+    public:
+        // when the iterator was first consumed, or 0 if it never was
+        unsigned first() const { return m_first; }
+
+    private:
+        std::vector<std::string> m_keys;
+        size_t m_idx;
+        bool m_sorted;
+        unsigned* m_clock;
+        unsigned m_first;
+};
+
+static std::string
+drain(datalayer::index_iterator* it)
+{
+    std::string out;
+
+    for (; it->valid(); it->next())
+    {
+        e::slice k = it->key();
+        out.append(reinterpret_cast<const char*>(k.data()), k.size());
+    }
+
+    return out;
+}
+
+TEST(HashIntersectIterator, Intersect)
+{
+    unsigned clock = 0;
+    std::vector<index_iterator_ptr> iters;
+    std::vector<uint64_t> costs;
+    iters.push_back(new list_iterator("dbeac", false, &clock));
+    costs.push_back(5);
+    iters.push_back(new list_iterator("acxe", false, &clock));
+    costs.push_back(4);
+    index_iterator_ptr it(new datalayer::hash_intersect_iterator(leveldb_snapshot_ptr(), iters, costs));
+    ASSERT_FALSE(it->sorted());
+    ASSERT_EQ(9U, it->cost(NULL));
+    // the most expensive iterator is walked last and sets the order
+    ASSERT_EQ("eac", drain(it.get()));
+}
+
+TEST(HashIntersectIterator, Dedup)
+{
+    unsigned clock = 0;
+    std::vector<index_iterator_ptr> iters;
+    std::vector<uint64_t> costs;
+    iters.push_back(new list_iterator("abc", false, &clock));
+    costs.push_back(1);
+    // e.g. an iterator over container elements returns an object once for
+    // each of its matching elements
+    iters.push_back(new list_iterator("abacbdca", false, &clock));
+    costs.push_back(2);
+    index_iterator_ptr it(new datalayer::hash_intersect_iterator(leveldb_snapshot_ptr(), iters, costs));
+    ASSERT_EQ("abc", drain(it.get()));
+}
+
+TEST(HashIntersectIterator, CostOrder)
+{
+    unsigned clock = 0;
+    list_iterator* expensive = new list_iterator("abcdef", false, &clock);
+    list_iterator* cheap = new list_iterator("bdf", false, &clock);
+    list_iterator* middle = new list_iterator("abdf", false, &clock);
+    std::vector<index_iterator_ptr> iters;
+    std::vector<uint64_t> costs;
+    iters.push_back(expensive);
+    costs.push_back(30);
+    iters.push_back(cheap);
+    costs.push_back(10);
+    iters.push_back(middle);
+    costs.push_back(20);
+    index_iterator_ptr it(new datalayer::hash_intersect_iterator(leveldb_snapshot_ptr(), iters, costs));
+    ASSERT_EQ(60U, it->cost(NULL));
+    ASSERT_EQ(0U, clock);
+    ASSERT_EQ("bdf", drain(it.get()));
+    // the candidates come from the cheapest iterator, are narrowed by the
+    // next cheapest, and the most expensive is walked last
+    ASSERT_EQ(1U, cheap->first());
+    ASSERT_EQ(2U, middle->first());
+    ASSERT_EQ(3U, expensive->first());
+}
+
+TEST(HashIntersectIterator, NoCandidates)
+{
+    unsigned clock = 0;
+    list_iterator* empty = new list_iterator("", false, &clock);
+    list_iterator* middle = new list_iterator("ab", false, &clock);
+    list_iterator* last = new list_iterator("abc", false, &clock);
+    std::vector<index_iterator_ptr> iters;
+    std::vector<uint64_t> costs;
+    iters.push_back(empty);
+    costs.push_back(0);
+    iters.push_back(middle);
+    costs.push_back(1);
+    iters.push_back(last);
+    costs.push_back(2);
+    index_iterator_ptr it(new datalayer::hash_intersect_iterator(leveldb_snapshot_ptr(), iters, costs));
+    ASSERT_EQ("", drain(it.get()));
+    // once the candidates run out the remaining iterators are not read
+    ASSERT_EQ(1U, empty->first());
+    ASSERT_EQ(0U, middle->first());
+    ASSERT_EQ(0U, last->first());
+}
+
+TEST(UnionIterator, Unsorted)
+{
+    unsigned clock = 0;
+    std::vector<index_iterator_ptr> iters;
+    iters.push_back(new list_iterator("caab", false, &clock));
+    iters.push_back(new list_iterator("bdc", true, &clock));
+    iters.push_back(new list_iterator("eda", false, &clock));
+    index_iterator_ptr it(new datalayer::union_iterator(leveldb_snapshot_ptr(), iters));
+    ASSERT_FALSE(it->sorted());
+    ASSERT_EQ(10U, it->cost(NULL));
+    // one iterator after another, each key once
+    ASSERT_EQ("cabde", drain(it.get()));
+}
+
+TEST(UnionIterator, Sorted)
+{
+    unsigned clock = 0;
+    std::vector<index_iterator_ptr> iters;
+    iters.push_back(new list_iterator("acef", true, &clock));
+    iters.push_back(new list_iterator("bcf", true, &clock));
+    iters.push_back(new list_iterator("", true, &clock));
+    iters.push_back(new list_iterator("cg", true, &clock));
+    index_iterator_ptr it(new datalayer::union_iterator(leveldb_snapshot_ptr(), iters));
+    ASSERT_TRUE(it->sorted());
+    // merged in order, each key once
+    ASSERT_EQ("abcefg", drain(it.get()));
+}
+
+TEST(UnionIterator, Seek)
+{
+    unsigned clock = 0;
+    std::vector<index_iterator_ptr> iters;
+    iters.push_back(new list_iterator("acef", true, &clock));
+    iters.push_back(new list_iterator("bdf", true, &clock));
+    index_iterator_ptr it(new datalayer::union_iterator(leveldb_snapshot_ptr(), iters));
+    ASSERT_TRUE(it->valid());
+    it->seek(e::slice("d", 1));
+    ASSERT_EQ("def", drain(it.get()));
+}
@@ -0,0 +1,209 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "daemon/datalayer_values.h"
+
+using hyperdex::datalayer;
+using hyperdex::decode_value;
+using hyperdex::decode_value_attrs;
+using hyperdex::encode_value;
+
+static std::vector<e::slice>
+make_attrs(const char** strs, size_t sz)
+{
+    std::vector<e::slice> attrs;
+
+    for (size_t i = 0; i < sz; ++i)
+    {
+        attrs.push_back(e::slice(strs[i], strlen(strs[i])));
+    }
+
+    return attrs;
+}
+
+// the layout written before values carried an offset table
+static std::string
+encode_sequential(const std::vector<e::slice>& attrs, uint64_t version)
+{
+    std::string out(sizeof(uint64_t) + sizeof(uint16_t), '\0');
+    char* ptr = &out[0];
+    ptr = e::pack64be(version, ptr);
+    ptr = e::pack16be(attrs.size(), ptr);
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        char buf[sizeof(uint32_t)];
+        e::pack32be(attrs[i].size(), buf);
+        out.append(buf, sizeof(buf));
+        out.append(reinterpret_cast<const char*>(attrs[i].data()), attrs[i].size());
+    }
+
+    return out;
+}
+
+static std::string
+encode_offsets(const std::vector<e::slice>& attrs, uint64_t version)
+{
+    std::vector<char> backing;
+    leveldb::Slice out;
+    encode_value(attrs, version, &backing, &out);
+    return std::string(out.data(), out.size());
+}
+
+static std::string
+str(const e::slice& s)
+{
+    return std::string(reinterpret_cast<const char*>(s.data()), s.size());
+}
+
+static void
+check_formats(const std::vector<e::slice>& attrs, uint64_t version)
+{
+    std::string encs[2] = {encode_sequential(attrs, version), encode_offsets(attrs, version)};
+
+    for (size_t f = 0; f < 2; ++f)
+    {
+        e::slice in(encs[f].data(), encs[f].size());
+        std::vector<e::slice> out;
+        uint64_t ver = 0;
+        ASSERT_TRUE(decode_value(in, &out, &ver) == datalayer::SUCCESS);
+        ASSERT_EQ(version, ver);
+        ASSERT_EQ(attrs.size(), out.size());
+
+        for (size_t i = 0; i < attrs.size(); ++i)
+        {
+            ASSERT_EQ(str(attrs[i]), str(out[i]));
+        }
+
+        // attribute numbers are as in the schema, where 0 is the key
+        for (size_t i = 0; i < attrs.size(); ++i)
+        {
+            std::vector<uint16_t> reads;
+            reads.push_back(0);
+            reads.push_back(i + 1);
+            ASSERT_TRUE(decode_value_attrs(in, &reads, &out, &ver) == datalayer::SUCCESS);
+            ASSERT_EQ(version, ver);
+            ASSERT_EQ(attrs.size(), out.size());
+            ASSERT_EQ(str(attrs[i]), str(out[i]));
+        }
+    }
+}
+
+TEST(DatalayerValues, RoundTrip)
+{
+    const char* strs[] = {"alpha", "", "gamma", "a\xff" "b"};
+    check_formats(make_attrs(strs, 0), 0);
+    check_formats(make_attrs(strs, 1), 1);
+    check_formats(make_attrs(strs, 4), 0xfeffffffffffffffULL);
+}
+
+TEST(DatalayerValues, Subset)
+{
+    const char* strs[] = {"one", "two", "three", "four"};
+    std::vector<e::slice> attrs(make_attrs(strs, 4));
+    std::string encs[2] = {encode_sequential(attrs, 7), encode_offsets(attrs, 7)};
+    std::vector<uint16_t> reads;
+    reads.push_back(3);
+    reads.push_back(1);
+
+    for (size_t f = 0; f < 2; ++f)
+    {
+        std::vector<e::slice> out;
+        uint64_t ver = 0;
+        e::slice in(encs[f].data(), encs[f].size());
+        ASSERT_TRUE(decode_value_attrs(in, &reads, &out, &ver) == datalayer::SUCCESS);
+        ASSERT_EQ(4U, out.size());
+        ASSERT_EQ("one", str(out[0]));
+        ASSERT_EQ("three", str(out[2]));
+        // the offset table lets the decoder skip attributes it is not asked for
+        if (f == 1)
+        {
+            ASSERT_EQ("", str(out[1]));
+            ASSERT_EQ("", str(out[3]));
+        }
+    }
+
+    // asking for an attribute the value does not have
+    reads.push_back(5);
+
+    for (size_t f = 0; f < 2; ++f)
+    {
+        std::vector<e::slice> out;
+        uint64_t ver = 0;
+        e::slice in(encs[f].data(), encs[f].size());
+        ASSERT_TRUE(decode_value_attrs(in, &reads, &out, &ver) == datalayer::BAD_ENCODING);
+    }
+}
+
+TEST(DatalayerValues, Corrupt)
+{
+    const char* strs[] = {"one", "two", "three"};
+    std::vector<e::slice> attrs(make_attrs(strs, 3));
+    std::string good(encode_offsets(attrs, 1));
+    std::vector<e::slice> out;
+    uint64_t ver;
+    // marker, format, version and attribute count precede the offset table
+    const size_t table = 2 + sizeof(uint64_t) + sizeof(uint16_t);
+
+    // an end offset past the data
+    std::string past(good);
+    e::pack32be(1000, &past[table + sizeof(uint32_t)]);
+    ASSERT_TRUE(decode_value(e::slice(past.data(), past.size()), &out, &ver) == datalayer::BAD_ENCODING);
+
+    // offsets that run backwards
+    std::string backwards(good);
+    e::pack32be(5, &backwards[table]);
+    e::pack32be(4, &backwards[table + sizeof(uint32_t)]);
+    ASSERT_TRUE(decode_value(e::slice(backwards.data(), backwards.size()), &out, &ver) == datalayer::BAD_ENCODING);
+
+    // an offset table longer than the value
+    std::string count(good);
+    e::pack16be(1000, &count[2 + sizeof(uint64_t)]);
+    ASSERT_TRUE(decode_value(e::slice(count.data(), count.size()), &out, &ver) == datalayer::BAD_ENCODING);
+
+    // truncated values of both formats
+    std::string seq(encode_sequential(attrs, 1));
+
+    for (size_t sz = 0; sz < good.size(); ++sz)
+    {
+        ASSERT_TRUE(decode_value(e::slice(good.data(), sz), &out, &ver) == datalayer::BAD_ENCODING);
+    }
+
+    for (size_t sz = 0; sz < seq.size(); ++sz)
+    {
+        ASSERT_TRUE(decode_value(e::slice(seq.data(), sz), &out, &ver) == datalayer::BAD_ENCODING);
+    }
+}
@@ -0,0 +1,181 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cmath>
+#include <cstdio>
+
+// e
+#include <e/endian.h>
+
+// HyperDex
+#include "test/th.h"
+#include "daemon/index_stats.h"
+
+using hyperdex::attribute;
+using hyperdex::index_stats;
+using hyperdex::range;
+using hyperdex::schema;
+using hyperdex::subspace;
+
+// a space of ("k" string, "v" int64, "s" string) where only "v" is indexed,
+// filled with v = 0 ... n - 1
+static index_stats::summary_ptr
+build(int64_t n)
+{
+    attribute attrs[3] = {attribute("k", HYPERDATATYPE_STRING),
+                          attribute("v", HYPERDATATYPE_INT64),
+                          attribute("s", HYPERDATATYPE_STRING)};
+    schema sc;
+    sc.attrs_sz = 3;
+    sc.attrs = attrs;
+    subspace sub;
+    sub.indices.push_back(1);
+    index_stats::builder b(sc, sub);
+
+    for (int64_t i = 0; i < n; ++i)
+    {
+        char key[32];
+        int key_sz = sprintf(key, "key%ld", static_cast<long>(i));
+        char v[sizeof(int64_t)];
+        e::pack64le(i, v);
+        std::vector<e::slice> value;
+        value.push_back(e::slice(v, sizeof(v)));
+        value.push_back(e::slice("unindexed", 9));
+        b.add(e::slice(key, key_sz), value);
+    }
+
+    return b.finish();
+}
+
+// v in [lower, upper]; a negative bound leaves that side open
+static double
+selectivity(const index_stats::summary& s, int64_t lower, int64_t upper)
+{
+    char lbuf[sizeof(int64_t)];
+    char ubuf[sizeof(int64_t)];
+    e::pack64le(lower, lbuf);
+    e::pack64le(upper, ubuf);
+    range r;
+    r.attr = 1;
+    r.type = HYPERDATATYPE_INT64;
+    r.start = e::slice(lbuf, sizeof(lbuf));
+    r.end = e::slice(ubuf, sizeof(ubuf));
+    r.has_start = lower >= 0;
+    r.has_end = upper >= 0;
+    r.invalid = false;
+    return s.selectivity(r);
+}
+
+TEST(IndexStats, Selectivity)
+{
+    index_stats::summary_ptr s = build(1000);
+    ASSERT_EQ(1000U, s->objects);
+    ASSERT_EQ(3U, s->attrs.size());
+    ASSERT_TRUE(s->attrs[1].indexed);
+    ASSERT_FALSE(s->attrs[2].indexed);
+    // the distinct count is estimated; allow for its error
+    ASSERT_LT(800U, s->attrs[1].distinct);
+    ASSERT_LT(s->attrs[1].distinct, 1200U);
+
+    // equality admits about one object in a thousand
+    double eq = selectivity(*s, 500, 500);
+    ASSERT_LT(0.0005, eq);
+    ASSERT_LT(eq, 0.002);
+
+    // ranges over a uniform distribution admit their share of the domain
+    ASSERT_LT(std::fabs(selectivity(*s, 250, 749) - 0.5), 0.05);
+    ASSERT_LT(std::fabs(selectivity(*s, 900, -1) - 0.1), 0.05);
+    ASSERT_LT(std::fabs(selectivity(*s, -1, 99) - 0.1), 0.05);
+    ASSERT_LT(std::fabs(selectivity(*s, -1, -1) - 1.0), 0.05);
+    // nothing lies outside the domain, but the estimate never drops below
+    // one object
+    ASSERT_LT(selectivity(*s, 5000, 6000), 0.002);
+}
+
+TEST(IndexStats, Unknown)
+{
+    index_stats::summary_ptr s = build(100);
+    range r;
+    r.type = HYPERDATATYPE_STRING;
+    r.has_start = false;
+    r.has_end = false;
+    r.invalid = false;
+
+    // unindexed and out-of-range attributes are unknown
+    r.attr = 2;
+    ASSERT_LT(s->selectivity(r), 0);
+    r.attr = 3;
+    ASSERT_LT(s->selectivity(r), 0);
+
+    // an invalid range admits nothing
+    r.attr = 1;
+    r.type = HYPERDATATYPE_INT64;
+    r.invalid = true;
+    ASSERT_EQ(0, s->selectivity(r));
+}
+
+TEST(IndexStats, RoundTrip)
+{
+    index_stats::summary_ptr s = build(1000);
+    std::vector<char> enc;
+    s->encode(&enc);
+
+    index_stats::summary d;
+    ASSERT_TRUE(d.decode(e::slice(&enc.front(), enc.size())));
+    ASSERT_EQ(s->objects, d.objects);
+    ASSERT_EQ(s->attrs.size(), d.attrs.size());
+
+    for (size_t i = 0; i < s->attrs.size(); ++i)
+    {
+        ASSERT_EQ(s->attrs[i].indexed, d.attrs[i].indexed);
+        ASSERT_EQ(s->attrs[i].distinct, d.attrs[i].distinct);
+        ASSERT_TRUE(s->attrs[i].bounds == d.attrs[i].bounds);
+    }
+
+    ASSERT_EQ(selectivity(*s, 250, 749), selectivity(d, 250, 749));
+}
+
+TEST(IndexStats, Corrupt)
+{
+    index_stats::summary_ptr s = build(100);
+    std::vector<char> enc;
+    s->encode(&enc);
+
+    // every truncation is rejected
+    for (size_t i = 0; i < enc.size(); ++i)
+    {
+        index_stats::summary d;
+        ASSERT_FALSE(d.decode(e::slice(&enc.front(), i)));
+    }
+
+    // as is a count of attributes the input cannot hold
+    e::pack16be(0xffff, &enc[sizeof(uint64_t)]);
+    index_stats::summary d;
+    ASSERT_FALSE(d.decode(e::slice(&enc.front(), enc.size())));
+}
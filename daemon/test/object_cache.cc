@@ -0,0 +1,180 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// STL
+#include <sstream>
+
+// HyperDex
+#include "test/th.h"
+#include "daemon/object_cache.h"
+
+using hyperdex::object_cache;
+
+static object_cache::object_ptr
+make_object(const std::string& backing, uint64_t version)
+{
+    std::tr1::shared_ptr<object_cache::object> obj(new object_cache::object());
+    obj->backing = backing;
+    obj->version = version;
+    return obj;
+}
+
+static std::string
+make_key(unsigned i)
+{
+    char buf[32];
+    sprintf(buf, "key%u", i);
+    return buf;
+}
+
+// the version of the cached object for key, or 0 on a miss
+static uint64_t
+cached(object_cache* oc, const std::string& key)
+{
+    object_cache::object_ptr obj;
+    uint64_t ticket;
+
+    if (!oc->lookup(e::slice(key), &obj, &ticket))
+    {
+        return 0;
+    }
+
+    return obj->version;
+}
+
+static uint64_t
+cached_bytes(object_cache* oc)
+{
+    std::ostringstream ostr;
+    oc->collect_stats(&ostr);
+    std::string stats = ostr.str();
+    size_t pos = stats.find("objcache.bytes=");
+    assert(pos != std::string::npos);
+    return strtoull(stats.c_str() + pos + strlen("objcache.bytes="), NULL, 10);
+}
+
+TEST(ObjectCache, Fill)
+{
+    object_cache oc;
+    oc.set_capacity(1ULL << 20);
+    object_cache::object_ptr obj;
+    uint64_t ticket = 0;
+    ASSERT_FALSE(oc.lookup(e::slice("k"), &obj, &ticket));
+    oc.fill(e::slice("k"), ticket, make_object("value", 1));
+    ASSERT_EQ(1U, cached(&oc, "k"));
+}
+
+TEST(ObjectCache, FillAfterUpdate)
+{
+    object_cache oc;
+    oc.set_capacity(1ULL << 20);
+    object_cache::object_ptr obj;
+    uint64_t ticket = 0;
+
+    // a write lands between the miss and the fill; the reader's object is
+    // stale and must not replace the written one
+    ASSERT_FALSE(oc.lookup(e::slice("k"), &obj, &ticket));
+    oc.update(e::slice("k"), make_object("new", 2));
+    oc.fill(e::slice("k"), ticket, make_object("old", 1));
+    ASSERT_EQ(2U, cached(&oc, "k"));
+
+    // likewise for a delete
+    ASSERT_FALSE(oc.lookup(e::slice("j"), &obj, &ticket));
+    oc.update(e::slice("j"), object_cache::object_ptr());
+    oc.fill(e::slice("j"), ticket, make_object("old", 1));
+    ASSERT_EQ(0U, cached(&oc, "j"));
+}
+
+TEST(ObjectCache, ClearBumpsTicket)
+{
+    object_cache oc;
+    oc.set_capacity(1ULL << 20);
+    oc.update(e::slice("a"), make_object("a", 1));
+    object_cache::object_ptr obj;
+    uint64_t ticket = 0;
+    ASSERT_FALSE(oc.lookup(e::slice("k"), &obj, &ticket));
+    oc.clear();
+    oc.fill(e::slice("k"), ticket, make_object("old", 1));
+    ASSERT_EQ(0U, cached(&oc, "k"));
+    ASSERT_EQ(0U, cached(&oc, "a"));
+    ASSERT_EQ(0U, cached_bytes(&oc));
+}
+
+TEST(ObjectCache, Eviction)
+{
+    const uint64_t capacity = 64 * 1024;
+    object_cache oc;
+    oc.set_capacity(capacity);
+    std::string backing(1000, 'x');
+    // "hot" is used after every insert and stays cached; "cold" is not
+    oc.update(e::slice("hot"), make_object(backing, 1));
+    oc.update(e::slice("cold"), make_object(backing, 1));
+
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+        oc.update(e::slice(make_key(i)), make_object(backing, i + 1));
+        ASSERT_EQ(1U, cached(&oc, "hot"));
+        ASSERT_LE(cached_bytes(&oc), capacity);
+    }
+
+    ASSERT_EQ(0U, cached(&oc, "cold"));
+    ASSERT_EQ(0U, cached(&oc, make_key(0)));
+    ASSERT_EQ(1000U, cached(&oc, make_key(999)));
+    ASSERT_LT(0U, cached_bytes(&oc));
+
+    // shrinking evicts down to the new capacity
+    oc.set_capacity(capacity / 4);
+    ASSERT_LE(cached_bytes(&oc), capacity / 4);
+}
+
+TEST(ObjectCache, Disabled)
+{
+    object_cache oc;
+    object_cache::object_ptr obj;
+    uint64_t ticket = 0;
+    ASSERT_FALSE(oc.lookup(e::slice("k"), &obj, &ticket));
+    oc.fill(e::slice("k"), ticket, make_object("value", 1));
+    oc.update(e::slice("j"), make_object("value", 1));
+    ASSERT_EQ(0U, cached(&oc, "k"));
+    ASSERT_EQ(0U, cached(&oc, "j"));
+    ASSERT_EQ(0U, cached_bytes(&oc));
+
+    // turning the cache off drops what it held
+    oc.set_capacity(1ULL << 20);
+    oc.update(e::slice("k"), make_object("value", 1));
+    ASSERT_EQ(1U, cached(&oc, "k"));
+    oc.set_capacity(0);
+    ASSERT_EQ(0U, cached_bytes(&oc));
+    ASSERT_EQ(0U, cached(&oc, "k"));
+}
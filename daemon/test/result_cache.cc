@@ -0,0 +1,152 @@
+// Copyright (c) 2013, Cornell University
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of HyperDex nor the names of its contributors may be
+//       used to endorse or promote products derived from this software without
+//       specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+
+// C
+#include <string.h>
+
+// HyperDex
+#include "test/th.h"
+#include "daemon/result_cache.h"
+
+using hyperdex::attribute_check;
+using hyperdex::region_id;
+using hyperdex::result_cache;
+
+static attribute_check
+make_check(uint16_t attr, hyperpredicate pred, const char* value)
+{
+    attribute_check chk;
+    chk.attr = attr;
+    chk.value = e::slice(value, strlen(value));
+    chk.datatype = HYPERDATATYPE_STRING;
+    chk.predicate = pred;
+    return chk;
+}
+
+static std::string
+lookup(result_cache* rc, const std::string& key, uint64_t epoch)
+{
+    std::string reply;
+
+    if (!rc->lookup(key, epoch, &reply))
+    {
+        return "<miss>";
+    }
+
+    return reply;
+}
+
+TEST(ResultCache, KeyIgnoresCheckOrder)
+{
+    result_cache rc;
+    rc.set_capacity(16);
+    attribute_check a = make_check(1, HYPERPREDICATE_EQUALS, "x");
+    attribute_check b = make_check(1, HYPERPREDICATE_EQUALS, "y");
+    attribute_check c = make_check(2, HYPERPREDICATE_LESS_EQUAL, "x");
+    std::vector<attribute_check> abc;
+    abc.push_back(a);
+    abc.push_back(b);
+    abc.push_back(c);
+    std::vector<attribute_check> cba;
+    cba.push_back(c);
+    cba.push_back(b);
+    cba.push_back(a);
+    std::vector<attribute_check> ab;
+    ab.push_back(a);
+    ab.push_back(b);
+
+    std::string k1;
+    std::string k2;
+    ASSERT_TRUE(rc.key('c', region_id(1), abc, "", &k1));
+    ASSERT_TRUE(rc.key('c', region_id(1), cba, "", &k2));
+    ASSERT_EQ(k1, k2);
+
+    // everything else about the request distinguishes it
+    ASSERT_TRUE(rc.key('s', region_id(1), abc, "", &k2));
+    ASSERT_NE(k1, k2);
+    ASSERT_TRUE(rc.key('c', region_id(2), abc, "", &k2));
+    ASSERT_NE(k1, k2);
+    ASSERT_TRUE(rc.key('c', region_id(1), abc, "p", &k2));
+    ASSERT_NE(k1, k2);
+    ASSERT_TRUE(rc.key('c', region_id(1), ab, "", &k2));
+    ASSERT_NE(k1, k2);
+}
+
+TEST(ResultCache, Epoch)
+{
+    result_cache rc;
+    rc.set_capacity(16);
+    rc.insert("k", 5, e::slice("reply", 5));
+    ASSERT_EQ("reply", lookup(&rc, "k", 5));
+    // the region was written since the reply was computed
+    ASSERT_EQ("<miss>", lookup(&rc, "k", 6));
+    // a reply computed at the new epoch replaces it
+    rc.insert("k", 6, e::slice("newer", 5));
+    ASSERT_EQ("newer", lookup(&rc, "k", 6));
+    ASSERT_EQ("<miss>", lookup(&rc, "k", 5));
+}
+
+TEST(ResultCache, LRU)
+{
+    result_cache rc;
+    rc.set_capacity(2);
+    rc.insert("a", 1, e::slice("A", 1));
+    rc.insert("b", 1, e::slice("B", 1));
+    // using "a" leaves "b" least recently used
+    ASSERT_EQ("A", lookup(&rc, "a", 1));
+    rc.insert("c", 1, e::slice("C", 1));
+    ASSERT_EQ("A", lookup(&rc, "a", 1));
+    ASSERT_EQ("<miss>", lookup(&rc, "b", 1));
+    ASSERT_EQ("C", lookup(&rc, "c", 1));
+    // replacing an entry evicts nothing
+    rc.insert("c", 2, e::slice("D", 1));
+    ASSERT_EQ("A", lookup(&rc, "a", 1));
+    ASSERT_EQ("D", lookup(&rc, "c", 2));
+}
+
+TEST(ResultCache, Clear)
+{
+    result_cache rc;
+    rc.set_capacity(2);
+    rc.insert("a", 1, e::slice("A", 1));
+    rc.clear();
+    ASSERT_EQ("<miss>", lookup(&rc, "a", 1));
+    rc.insert("a", 1, e::slice("A", 1));
+    rc.set_capacity(4);
+    ASSERT_EQ("<miss>", lookup(&rc, "a", 1));
+}
+
+TEST(ResultCache, Disabled)
+{
+    result_cache rc;
+    std::vector<attribute_check> checks;
+    std::string key;
+    ASSERT_FALSE(rc.key('c', region_id(1), checks, "", &key));
+    rc.insert("a", 1, e::slice("A", 1));
+    ASSERT_EQ("<miss>", lookup(&rc, "a", 1));
+}
@@ -101,7 +101,9 @@ enum hyperpredicate
     HYPERPREDICATE_LENGTH_EQUALS        = 9734,
     HYPERPREDICATE_LENGTH_LESS_EQUAL    = 9735,
     HYPERPREDICATE_LENGTH_GREATER_EQUAL = 9736,
-    HYPERPREDICATE_CONTAINS      = 9737
+    HYPERPREDICATE_CONTAINS      = 9737,
+    HYPERPREDICATE_PREFIX        = 9738,
+    HYPERPREDICATE_IN            = 9739  /* value is a list or set of candidates */
 };
 
 #ifdef __cplusplus
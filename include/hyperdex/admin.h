@@ -100,6 +100,18 @@ hyperdex_admin_rm_space(struct hyperdex_admin* admin,
                         const char* name,
                         enum hyperdex_admin_returncode* status);
 
+int64_t
+hyperdex_admin_add_index(struct hyperdex_admin* admin,
+                         const char* space,
+                         const char* attribute,
+                         enum hyperdex_admin_returncode* status);
+
+int64_t
+hyperdex_admin_rm_index(struct hyperdex_admin* admin,
+                        const char* space,
+                        const char* attribute,
+                        enum hyperdex_admin_returncode* status);
+
 int64_t
 hyperdex_admin_enable_perf_counters(struct hyperdex_admin* admin,
                                     enum hyperdex_admin_returncode* status,
@@ -66,6 +66,12 @@ class Admin
         int64_t rm_space(const char* name,
                          enum hyperdex_admin_returncode* status)
             { return hyperdex_admin_rm_space(m_adm, name, status); }
+        int64_t add_index(const char* space, const char* attribute,
+                          enum hyperdex_admin_returncode* status)
+            { return hyperdex_admin_add_index(m_adm, space, attribute, status); }
+        int64_t rm_index(const char* space, const char* attribute,
+                         enum hyperdex_admin_returncode* status)
+            { return hyperdex_admin_rm_index(m_adm, space, attribute, status); }
         int64_t enable_perf_counters(enum hyperdex_admin_returncode* status,
                                      struct hyperdex_admin_perf_counter* pc)
             { return hyperdex_admin_enable_perf_counters(m_adm, status, pc); }
@@ -71,6 +71,21 @@ struct hyperdex_client_attribute_check
     enum hyperpredicate predicate;
 };
 
+#define HYPERDEX_CLIENT_AGGREGATE_BUCKETS 16
+
+struct hyperdex_client_aggregate_result
+{
+    uint64_t count; /* number of objects aggregated */
+    double sum;
+    double min;
+    double max;
+    double avg;
+    /* the histogram evenly divides [histogram_lower, histogram_upper) */
+    uint64_t below;
+    uint64_t above;
+    uint64_t buckets[HYPERDEX_CLIENT_AGGREGATE_BUCKETS];
+};
+
 /* HyperClient returncode occupies [8448, 8576) */
 enum hyperdex_client_returncode
 {
@@ -119,6 +134,14 @@ hyperdex_client_get(struct hyperdex_client* client,
                     enum hyperdex_client_returncode* status,
                     const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
 
+int64_t
+hyperdex_client_get_partial(struct hyperdex_client* client,
+                            const char* space,
+                            const char* key, size_t key_sz,
+                            const char** attrnames, size_t attrnames_sz,
+                            enum hyperdex_client_returncode* status,
+                            const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
 int64_t
 hyperdex_client_put(struct hyperdex_client* client,
                     const char* space,
@@ -581,6 +604,22 @@ hyperdex_client_search(struct hyperdex_client* client,
                        enum hyperdex_client_returncode* status,
                        const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
 
+int64_t
+hyperdex_client_search_partial(struct hyperdex_client* client,
+                               const char* space,
+                               const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char** attrnames, size_t attrnames_sz,
+                               enum hyperdex_client_returncode* status,
+                               const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
+int64_t
+hyperdex_client_search_limit(struct hyperdex_client* client,
+                             const char* space,
+                             const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                             uint64_t limit,
+                             enum hyperdex_client_returncode* status,
+                             const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
 int64_t
 hyperdex_client_search_describe(struct hyperdex_client* client,
                                 const char* space,
@@ -598,12 +637,226 @@ hyperdex_client_sorted_search(struct hyperdex_client* client,
                               enum hyperdex_client_returncode* status,
                               const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
 
+int64_t
+hyperdex_client_sorted_search_partial(struct hyperdex_client* client,
+                                      const char* space,
+                                      const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                      const char* sort_by,
+                                      uint64_t limit,
+                                      int maxmin,
+                                      const char** attrnames, size_t attrnames_sz,
+                                      enum hyperdex_client_returncode* status,
+                                      const struct hyperdex_client_attribute** attrs, size_t* attrs_sz);
+
 int64_t
 hyperdex_client_group_del(struct hyperdex_client* client,
                           const char* space,
                           const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
                           enum hyperdex_client_returncode* status);
 
+int64_t
+hyperdex_client_group_put(struct hyperdex_client* client,
+                          const char* space,
+                          const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                          enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_add(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_sub(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_mul(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_div(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_mod(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_and(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_or(struct hyperdex_client* client,
+                                const char* space,
+                                const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_atomic_xor(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_string_prepend(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_string_append(struct hyperdex_client* client,
+                                    const char* space,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_list_lpush(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_list_rpush(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_set_add(struct hyperdex_client* client,
+                              const char* space,
+                              const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                              const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                              enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_set_remove(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_set_intersect(struct hyperdex_client* client,
+                                    const char* space,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_set_union(struct hyperdex_client* client,
+                                const char* space,
+                                const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_add(struct hyperdex_client* client,
+                              const char* space,
+                              const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                              const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                              enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_remove(struct hyperdex_client* client,
+                                 const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_add(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_sub(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_mul(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_div(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_mod(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_and(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_or(struct hyperdex_client* client,
+                                    const char* space,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                    enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_atomic_xor(struct hyperdex_client* client,
+                                     const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_string_prepend(struct hyperdex_client* client,
+                                         const char* space,
+                                         const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                         const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                         enum hyperdex_client_returncode* status);
+
+int64_t
+hyperdex_client_group_map_string_append(struct hyperdex_client* client,
+                                        const char* space,
+                                        const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                        const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                        enum hyperdex_client_returncode* status);
+
 int64_t
 hyperdex_client_count(struct hyperdex_client* client,
                       const char* space,
@@ -611,6 +864,15 @@ hyperdex_client_count(struct hyperdex_client* client,
                       enum hyperdex_client_returncode* status,
                       uint64_t* count);
 
+int64_t
+hyperdex_client_aggregate(struct hyperdex_client* client,
+                          const char* space,
+                          const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const char* attr,
+                          double histogram_lower, double histogram_upper,
+                          enum hyperdex_client_returncode* status,
+                          struct hyperdex_client_aggregate_result* aggregate);
+
 int64_t
 hyperdex_client_loop(struct hyperdex_client* client, int timeout,
                      enum hyperdex_client_returncode* status);
@@ -58,6 +58,11 @@ class Client
                     hyperdex_client_returncode* status,
                     const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
             { return hyperdex_client_get(m_cl, space, key, key_sz, status, attrs, attrs_sz); }
+        int64_t get_partial(const char* space, const char* key, size_t key_sz,
+                            const char** attrnames, size_t attrnames_sz,
+                            hyperdex_client_returncode* status,
+                            const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_get_partial(m_cl, space, key, key_sz, attrnames, attrnames_sz, status, attrs, attrs_sz); }
         int64_t put(const char* space, const char* key, size_t key_sz,
                     const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
                     hyperdex_client_returncode* status)
@@ -335,6 +340,18 @@ class Client
                        enum hyperdex_client_returncode* status,
                        const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
             { return hyperdex_client_search(m_cl, space, checks, checks_sz, status, attrs, attrs_sz); }
+        int64_t search_partial(const char* space,
+                               const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                               const char** attrnames, size_t attrnames_sz,
+                               enum hyperdex_client_returncode* status,
+                               const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_search_partial(m_cl, space, checks, checks_sz, attrnames, attrnames_sz, status, attrs, attrs_sz); }
+        int64_t search_limit(const char* space,
+                             const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                             uint64_t limit,
+                             enum hyperdex_client_returncode* status,
+                             const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_search_limit(m_cl, space, checks, checks_sz, limit, status, attrs, attrs_sz); }
         int64_t search_describe(const char* space,
                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
                                 enum hyperdex_client_returncode* status, const char** str)
@@ -345,14 +362,172 @@ class Client
                               enum hyperdex_client_returncode* status,
                               const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
             { return hyperdex_client_sorted_search(m_cl, space, checks, checks_sz, sort_by, limit, maximize, status, attrs, attrs_sz); }
+        int64_t sorted_search_partial(const char* space,
+                                      const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                      const char* sort_by, uint64_t limit, int maximize,
+                                      const char** attrnames, size_t attrnames_sz,
+                                      enum hyperdex_client_returncode* status,
+                                      const struct hyperdex_client_attribute** attrs, size_t* attrs_sz)
+            { return hyperdex_client_sorted_search_partial(m_cl, space, checks, checks_sz, sort_by, limit, maximize, attrnames, attrnames_sz, status, attrs, attrs_sz); }
         int64_t group_del(const char* space,
                           const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
                           enum hyperdex_client_returncode* status)
             { return hyperdex_client_group_del(m_cl, space, checks, checks_sz, status); }
+        int64_t group_put(const char* space,
+                          const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                          hyperdex_client_returncode* status)
+            { return hyperdex_client_group_put(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_add(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_add(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_sub(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_sub(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_mul(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_mul(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_div(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_div(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_mod(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_mod(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_and(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_and(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_or(const char* space,
+                                const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_or(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_atomic_xor(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_atomic_xor(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_string_prepend(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_string_prepend(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_string_append(const char* space,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    hyperdex_client_returncode* status)
+            { return hyperdex_client_group_string_append(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_list_lpush(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_list_lpush(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_list_rpush(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_list_rpush(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_set_add(const char* space,
+                              const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                              const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                              hyperdex_client_returncode* status)
+            { return hyperdex_client_group_set_add(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_set_remove(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_set_remove(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_set_intersect(const char* space,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                    hyperdex_client_returncode* status)
+            { return hyperdex_client_group_set_intersect(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_set_union(const char* space,
+                                const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                hyperdex_client_returncode* status)
+            { return hyperdex_client_group_set_union(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_map_add(const char* space,
+                              const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                              const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                              hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_add(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_remove(const char* space,
+                                 const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                 const struct hyperdex_client_attribute* attrs, size_t attrs_sz,
+                                 hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_remove(m_cl, space, checks, checks_sz, attrs, attrs_sz, status); }
+        int64_t group_map_atomic_add(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_add(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_sub(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_sub(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_mul(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_mul(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_div(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_div(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_mod(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_mod(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_and(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_and(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_or(const char* space,
+                                    const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                    const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                    hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_or(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_atomic_xor(const char* space,
+                                     const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                     const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                     hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_atomic_xor(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_string_prepend(const char* space,
+                                         const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                         const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                         hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_string_prepend(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
+        int64_t group_map_string_append(const char* space,
+                                        const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                                        const struct hyperdex_client_map_attribute* mapattrs, size_t mapattrs_sz,
+                                        hyperdex_client_returncode* status)
+            { return hyperdex_client_group_map_string_append(m_cl, space, checks, checks_sz, mapattrs, mapattrs_sz, status); }
         int64_t count(const char* space,
                       const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
                       enum hyperdex_client_returncode* status, uint64_t* result)
             { return hyperdex_client_count(m_cl, space, checks, checks_sz, status, result); }
+        int64_t aggregate(const char* space,
+                          const struct hyperdex_client_attribute_check* checks, size_t checks_sz,
+                          const char* attr, double histogram_lower, double histogram_upper,
+                          enum hyperdex_client_returncode* status,
+                          struct hyperdex_client_aggregate_result* aggregate)
+            { return hyperdex_client_aggregate(m_cl, space, checks, checks_sz, attr, histogram_lower, histogram_upper, status, aggregate); }
 
     public:
         int64_t loop(int timeout, hyperdex_client_returncode* status)
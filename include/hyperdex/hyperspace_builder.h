@@ -84,6 +84,15 @@ hyperspace_add_attribute(struct hyperspace* space,
 enum hyperspace_returncode
 hyperspace_primary_index(struct hyperspace* space, const char* attr);
 
+/* store attr's value in the key subspace's index entries */
+enum hyperspace_returncode
+hyperspace_primary_covering(struct hyperspace* space, const char* attr);
+
+/* start a composite index in the key subspace; see
+ * hyperspace_add_composite_index_attribute */
+enum hyperspace_returncode
+hyperspace_primary_composite_index(struct hyperspace* space);
+
 enum hyperspace_returncode
 hyperspace_add_subspace(struct hyperspace* space);
 
@@ -93,6 +102,18 @@ hyperspace_add_subspace_attribute(struct hyperspace* space, const char* attr);
 enum hyperspace_returncode
 hyperspace_add_secondary_index(struct hyperspace* space, const char* attr);
 
+/* store attr's value in the most recent subspace's index entries */
+enum hyperspace_returncode
+hyperspace_add_secondary_covering(struct hyperspace* space, const char* attr);
+
+/* start a composite index in the most recent subspace */
+enum hyperspace_returncode
+hyperspace_add_secondary_composite_index(struct hyperspace* space);
+
+/* append attr to the most recently started composite index */
+enum hyperspace_returncode
+hyperspace_add_composite_index_attribute(struct hyperspace* space, const char* attr);
+
 enum hyperspace_returncode
 hyperspace_set_fault_tolerance(struct hyperspace* space, uint64_t num);
 